@@ -0,0 +1,169 @@
+/********************************************************************************
+ * @file   : OpenTimeBenchmark.cpp
+ * @brief  : 媒体打开耗时基准测试。
+ *
+ * 对每个输入文件分别测量：
+ *   - cold：清除探测缓存后，完整执行 avformat_find_stream_info 的打开耗时；
+ *   - warm：探测缓存命中时的打开耗时。
+ * 每次打开都会继续初始化解码器并解出第一帧，因此结果即“启动到首帧”时间。
+ * 注意：文件数据在第一次打开后已进入页缓存，这里的 cold 只表示探测未命中。
+ *
+ * 用法：open_time_benchmark [-n 次数] <媒体文件>...
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include <QtCore/QDir>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#include "aurorastream/core/ProbeCache.h"
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+}
+
+using aurorastream::core::ProbeCache;
+
+namespace {
+
+struct OpenResult {
+    double openUs = 0;          // avformat_open_input + 流信息（探测或缓存重建）
+    double firstFrameUs = 0;    // 打开开始到第一帧解码完成
+    bool ok = false;
+};
+
+OpenResult openOnce(ProbeCache& cache, const std::string& path, bool useCache)
+{
+    using Clock = std::chrono::steady_clock;
+    OpenResult result;
+    const auto start = Clock::now();
+
+    AVFormatContext* formatContext = nullptr;
+    if (avformat_open_input(&formatContext, path.c_str(), nullptr, nullptr) < 0) {
+        return result;
+    }
+
+    const bool hit = useCache && cache.restore(path, formatContext);
+    if (!hit) {
+        if (avformat_find_stream_info(formatContext, nullptr) < 0) {
+            avformat_close_input(&formatContext);
+            return result;
+        }
+        if (useCache) {
+            cache.store(path, formatContext);
+        }
+    }
+    result.openUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+    int streamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (streamIndex < 0) {
+        streamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    }
+
+    AVCodecContext* codecContext = nullptr;
+    if (streamIndex >= 0) {
+        const AVCodecParameters* par = formatContext->streams[streamIndex]->codecpar;
+        const AVCodec* codec = avcodec_find_decoder(par->codec_id);
+        codecContext = codec ? avcodec_alloc_context3(codec) : nullptr;
+        if (codecContext && (avcodec_parameters_to_context(codecContext, par) < 0
+                             || avcodec_open2(codecContext, codec, nullptr) < 0)) {
+            avcodec_free_context(&codecContext);
+        }
+    }
+
+    if (codecContext) {
+        AVPacket* packet = av_packet_alloc();
+        AVFrame* frame = av_frame_alloc();
+        bool gotFrame = false;
+        while (!gotFrame && av_read_frame(formatContext, packet) >= 0) {
+            if (packet->stream_index == streamIndex && avcodec_send_packet(codecContext, packet) >= 0) {
+                gotFrame = avcodec_receive_frame(codecContext, frame) >= 0;
+            }
+            av_packet_unref(packet);
+        }
+        result.firstFrameUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        result.ok = gotFrame;
+        av_frame_free(&frame);
+        av_packet_free(&packet);
+        avcodec_free_context(&codecContext);
+    }
+
+    avformat_close_input(&formatContext);
+    return result;
+}
+
+double median(std::vector<double> values)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int iterations = 10;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            iterations = std::max(1, std::atoi(argv[++i]));
+        } else {
+            files.emplace_back(argv[i]);
+        }
+    }
+    if (files.empty()) {
+        std::fprintf(stderr, "usage: %s [-n iterations] <media files>...\n", argv[0]);
+        return 1;
+    }
+
+    // 使用独立目录，避免影响应用自身的缓存
+    ProbeCache cache((QDir::tempPath() + "/aurorastream-open-bench").toStdString());
+
+    std::printf("%-40s %12s %12s %12s %12s %8s\n",
+                "file", "cold open", "warm open", "cold 1st fr", "warm 1st fr", "speedup");
+    for (const std::string& file : files) {
+        std::vector<double> coldOpen, coldFrame, warmOpen, warmFrame;
+        bool ok = true;
+
+        for (int i = 0; i < iterations && ok; ++i) {
+            cache.remove(file);
+            OpenResult cold = openOnce(cache, file, true);
+            OpenResult warm = openOnce(cache, file, true);
+            ok = cold.ok && warm.ok;
+            coldOpen.push_back(cold.openUs);
+            coldFrame.push_back(cold.firstFrameUs);
+            warmOpen.push_back(warm.openUs);
+            warmFrame.push_back(warm.firstFrameUs);
+        }
+
+        if (!ok) {
+            std::printf("%-40s failed to open or decode\n", file.c_str());
+            continue;
+        }
+
+        const double warmFirstFrame = median(warmFrame);
+        std::printf("%-40s %10.0fus %10.0fus %10.0fus %10.0fus %7.2fx\n",
+                    file.c_str(), median(coldOpen), median(warmOpen),
+                    median(coldFrame), warmFirstFrame,
+                    warmFirstFrame > 0 ? median(coldFrame) / warmFirstFrame : 0.0);
+    }
+
+    const ProbeCache::Statistics stats = cache.getStatistics();
+    std::printf("probe cache: %llu hits, %llu misses, %llu stores\n",
+                static_cast<unsigned long long>(stats.hits),
+                static_cast<unsigned long long>(stats.misses),
+                static_cast<unsigned long long>(stats.stores));
+    return 0;
+}
@@ -100,6 +100,10 @@ public:
     virtual float getVolume() const = 0;
     virtual void setLoop(bool loop) = 0;
     virtual bool getLoop() const = 0;
+
+    // 播放速率：负值表示倒放，约 2 倍以上只解码关键帧并静音
+    virtual bool setPlaybackRate(double rate) = 0;
+    virtual double getPlaybackRate() const = 0;
 };
 
 // 工具方法
@@ -0,0 +1,103 @@
+/********************************************************************************
+ * @file   : AbrController.h
+ * @brief  : 定义了 aurorastream::core::AbrController 类。
+ *
+ * AbrController 为自适应流的下一个分段选择码率档位，结合两条规则：
+ *   - 吞吐量规则：缓冲较少时（启动、跳转后、卡顿后）选择不超过
+ *     带宽估计 × safetyFactor 的最高档位。带宽估计取快、慢两个按下载时长
+ *     加权的指数滑动平均中较小的一个，下降时反应快、上升时保守；
+ *   - BOLA：缓冲充足后按缓冲水位选择使效用函数最大的档位（Spiteri 等，
+ *     BOLA-BASIC 的形式与 dash.js 相同），缓冲越多选得越高，不依赖带宽估计。
+ *     BOLA 要升到吞吐量规则之上时，最多只升到吞吐量规则和当前档位中较高的一个，
+ *     避免在带宽不足时因缓冲暂时充足而来回切换（BOLA-O）。
+ * 两条规则之间带回差：缓冲超过 bolaBufferSeconds 后切到 BOLA，
+ * 低于 bolaBufferSeconds 的一半时回到吞吐量规则。切到 BOLA 时加上一段虚拟缓冲，
+ * 使 BOLA 从当前档位接手（dash.js 的 placeholder buffer）。
+ *
+ * 该类不加锁，由 AdaptiveStream 在自己的锁内调用。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_ABRCONTROLLER_H
+#define AURORASTREAM_CORE_ABRCONTROLLER_H
+
+#include <vector>
+#include <cstdint>
+
+#include "aurorastream/AuroraStream.h"
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API AbrController
+{
+public:
+    /**
+     * @brief 控制参数
+     */
+    struct Options {
+        double initialBandwidth = 1e6;          ///< 还没有测量时使用的带宽估计（bit/s）
+        double safetyFactor = 0.9;              ///< 吞吐量规则只使用带宽估计的这一比例
+        double fastHalfLife = 3.0;              ///< 快速滑动平均的半衰期（秒，按下载时长计）
+        double slowHalfLife = 8.0;              ///< 慢速滑动平均的半衰期
+        double bolaBufferSeconds = 10.0;        ///< 缓冲超过该值时使用 BOLA，也是 BOLA 的最低缓冲
+        double stableBufferSeconds = 12.0;      ///< BOLA 在最高档位时维持的缓冲目标
+    };
+
+    /**
+     * @param bitrates 各档位码率（bit/s），升序
+     * @param options 控制参数
+     */
+    AbrController(const std::vector<int64_t>& bitrates, const Options& options);
+
+    /**
+     * @brief 加入一次吞吐量测量
+     * @param bytes 这段时间内收到的字节数
+     * @param seconds 下载耗时（有下载进行的时长）
+     */
+    void addSample(int64_t bytes, double seconds);
+
+    /// 当前带宽估计（bit/s）
+    double bandwidth() const;
+
+    /// 吞吐量规则选出的档位
+    int throughputQuality() const;
+
+    /**
+     * @brief 为下一个分段选择档位
+     * @param bufferSeconds 当前缓冲时长（秒）
+     * @param current 上一个分段的档位，-1 表示还没有
+     * @return 档位下标
+     */
+    int select(double bufferSeconds, int current);
+
+    /// 当前是否处于 BOLA 阶段
+    bool isBufferBased() const;
+
+    /// 跳转后缓冲清空，回到吞吐量规则
+    void reset();
+
+private:
+    int bolaQuality(double bufferSeconds) const;
+    double minimumBufferFor(int quality) const;
+
+    std::vector<int64_t> m_bitrates;
+    Options m_options;
+    std::vector<double> m_utilities;            ///< ln(码率 / 最低码率) + 1
+    double m_gp {0.0};                          ///< BOLA 参数 γp
+    double m_vp {0.0};                          ///< BOLA 参数 Vp（秒）
+
+    double m_fastEstimate {0.0};
+    double m_slowEstimate {0.0};
+    double m_fastWeight {0.0};                  ///< 零偏修正用的累计权重
+    double m_slowWeight {0.0};
+    bool m_bufferBased {false};
+    double m_placeholder {0.0};                 ///< 切到 BOLA 时补足的虚拟缓冲（秒）
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_ABRCONTROLLER_H
@@ -0,0 +1,206 @@
+/********************************************************************************
+ * @file   : AdaptiveStream.h
+ * @brief  : 定义了 aurorastream::core::AdaptiveStream 类。
+ *
+ * AdaptiveStream 是 HLS / DASH 的自适应码率客户端，以自定义 AVIOContext 的形式
+ * 把所选档位的分段按顺序拼接成一个连续的字节流交给解复用器：
+ *   - 清单解析见 StreamManifest，码率选择见 AbrController；
+ *   - 分段下载作为任务提交到共享线程池（TaskScheduler），并行预取后续分段，
+ *     同时在途的任务数和预取的总时长都有上限；
+ *     解复用器可以读取正在下载的分段，不必等整个分段下载完；
+ *   - 每个分段下载前才决定档位，切换总是落在分段边界上。MPEG-TS 分段之间
+ *     的切换对解复用器和解码器是透明的（编码参数的变化由码流内的参数集携带），
+ *     不需要重新打开解码器；
+ *   - 带初始化分段的 fMP4 档位无法在同一个解复用器中切换，此时只在启动时
+ *     选择一次档位。
+ *
+ * 统计启动时间、卡顿比例（卡顿时长 /（卡顿时长 + 已播放的媒体时长））
+ * 和按时长加权的平均码率。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_ADAPTIVESTREAM_H
+#define AURORASTREAM_CORE_ADAPTIVESTREAM_H
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+#include <QString>
+
+#include "aurorastream/AuroraStream.h"
+#include "aurorastream/core/AbrController.h"
+#include "aurorastream/core/StreamManifest.h"
+#include "aurorastream/core/TaskScheduler.h"
+
+extern "C" {
+#include <libavformat/avio.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API AdaptiveStream
+{
+public:
+    /**
+     * @brief 客户端选项
+     */
+    struct Options {
+        QualityLevel quality = QualityLevel::ADAPTIVE;  ///< ADAPTIVE 为自动选择，其他值固定档位
+        int maxInFlight = 3;                            ///< 同时在线程池中执行的下载任务数（分段和播放列表）
+        double maxBufferSeconds = 30.0;                 ///< 预取的最大媒体时长（秒）
+        int maxRetries = 3;                             ///< 单个分段的最大重试次数
+        double timeoutSeconds = 10.0;                   ///< 单次网络读写超时（秒）
+        AbrController::Options abr;                     ///< 码率选择参数
+    };
+
+    /**
+     * @brief 统计
+     */
+    struct Statistics {
+        int64_t startupTimeUs = 0;                      ///< 从打开到第一个字节交给解复用器的时间
+        int64_t rebufferTimeUs = 0;                     ///< 启动和跳转之外，解复用器等待数据的累计时间
+        int rebufferCount = 0;
+        double playedSeconds = 0.0;                     ///< 已交给解复用器的媒体时长
+        double rebufferRatio = 0.0;                     ///< 卡顿时长 /（卡顿时长 + 已播放时长）
+        double averageBitrate = 0.0;                    ///< 已播放分段的声明码率按时长加权平均（bit/s）
+        double bandwidth = 0.0;                         ///< 当前带宽估计（bit/s）
+        double bufferSeconds = 0.0;                     ///< 已下载、尚未交给解复用器的媒体时长
+        int rendition = -1;                             ///< 最近一个分段的档位
+        int64_t bitrate = 0;                            ///< 最近一个分段的声明码率
+        int switches = 0;                               ///< 档位切换次数
+        uint64_t segments = 0;                          ///< 已下载完成的分段数
+        uint64_t bytes = 0;                             ///< 已下载的字节数
+        uint64_t errors = 0;                            ///< 下载失败次数（含重试）
+        uint64_t skipped = 0;                           ///< 重试后仍失败而跳过的分段数
+    };
+
+    /**
+     * @brief 下载并解析清单，加载初始档位，开始预取分段
+     * @param uri 清单地址（http(s)://... 或本地 .m3u8 / .mpd 路径）
+     * @param options 客户端选项
+     * @param errorMessage 失败时写入错误描述，可为空
+     * @return 失败返回 nullptr；加密分段等不支持的情况也返回 nullptr，调用方可回退到 FFmpeg 自带的解复用器
+     */
+    static std::unique_ptr<AdaptiveStream> open(const QString& uri, const Options& options,
+                                                QString* errorMessage = nullptr);
+
+    /// 按地址判断是否为自适应流清单
+    static bool isManifest(const QString& uri);
+
+    /// 析构函数，中断所有下载并等待下载任务结束
+    ~AdaptiveStream();
+
+    AdaptiveStream(const AdaptiveStream&) = delete;
+    AdaptiveStream& operator=(const AdaptiveStream&) = delete;
+
+    /**
+     * @brief 获取可以挂到 AVFormatContext::pb 上的 AVIOContext（不可随机访问）
+     * @note 调用方需设置 AVFMT_FLAG_CUSTOM_IO，并在本对象销毁前关闭 AVFormatContext
+     */
+    AVIOContext* avioContext() const;
+
+    /**
+     * @brief 跳转：丢弃已预取的分段，从包含目标时间的分段重新开始
+     * 字节位置从 0 重新计数，并通过 avio_seek 丢弃 AVIOContext 中的旧数据。
+     * @param time 目标时间（微秒），相对于节目开头
+     * @return 新的起始分段的时间（微秒），失败返回负的 FFmpeg 错误码
+     * @note 只能在读取 AVIOContext 的线程中调用；调用方负责清空解复用器的状态（avformat_flush）
+     */
+    int64_t seek(int64_t time);
+
+    /**
+     * @brief 修改档位选择方式，从下一个开始下载的分段起生效
+     */
+    void setQuality(QualityLevel quality);
+    QualityLevel quality() const;
+
+    /// 清单；档位属性（码率、分辨率）打开后不变，分段列表可能被下载任务刷新，不应在外部读取
+    const StreamManifest& manifest() const;
+    /// 节目总时长（微秒），直播为 0
+    int64_t duration() const;
+    bool isLive() const;
+    /// 档位能否切换（fMP4 档位在启动后固定）
+    bool isSwitchable() const;
+
+    Statistics getStatistics() const;
+
+private:
+    struct Slot;
+
+    AdaptiveStream(std::unique_ptr<StreamManifest> manifest, const Options& options);
+
+    static int readPacket(void* opaque, uint8_t* buf, int size);
+    static int64_t seekPacket(void* opaque, int64_t offset, int whence);
+    static int interrupted(void* opaque);
+    int read(uint8_t* buf, int size);
+
+    void dispatchLocked();
+    void submitLocked(std::function<void()> task);
+    void fetchSlot(const std::shared_ptr<Slot>& slot, uint64_t generation);
+    void loadPlaylist(int rendition);
+
+    std::shared_ptr<Slot> scheduleLocked();
+    void popFrontLocked();
+    int chooseRenditionLocked();
+    int usableRenditionLocked(int rendition) const;
+    int fixedRenditionLocked(QualityLevel quality) const;
+    double bufferedLocked(bool downloadedOnly) const;
+    double busyTimeLocked() const;
+    void beginFetchLocked();
+    void endFetchLocked();
+
+    Options m_options;
+    std::unique_ptr<StreamManifest> m_manifest;
+    AVIOContext* m_avio {nullptr};
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_retryWakeup;          ///< 唤醒退避等待中的下载：跳转或停止
+    std::condition_variable m_dataAvailable;        ///< 通知读取方：有新数据或分段结束
+    std::deque<std::shared_ptr<Slot>> m_slots;      ///< 按播放顺序排列的分段
+    TaskGroup m_tasks;                              ///< 已提交到线程池的下载任务
+    int m_inFlight {0};                             ///< 已提交、尚未结束的下载任务数
+    std::atomic<bool> m_stopping {false};
+    std::atomic<uint64_t> m_generation {0};         ///< 每次跳转加一，旧的下载据此中止
+
+    // 调度状态
+    AbrController m_abr;
+    QualityLevel m_quality;
+    int64_t m_nextNumber {0};                       ///< 下一个要调度的分段编号
+    bool m_ended {false};                           ///< 点播的所有分段都已调度
+    bool m_switchable {true};
+    int m_lockedRendition {-1};                     ///< fMP4 时启动后固定的档位
+    int m_lastRendition {-1};
+    std::vector<bool> m_excluded;                   ///< 编码不兼容或播放列表加载失败的档位
+    std::vector<bool> m_loading;                    ///< 正在加载播放列表的档位
+    std::vector<int64_t> m_lastReload;              ///< 直播播放列表上次刷新的时间（微秒）
+    int m_reloadRequest {-1};                       ///< 需要加载或刷新播放列表的档位
+
+    // 吞吐量测量：只计算有下载在进行的时间，并行下载时得到的是总带宽
+    int m_activeFetches {0};
+    int64_t m_busyStart {0};
+    int64_t m_busyTime {0};
+    uint64_t m_busyBytes {0};
+    int64_t m_sampleTime {0};
+    uint64_t m_sampleBytes {0};
+
+    // 统计
+    int64_t m_openStart {0};
+    bool m_started {false};                         ///< 已交出第一个字节
+    bool m_afterSeek {false};                       ///< 跳转后尚未交出数据，此时的等待不计入卡顿
+    int64_t m_readPosition {0};                     ///< 上次跳转以来交出的字节数，即 AVIOContext 的位置
+    double m_weightedBitrate {0.0};
+    Statistics m_statistics;
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_ADAPTIVESTREAM_H
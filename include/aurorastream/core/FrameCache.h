@@ -0,0 +1,116 @@
+/********************************************************************************
+ * @file   : FrameCache.h
+ * @brief  : 定义了 aurorastream::core::FrameCache 类。
+ *
+ * FrameCache 缓存播放头附近最近解码的视频帧，用于逐帧前进/后退和
+ * 小范围的向后跳转。帧以 GOP 为单位组织：关键帧开启一个新的 GOP，
+ * 之后连续解码的帧归入该 GOP；超过内存上限时按 GOP 做 LRU 淘汰。
+ *
+ * 缓存只保存 AVFrame 的引用（av_frame_ref），写入和读取都不拷贝像素数据。
+ * 时间戳由调用者决定（通常为所属流的时间基），同一缓存内必须保持一致。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_FRAMECACHE_H
+#define AURORASTREAM_CORE_FRAMECACHE_H
+
+#include <map>
+#include <list>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "aurorastream/AuroraStream.h"
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API FrameCache
+{
+public:
+    /**
+     * @brief 缓存统计
+     */
+    struct Statistics {
+        uint64_t hits = 0;          ///< 命中次数
+        uint64_t misses = 0;        ///< 未命中次数
+        uint64_t evictions = 0;     ///< 被淘汰的 GOP 数
+        std::size_t bytes = 0;      ///< 当前占用内存（字节）
+        std::size_t frames = 0;     ///< 当前缓存的帧数
+    };
+
+    /**
+     * @brief 构造函数
+     * @param memoryLimit 内存上限（字节）
+     */
+    explicit FrameCache(std::size_t memoryLimit = 256 * 1024 * 1024);
+    ~FrameCache();
+
+    FrameCache(const FrameCache&) = delete;
+    FrameCache& operator=(const FrameCache&) = delete;
+
+    void setMemoryLimit(std::size_t memoryLimit);
+    std::size_t memoryLimit() const;
+
+    /**
+     * @brief 写入一帧解码后的视频帧
+     * 帧必须按显示顺序连续写入；关键帧开启新的 GOP。
+     * 在 resetSequence() 之后、下一个关键帧之前写入的帧无法确定连续性，会被忽略。
+     */
+    void insert(const AVFrame* frame);
+
+    /// 标记解码序列不连续（跳转、刷新解码器之后调用）
+    void resetSequence();
+
+    /**
+     * @brief 查找在指定时间显示的帧（pts 不大于目标的最后一帧）
+     * @param out 命中时写入该帧的引用
+     * @return 命中返回 true
+     */
+    bool find(int64_t pts, AVFrame* out);
+
+    /// 查找紧接在 pts 之后的帧
+    bool next(int64_t pts, AVFrame* out);
+
+    /// 查找紧接在 pts 之前的帧
+    bool previous(int64_t pts, AVFrame* out);
+
+    void clear();
+    Statistics getStatistics() const;
+
+private:
+    struct Gop {
+        std::vector<AVFrame*> frames;       ///< 按 pts 排序
+        std::size_t bytes = 0;
+        int64_t next = AV_NOPTS_VALUE;      ///< 紧随其后的 GOP 的关键帧时间戳
+        std::list<int64_t>::iterator lru;
+    };
+
+    using GopMap = std::map<int64_t, Gop>;
+
+    GopMap::iterator gopContaining(int64_t pts);
+    GopMap::iterator gopBefore(GopMap::iterator gop);
+    void touch(GopMap::iterator gop);
+    void evict();
+    void erase(GopMap::iterator gop);
+    bool output(const AVFrame* frame, AVFrame* out);
+
+    mutable std::mutex m_mutex;
+    GopMap m_gops;                          ///< 以关键帧时间戳为键
+    std::list<int64_t> m_lru;               ///< 最近使用的 GOP 在前
+    int64_t m_openGop {AV_NOPTS_VALUE};     ///< 正在写入的 GOP
+    std::size_t m_memoryLimit;
+    Statistics m_stats;
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_FRAMECACHE_H
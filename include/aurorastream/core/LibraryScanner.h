@@ -0,0 +1,140 @@
+/********************************************************************************
+ * @file   : LibraryScanner.h
+ * @brief  : 定义了 aurorastream::core::LibraryScanner 类。
+ *
+ * LibraryScanner 并行扫描媒体目录并把结果写入 MediaLibrary：
+ *  - 每个目录是 TaskScheduler 上的一个后台任务，遇到子目录继续提交新任务；
+ *  - 文件大小和修改时间与数据库中的记录一致时跳过，只有新增或变化的文件
+ *    才提交探测任务（探测结果同时写入 ProbeCache，之后播放时打开更快）；
+ *  - 结果经无锁队列汇总到一个写入线程，按批在单个事务中写入数据库；
+ *  - 扫描结束后删除数据库中已不存在的文件；无法读取的目录（例如未挂载的
+ *    磁盘）下的记录保持不变。
+ *
+ * watch() 用 inotify 监视已扫描的目录（其他平台不可用），文件变化后去抖
+ * 再只重新扫描受影响的目录。
+ *
+ * 吞吐量通过 PerformanceMonitor 的 library.* 指标和 getStatistics() 提供。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_LIBRARYSCANNER_H
+#define AURORASTREAM_CORE_LIBRARYSCANNER_H
+
+#include <QObject>
+
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+#include "aurorastream/AuroraStream.h"
+
+namespace aurorastream {
+namespace core {
+
+class MediaLibrary;
+
+class AURORASTREAM_API LibraryScanner : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 最近一次扫描的统计
+     */
+    struct Statistics {
+        uint64_t directories = 0;   ///< 遍历的目录数
+        uint64_t files = 0;         ///< 发现的媒体文件数
+        uint64_t unchanged = 0;     ///< 大小和修改时间未变、跳过探测的文件数
+        uint64_t probed = 0;        ///< 探测成功并写入的文件数
+        uint64_t failed = 0;        ///< 探测失败的文件数
+        uint64_t removed = 0;       ///< 从数据库删除的文件数
+        uint64_t batches = 0;       ///< 写入事务数
+        double seconds = 0.0;       ///< 扫描耗时
+        double filesPerSecond = 0.0;///< 吞吐量（发现的文件数 / 耗时）
+    };
+
+    /**
+     * @brief 构造函数
+     * @param library 写入的媒体库
+     * @param parent 父对象
+     */
+    explicit LibraryScanner(MediaLibrary& library, QObject* parent = nullptr);
+
+    /// 析构函数，取消正在进行的扫描并停止监视
+    ~LibraryScanner() override;
+
+    /**
+     * @brief 开始增量扫描，立即返回；完成时发出 scanFinished
+     * @param roots 媒体目录
+     * @return 已有扫描在进行时返回 false
+     */
+    bool scan(const std::vector<std::string>& roots);
+
+    /// 取消正在进行的扫描，已探测的结果仍会写入
+    void cancel();
+
+    /// 等待当前扫描结束
+    void wait();
+
+    bool isScanning() const;
+
+    /**
+     * @brief 用 inotify 监视目录树，变化时增量重新扫描受影响的目录
+     * @param roots 媒体目录
+     * @return 当前平台不支持或初始化失败时返回 false
+     */
+    bool watch(const std::vector<std::string>& roots);
+
+    /// 停止监视
+    void unwatch();
+
+    Statistics getStatistics() const;
+
+    /// 按扩展名判断是否为媒体文件
+    static bool isMediaFile(const std::string& path);
+
+signals:
+    /**
+     * @brief 扫描进度，大约每批写入后发出一次（在写入线程中发出）
+     * @param files 已发现的媒体文件数
+     * @param probed 已探测的文件数
+     */
+    void scanProgress(qint64 files, qint64 probed);
+
+    /// 扫描结束（包括被取消）
+    void scanFinished();
+
+private:
+    /// 扫描目标，recursive 为 false 时只处理目录下的直接文件
+    struct Target {
+        std::string directory;
+        bool recursive = true;
+        bool removeIfMissing = false;   ///< 目录已被删除时移除其下的记录（仅用于 inotify 触发的扫描）
+    };
+
+    bool start(const std::vector<Target>& targets);
+    void run(std::vector<Target> targets);
+    void watchLoop(int watchFd, std::vector<std::string> roots);
+
+    MediaLibrary& m_library;
+
+    mutable std::mutex m_mutex;         ///< 保护 m_statistics
+    std::mutex m_threadMutex;           ///< 保护 m_scanThread
+    std::thread m_scanThread;
+    std::atomic<bool> m_scanning {false};
+    std::atomic<bool> m_cancelled {false};
+    Statistics m_statistics;
+
+    std::thread m_watchThread;
+    int m_wakeFd {-1};
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_LIBRARYSCANNER_H
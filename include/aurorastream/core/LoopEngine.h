@@ -0,0 +1,165 @@
+/********************************************************************************
+ * @file   : LoopEngine.h
+ * @brief  : 定义了 aurorastream::core::LoopEngine 类。
+ *
+ * LoopEngine 实现无缝循环播放：把循环区间开头的若干 GOP 及对应音频解码后
+ * 缓存在内存中。播放到区间结尾（文件结尾或 A-B 区间的 B 点）时直接从缓存
+ * 继续输出，同时在后台线程把媒体源重新定位到缓存之后的位置，
+ * 关键路径上没有 seek、解码器刷新或重新探测。
+ *
+ * 输出帧的时间戳为 AV_TIME_BASE（微秒），跨越循环边界保持连续递增。
+ * 区间足够短、能整体放入缓存时，循环完全在内存中进行，不再访问媒体源。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_LOOPENGINE_H
+#define AURORASTREAM_CORE_LOOPENGINE_H
+
+#include <QObject>
+#include <QString>
+
+#include <deque>
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+#include "aurorastream/AuroraStream.h"
+#include "aurorastream/core/MediaSource.h"
+#include "aurorastream/core/TaskScheduler.h"
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API LoopEngine : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief 循环缓存参数
+     */
+    struct Options {
+        qint64 headDuration = 2000;                         ///< 缓存的区间开头时长（毫秒），实际会延伸到下一个关键帧
+        std::size_t headMemoryLimit = 64 * 1024 * 1024;     ///< 缓存帧可占用的内存上限（字节）
+    };
+
+    explicit LoopEngine(QObject* parent = nullptr);
+    ~LoopEngine() override;
+
+    void setOptions(const Options& options);
+    Options options() const;
+
+    /**
+     * @brief 关联媒体源并缓存循环区间的开头
+     * @param source 媒体源，由调用者持有，在 detach() 之前必须保持有效
+     * @return 成功返回 true
+     */
+    bool attach(MediaSource* source);
+
+    /// 解除关联，等待后台重定位结束并释放缓存
+    void detach();
+
+    /**
+     * @brief 设置 A-B 循环区间并重建开头缓存
+     * @param start 区间起点（毫秒）
+     * @param end 区间终点（毫秒），小于等于 0 表示媒体结尾
+     * @return 成功返回 true
+     */
+    bool setRange(qint64 start, qint64 end);
+
+    /// 取消 A-B 区间，恢复整段循环
+    bool clearRange();
+
+    qint64 rangeStart() const;
+    qint64 rangeEnd() const;
+
+    /**
+     * @brief 在循环区间内跳转
+     * @param position 目标位置（毫秒），会被限制在区间内
+     * @return 成功返回 true
+     */
+    bool seek(qint64 position);
+
+    /**
+     * @brief 读取循环时间线上的下一帧
+     * @param frame 输出帧，pts/duration 以 AV_TIME_BASE 为单位
+     * @param type 输出帧的媒体类型
+     * @return 0 表示成功，负值为错误码
+     */
+    int readFrame(AVFrame* frame, AVMediaType* type);
+
+    /// 最近输出的帧在媒体中的位置（毫秒）
+    qint64 position() const;
+
+    /// 已完成的循环次数
+    int iterations() const;
+
+    /// 开头缓存占用的内存（字节）
+    std::size_t cachedBytes() const;
+
+signals:
+    void loopCompleted(int iteration);
+    void error(const QString& message);
+
+private:
+    struct CachedFrame {
+        AVFrame* frame;
+        AVMediaType type;
+    };
+
+    enum class Phase {
+        Head,       ///< 从开头缓存输出
+        Bridge,     ///< 输出重定位时已经解出的衔接帧
+        Source      ///< 直接从媒体源读取
+    };
+
+    bool buildHead();
+    void clearFrames();
+    bool filter(AVFrame* frame, AVMediaType type, int64_t videoFloor, int64_t audioFloor);
+    bool rangeFinished() const;
+    bool splice();
+    void startResync();
+    bool finishResync();
+    bool resync();
+    int emitFrame(AVFrame* frame, AVMediaType type);
+
+    MediaSource* m_source {nullptr};
+    Options m_options;
+    qint64 m_rangeStart {0};
+    qint64 m_rangeEnd {0};
+
+    // 开头缓存（源时间线，微秒）
+    std::vector<CachedFrame> m_head;
+    std::size_t m_headBytes {0};
+    bool m_headComplete {false};                ///< 整个区间都在缓存中
+    int64_t m_headStart {AV_NOPTS_VALUE};       ///< 缓存中首个主时钟帧的时间戳
+    int64_t m_videoResume {AV_NOPTS_VALUE};     ///< 缓存之后首个视频帧的时间戳
+    int64_t m_audioResume {AV_NOPTS_VALUE};     ///< 缓存音频的结束时间
+
+    // 播放状态
+    Phase m_phase {Phase::Source};
+    std::size_t m_headCursor {0};
+    std::deque<CachedFrame> m_bridge;
+    bool m_videoDone {false};
+    bool m_audioDone {false};
+    int64_t m_offset {0};                       ///< 源时间戳到输出时间线的偏移（微秒）
+    int64_t m_audioEnd {AV_NOPTS_VALUE};        ///< 已输出音频在时间线上的结束时间
+    int64_t m_videoEnd {AV_NOPTS_VALUE};        ///< 已输出视频在时间线上的结束时间
+    int64_t m_lastSourcePts {0};
+    int m_iterations {0};
+
+    // 后台重定位
+    TaskGroup m_resync;
+    std::atomic<bool> m_resyncOk {false};
+    bool m_resyncPending {false};               ///< 已提交、结果尚未取回
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_LOOPENGINE_H
@@ -0,0 +1,157 @@
+/********************************************************************************
+ * @file   : MediaLibrary.h
+ * @brief  : 定义了 aurorastream::core::MediaLibrary 类。
+ *
+ * MediaLibrary 是媒体库的元数据数据库，使用 Qt SQL 的 SQLite 驱动，
+ * 库文件位于应用数据目录下的 library.db。表结构见 docs/architecture 中的
+ * media_files / playlists，media_files 额外记录文件修改时间和探测到的
+ * 格式、编解码器、分辨率，供增量扫描判断文件是否变化。
+ *
+ * QSqlDatabase 连接只能在创建它的线程上使用，MediaLibrary 为每个访问线程
+ * 各建一个连接，线程结束时连接随之移除；数据库使用 WAL 日志，
+ * 扫描线程批量写入时 UI 线程仍可读取。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_MEDIALIBRARY_H
+#define AURORASTREAM_CORE_MEDIALIBRARY_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "aurorastream/AuroraStream.h"
+
+class QSqlDatabase;
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API MediaLibrary
+{
+public:
+    /**
+     * @brief media_files 表中的一行
+     */
+    struct MediaFile {
+        int64_t id = 0;
+        std::string path;           ///< 绝对路径
+        std::string title;          ///< 元数据中的标题，没有时为文件名
+        double duration = 0.0;      ///< 时长（秒）
+        int64_t fileSize = 0;       ///< 文件大小（字节）
+        int64_t modifiedTime = 0;   ///< 修改时间（毫秒，Unix 纪元）
+        int64_t lastPlayed = 0;     ///< 最近播放时间（毫秒），从未播放为 0
+        std::string format;         ///< 容器格式
+        std::string videoCodec;
+        std::string audioCodec;
+        int width = 0;
+        int height = 0;
+        int64_t bitRate = 0;
+        bool hasLoudness = false;   ///< 是否已完成响度分析
+        double loudness = 0.0;      ///< EBU R128 综合响度（LUFS）
+        double truePeak = 0.0;      ///< 真峰值（dBTP）
+    };
+
+    /**
+     * @brief 增量扫描用的文件状态
+     */
+    struct FileState {
+        int64_t fileSize = 0;
+        int64_t modifiedTime = 0;
+    };
+
+    /**
+     * @brief 获取进程内共享的媒体库，数据库位于应用数据目录下的 library.db
+     */
+    static MediaLibrary& instance();
+
+    /**
+     * @brief 构造函数，打开（必要时创建）数据库并升级表结构
+     * @param databasePath 数据库文件路径
+     */
+    explicit MediaLibrary(const std::string& databasePath);
+
+    /// 析构函数，关闭所有线程的连接
+    ~MediaLibrary();
+
+    MediaLibrary(const MediaLibrary&) = delete;
+    MediaLibrary& operator=(const MediaLibrary&) = delete;
+
+    /// 数据库是否可用
+    bool isOpen() const;
+
+    /**
+     * @brief 读取目录下已入库文件的状态
+     * @param directory 目录绝对路径
+     * @param recursive 为 false 时只包含直接位于该目录下的文件
+     * @return 路径到状态的映射
+     */
+    std::unordered_map<std::string, FileState> fileStates(const std::string& directory, bool recursive = true) const;
+
+    /**
+     * @brief 在一个事务中写入一批新增或变化的文件并删除已消失的文件
+     * 已有行保留 id 和 last_played
+     * @return 提交成功返回 true，失败时整批回滚
+     */
+    bool write(const std::vector<MediaFile>& files, const std::vector<std::string>& removed);
+
+    /**
+     * @brief 按路径查找
+     * @return 找到返回 true
+     */
+    bool find(const std::string& path, MediaFile* file) const;
+
+    /**
+     * @brief 列出目录下的文件，按路径排序
+     * @param directory 目录绝对路径，空字符串表示整个媒体库
+     */
+    std::vector<MediaFile> files(const std::string& directory = std::string()) const;
+
+    /**
+     * @brief 保存响度分析结果，文件内容变化后重新扫描时会被清除
+     * @param loudness 综合响度（LUFS）
+     * @param truePeak 真峰值（dBTP）
+     * @return 文件不在媒体库中时返回 false
+     */
+    bool setLoudness(const std::string& path, double loudness, double truePeak);
+
+    /**
+     * @brief 列出含音频流但尚未分析响度的文件
+     * @param limit 最多返回的数量，小于 0 表示不限
+     */
+    std::vector<std::string> withoutLoudness(int limit) const;
+
+    /// 记录播放时间
+    bool markPlayed(const std::string& path, int64_t time);
+
+    /// 媒体库中的文件数量
+    int64_t count() const;
+
+    /// 数据库文件路径
+    std::string databasePath() const;
+
+private:
+    /// 当前线程的连接，不存在时创建
+    QSqlDatabase connection() const;
+
+    bool migrate();
+
+    struct Connections;
+    struct ThreadConnections;
+
+    std::string m_databasePath;
+    std::string m_connectionPrefix;
+    bool m_open {false};
+
+    std::shared_ptr<Connections> m_connections;     ///< 各线程上仍然存在的连接名
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_MEDIALIBRARY_H
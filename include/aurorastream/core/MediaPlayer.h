@@ -15,9 +15,14 @@
 #include <QUrl>
 #include <QObject>
 #include <QString>
+#include <QStringList>
+#include <memory>
 #include <unordered_set>
 
 #include "aurorastream/AuroraStream.h"
+#include "aurorastream/core/AdaptiveStream.h"
+#include "aurorastream/core/StreamRecorder.h"
+#include "aurorastream/core/RestreamServer.h"
 
 // FFmpeg 头文件
 extern "C" {
@@ -28,6 +33,14 @@ extern "C" {
 namespace aurorastream {
 namespace core {
 
+class MediaSource;
+class LoopEngine;
+class FrameCache;
+class ReverseEngine;
+class TrickPlayEngine;
+class MetricsScope;
+class PlaylistEngine;
+
 class AURORASTREAM_API MediaPlayer : public QObject, public MediaController
 {
     Q_OBJECT
@@ -57,9 +70,196 @@ public:
     void setLoop(bool loop) override;
     bool getLoop() const override;
 
+    /**
+     * @brief 设置播放速率
+     * @param rate 速率，不能为 0；负值表示倒放。
+     *        |rate| 不超过 kFullDecodeMaxRate 时完整解码，音频由时间伸缩保持音调；
+     *        超过后视频只解码关键帧、音频静音
+     * @return 成功返回 true
+     */
+    bool setPlaybackRate(double rate) override;
+    double getPlaybackRate() const override;
+
+    /// 完整解码的最高速率，超过后切换到仅关键帧快进
+    static constexpr double kFullDecodeMaxRate = 2.0;
+
     Q_INVOKABLE bool openFile(const QString& fileName);
     Q_INVOKABLE bool setSource(const QString& source);
 
+    /**
+     * @brief 接管一个已经打开的媒体源（例如播放列表在后台预打开的下一项）
+     * @param source 媒体源
+     * @return 成功返回 true
+     * @note 由调用方直接交来的媒体源会结束当前的播放列表
+     */
+    bool adoptSource(std::unique_ptr<MediaSource> source);
+
+    /**
+     * @brief 设置播放列表并打开指定项
+     * 之后 readFrame() 读到一项结尾时无缝切换到在后台预打开的下一项（见 PlaylistEngine），
+     * 下一项的媒体源经 adoptSource() 交给播放器；setSource() 结束播放列表
+     * @param items 各项的文件路径或网络地址
+     * @param index 起始项
+     * @return 成功返回 true
+     */
+    bool setPlaylist(const QStringList& items, int index = 0);
+
+    /**
+     * @brief 追加到播放列表末尾
+     * 没有播放列表时以当前媒体为第一项建立播放列表，当前媒体从当前位置继续播放；
+     * 没有加载媒体时直接开始播放该项
+     */
+    void enqueue(const QString& uri);
+
+    /// 立即切换到播放列表的下一项，没有下一项时返回 false
+    bool next();
+
+    /// 播放列表，没有时为空
+    QStringList getPlaylist() const;
+    /// 当前项在播放列表中的序号，没有播放列表时为 -1
+    int getPlaylistIndex() const;
+
+    /**
+     * @brief 设置播放列表相邻两项之间的交叉淡化时长
+     * @param crossfade 时长（毫秒），0 表示逐样本无缝硬切
+     */
+    void setCrossfade(qint64 crossfade);
+    qint64 getCrossfade() const;
+
+    /// 获取当前媒体源，未加载时返回 nullptr
+    MediaSource* source() const;
+
+    /// 本播放器的性能指标子注册表，快照中以 "media_player-N" 标签列出
+    std::shared_ptr<MetricsScope> metricsScope() const;
+
+    /**
+     * @brief 设置 A-B 循环区间，仅在循环播放时生效
+     * @param start 区间起点（毫秒）
+     * @param end 区间终点（毫秒），小于等于 0 表示媒体结尾
+     * @return 成功返回 true
+     */
+    bool setLoopRange(qint64 start, qint64 end);
+    void clearLoopRange();
+    qint64 getLoopStart() const;
+    qint64 getLoopEnd() const;
+
+    /**
+     * @brief 读取播放时间线上的下一帧（解码后的音频或视频）
+     * @param frame 输出帧
+     * @param type 输出帧的媒体类型
+     * @return 0 表示成功，AVERROR_EOF 表示播放结束，其他负值为错误码
+     * @note 循环播放时帧时间戳为 AV_TIME_BASE 且跨循环连续，播放列表时为 AV_TIME_BASE 且跨项目连续；
+     *       否则为所属流的时间基
+     */
+    int readFrame(AVFrame* frame, AVMediaType* type);
+
+    /**
+     * @brief 逐帧前进，优先从已解码帧缓存中取帧
+     * @param frame 输出的视频帧（所属流的时间基）
+     * @return 成功返回 true
+     */
+    bool stepForward(AVFrame* frame);
+
+    /**
+     * @brief 逐帧后退，缓存未命中时从上一个关键帧解码并填充缓存
+     * @param frame 输出的视频帧
+     * @return 成功返回 true
+     */
+    bool stepBackward(AVFrame* frame);
+
+    /**
+     * @brief 精确跳转到指定位置显示的视频帧，小范围跳转直接由缓存提供
+     * @param position 目标位置（毫秒）
+     * @param frame 输出的视频帧
+     * @return 成功返回 true
+     */
+    bool seekToFrame(qint64 position, AVFrame* frame);
+
+    /**
+     * @brief 开始或结束倒放
+     * @param reverse true 表示从当前位置开始倒放，false 表示从倒放停下的位置恢复正向播放
+     * @return 成功返回 true
+     * @note 倒放期间 readFrame() 只输出视频帧，时间戳递减
+     */
+    bool setReverse(bool reverse);
+    bool isReverse() const;
+
+    /**
+     * @brief 设置已解码帧缓存的内存上限
+     * @param bytes 上限（字节），0 表示禁用缓存
+     */
+    void setFrameCacheLimit(std::size_t bytes);
+    std::size_t getFrameCacheUsage() const;
+
+    /**
+     * @brief 启用或禁用基于 io_uring 的异步预读 I/O
+     * @param enabled 是否启用，仅对本地文件生效，在下一次 setSource 时生效
+     * @param directIo 是否以 O_DIRECT 读取（适合冷归档，绕过页缓存）
+     * @note io_uring 不可用时自动回退到 FFmpeg 的同步文件读取
+     */
+    void setAsyncIoEnabled(bool enabled, bool directIo = false);
+    bool isAsyncIoEnabled() const;
+
+    /**
+     * @brief 获取当前媒体解复用时阻塞等待 I/O 的累计时间
+     * @return 等待时间（微秒），未使用异步 I/O 时返回 0
+     */
+    qint64 getIoWaitTime() const;
+
+    /**
+     * @brief 启用或禁用持久化探测缓存
+     * @param enabled 是否启用；启用后重复打开同一本地文件可跳过 avformat_find_stream_info
+     */
+    void setProbeCacheEnabled(bool enabled);
+    bool isProbeCacheEnabled() const;
+
+    /**
+     * @brief 获取最近一次 setSource 的打开耗时（打开 + 流信息探测 + 解码器初始化）
+     * @return 耗时（微秒）
+     */
+    qint64 getOpenTime() const;
+
+    /**
+     * @brief 设置自适应流（HLS / DASH）的画质
+     * @param quality ADAPTIVE 为按带宽和缓冲自动选择，其他值固定为对应分辨率的档位
+     * @note 正在播放自适应流时从下一个下载的分段起生效，不重新打开媒体
+     */
+    void setQualityLevel(QualityLevel quality);
+    QualityLevel getQualityLevel() const;
+
+    /// 当前自适应流的统计（启动时间、卡顿比例、平均码率等），不是自适应流时返回空统计
+    AdaptiveStream::Statistics getAdaptiveStatistics() const;
+
+    /**
+     * @brief 开始把当前媒体的数据包原样录制到文件（不重新编码，不再次读取网络）
+     * @param path 输出文件路径，封装格式按扩展名（.mp4、.mkv、.ts）或 options.format 确定
+     * @param options 分段和队列上限等选项
+     * @return 成功返回 true；没有加载媒体或无法创建输出时返回 false
+     * @note 录制从下一个视频关键帧开始；打开新的媒体时录制自动停止
+     */
+    bool startRecording(const QString& path, const StreamRecorder::Options& options = StreamRecorder::Options());
+
+    /**
+     * @brief 停止录制，剩余数据包由写线程在后台写完，不阻塞调用线程
+     */
+    void stopRecording();
+    bool isRecording() const;
+
+    /// 当前录制的统计，未录制时返回空统计
+    StreamRecorder::Statistics getRecordingStatistics() const;
+
+    /**
+     * @brief 开始把当前媒体转发给本地客户端（HLS 和 HTTP-TS），只封装一次
+     * @param options 监听地址、端口和分段选项
+     * @return 成功返回 true；没有加载媒体或无法监听时返回 false
+     * @note 打开新的媒体时转发自动停止
+     */
+    bool startRestreaming(const RestreamServer::Options& options = RestreamServer::Options());
+    void stopRestreaming();
+
+    /// 当前的转发服务，未转发时返回 nullptr
+    RestreamServer* restreamServer() const;
+
 signals:
     void stateChanged(MediaState state);
     void positionChanged(qint64 position);
@@ -68,19 +268,49 @@ signals:
     void error(const QString& message);
     void volumeChanged(float volume);
     void loopChanged(bool loop);
+    void playbackRateChanged(double rate);
+    void recordingChanged(bool recording);
+    void restreamingChanged(bool restreaming);
+    void playlistIndexChanged(int index);
 
 private:
+    bool attachLoopEngine();
+    void suspendLoopEngine();
+    bool seekVideo(int64_t target, AVFrame* shown);
+    int readVideoFrame(AVFrame* frame);
+    int decodeVideoFrame(AVFrame* frame);
+    void presentFrame(const AVFrame* frame);
+    void detachTap(std::shared_ptr<PacketTap> tap);
+    void createPlaylist(const QStringList& items);
+
     MediaState m_state;
     qint64 m_duration;
     qint64 m_position;
     QString m_currentMedia;
-    int m_videoStreamIndex;
-    int m_audioStreamIndex;
-    AVFormatContext* m_formatContext;
-    AVCodecContext* m_videoCodecContext;
-    AVCodecContext* m_audioCodecContext;
+    std::unique_ptr<MediaSource> m_source;
+    std::unique_ptr<LoopEngine> m_loopEngine;
+    std::unique_ptr<FrameCache> m_frameCache;
+    std::unique_ptr<ReverseEngine> m_reverseEngine;
+    std::unique_ptr<TrickPlayEngine> m_trickPlay;
+    std::shared_ptr<StreamRecorder> m_recorder;    ///< 与媒体源共享的录制分支
+    std::shared_ptr<RestreamServer> m_restream;    ///< 与媒体源共享的转发分支
+    int64_t m_videoPts;         ///< 当前显示的视频帧时间戳（视频流时间基）
+    int64_t m_decodePts;        ///< 媒体源最近解出的视频帧时间戳
+    AVFrame* m_pendingFrame;    ///< 逐帧定位时多解出的下一帧
+    bool m_resumePending;       ///< 逐帧操作后，播放需从当前帧之后继续
     float m_volume;
     bool m_loop;
+    double m_playbackRate;
+    qint64 m_loopStart;
+    qint64 m_loopEnd;
+    bool m_asyncIo;
+    bool m_directIo;
+    bool m_probeCache;
+    QualityLevel m_quality;
+    std::unique_ptr<PlaylistEngine> m_playlist;    ///< 当前项的媒体源由播放器持有，播放列表只读取
+    qint64 m_crossfade;
+    bool m_playlistHandoff;     ///< 播放列表正在把下一项交给 adoptSource
+    std::shared_ptr<MetricsScope> m_metricsScope;
 };
 
 } // namespace core
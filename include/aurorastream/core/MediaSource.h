@@ -0,0 +1,172 @@
+/********************************************************************************
+ * @file   : MediaSource.h
+ * @brief  : 定义了 aurorastream::core::MediaSource 类。
+ *
+ * MediaSource 表示一个已经打开的媒体：格式上下文、可选的自定义 I/O、
+ * 以及已初始化的音视频解码器。它负责打开、探测（可使用探测缓存）和
+ * 解码器初始化，并提供按解码顺序逐帧读取的接口。
+ *
+ * MediaSource 不依赖 QObject，可以在后台线程中完成打开和预解码，
+ * 再整体移交给播放流程（例如播放列表的无缝衔接）。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_MEDIASOURCE_H
+#define AURORASTREAM_CORE_MEDIASOURCE_H
+
+#include <memory>
+#include <vector>
+#include <QString>
+
+#include "aurorastream/AuroraStream.h"
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+class UringIOContext;
+class AdaptiveStream;
+class UdpIngest;
+class PacketTap;
+class MetricsScope;
+class Counter;
+class Histogram;
+
+class AURORASTREAM_API MediaSource
+{
+public:
+    /**
+     * @brief 打开选项
+     */
+    struct Options {
+        bool asyncIo = false;       ///< 本地文件使用 io_uring 预读
+        bool directIo = false;      ///< io_uring 预读时使用 O_DIRECT
+        bool probeCache = true;     ///< 使用持久化探测缓存
+        bool seekIndex = true;      ///< 使用离线生成的关键帧索引（见 SeekIndex）
+        bool adaptiveStreaming = true;  ///< HLS / DASH 清单使用自适应码率客户端（见 AdaptiveStream）
+        QualityLevel quality = QualityLevel::ADAPTIVE; ///< 自适应流的画质，ADAPTIVE 为自动选择
+        bool batchedUdp = true;     ///< udp:// 和 rtp:// 的 MPEG-TS 使用批量接收（见 UdpIngest），rtp:// 经抖动缓冲重排
+    };
+
+    /**
+     * @brief 打开媒体并初始化解码器
+     * @param uri 本地文件路径或网络地址
+     * @param options 打开选项
+     * @param errorMessage 失败时写入错误描述，可为空
+     * @return 成功返回媒体源，失败返回 nullptr
+     */
+    static std::unique_ptr<MediaSource> open(const QString& uri, const Options& options,
+                                             QString* errorMessage = nullptr);
+
+    ~MediaSource();
+
+    MediaSource(const MediaSource&) = delete;
+    MediaSource& operator=(const MediaSource&) = delete;
+
+    /**
+     * @brief 读取并解码下一帧
+     * @param frame 输出帧，pts 为所属流的时间基，frame->time_base 会被设置为该时间基
+     * @param type 输出帧的媒体类型（音频或视频）
+     * @return 0 表示成功；AVERROR_EOF 表示所有解码器均已排空；其他负值为读取错误
+     */
+    int readFrame(AVFrame* frame, AVMediaType* type);
+
+    /**
+     * @brief 跳转到指定位置并刷新解码器
+     * @param position 目标位置（毫秒）
+     * @return 成功返回 0，失败返回 FFmpeg 错误码
+     */
+    int seek(qint64 position);
+
+    /**
+     * @brief 按指定流的时间戳跳转并刷新解码器
+     * @param streamIndex 流索引，-1 表示以 AV_TIME_BASE 为单位
+     * @param timestamp 目标时间戳（该流的时间基）
+     * @param flags av_seek_frame 的标志
+     * @return 成功返回 0，失败返回 FFmpeg 错误码
+     */
+    int seekStream(int streamIndex, int64_t timestamp, int flags = AVSEEK_FLAG_BACKWARD);
+
+    QString uri() const;
+    AVFormatContext* formatContext() const;
+    AVCodecContext* videoCodecContext() const;
+    AVCodecContext* audioCodecContext() const;
+    int videoStreamIndex() const;
+    int audioStreamIndex() const;
+    AVStream* videoStream() const;
+    AVStream* audioStream() const;
+
+    /// 起始时间（微秒，AV_TIME_BASE），未知时为 0
+    int64_t startTime() const;
+    /// 媒体时长（毫秒），未知时为 0
+    qint64 duration() const;
+    /// 打开耗时（微秒）
+    qint64 openTime() const;
+    /// 本次打开是否命中探测缓存
+    bool probeCacheHit() const;
+    /// 异步 I/O 上下文，未使用时为 nullptr
+    const UringIOContext* ioContext() const;
+    /// 自适应流客户端，不是 HLS / DASH 清单或回退到 FFmpeg 解复用器时为 nullptr
+    AdaptiveStream* adaptiveStream() const;
+    /// UDP / RTP 接收端，不是 udp:// 或 rtp:// 地址，或回退到 FFmpeg 的协议时为 nullptr
+    const UdpIngest* udpIngest() const;
+
+    /**
+     * @brief 接入一个数据包分支（录制、转发等，见 PacketTap）
+     * @param tap 分支，每个读到的数据包在送入解码器前交给它；跳转时通知它时间线不连续
+     */
+    void addTap(std::shared_ptr<PacketTap> tap);
+
+    /// 移除数据包分支
+    void removeTap(const PacketTap* tap);
+
+    /**
+     * @brief 把解复用和解码指标记录到指定实例的子注册表（见 PerformanceMonitor::createScope）
+     * @param scope 子注册表，为空时只记录到进程注册表
+     */
+    void setMetricsScope(std::shared_ptr<MetricsScope> scope);
+
+private:
+    MediaSource();
+
+    AVCodecContext* decoderFor(int streamIndex) const;
+
+    QString m_uri;
+    std::unique_ptr<UringIOContext> m_ioContext;
+    std::unique_ptr<AdaptiveStream> m_adaptiveStream;
+    std::unique_ptr<UdpIngest> m_udpIngest;
+    AVFormatContext* m_formatContext {nullptr};
+    AVCodecContext* m_videoCodecContext {nullptr};
+    AVCodecContext* m_audioCodecContext {nullptr};
+    int m_videoStreamIndex {-1};
+    int m_audioStreamIndex {-1};
+    qint64 m_openTime {0};
+    bool m_probeCacheHit {false};
+    std::vector<std::shared_ptr<PacketTap>> m_taps;
+
+    // 性能指标，指向进程注册表或 m_metricsScope 中的指标
+    std::shared_ptr<MetricsScope> m_metricsScope;
+    Counter* m_demuxBytes {nullptr};
+    Counter* m_demuxPackets {nullptr};
+    Counter* m_videoFrames {nullptr};
+    Counter* m_audioFrames {nullptr};
+    Histogram* m_sendTime {nullptr};
+    Histogram* m_receiveTime {nullptr};
+
+    // 解码状态
+    AVPacket* m_packet {nullptr};
+    AVCodecContext* m_activeDecoder {nullptr};      ///< 最近送入数据包、尚未取空的解码器
+    std::vector<AVCodecContext*> m_drainQueue;      ///< 输入结束后等待排空的解码器
+    bool m_inputEnded {false};
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_MEDIASOURCE_H
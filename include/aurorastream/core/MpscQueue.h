@@ -0,0 +1,85 @@
+/********************************************************************************
+ * @file   : MpscQueue.h
+ * @brief  : 定义了 aurorastream::core::MpscQueue 类模板。
+ *
+ * MpscQueue 是无锁的多生产者单消费者队列（Vyukov 链表队列）：
+ * 任意线程都可以 push，只有一个线程 pop。push 只需一次原子交换，
+ * 不会阻塞，适合 UI 线程、网络线程等向播放管线投递控制命令。
+ *
+ * 生产者交换尾指针后、链接节点前的短暂窗口内，pop 可能暂时看不到该元素，
+ * 消费者应当在稍后重试（通常配合一个计数器判断是否还有待处理的元素）。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_MPSCQUEUE_H
+#define AURORASTREAM_CORE_MPSCQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+namespace aurorastream {
+namespace core {
+
+template <typename T>
+class MpscQueue
+{
+public:
+    MpscQueue()
+        : m_head(new Node())
+    {
+        m_tail = m_head.load(std::memory_order_relaxed);
+    }
+
+    ~MpscQueue()
+    {
+        T value;
+        while (pop(value)) {
+        }
+        delete m_tail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /// 入队，可在任意线程调用
+    void push(T value)
+    {
+        Node* node = new Node();
+        node->value = std::move(value);
+        Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * @brief 出队，只能由消费者线程调用
+     * @return 队列为空（或生产者尚未完成链接）时返回 false
+     */
+    bool pop(T& value)
+    {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        value = std::move(next->value);
+        m_tail = next;
+        delete tail;
+        return true;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next {nullptr};
+        T value {};
+    };
+
+    std::atomic<Node*> m_head;      ///< 最后入队的节点（生产者端）
+    Node* m_tail;                   ///< 哨兵节点（消费者端），其后为下一个待出队的元素
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_MPSCQUEUE_H
@@ -0,0 +1,147 @@
+/********************************************************************************
+ * @file   : PacketTap.h
+ * @brief  : 定义了 aurorastream::core::PacketTap 类。
+ *
+ * PacketTap 是挂在解复用输出上的数据包分支的基类（录制、转发等）：
+ * MediaSource 每读到一个数据包就交给 push()，分支只增加数据包缓冲区的
+ * 引用计数（av_packet_ref，不复制数据、不重新读取网络），放入有界队列；
+ * 分支自己的工作线程按顺序取出数据包交给派生类的 consume()。
+ *
+ * push() 从不等待工作线程：队列超过数据包数或字节数上限时丢弃数据包并计数，
+ * 之后从下一个视频关键帧恢复，保证输出可以正常解码。
+ *
+ * 派生类在构造完成后调用 start() 启动工作线程，并在自己的析构函数中先调用
+ * stop() 和 wait()，保证工作线程退出前派生类的成员仍然有效。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_PACKETTAP_H
+#define AURORASTREAM_CORE_PACKETTAP_H
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <condition_variable>
+
+#include "aurorastream/AuroraStream.h"
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+class Counter;
+class Gauge;
+
+class AURORASTREAM_API PacketTap
+{
+public:
+    /**
+     * @brief 队列上限
+     */
+    struct Limits {
+        std::size_t maxQueuedPackets = 2048;            ///< 队列中最多的数据包数
+        std::size_t maxQueuedBytes = 64 << 20;          ///< 队列中数据包的最大总字节数
+    };
+
+    virtual ~PacketTap();
+
+    PacketTap(const PacketTap&) = delete;
+    PacketTap& operator=(const PacketTap&) = delete;
+
+    /**
+     * @brief 提交一个解复用得到的数据包（解复用线程调用，不会阻塞）
+     * @param packet 输入流时间基的数据包，只增加引用计数
+     * @return 数据包进入队列返回 true，未接入的流或被丢弃时返回 false
+     */
+    bool push(const AVPacket* packet);
+
+    /**
+     * @brief 输入时间线不连续（例如跳转）时调用，工作线程按顺序收到 discontinuity()
+     * @note 之后从下一个视频关键帧开始接收数据包
+     */
+    void split();
+
+    /**
+     * @brief 停止：不再接受新的数据包，工作线程处理完队列后调用 finish() 并退出
+     * @note 不等待工作线程，需要等待时调用 wait()
+     */
+    void stop();
+
+    /// 等待工作线程退出
+    void wait();
+
+    bool isRunning() const;
+
+    /// 因队列已满或等待关键帧而丢弃的数据包数
+    uint64_t droppedPackets() const;
+
+protected:
+    /**
+     * @param metricPrefix 性能指标前缀，例如 "record" 对应 record.dropped_packets、record.queued_bytes
+     * @param limits 队列上限
+     */
+    PacketTap(const std::string& metricPrefix, const Limits& limits);
+
+    /**
+     * @brief 接入一个输入流（在 start() 之前调用）
+     * @return 输出流索引，consume() 收到的数据包 stream_index 为该索引
+     */
+    int addStream(int inputIndex, AVRational timeBase, bool video);
+
+    /// 启动工作线程
+    void start();
+
+    /// 已接入的流数
+    int streamCount() const;
+    /// 输出流的输入时间基
+    AVRational inputTimeBase(int outputIndex) const;
+    /// 视频输出流索引，-1 表示纯音频
+    int videoStream() const;
+
+    /**
+     * @brief 处理一个数据包（工作线程调用）
+     * @param packet 数据包，所有权交给派生类，stream_index 为输出流索引
+     */
+    virtual void consume(AVPacket* packet) = 0;
+
+    /// 输入时间线不连续（工作线程调用）
+    virtual void discontinuity() {}
+
+    /// 队列已处理完、工作线程即将退出（工作线程调用）
+    virtual void finish() {}
+
+private:
+    void workerLoop();
+
+    Limits m_limits;
+    Counter& m_droppedCounter;
+    Gauge& m_queuedGauge;
+    std::vector<int> m_streamMap;                   ///< 输入流索引 → 输出流索引，-1 表示未接入
+    std::vector<AVRational> m_inputTimeBases;       ///< 输入流时间基，按输出流索引
+    int m_videoStream {-1};
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::deque<AVPacket*> m_queue;                  ///< 空指针表示时间线不连续
+    std::size_t m_queuedBytes {0};
+    bool m_stopping {false};
+    bool m_waitKeyframe {true};                     ///< 从关键帧开始接收，丢包后重新等待关键帧
+    uint64_t m_dropped {0};
+    std::atomic<bool> m_running {false};
+    std::thread m_worker;
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_PACKETTAP_H
@@ -0,0 +1,266 @@
+/********************************************************************************
+ * @file   : PerformanceMonitor.h
+ * @brief  : 定义了 aurorastream::core::PerformanceMonitor 类。
+ *
+ * PerformanceMonitor 是进程内共享的指标注册表，提供三类无锁指标：
+ * 计数器（Counter）、仪表（Gauge）和直方图（Histogram，按 2 的幂划分微秒区间）。
+ * 解复用、解码、渲染和音频路径在热路径上直接更新指标，只有原子加法，没有锁。
+ *
+ * 读取方式：
+ *  - C++ 接口：getCurrentMetrics() 和 toJson()；
+ *  - Qt 信号：startMonitoring() 之后按固定间隔（默认 1 秒）发出 metricsUpdated；
+ *  - JSON 快照：设置 setSnapshotFile() 后每个间隔原子地重写该文件，供外部工具采集。
+ *
+ * 入口：GUI 设置环境变量 AURORASTREAM_METRICS=文件（间隔由 AURORASTREAM_METRICS_INTERVAL_MS 指定）；
+ * aurorastream-cli 使用全局选项 --metrics-snapshot=文件。命令行工具没有事件循环，由后台线程定时调用 sample()。
+ *
+ * 热路径上用函数内静态引用缓存指标，避免每次按名字查找：
+ * @code
+ *   static Counter& bytes = PerformanceMonitor::instance().counter("demux.bytes");
+ *   bytes.add(packet->size);
+ * @endcode
+ *
+ * 一个进程中有多个播放器时，每个播放器用 createScope() 创建自己的子注册表（MetricsScope），
+ * 在构造时取得指标引用并保存为成员。子注册表的计数器和直方图同时累加到进程注册表中的
+ * 同名指标，进程汇总不变；快照的 instances 中按实例标签列出各自的指标。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_PERFORMANCEMONITOR_H
+#define AURORASTREAM_CORE_PERFORMANCEMONITOR_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+
+#include "aurorastream/AuroraStream.h"
+
+namespace aurorastream {
+namespace core {
+
+/**
+ * @brief 单调递增的计数器
+ */
+class AURORASTREAM_API Counter
+{
+public:
+    void add(uint64_t value = 1)
+    {
+        m_value.fetch_add(value, std::memory_order_relaxed);
+        if (m_parent) {
+            m_parent->add(value);
+        }
+    }
+    uint64_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    friend class MetricsScope;
+
+    std::atomic<uint64_t> m_value {0};
+    Counter* m_parent {nullptr};            ///< 子注册表中的计数器同时累加到进程注册表
+};
+
+/**
+ * @brief 记录当前值的仪表
+ * 子注册表中的仪表只属于该实例，不汇总到进程注册表。
+ */
+class AURORASTREAM_API Gauge
+{
+public:
+    void set(int64_t value) { m_value.store(value, std::memory_order_relaxed); }
+    void add(int64_t delta) { m_value.fetch_add(delta, std::memory_order_relaxed); }
+    int64_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> m_value {0};
+};
+
+/**
+ * @brief 耗时直方图（微秒），第 i 个桶统计 [2^(i-1), 2^i) 微秒
+ */
+class AURORASTREAM_API Histogram
+{
+public:
+    static constexpr int kBuckets = 32;
+
+    void record(int64_t micros);
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    uint64_t sum() const { return m_sum.load(std::memory_order_relaxed); }
+    int64_t max() const { return m_max.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 估算分位数（取所在桶的上界）
+     * @param quantile 分位，0.0–1.0
+     */
+    int64_t percentile(double quantile) const;
+
+private:
+    friend class MetricsScope;
+
+    std::atomic<uint64_t> m_buckets[kBuckets] {};
+    std::atomic<uint64_t> m_count {0};
+    std::atomic<uint64_t> m_sum {0};
+    std::atomic<int64_t> m_max {0};
+    Histogram* m_parent {nullptr};          ///< 子注册表中的直方图同时记录到进程注册表
+};
+
+/**
+ * @brief 作用域计时，析构时把耗时记录到直方图
+ */
+class AURORASTREAM_API ScopedTimer
+{
+public:
+    explicit ScopedTimer(Histogram& histogram)
+        : m_histogram(histogram)
+        , m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~ScopedTimer()
+    {
+        m_histogram.record(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - m_start).count());
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Histogram& m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+class PerformanceMonitor;
+
+/**
+ * @brief 单个实例（例如一个播放器）的子注册表，由 PerformanceMonitor::createScope() 创建
+ * 最后一个持有者释放后不再出现在快照中。
+ */
+class AURORASTREAM_API MetricsScope
+{
+public:
+    /// 实例标签，例如 "media_player-3"
+    const std::string& label() const { return m_label; }
+
+    /// 获取或创建指标，返回的引用在本作用域的生命周期内有效
+    Counter& counter(const std::string& name);
+    Gauge& gauge(const std::string& name);
+    Histogram& histogram(const std::string& name);
+
+    MetricsScope(const MetricsScope&) = delete;
+    MetricsScope& operator=(const MetricsScope&) = delete;
+
+private:
+    friend class PerformanceMonitor;
+
+    MetricsScope(PerformanceMonitor& monitor, std::string label);
+    void writeJson(std::ostream& out) const;
+
+    PerformanceMonitor& m_monitor;
+    const std::string m_label;
+    mutable std::mutex m_mutex;
+    std::map<std::string, std::unique_ptr<Counter>> m_counters;
+    std::map<std::string, std::unique_ptr<Gauge>> m_gauges;
+    std::map<std::string, std::unique_ptr<Histogram>> m_histograms;
+};
+
+class AURORASTREAM_API PerformanceMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 汇总指标（最近一个采样间隔内）
+     */
+    struct Metrics {
+        double frameRate = 0.0;             ///< 视频帧率（帧/秒）
+        double decodeTime = 0.0;            ///< 平均解码耗时（毫秒/数据包，送入和取出之和）
+        double renderTime = 0.0;            ///< 平均渲染耗时（毫秒/帧）
+        std::size_t memoryUsage = 0;        ///< 进程常驻内存（字节）
+        double networkThroughput = 0.0;     ///< 解复用读取速率（字节/秒）
+    };
+
+    static PerformanceMonitor& instance();
+
+    /// 获取或创建指标，返回的引用在进程生命周期内有效
+    Counter& counter(const std::string& name);
+    Gauge& gauge(const std::string& name);
+    Histogram& histogram(const std::string& name);
+
+    /**
+     * @brief 为一个实例创建子注册表
+     * @param kind 实例类型，标签为 kind-序号，例如 "media_player-3"
+     */
+    std::shared_ptr<MetricsScope> createScope(const std::string& kind);
+
+    /// 最近一个采样间隔的汇总指标；未启动监控时为空
+    Metrics getCurrentMetrics() const;
+
+    /**
+     * @brief 开始周期性采样
+     * @param intervalMs 采样间隔（毫秒）
+     */
+    void startMonitoring(int intervalMs = 1000);
+    /// 停止周期性采样；正在监控时再采样一次，快照文件保留最后的值
+    void stopMonitoring();
+    bool isMonitoring() const;
+
+    /**
+     * @brief 立即采样一次，更新汇总指标、发出 metricsUpdated 并写快照
+     * 没有 Qt 事件循环的程序用它代替 startMonitoring()；同一时刻只应有一个线程调用
+     */
+    void sample();
+
+    /**
+     * @brief 设置 JSON 快照文件，每个采样间隔重写一次；空字符串表示不写
+     */
+    void setSnapshotFile(const QString& filePath);
+    QString snapshotFile() const;
+
+    /// 所有指标、汇总指标和各实例子注册表的 JSON 表示
+    std::string toJson() const;
+
+signals:
+    void metricsUpdated(const aurorastream::core::PerformanceMonitor::Metrics& metrics);
+
+private:
+    explicit PerformanceMonitor(QObject* parent = nullptr);
+
+    bool writeSnapshot(const std::string& json) const;
+
+    mutable std::mutex m_mutex;         ///< 保护注册表、汇总指标和上次采样的值
+    std::map<std::string, std::unique_ptr<Counter>> m_counters;
+    std::map<std::string, std::unique_ptr<Gauge>> m_gauges;
+    std::map<std::string, std::unique_ptr<Histogram>> m_histograms;
+    std::vector<std::weak_ptr<MetricsScope>> m_scopes;      ///< 按创建顺序
+    uint64_t m_nextScope {1};
+
+    QTimer m_timer;
+    QString m_snapshotFile;
+    Metrics m_metrics;
+    std::chrono::steady_clock::time_point m_lastSample;
+    uint64_t m_lastFrames {0};
+    uint64_t m_lastBytes {0};
+    uint64_t m_lastDecodeCount {0};
+    uint64_t m_lastDecodeSum {0};
+    uint64_t m_lastRenderCount {0};
+    uint64_t m_lastRenderSum {0};
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_PERFORMANCEMONITOR_H
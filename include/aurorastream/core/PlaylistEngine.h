@@ -0,0 +1,193 @@
+/********************************************************************************
+ * @file   : PlaylistEngine.h
+ * @brief  : 定义了 aurorastream::core::PlaylistEngine 类。
+ *
+ * PlaylistEngine 实现无缝（gapless）播放列表：在当前项最后 N 秒内，
+ * 在共享线程池中预先打开、探测下一项并预解码其开头的若干帧（受内存上限约束），
+ * 交叉淡化所需的下一项音频也在此时解码，衔接时读取线程不会阻塞在解码上。
+ * 当前项读到结尾时直接切换到已就绪的下一项，音频在时间线上逐样本衔接，
+ * 可选地在两项之间做等功率交叉淡化。
+ *
+ * readFrame() 输出的帧时间戳统一为 AV_TIME_BASE（微秒）并位于一条连续的时间线上，
+ * 下游无需感知项目切换。
+ *
+ * 默认由播放列表持有各项的媒体源；设置 setSourceHandler() 后，每一项成为当前项时
+ * 媒体源的所有权交给处理函数（MediaPlayer 经 adoptSource 接管），播放列表只保留读取用的指针。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_PLAYLISTENGINE_H
+#define AURORASTREAM_CORE_PLAYLISTENGINE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <functional>
+
+#include "aurorastream/AuroraStream.h"
+#include "aurorastream/core/MediaSource.h"
+#include "aurorastream/core/TaskScheduler.h"
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API PlaylistEngine : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief 播放列表参数
+     */
+    struct Options {
+        qint64 prerollWindow = 5000;                        ///< 距当前项结束多少毫秒时开始预打开下一项
+        qint64 prerollDuration = 1000;                      ///< 下一项预解码的目标时长（毫秒），不短于 crossfade
+        qint64 crossfade = 0;                               ///< 交叉淡化时长（毫秒），0 表示逐样本硬切
+        std::size_t prerollMemoryLimit = 64 * 1024 * 1024;  ///< 预解码帧可占用的内存上限（字节）
+        bool loop = false;                                  ///< 播放到末尾后回到第一项
+        MediaSource::Options sourceOptions;                 ///< 打开各项时使用的选项
+    };
+
+    /// 接管当前项媒体源的处理函数，返回接管后用于继续读取的媒体源
+    using SourceHandler = std::function<MediaSource*(std::unique_ptr<MediaSource> source)>;
+
+    explicit PlaylistEngine(QObject* parent = nullptr);
+    ~PlaylistEngine() override;
+
+    void setOptions(const Options& options);
+    Options options() const;
+
+    /**
+     * @brief 设置当前项媒体源的接管方，需在 start() 之前设置
+     * @note 接管方必须让媒体源在它不再是当前项、或播放列表停止之前保持有效
+     */
+    void setSourceHandler(SourceHandler handler);
+
+    // 列表管理
+    void setItems(const QStringList& items);
+    void append(const QString& uri);
+    QStringList items() const;
+    int count() const;
+    int currentIndex() const;
+
+    /**
+     * @brief 同步打开指定项并开始播放列表
+     * @param index 起始项
+     * @return 成功返回 true
+     */
+    bool start(int index = 0);
+
+    /**
+     * @brief 以一个已经打开的媒体源作为当前项开始播放列表，不重新打开
+     * @param index 当前项
+     * @param source 媒体源，所有权仍归调用方，需在播放列表切到下一项或停止之前保持有效
+     * @return 成功返回 true
+     */
+    bool attach(int index, MediaSource* source);
+
+    /**
+     * @brief 立即切换到下一项，预打开尚未完成时同步等待
+     * @return 成功返回 true；列表已经到末尾返回 false
+     */
+    bool next();
+
+    /// 停止播放列表，取消后台预打开并释放所有媒体源
+    void stop();
+
+    /**
+     * @brief 在当前项内跳转
+     * @param position 相对当前项开头的位置（毫秒）
+     * @return 成功返回 true
+     */
+    bool seek(qint64 position);
+
+    /**
+     * @brief 读取无缝时间线上的下一帧
+     * @param frame 输出帧，pts/duration 以 AV_TIME_BASE 为单位
+     * @param type 输出帧的媒体类型
+     * @return 0 表示成功；AVERROR_EOF 表示列表播放完毕
+     */
+    int readFrame(AVFrame* frame, AVMediaType* type);
+
+    /// 当前项的媒体源
+    MediaSource* currentSource() const;
+
+    /// 当前项时间戳（微秒）到时间线的偏移：时间线时间戳减去它即为当前项内的时间戳
+    int64_t timelineOffset() const;
+
+    /// 下一项预解码帧当前占用的内存（字节）
+    std::size_t prerollMemoryUsage() const;
+
+signals:
+    void currentItemChanged(int index, const QString& uri, qint64 duration);
+    void prerollReady(int index);
+    void error(const QString& message);
+    void finished();
+
+private:
+    struct QueuedFrame {
+        AVFrame* frame;
+        AVMediaType type;
+    };
+
+    struct PreparedItem {
+        int index {-1};
+        std::unique_ptr<MediaSource> source;    ///< 预打开期间和没有接管方时持有
+        MediaSource* active {nullptr};          ///< 成为当前项后用于读取的媒体源
+        std::deque<QueuedFrame> frames;     ///< 预解码帧（解码顺序）
+        std::size_t bytes {0};              ///< 预解码帧占用的内存
+        int64_t firstPts {AV_NOPTS_VALUE};  ///< 首个音频帧（无音频时为视频帧）的时间戳（微秒）
+        int64_t audioConsumed {0};          ///< 交叉淡化中已经混入上一项的音频样本数
+        bool sourceEnded {false};
+
+        ~PreparedItem();
+        bool decodeOne();
+    };
+
+    void startPreroll();
+    void cancelPreroll();
+    std::unique_ptr<PreparedItem> prepare(int index, const QStringList& items, const Options& options);
+    std::unique_ptr<PreparedItem> takePrepared(bool wait);
+    bool advance();
+    void activate(std::unique_ptr<PreparedItem> item, int64_t timelineStart);
+    void mixCrossfade(AVFrame* frame);
+    void trimConsumedAudio(PreparedItem& item);
+
+    Options m_options;
+    QStringList m_items;
+    SourceHandler m_sourceHandler;
+
+    // 当前项（仅由调用 readFrame 的线程访问）
+    std::unique_ptr<PreparedItem> m_current;
+    std::unique_ptr<PreparedItem> m_pending;    ///< 已就绪、等待接管的下一项
+    int64_t m_offset {0};                       ///< 当前项时间戳到时间线的偏移（微秒）
+    int64_t m_currentEnd {AV_NOPTS_VALUE};      ///< 当前项预计在时间线上的结束时间（微秒）
+    int64_t m_audioEnd {AV_NOPTS_VALUE};        ///< 已输出音频在时间线上的结束时间（微秒）
+    int64_t m_videoEnd {AV_NOPTS_VALUE};        ///< 已输出视频在时间线上的结束时间（微秒）
+    int64_t m_lastVideoPts {AV_NOPTS_VALUE};
+    bool m_crossfadeWarned {false};
+
+    // 后台预打开
+    TaskGroup m_preroll;
+    std::atomic<bool> m_prerollCancel {false};
+    std::atomic<std::size_t> m_prerollBytes {0};
+    mutable std::mutex m_mutex;
+    std::unique_ptr<PreparedItem> m_prepared;   ///< 预打开任务的产出
+    bool m_prerollStarted {false};
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_PLAYLISTENGINE_H
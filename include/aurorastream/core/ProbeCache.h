@@ -0,0 +1,165 @@
+/********************************************************************************
+ * @file   : ProbeCache.h
+ * @brief  : 定义了 aurorastream::core::ProbeCache 类。
+ *
+ * avformat_find_stream_info 为了补全编解码参数可能需要解码数秒的媒体数据。
+ * ProbeCache 将探测结果（流布局、包含 extradata 的 codecpar、时长与码率）
+ * 持久化到磁盘，以 (路径, 文件大小, 修改时间) 为键。再次打开同一文件时，
+ * 只需 avformat_open_input 读取文件头，再用缓存结果重建各个流，
+ * 从而跳过完整的流信息探测。
+ *
+ * 不在媒体库中的文件的响度分析结果也以同样的键保存在这里（见 storeLoudness）。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_PROBECACHE_H
+#define AURORASTREAM_CORE_PROBECACHE_H
+
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "aurorastream/AuroraStream.h"
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API ProbeCache
+{
+public:
+    /**
+     * @brief 缓存命中统计
+     */
+    struct Statistics {
+        uint64_t hits;          ///< 命中并成功重建流的次数
+        uint64_t misses;        ///< 未命中（无缓存、文件已变化或流布局不一致）的次数
+        uint64_t stores;        ///< 写入缓存的次数
+    };
+
+    /**
+     * @brief 获取进程内共享的探测缓存，目录位于应用缓存目录下的 probe/
+     */
+    static ProbeCache& instance();
+
+    /**
+     * @brief 构造函数
+     * @param directory 缓存文件目录，不存在时自动创建
+     */
+    explicit ProbeCache(const std::string& directory);
+
+    ProbeCache(const ProbeCache&) = delete;
+    ProbeCache& operator=(const ProbeCache&) = delete;
+
+    /**
+     * @brief 用缓存的探测结果补全已打开的格式上下文
+     * @param path 媒体文件路径
+     * @param formatContext 已经 avformat_open_input、尚未 find_stream_info 的上下文
+     * @return 命中并重建成功返回 true，此时可以跳过 avformat_find_stream_info
+     */
+    bool restore(const std::string& path, AVFormatContext* formatContext);
+
+    /**
+     * @brief 保存 avformat_find_stream_info 之后的探测结果
+     * @param path 媒体文件路径
+     * @param formatContext 已完成流信息探测的上下文
+     */
+    void store(const std::string& path, const AVFormatContext* formatContext);
+
+    /**
+     * @brief 保存文件的响度分析结果，供不在媒体库中的文件使用
+     * @param loudness 综合响度（LUFS）
+     * @param truePeak 真峰值（dBTP）
+     */
+    void storeLoudness(const std::string& path, double loudness, double truePeak);
+
+    /**
+     * @brief 读取 storeLoudness 保存的结果
+     * @return 没有结果或文件已变化时返回 false
+     */
+    bool loudness(const std::string& path, double* loudness, double* truePeak) const;
+
+    /// 删除指定文件的缓存条目（包括响度结果）
+    void remove(const std::string& path);
+
+    /// 缓存目录
+    std::string directory() const;
+
+    Statistics getStatistics() const;
+
+private:
+    struct StreamEntry {
+        int id = 0;
+        AVRational timeBase {0, 1};
+        AVRational avgFrameRate {0, 1};
+        AVRational realFrameRate {0, 1};
+        AVRational sampleAspectRatio {0, 1};
+        int64_t startTime = AV_NOPTS_VALUE;
+        int64_t duration = AV_NOPTS_VALUE;
+        int64_t frameCount = 0;
+        int disposition = 0;
+
+        // codecpar
+        int codecType = AVMEDIA_TYPE_UNKNOWN;
+        int codecId = AV_CODEC_ID_NONE;
+        uint32_t codecTag = 0;
+        std::vector<uint8_t> extradata;
+        int format = -1;
+        int64_t bitRate = 0;
+        int bitsPerCodedSample = 0;
+        int bitsPerRawSample = 0;
+        int profile = 0;
+        int level = 0;
+        int width = 0;
+        int height = 0;
+        AVRational codecSampleAspectRatio {0, 1};
+        AVRational framerate {0, 1};
+        int fieldOrder = 0;
+        int colorRange = 0;
+        int colorPrimaries = 0;
+        int colorTrc = 0;
+        int colorSpace = 0;
+        int chromaLocation = 0;
+        int videoDelay = 0;
+        int channelOrder = AV_CHANNEL_ORDER_UNSPEC;
+        int channels = 0;
+        uint64_t channelMask = 0;
+        int sampleRate = 0;
+        int blockAlign = 0;
+        int frameSize = 0;
+        int initialPadding = 0;
+        int trailingPadding = 0;
+        int seekPreroll = 0;
+    };
+
+    struct Entry {
+        std::string formatName;
+        int64_t startTime = AV_NOPTS_VALUE;
+        int64_t duration = AV_NOPTS_VALUE;
+        int64_t bitRate = 0;
+        std::vector<StreamEntry> streams;
+    };
+
+    std::string keyFor(const std::string& path) const;
+    std::string fileFor(const std::string& key) const;
+    std::shared_ptr<const Entry> load(const std::string& key);
+    static bool apply(const Entry& entry, AVFormatContext* formatContext);
+
+    std::string m_directory;
+    mutable std::mutex m_cacheMutex;
+    std::unordered_map<std::string, std::shared_ptr<const Entry>> m_entries;
+    Statistics m_stats {};
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_PROBECACHE_H
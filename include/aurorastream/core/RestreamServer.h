@@ -0,0 +1,204 @@
+/********************************************************************************
+ * @file   : RestreamServer.h
+ * @brief  : 定义了 aurorastream::core::RestreamServer 类。
+ *
+ * RestreamServer 把播放器已经读到的数据包转发给多个本地客户端：
+ * 作为数据包分支（见 PacketTap），工作线程只封装一次 MPEG-TS，按关键帧切成
+ * HLS 分段；同一份 TS 数据块同时推送给所有 HTTP-TS 直连客户端，
+ * 不为每个客户端重新封装。
+ *
+ * 内置的 HTTP 服务器在单个线程上用 epoll 处理所有连接：
+ *   GET /live.m3u8        HLS 播放列表（滑动窗口）
+ *   GET /segment<N>.ts    HLS 分段；内存中的分段用 sendmsg 聚集写出引用计数的数据块，
+ *                         落盘的分段（设置了 directory）用 sendfile 发送
+ *   GET /live.ts          HTTP-TS 直播，从当前分段的开头（关键帧）开始
+ *   GET /clients          各客户端的发送量、积压和延迟（JSON）
+ * 数据块在各客户端之间共享，只增加引用计数，不复制。积压超过上限的直连客户端
+ * 被断开，不会拖慢其他客户端或播放。
+ *
+ * 仅支持 Linux（epoll、eventfd、sendfile），其他平台 create() 返回 nullptr。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_RESTREAMSERVER_H
+#define AURORASTREAM_CORE_RESTREAMSERVER_H
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <QString>
+
+#include "aurorastream/core/PacketTap.h"
+#include "aurorastream/core/MpscQueue.h"
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API RestreamServer : public PacketTap
+{
+public:
+    /**
+     * @brief 服务选项
+     */
+    struct Options {
+        std::string address = "127.0.0.1";             ///< 监听地址，默认只接受本机连接
+        int port = 8080;                                ///< 监听端口，0 表示由系统分配
+        double segmentSeconds = 2.0;                    ///< HLS 目标分段时长（秒），在之后的第一个关键帧处切分
+        int playlistSize = 6;                           ///< 播放列表中的分段数
+        std::string directory;                          ///< 非空时分段同时写入该目录，并用 sendfile 发送
+        std::size_t maxClientBytes = 16 << 20;          ///< 直连客户端的最大积压（字节），超过后断开
+        int maxClients = 4096;                          ///< 最大并发连接数
+        Limits limits;                                  ///< 封装线程队列上限
+    };
+
+    /**
+     * @brief 单个客户端的状态
+     */
+    struct ClientStatistics {
+        int id = 0;
+        std::string address;                            ///< 对端地址
+        std::string path;                               ///< 请求路径
+        bool live = false;                              ///< 是否为 HTTP-TS 直连
+        uint64_t bytesSent = 0;
+        std::size_t queuedBytes = 0;                    ///< 尚未发出的字节数
+        double lagSeconds = 0.0;                        ///< 正在发送的数据落后最新数据的时长
+    };
+
+    /**
+     * @brief 统计
+     */
+    struct Statistics {
+        int clients = 0;                                ///< 当前连接数
+        uint64_t requests = 0;
+        uint64_t bytesSent = 0;
+        uint64_t slowClients = 0;                       ///< 因积压过多被断开的直连客户端
+        int64_t segments = 0;                           ///< 已完成的分段数
+        uint64_t packetsDropped = 0;                    ///< 封装线程跟不上而丢弃的数据包
+    };
+
+    /**
+     * @brief 按输入流创建服务并开始监听
+     * @param input 解复用器的格式上下文，只转发 MPEG-TS 支持的音视频流
+     * @param options 服务选项
+     * @param errorMessage 失败时写入错误描述，可为空
+     * @return 失败返回 nullptr
+     */
+    static std::unique_ptr<RestreamServer> create(const AVFormatContext* input, const Options& options,
+                                                  QString* errorMessage = nullptr);
+
+    /// 析构函数，停止封装线程和服务线程并断开所有客户端
+    ~RestreamServer() override;
+
+    /// 实际监听的端口
+    int port() const;
+    /// 服务地址，例如 http://127.0.0.1:8080/
+    QString url() const;
+
+    std::vector<ClientStatistics> getClients() const;
+    Statistics getStatistics() const;
+
+protected:
+    void consume(AVPacket* packet) override;
+    void discontinuity() override;
+    void finish() override;
+
+private:
+    /// 一段已封装的 TS 数据（或一段 HTTP 响应头），由各客户端和分段共享
+    struct Chunk {
+        std::vector<uint8_t> data;
+        int64_t time = AV_NOPTS_VALUE;              ///< 产生该数据块的数据包的时间（微秒）
+    };
+
+    struct Segment {
+        int64_t sequence = 0;
+        int64_t startTime = 0;                      ///< 第一个数据包的时间（微秒）
+        double duration = 0.0;
+        bool discontinuity = false;                 ///< 之前发生了跳转或重新封装
+        int64_t discontinuitySequence = 0;          ///< 该分段之前（不含自身）带 discontinuity 的分段数
+        std::size_t bytes = 0;
+        std::vector<std::shared_ptr<const Chunk>> chunks;
+        std::string file;                           ///< 落盘路径，未落盘时为空
+    };
+
+    /// 封装线程发给服务线程的数据块
+    struct Publication {
+        std::shared_ptr<const Chunk> chunk;
+        bool segmentStart = false;                  ///< 该数据块是新分段的开头（以关键帧开始）
+    };
+
+    struct Client;
+
+    RestreamServer(const Options& options);
+
+    bool listen(QString* errorMessage);
+    bool openMuxer();
+    void closeMuxer();
+    void flushChunk(int64_t time);
+    void finishSegment(int64_t endTime);
+    static int writePacket(void* opaque, const uint8_t* data, int size);
+
+    void serverLoop();
+    void wakeServer();
+    void acceptClients();
+    bool readRequest(Client& client);
+    bool handleRequest(Client& client);
+    void sendPlaylist(Client& client);
+    void sendSegment(Client& client, int64_t sequence);
+    void sendClients(Client& client);
+    void sendResponse(Client& client, int status, const char* reason, const char* contentType,
+                      const std::string& body);
+    void queueText(Client& client, const std::string& text);
+    bool writeClient(Client& client);
+    void updateInterest(Client& client);
+    void closeClient(int fd);
+    void drainPublications();
+    void updateLag();
+
+    Options m_options;
+    std::vector<AVCodecParameters*> m_parameters;
+
+    // 封装线程
+    AVFormatContext* m_muxer {nullptr};
+    std::vector<uint8_t> m_pending;                 ///< 封装器写出、尚未发布的数据
+    int64_t m_lastTime {AV_NOPTS_VALUE};            ///< 最近一个数据包的时间（微秒）
+    int64_t m_nextSequence {0};
+    bool m_segmentStartPending {false};             ///< 下一个发布的数据块是新分段的开头
+    bool m_discontinuity {false};
+    int64_t m_discontinuityCount {0};               ///< 已开始的分段中带 discontinuity 的数量
+    std::shared_ptr<Segment> m_current;             ///< 正在生成的分段
+
+    // 已完成的分段（封装线程写，服务线程读）
+    mutable std::mutex m_segmentsMutex;
+    std::deque<std::shared_ptr<const Segment>> m_segments;
+
+    // 封装线程 → 服务线程
+    MpscQueue<Publication> m_publications;
+
+    // 服务线程
+    int m_listenFd {-1};
+    int m_epollFd {-1};
+    int m_wakeFd {-1};
+    int m_port {0};
+    std::atomic<bool> m_serverStopping {false};
+    std::thread m_server;
+    std::vector<std::shared_ptr<const Chunk>> m_joinChunks;     ///< 当前分段已发布的数据块，新的直连客户端从这里开始
+    int64_t m_latestTime {AV_NOPTS_VALUE};
+    int m_nextClientId {1};
+
+    mutable std::mutex m_clientsMutex;              ///< 保护 m_clients 和 m_statistics
+    std::map<int, std::unique_ptr<Client>> m_clients;
+    Statistics m_statistics;
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_RESTREAMSERVER_H
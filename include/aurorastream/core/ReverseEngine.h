@@ -0,0 +1,140 @@
+/********************************************************************************
+ * @file   : ReverseEngine.h
+ * @brief  : 定义了 aurorastream::core::ReverseEngine 类。
+ *
+ * ReverseEngine 实现倒放：以 GOP 为单位从关键帧正向解码到缓冲区，
+ * 再按相反顺序输出。多个解码器（各自持有独立打开的 MediaSource）
+ * 在共享线程池中并行解码更早的 GOP，当前 GOP 输出时下一个 GOP 通常已经就绪。
+ *
+ * 关键帧位置优先取自解复用器索引；没有索引时（如 MPEG-TS），
+ * 由上一个 GOP 的解码结果得到下一个 GOP 的结束位置，此时只能串行解码。
+ *
+ * 每段缓冲受 gopMemoryLimit 约束：GOP 过大时只保留结尾部分，
+ * 剩余部分作为新的一段重新解码。排队的段数不超过解码器数，另有一段正在输出，
+ * 峰值内存约为 (decoders + 1) × gopMemoryLimit。
+ * 倒放只输出视频帧，音频静音。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_REVERSEENGINE_H
+#define AURORASTREAM_CORE_REVERSEENGINE_H
+
+#include <QObject>
+#include <QString>
+
+#include <mutex>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <condition_variable>
+
+#include "aurorastream/AuroraStream.h"
+#include "aurorastream/core/MediaSource.h"
+#include "aurorastream/core/TaskScheduler.h"
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API ReverseEngine : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief 倒放参数
+     */
+    struct Options {
+        std::size_t gopMemoryLimit = 128 * 1024 * 1024;     ///< 每段解码缓冲的内存上限（字节）
+        int decoders = 2;                                   ///< 并行解码器数量
+        MediaSource::Options sourceOptions;                 ///< 打开解码用媒体源的选项
+    };
+
+    explicit ReverseEngine(QObject* parent = nullptr);
+    ~ReverseEngine() override;
+
+    void setOptions(const Options& options);
+    Options options() const;
+
+    /**
+     * @brief 从指定位置开始倒放
+     * @param uri 媒体地址
+     * @param position 起始位置（毫秒），该位置显示的帧最先输出
+     * @return 成功返回 true
+     */
+    bool start(const QString& uri, qint64 position);
+
+    /// 停止倒放并释放解码器与缓冲
+    void stop();
+
+    bool isActive() const;
+
+    /**
+     * @brief 读取下一帧（时间戳递减）
+     * @param frame 输出的视频帧，pts 为视频流时间基
+     * @return 0 表示成功；AVERROR_EOF 表示已到达媒体开头
+     */
+    int readFrame(AVFrame* frame);
+
+    /// 最近输出的帧在媒体中的位置（毫秒）
+    qint64 position() const;
+
+signals:
+    void error(const QString& message);
+
+private:
+    /**
+     * @brief 一段待倒放的连续帧：[start, end)
+     */
+    struct Segment {
+        int64_t start {AV_NOPTS_VALUE};             ///< 下界（已知的 GOP 起点），未知时不限
+        int64_t end {AV_NOPTS_VALUE};               ///< 上界（不含）
+        bool assigned {false};
+        bool done {false};
+        bool ok {false};
+        std::vector<AVFrame*> frames;               ///< 升序
+        int64_t gopStart {AV_NOPTS_VALUE};          ///< 实际解码起点（关键帧）
+        int64_t truncatedStart {AV_NOPTS_VALUE};    ///< 超出内存上限时保留部分的起点
+    };
+
+    void dispatch();
+    void decodeSegment(MediaSource* source, Segment& segment);
+    void schedule();
+    int64_t keyframeBefore(int64_t end) const;
+    AVFrame* acquireFrame();
+    void releaseFrame(AVFrame* frame);
+    void releaseFrames(std::vector<AVFrame*>& frames);
+
+    Options m_options;
+    std::vector<std::unique_ptr<MediaSource>> m_sources;
+    std::vector<int64_t> m_keyframes;               ///< 索引中的关键帧时间戳（升序）
+    AVRational m_timeBase {1, AV_TIME_BASE};
+    int64_t m_startTime {0};                        ///< 媒体起始时间（微秒）
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_segmentDone;
+    std::vector<MediaSource*> m_idleSources;        ///< 当前没有解码任务的解码器
+    TaskGroup m_tasks;
+    std::deque<std::shared_ptr<Segment>> m_segments;    ///< 按输出顺序排列
+    int64_t m_nextEnd {AV_NOPTS_VALUE};             ///< 下一段的上界，未知时为 AV_NOPTS_VALUE
+    bool m_reachedStart {false};
+    bool m_stopping {false};
+
+    // 输出（仅由调用 readFrame 的线程访问）
+    std::vector<AVFrame*> m_current;                ///< 正在倒序输出的一段
+    int64_t m_lastPts {AV_NOPTS_VALUE};
+
+    // AVFrame 对象池，避免逐帧分配
+    std::mutex m_poolMutex;
+    std::vector<AVFrame*> m_framePool;
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_REVERSEENGINE_H
@@ -0,0 +1,154 @@
+/********************************************************************************
+ * @file   : RtpJitterBuffer.h
+ * @brief  : 定义了 aurorastream::core::RtpJitterBuffer 类。
+ *
+ * RtpJitterBuffer 按 RTP 序号重排数据包，并按自适应的播放延迟放出：
+ *   - 包按扩展序号放进固定数量的槽位（序号对容量取模），内存在构造时一次分配。
+ *     新包超出窗口时提前放出最旧的包，持续乱序或长时间丢包时内存也不会增长；
+ *   - 每个包的放出时间 = RTP 时间戳 + 基准传输时延 + 播放延迟。基准传输时延
+ *     取一段时间内最小的（到达时间 − RTP 时间戳），定期重新取值以跟随时钟漂移；
+ *   - 到放出时间仍缺的包记为丢失并跳过；跳过之后才到达的包记为迟到丢包。
+ *     迟到丢包说明播放延迟不够，网络丢包则与延迟无关，两者分开统计；
+ *   - 播放延迟的目标值 = 系数 × 到达抖动（RFC 3550），限制在 [minDelay, maxDelay]。
+ *     一个统计窗口内的迟到丢包率超过 targetLateLoss 时增大系数，并把目标至少
+ *     提高到能容纳该窗口最晚的迟到包；窗口内没有迟到时系数缓慢回落。
+ *     延迟增大立即生效，减小时按固定速率回落，避免一次放出过多数据。
+ *
+ * 该类不加锁，由 UdpIngest 在接收线程中调用。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_RTPJITTERBUFFER_H
+#define AURORASTREAM_CORE_RTPJITTERBUFFER_H
+
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include "aurorastream/AuroraStream.h"
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API RtpJitterBuffer
+{
+public:
+    /**
+     * @brief 缓冲参数
+     */
+    struct Options {
+        int capacity = 512;                     ///< 最多缓冲的 RTP 包数（序号窗口）
+        int maxPacketSize = 2048;               ///< 单个 RTP 负载的最大字节数，超出部分截断
+        int clockRate = 90000;                  ///< RTP 时间戳频率，MPEG-TS（RFC 2250）为 90 kHz
+        int64_t minDelayUs = 20000;             ///< 播放延迟下限（微秒）
+        int64_t maxDelayUs = 1000000;           ///< 播放延迟上限（微秒）
+        double jitterFactor = 3.0;              ///< 播放延迟目标的初始系数（× 到达抖动）
+        double targetLateLoss = 0.002;          ///< 可接受的迟到丢包率
+    };
+
+    /**
+     * @brief 统计
+     */
+    struct Statistics {
+        uint64_t received = 0;                  ///< 收到的 RTP 包数
+        uint64_t played = 0;                    ///< 已放出的包数
+        uint64_t reordered = 0;                 ///< 乱序到达但仍按时放出的包数
+        uint64_t duplicates = 0;
+        uint64_t lost = 0;                      ///< 到放出时间仍缺失而跳过的包数（含之后迟到的）
+        uint64_t late = 0;                      ///< 跳过之后才到达而丢弃的包数
+        uint64_t overflows = 0;                 ///< 超出序号窗口而提前放出的包数
+        uint64_t resyncs = 0;                   ///< 序号跳变过大（发送端重启）而重新开始的次数
+        double jitterUs = 0.0;                  ///< RFC 3550 到达抖动（微秒）
+        int64_t delayUs = 0;                    ///< 当前播放延迟
+        int64_t targetDelayUs = 0;              ///< 播放延迟目标
+        double lateLossRatio = 0.0;             ///< 迟到丢包 /（放出 + 丢失）
+    };
+
+    /// 按序号顺序接收放出的 RTP 负载
+    using Sink = std::function<void(const uint8_t* payload, int size)>;
+
+    RtpJitterBuffer(const Options& options, Sink sink);
+
+    /**
+     * @brief 放入一个 RTP 数据报
+     * @param datagram 完整的 RTP 包（含头部）
+     * @param size 字节数
+     * @param arrivalUs 到达时间（微秒），与 drain() 使用同一时钟
+     * @return 不是 RTP 版本 2 的包时返回 false
+     * @note 超出序号窗口时会在本调用中提前放出最旧的包
+     */
+    bool push(const uint8_t* datagram, int size, int64_t arrivalUs);
+
+    /**
+     * @brief 放出所有已到放出时间的包，跳过到期仍缺失的包
+     * @param nowUs 当前时间（微秒）
+     */
+    void drain(int64_t nowUs);
+
+    /// 下一个包的放出时间，缓冲为空时返回 -1
+    int64_t nextDeadline() const;
+
+    /// 按序号顺序放出所有缓冲的包（结束或序号重新开始时）
+    void flush();
+
+    Statistics getStatistics() const;
+
+private:
+    struct Slot {
+        uint64_t sequence = 0;                  ///< 扩展序号
+        int64_t timestampUs = 0;                ///< 扩展 RTP 时间戳换算的微秒数
+        int size = 0;
+        bool used = false;
+        bool skipped = false;                   ///< 该序号到放出时间仍缺失，已跳过
+    };
+
+    Slot& slotFor(uint64_t sequence);
+    const Slot& slotFor(uint64_t sequence) const;
+    uint64_t firstBuffered() const;
+    int64_t deadline(const Slot& slot) const;
+    void release(Slot& slot);
+    void restart(uint16_t sequence, uint32_t timestamp);
+    void updateDelay(int64_t nowUs);
+    void publishMetrics();
+
+    Options m_options;
+    Sink m_sink;
+    std::vector<Slot> m_slots;
+    std::vector<uint8_t> m_storage;             ///< capacity 个 maxPacketSize 字节的负载缓冲
+
+    bool m_started {false};
+    bool m_playing {false};                     ///< 已放出过包；此后比 m_next 小的包都是迟到
+    uint64_t m_next {0};                        ///< 下一个要放出的扩展序号
+    uint64_t m_highest {0};                     ///< 收到的最大扩展序号
+    int m_count {0};                            ///< 已占用的槽位数
+    int64_t m_highestTimestamp {0};             ///< 收到的最大扩展 RTP 时间戳（时钟单位）
+    int64_t m_firstTimestamp {0};
+
+    // 时间映射和抖动
+    bool m_haveTransit {false};
+    int64_t m_lastTransit {0};
+    int64_t m_offset {0};                       ///< 基准传输时延（最小的 到达时间 − RTP 时间）
+    int64_t m_windowOffset {0};                 ///< 当前窗口内的最小传输时延
+    int64_t m_offsetWindowStart {0};
+
+    // 播放延迟控制
+    double m_factor {0.0};
+    int64_t m_delay {0};
+    int64_t m_target {0};
+    int64_t m_lateFloor {0};                    ///< 迟到丢包要求的最低延迟，逐窗口回落
+    int64_t m_lastDrain {0};
+    int64_t m_controlWindowStart {0};
+    uint64_t m_windowDone {0};                  ///< 窗口内放出或丢失的包数
+    uint64_t m_windowLate {0};
+    int64_t m_windowLateness {0};               ///< 窗口内迟到包超出放出时间的最大值
+
+    Statistics m_statistics;
+    Statistics m_published;                     ///< 上次导出到 PerformanceMonitor 时的统计
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_RTPJITTERBUFFER_H
@@ -0,0 +1,93 @@
+/********************************************************************************
+ * @file   : SeekIndex.h
+ * @brief  : 定义了 aurorastream::core::SeekIndex 类。
+ *
+ * 没有容器索引的文件（MPEG-TS、没有 Cues 的 Matroska、录制中断的文件等）
+ * 只能靠二分查找定位，倒放和关键帧快进也拿不到关键帧列表。SeekIndex 离线扫描
+ * 整个文件的数据包（只解复用、不解码），把主流的关键帧时间戳、字节位置和大小
+ * 保存到缓存目录；之后打开同一文件时，MediaSource 用 av_add_index_entry
+ * 补全流的索引。缓存键与 ProbeCache 相同：(路径, 文件大小, 修改时间)。
+ *
+ * 索引由命令行工具的 index 子命令生成，播放路径上只读取。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_SEEKINDEX_H
+#define AURORASTREAM_CORE_SEEKINDEX_H
+
+#include <string>
+#include <cstdint>
+
+#include "aurorastream/AuroraStream.h"
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API SeekIndex
+{
+public:
+    /**
+     * @brief 建立索引的结果
+     */
+    struct BuildResult {
+        int streamIndex = -1;       ///< 建立索引的流
+        std::size_t keyframes = 0;  ///< 关键帧数量
+        int64_t packets = 0;        ///< 扫描的数据包数量（所有流）
+        int64_t bytes = 0;          ///< 扫描的数据量（字节）
+    };
+
+    /**
+     * @brief 获取进程内共享的索引存储，目录位于应用缓存目录下的 index/
+     */
+    static SeekIndex& instance();
+
+    /**
+     * @brief 构造函数
+     * @param directory 索引文件目录，不存在时自动创建
+     */
+    explicit SeekIndex(const std::string& directory);
+
+    SeekIndex(const SeekIndex&) = delete;
+    SeekIndex& operator=(const SeekIndex&) = delete;
+
+    /**
+     * @brief 扫描文件并保存关键帧索引
+     * 有视频流时索引视频流，否则索引第一个音频流
+     * @param path 媒体文件路径
+     * @param result 可选，返回扫描统计
+     * @return 成功保存返回 true
+     */
+    bool build(const std::string& path, BuildResult* result = nullptr);
+
+    /**
+     * @brief 用已保存的索引补全流的索引条目
+     * 流自带的索引条目不少于保存的关键帧数时不做修改
+     * @param path 媒体文件路径
+     * @param formatContext 已完成流信息探测的上下文
+     * @return 补充了索引条目返回 true
+     */
+    bool apply(const std::string& path, AVFormatContext* formatContext) const;
+
+    /// 删除指定文件的索引
+    void remove(const std::string& path);
+
+    /// 索引目录
+    std::string directory() const;
+
+private:
+    std::string keyFor(const std::string& path) const;
+    std::string fileFor(const std::string& key) const;
+
+    std::string directory_;
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_SEEKINDEX_H
@@ -0,0 +1,88 @@
+/********************************************************************************
+ * @file   : StartupProfiler.h
+ * @brief  : 定义了 aurorastream::core::StartupProfiler 类。
+ *
+ * StartupProfiler 记录冷启动各阶段相对进程启动的耗时：进入 main、QApplication
+ * 创建、播放器创建、主窗口首次绘制（time-to-window）、媒体打开和第一帧显示
+ * （time-to-first-frame）。Linux 上以内核记录的进程启动时间为起点，因此动态链接
+ * 和静态初始化的时间也计算在内；其他平台以本模块静态初始化的时刻为起点。
+ *
+ * 每个阶段只记录第一次到达的时间，之后的 mark() 只有一次原子读取，可以放在
+ * 渲染等热路径上。第一帧显示时把报告写入日志，同时更新 PerformanceMonitor 的
+ * startup.* 仪表；设置了预算时，超出预算会记录警告。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_STARTUPPROFILER_H
+#define AURORASTREAM_CORE_STARTUPPROFILER_H
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+
+#include "aurorastream/AuroraStream.h"
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API StartupProfiler
+{
+public:
+    /**
+     * @brief 启动阶段，按预期到达的顺序排列
+     */
+    enum class Phase {
+        Main,               ///< 进入 main()
+        Application,        ///< QApplication 创建完成
+        Player,             ///< 播放器创建完成
+        Window,             ///< 主窗口首次绘制
+        MediaOpened,        ///< 第一个媒体打开完成
+        FirstFrame,         ///< 第一帧显示
+        Count
+    };
+
+    static StartupProfiler& instance();
+
+    /**
+     * @brief 记录阶段到达时间，只有第一次调用生效
+     */
+    void mark(Phase phase)
+    {
+        if (m_marks[static_cast<int>(phase)].load(std::memory_order_relaxed) < 0) {
+            record(phase);
+        }
+    }
+
+    /**
+     * @brief 阶段相对进程启动的耗时
+     * @return 微秒，尚未到达时返回 -1
+     */
+    int64_t elapsed(Phase phase) const;
+
+    /**
+     * @brief 设置冷启动预算（从进程启动到第一帧），0 表示不检查
+     */
+    void setBudget(int64_t milliseconds);
+    int64_t budget() const;
+
+    /// 各阶段耗时和相邻阶段间隔的文本报告
+    std::string report() const;
+
+    static const char* phaseName(Phase phase);
+
+private:
+    StartupProfiler();
+
+    void record(Phase phase);
+
+    int64_t m_processStart;                                         ///< 起点（微秒，与 now() 同一时钟）
+    std::atomic<int64_t> m_marks[static_cast<int>(Phase::Count)];   ///< 各阶段耗时，-1 表示未到达
+    std::atomic<int64_t> m_budget {0};
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_STARTUPPROFILER_H
@@ -0,0 +1,118 @@
+/********************************************************************************
+ * @file   : StreamManifest.h
+ * @brief  : 定义了 aurorastream::core::StreamManifest 类。
+ *
+ * StreamManifest 是自适应流清单的统一表示：HLS 主播放列表 / 媒体播放列表，
+ * 以及 DASH MPD（SegmentTemplate、SegmentTimeline、SegmentList）都解析成
+ * 一组按码率升序排列的档位（Rendition），每个档位是一串带编号和时长的分段。
+ * 不同档位中编号相同的分段覆盖同一段时间，切换档位只需换下一个分段的地址。
+ *
+ * HLS 的主播放列表只列出各档位的媒体播放列表地址，媒体播放列表在需要时
+ * 再通过 loadMediaPlaylist() 解析；直播播放列表重复调用即可刷新。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_STREAMMANIFEST_H
+#define AURORASTREAM_CORE_STREAMMANIFEST_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <QString>
+
+#include "aurorastream/AuroraStream.h"
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API StreamManifest
+{
+public:
+    enum class Kind {
+        Hls,
+        Dash
+    };
+
+    /**
+     * @brief 一个媒体分段（或字节区间）
+     */
+    struct Segment {
+        int64_t number = 0;                     ///< 分段编号（HLS 媒体序号 / DASH $Number$），各档位对齐
+        double start = 0.0;                     ///< 起始时间（秒），相对于节目开头
+        double duration = 0.0;                  ///< 时长（秒）
+        QString url;                            ///< 绝对地址
+        int64_t offset = 0;                     ///< 字节区间起点
+        int64_t length = -1;                    ///< 字节区间长度，-1 表示整个资源
+        bool discontinuity = false;             ///< 之前的时间线不连续（HLS EXT-X-DISCONTINUITY）
+    };
+
+    /**
+     * @brief 一个码率档位
+     */
+    struct Rendition {
+        QString id;                             ///< DASH Representation@id，HLS 为档位序号
+        int64_t bandwidth = 0;                  ///< 声明的峰值码率（bit/s）
+        int width = 0;
+        int height = 0;
+        double frameRate = 0.0;
+        std::string codecs;                     ///< RFC 6381 编码串，例如 avc1.64001f,mp4a.40.2
+        QString playlistUrl;                    ///< HLS 媒体播放列表地址，DASH 为空
+        bool loaded = false;                    ///< 分段列表是否已解析
+        bool live = false;                      ///< 播放列表还会追加分段（未见到 EXT-X-ENDLIST）
+        bool encrypted = false;                 ///< 分段加密（HLS EXT-X-KEY）
+        double targetDuration = 0.0;            ///< 最大分段时长（秒）
+        Segment init;                           ///< 初始化分段（fMP4），url 为空表示没有
+        std::vector<Segment> segments;
+    };
+
+    /**
+     * @brief 解析清单
+     * @param text 清单内容（HLS 主播放列表或媒体播放列表、DASH MPD）
+     * @param url 清单地址，用于解析相对地址
+     * @param errorMessage 失败时写入错误描述，可为空
+     * @return 失败返回 nullptr；只有一个媒体播放列表时生成单个已加载的档位
+     */
+    static std::unique_ptr<StreamManifest> parse(const std::string& text, const QString& url,
+                                                 QString* errorMessage = nullptr);
+
+    /// 按地址（扩展名 .m3u8 / .mpd）判断是否为自适应流清单
+    static bool isManifestUrl(const QString& uri);
+
+    /**
+     * @brief 解析（或刷新）一个 HLS 档位的媒体播放列表
+     * @note 直播刷新时保留已知分段的起始时间，新分段接在最后一个已知分段之后
+     */
+    bool loadMediaPlaylist(int rendition, const std::string& text, QString* errorMessage = nullptr);
+
+    Kind kind() const;
+    QString url() const;
+    /// 节目总时长（秒），直播为 0
+    double duration() const;
+
+    int renditionCount() const;
+    const Rendition& rendition(int index) const;
+
+    /// 编号为 number 的分段在档位中的下标，不存在返回 -1
+    int findSegment(int rendition, int64_t number) const;
+    /// 覆盖时间 seconds 的分段下标，超出范围时返回第一个或最后一个分段
+    int segmentAt(int rendition, double seconds) const;
+
+private:
+    StreamManifest() = default;
+
+    bool parseHls(const std::string& text, QString* errorMessage);
+    bool parseDash(const std::string& text, QString* errorMessage);
+
+    Kind m_kind {Kind::Hls};
+    QString m_url;
+    double m_duration {0.0};
+    std::vector<Rendition> m_renditions;        ///< 按码率升序
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_STREAMMANIFEST_H
@@ -0,0 +1,101 @@
+/********************************************************************************
+ * @file   : StreamRecorder.h
+ * @brief  : 定义了 aurorastream::core::StreamRecorder 类。
+ *
+ * StreamRecorder 是录制用的数据包分支（见 PacketTap）：写线程用
+ * av_interleaved_write_frame 把解复用得到的数据包原样封装为 MP4 / MKV / TS，
+ * 不重新编码。磁盘慢时由 PacketTap 丢包，不会阻塞播放。
+ * 可选按时长或大小分段，分段总是在视频关键帧处切换。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_STREAMRECORDER_H
+#define AURORASTREAM_CORE_STREAMRECORDER_H
+
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <QString>
+
+#include "aurorastream/core/PacketTap.h"
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API StreamRecorder : public PacketTap
+{
+public:
+    /**
+     * @brief 录制选项
+     */
+    struct Options {
+        std::string format;                             ///< 封装格式（mp4、matroska、mpegts），为空时按扩展名推断
+        double segmentSeconds = 0.0;                    ///< 按时长分段（秒），0 表示不分段
+        int64_t segmentBytes = 0;                       ///< 按大小分段（字节），0 表示不分段
+        Limits limits;                                  ///< 写线程队列上限
+    };
+
+    /**
+     * @brief 统计
+     */
+    struct Statistics {
+        uint64_t packetsWritten = 0;
+        uint64_t bytesWritten = 0;
+        uint64_t packetsDropped = 0;                    ///< 因队列已满或等待关键帧而丢弃的数据包
+        uint64_t writeErrors = 0;
+        int segments = 0;                               ///< 已打开的输出文件数
+    };
+
+    /**
+     * @brief 按输入流创建录制器并启动写线程
+     * @param input 解复用器的格式上下文，只复制音视频流的编码参数
+     * @param path 输出文件路径；分段时依次写入 name_000.ext、name_001.ext ...
+     * @param options 录制选项
+     * @param errorMessage 失败时写入错误描述，可为空
+     * @return 失败返回 nullptr
+     */
+    static std::unique_ptr<StreamRecorder> create(const AVFormatContext* input, const QString& path,
+                                                  const Options& options, QString* errorMessage = nullptr);
+
+    /// 析构函数，停止写线程并写出剩余数据包
+    ~StreamRecorder() override;
+
+    QString path() const;
+    Statistics getStatistics() const;
+
+protected:
+    void consume(AVPacket* packet) override;
+    /// 跳转后在下一个关键帧处开始新的文件
+    void discontinuity() override;
+    void finish() override;
+
+private:
+    StreamRecorder(const QString& path, const Options& options);
+
+    bool openSegment();
+    void closeSegment();
+    QString segmentPath(int index) const;
+
+    QString m_path;
+    Options m_options;
+    const AVOutputFormat* m_format {nullptr};
+    std::vector<AVCodecParameters*> m_parameters;   ///< 录制的各输出流的编码参数
+
+    mutable std::mutex m_statisticsMutex;
+    Statistics m_statistics;
+
+    // 只在写线程使用
+    AVFormatContext* m_output {nullptr};
+    int m_segmentIndex {0};
+    int64_t m_segmentStart {AV_NOPTS_VALUE};        ///< 当前分段第一个数据包的时间（微秒）
+    int64_t m_segmentBytes {0};
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_STREAMRECORDER_H
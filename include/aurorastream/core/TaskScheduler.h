@@ -0,0 +1,161 @@
+/********************************************************************************
+ * @file   : TaskScheduler.h
+ * @brief  : 定义了 aurorastream::core::TaskScheduler 和 TaskGroup 类。
+ *
+ * TaskScheduler 是进程内共享的工作窃取线程池，所有播放器和后台任务
+ * （预加载、循环重同步、倒放解码、缩略图、探测、扫描等）都向它提交任务，
+ * 而不是各自创建线程。工作线程数默认等于 CPU 核数，同一进程运行几十个
+ * 播放器时也不会超额订阅。
+ *
+ * 每个工作线程为每个优先级维护一个双端队列：自己从尾部取（LIFO，缓存友好），
+ * 空闲线程从其他线程的头部窃取（FIFO）。工作线程总是先处理高优先级的任务；
+ * 后台任务最多同时占用一半的工作线程，为音频和解码保留余量。
+ *
+ * 任务应当是短小、可结束的：长时间运行的循环拆成多个批次，
+ * 每个批次结束时重新提交自己（参见 Player 的解码循环）。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_TASKSCHEDULER_H
+#define AURORASTREAM_CORE_TASKSCHEDULER_H
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+#include "aurorastream/AuroraStream.h"
+
+namespace aurorastream {
+namespace core {
+
+/**
+ * @brief 任务组，用于等待一组任务（包括任务执行中追加提交的任务）全部完成
+ * 可以拷贝，拷贝共享同一计数
+ */
+class AURORASTREAM_API TaskGroup
+{
+public:
+    TaskGroup();
+
+    /**
+     * @brief 等待组内所有任务完成
+     * 在工作线程上调用时会在等待期间执行其他任务，避免线程池死锁
+     */
+    void wait() const;
+
+    /// 组内是否还有未完成的任务
+    bool isBusy() const;
+
+private:
+    friend class TaskScheduler;
+
+    struct State {
+        std::mutex mutex;
+        std::condition_variable done;
+        std::atomic<int> pending {0};
+    };
+    std::shared_ptr<State> m_state;
+};
+
+class AURORASTREAM_API TaskScheduler
+{
+public:
+    /**
+     * @brief 优先级，从高到低
+     */
+    enum class Priority {
+        RealtimeAudio = 0,  ///< 音频输出，延迟最敏感
+        PlaybackDecode,     ///< 播放中的解码
+        Interactive,        ///< 用户操作触发的任务（跳转、逐帧、预加载下一项）
+        Background,         ///< 缩略图、探测、索引、媒体库扫描
+        Count
+    };
+
+    /**
+     * @brief 统计
+     */
+    struct Statistics {
+        int workers = 0;            ///< 工作线程数
+        uint64_t executed = 0;      ///< 已执行的任务数
+        uint64_t stolen = 0;        ///< 通过窃取执行的任务数
+        std::size_t queued = 0;     ///< 当前排队的任务数
+    };
+
+    /// 进程内共享的实例，首次调用时按 CPU 核数创建工作线程
+    static TaskScheduler& instance();
+
+    /**
+     * @brief 构造函数
+     * @param workers 工作线程数，不大于 0 时使用 CPU 核数
+     */
+    explicit TaskScheduler(int workers = 0);
+
+    /// 析构函数，执行完已排队的任务后结束工作线程
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /**
+     * @brief 提交任务
+     * @param priority 优先级
+     * @param task 任务
+     * @param group 所属任务组，可为空
+     * @param affinity 亲和提示：同一提示值的任务优先放到同一个工作线程，
+     *                 使同一播放器的任务尽量在同一核心上执行；小于 0 表示不指定
+     */
+    void submit(Priority priority, std::function<void()> task, const TaskGroup* group = nullptr, int affinity = -1);
+
+    /// 工作线程数
+    int workerCount() const;
+
+    /// 当前线程是否为本线程池的工作线程
+    bool isWorkerThread() const;
+
+    Statistics getStatistics() const;
+
+private:
+    friend class TaskGroup;
+
+    struct Task {
+        std::function<void()> function;
+        std::shared_ptr<TaskGroup::State> group;
+        Priority priority = Priority::Background;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> queues[static_cast<int>(Priority::Count)];
+        std::thread thread;
+    };
+
+    void workerLoop(int index);
+    bool tryRunOne(int index, bool helping = false);
+    bool takeTask(int index, bool helping, Task& task);
+    void runTask(Task& task, bool counted);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeup;
+    std::atomic<uint64_t> m_wakeupEpoch {0};        ///< 提交任务或后台任务结束时递增（持有 m_sleepMutex）
+    std::atomic<std::size_t> m_queued {0};
+    std::atomic<uint64_t> m_executed {0};
+    std::atomic<uint64_t> m_stolen {0};
+    std::atomic<int> m_backgroundRunning {0};
+    std::atomic<unsigned> m_nextWorker {0};
+    int m_backgroundLimit {1};
+    bool m_stopping {false};
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_TASKSCHEDULER_H
@@ -0,0 +1,195 @@
+/********************************************************************************
+ * @file   : ThumbnailService.h
+ * @brief  : 定义了 aurorastream::core::ThumbnailService 和 SpriteSheet 类。
+ *
+ * ThumbnailService 在后台按固定间隔提取缩略图，拼成一张精灵图（sprite sheet）
+ * 缓存到磁盘，供进度条悬停预览和媒体库使用：
+ *  - 只解码关键帧（skip_frame = AVDISCARD_NONKEY），每个目标时间跳转到之前的
+ *    关键帧解码一帧；多个目标落在同一关键帧上时直接复用已缩放的图块；
+ *  - 解码器支持 lowres 时在解码阶段缩小，其余情况由 swscale 缩放；
+ *  - 同一文件的图块按 GOP 分段并行解码，多个文件之间也并行；
+ *  - 界面请求使用 Interactive 优先级，媒体库批量任务使用 Background 优先级，
+ *    后者只占用一半的工作线程，不会挡住界面请求；界面请求的文件已有排队或
+ *    运行中的批量任务时，该任务的剩余部分提升为 Interactive；
+ *  - 缓存键由文件大小和首、中、尾三段内容的摘要以及缩略图参数组成，
+ *    文件改名或移动后仍然命中。
+ *
+ * 精灵图文件可以直接映射到内存（见 SpriteSheet），像素为 32 位 0xffRRGGBB，
+ * 与 QImage::Format_RGB32 相同，界面可以不拷贝地构造 QImage。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_THUMBNAILSERVICE_H
+#define AURORASTREAM_CORE_THUMBNAILSERVICE_H
+
+#include <QObject>
+#include <QString>
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+#include "aurorastream/AuroraStream.h"
+#include "aurorastream/core/TaskScheduler.h"
+
+class QFile;
+
+namespace aurorastream {
+namespace core {
+
+struct SpriteHeader;
+
+/**
+ * @brief 映射到内存的只读精灵图
+ */
+class AURORASTREAM_API SpriteSheet
+{
+public:
+    /**
+     * @brief 映射精灵图文件
+     * @return 文件不存在或格式不正确时返回 nullptr
+     */
+    static std::shared_ptr<const SpriteSheet> map(const std::string& filePath);
+
+    ~SpriteSheet();
+
+    SpriteSheet(const SpriteSheet&) = delete;
+    SpriteSheet& operator=(const SpriteSheet&) = delete;
+
+    int count() const;
+    int tileWidth() const;
+    int tileHeight() const;
+    int columns() const;
+    int64_t interval() const;       ///< 图块间隔（毫秒）
+
+    /// 最接近 position（毫秒）的图块序号
+    int tileAt(int64_t position) const;
+
+    /**
+     * @brief 图块像素
+     * @param index 图块序号
+     * @param stride 输出整张精灵图的行字节数
+     * @return 图块左上角像素，序号无效时返回 nullptr
+     */
+    const uint8_t* tile(int index, int* stride) const;
+
+    /// 图块实际对应的关键帧时间（毫秒），该图块解码失败时为 -1
+    int64_t timestamp(int index) const;
+
+private:
+    SpriteSheet() = default;
+
+    std::unique_ptr<QFile> m_file;
+    const uint8_t* m_data {nullptr};
+    const SpriteHeader* m_header {nullptr};
+    const int64_t* m_timestamps {nullptr};
+};
+
+/**
+ * @brief 缩略图参数，参与缓存键
+ */
+struct ThumbnailOptions {
+    int64_t interval = 10000;   ///< 图块间隔（毫秒），超出 maxTiles 时自动加大
+    int tileWidth = 160;        ///< 图块宽度，高度按显示宽高比计算
+    int maxTiles = 400;         ///< 单个文件的最大图块数
+    int columns = 10;           ///< 精灵图每行的图块数
+};
+
+class AURORASTREAM_API ThumbnailService : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 请求优先级
+     */
+    enum class Priority {
+        Interactive,    ///< 界面请求（当前播放的文件、悬停预览）
+        Batch           ///< 媒体库批量生成
+    };
+
+    using Options = ThumbnailOptions;
+
+    /**
+     * @brief 统计
+     */
+    struct Statistics {
+        uint64_t sheets = 0;        ///< 生成的精灵图数
+        uint64_t cacheHits = 0;     ///< 磁盘缓存命中数
+        uint64_t tiles = 0;         ///< 生成的图块数
+        uint64_t decodedFrames = 0; ///< 实际解码的关键帧数
+        uint64_t reusedTiles = 0;   ///< 复用相邻图块（同一关键帧）的图块数
+    };
+
+    /// 进程内共享的实例，缓存目录位于应用缓存目录下的 thumbnails/
+    static ThumbnailService& instance();
+
+    /**
+     * @brief 构造函数
+     * @param directory 缓存目录，不存在时自动创建
+     */
+    explicit ThumbnailService(const std::string& directory, QObject* parent = nullptr);
+    ~ThumbnailService() override;
+
+    /**
+     * @brief 获取精灵图；尚未生成时在后台开始生成，完成后发出 spriteReady
+     * @param path 本地媒体文件
+     * @param priority 优先级
+     * @param options 缩略图参数
+     * @return 内存中已有时直接返回，否则返回 nullptr
+     */
+    std::shared_ptr<const SpriteSheet> request(const QString& path, Priority priority,
+                                               const Options& options = Options());
+
+    /**
+     * @brief 同步获取精灵图，必要时在当前线程等待生成完成
+     * @return 不是可解码的视频文件时返回 nullptr
+     */
+    std::shared_ptr<const SpriteSheet> generate(const QString& path, Priority priority,
+                                                const Options& options = Options());
+
+    /// 缓存目录
+    std::string directory() const;
+
+    Statistics getStatistics() const;
+
+signals:
+    /// 精灵图已可用（在工作线程中发出）
+    void spriteReady(const QString& path);
+
+    /// 文件无法生成缩略图（不存在、没有视频流或无法解码）
+    void spriteFailed(const QString& path);
+
+private:
+    struct Job;
+    struct Entry {
+        int64_t fileSize = 0;
+        int64_t modifiedTime = 0;
+        Options options;
+        std::shared_ptr<const SpriteSheet> sheet;
+    };
+
+    std::shared_ptr<Job> startJob(const QString& path, Priority priority, const Options& options);
+    void submitRun(const std::shared_ptr<Job>& job, TaskScheduler::Priority priority);
+    void submitChunks(const std::shared_ptr<Job>& job, TaskScheduler::Priority priority);
+    void runJob(const std::shared_ptr<Job>& job);
+    void decodeChunk(const std::shared_ptr<Job>& job, int first, int last);
+    void finishJob(const std::shared_ptr<Job>& job);
+    void failJob(const std::shared_ptr<Job>& job);
+
+    std::string m_directory;
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, Entry> m_sheets;                  ///< 路径 -> 已映射的精灵图
+    std::map<std::string, std::shared_ptr<Job>> m_jobs;     ///< 路径 -> 进行中的任务
+    Statistics m_statistics;
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_THUMBNAILSERVICE_H
@@ -0,0 +1,87 @@
+/********************************************************************************
+ * @file   : TrickPlayEngine.h
+ * @brief  : 定义了 aurorastream::core::TrickPlayEngine 类。
+ *
+ * TrickPlayEngine 实现高倍速快进（约 2x 以上）：视频解码器切换到
+ * AVDISCARD_NONKEY 只解码关键帧，音频流在解复用层直接丢弃。
+ *
+ * 为了让输出的有效帧率保持恒定，每一帧都对应固定的媒体时间步长
+ * rate / frameRate：有索引时通过解复用器索引直接跳到离下一个目标时间
+ * 最近的关键帧，跳过中间的数据；没有索引时顺序读取并丢弃早于目标的关键帧。
+ * 关键帧间隔大于步长时实际跨过的媒体时长更长，输出帧的显示时长随之延长。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_TRICKPLAYENGINE_H
+#define AURORASTREAM_CORE_TRICKPLAYENGINE_H
+
+#include <vector>
+#include <cstdint>
+
+#include "aurorastream/AuroraStream.h"
+#include "aurorastream/core/MediaSource.h"
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API TrickPlayEngine
+{
+public:
+    /**
+     * @brief 构造函数，切换解码器到仅关键帧模式
+     * @param source 媒体源，由调用者持有，必须包含视频流
+     * @param frameRate 输出的有效帧率（每秒显示的关键帧数）
+     */
+    explicit TrickPlayEngine(MediaSource* source, double frameRate = 10.0);
+
+    /// 析构函数，恢复解码器和音频流的丢弃设置
+    ~TrickPlayEngine();
+
+    TrickPlayEngine(const TrickPlayEngine&) = delete;
+    TrickPlayEngine& operator=(const TrickPlayEngine&) = delete;
+
+    void setRate(double rate);
+    double rate() const;
+
+    /**
+     * @brief 从指定位置重新开始选取关键帧
+     * @param position 位置（毫秒）
+     */
+    void reset(qint64 position);
+
+    /**
+     * @brief 读取下一个关键帧
+     * @param frame 输出的视频帧，pts 为视频流时间基；duration 为该帧的显示时长（视频流时间基），
+     *        即与上一帧之间的媒体时长除以 rate，按它显示时有效速率等于 rate
+     * @return 0 表示成功；AVERROR_EOF 表示到达结尾
+     */
+    int readFrame(AVFrame* frame);
+
+    /// 最近输出的帧在媒体中的位置（毫秒）
+    qint64 position() const;
+
+private:
+    int64_t step() const;
+    int readKeyframe(AVFrame* frame);
+
+    MediaSource* m_source;
+    AVStream* m_videoStream;
+    double m_frameRate;
+    double m_rate {4.0};
+    std::vector<int64_t> m_keyframes;           ///< 索引中的关键帧时间戳（升序）
+    int64_t m_nextTarget {AV_NOPTS_VALUE};      ///< 下一帧的目标时间戳
+    int64_t m_lastPts {AV_NOPTS_VALUE};
+    AVDiscard m_savedSkipFrame;
+    AVDiscard m_savedAudioDiscard {AVDISCARD_DEFAULT};
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_TRICKPLAYENGINE_H
@@ -0,0 +1,165 @@
+/********************************************************************************
+ * @file   : UdpIngest.h
+ * @brief  : 定义了 aurorastream::core::UdpIngest 类。
+ *
+ * UdpIngest 是 UDP 承载的 MPEG-TS（组播或单播）的接收端，以自定义 AVIOContext
+ * 的形式交给 mpegts 解复用器，替代 FFmpeg 的 udp 协议：
+ *   - 独立的接收线程用 recvmmsg 一次取出套接字中排队的多个数据报，直接收进
+ *     预分配的环形缓冲区（每个槽位一个数据报），突发到达时也能及时清空
+ *     套接字接收队列，减少内核丢包；
+ *   - 用 SO_TIMESTAMPNS 取得内核接收时间戳，结合 TS 中的 PCR 计算到达抖动
+ *     （RFC 3550 的到达间隔抖动，以 PCR 作为发送端时钟）；
+ *   - 按 PID 检查连续计数器（continuity_counter），统计丢失的 TS 包；
+ *     SO_RXQ_OVFL 给出内核因接收缓冲区满而丢弃的数据报数。
+ * 包速率、码率、丢包和抖动同时导出到 PerformanceMonitor（udp.*）。
+ *
+ * rtp:// 地址接收 RTP 承载的 MPEG-TS（RFC 2250）：数据报先经 RtpJitterBuffer 按序号重排，
+ * 按自适应的播放延迟放出后才写入环形缓冲区，此时 TS 层的到达间隔和 PCR 抖动
+ * 反映的是抖动缓冲之后的残余抖动，网络抖动和迟到丢包见 Statistics::jitterBuffer。
+ *
+ * 地址格式与 FFmpeg 相同：udp://[@]地址:端口[?localaddr=网卡地址&buffer_size=字节&timeout=微秒]
+ * （rtp:// 相同），地址为组播地址时加入该组。只支持 IPv4 和 Linux，其他情况 create() 返回 nullptr，
+ * 调用方应回退到 FFmpeg 的 udp / rtp 协议。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_UDPINGEST_H
+#define AURORASTREAM_CORE_UDPINGEST_H
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <condition_variable>
+#include <QString>
+
+#include "aurorastream/AuroraStream.h"
+#include "aurorastream/core/RtpJitterBuffer.h"
+
+extern "C" {
+#include <libavformat/avio.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API UdpIngest
+{
+public:
+    /**
+     * @brief 接收参数
+     */
+    struct Options {
+        int batchSize = 64;                     ///< 单次 recvmmsg 最多接收的数据报数
+        int ringSize = 8192;                    ///< 环形缓冲区的槽位数（数据报数）
+        int maxDatagramSize = 2048;             ///< 单个槽位的大小，TS over UDP 通常为 7 × 188 = 1316 字节
+        int receiveBufferSize = 8 << 20;        ///< 套接字接收缓冲区（SO_RCVBUF），有权限时用 SO_RCVBUFFORCE 突破系统上限
+        double timeoutSeconds = 10.0;           ///< 持续没有数据时结束输入（秒），0 表示一直等待
+        RtpJitterBuffer::Options jitterBuffer;  ///< rtp:// 的抖动缓冲参数
+    };
+
+    /**
+     * @brief 统计
+     */
+    struct Statistics {
+        uint64_t datagrams = 0;                 ///< 收到的数据报数
+        uint64_t packets = 0;                   ///< 收到的 TS 包数
+        uint64_t bytes = 0;
+        uint64_t batches = 0;                   ///< recvmmsg 调用次数（返回了数据的）
+        uint64_t ccErrors = 0;                  ///< 连续计数器不连续的次数
+        uint64_t lostPackets = 0;               ///< 按连续计数器估计丢失的 TS 包数（每次最多 15 个）
+        uint64_t transportErrors = 0;           ///< transport_error_indicator 置位的 TS 包数
+        uint64_t syncErrors = 0;                ///< 同步字节错误或长度不是 188 整数倍的数据报
+        uint64_t ringOverflows = 0;             ///< 环形缓冲区已满而丢弃的数据报（解复用跟不上）
+        uint64_t socketDrops = 0;               ///< 内核接收缓冲区已满而丢弃的数据报（SO_RXQ_OVFL）
+        double packetRate = 0.0;                ///< 最近一秒的 TS 包速率（包/秒）
+        double bitrate = 0.0;                   ///< 最近一秒的码率（bit/s）
+        double jitterUs = 0.0;                  ///< 基于 PCR 的到达抖动（微秒）
+        int64_t maxGapUs = 0;                   ///< 相邻数据报的最大到达间隔（微秒）
+        bool rtp = false;                       ///< 是否为 rtp:// 输入
+        RtpJitterBuffer::Statistics jitterBuffer;   ///< rtp:// 的抖动缓冲统计
+    };
+
+    /**
+     * @brief 创建套接字（必要时加入组播组）并启动接收线程
+     * @param uri udp:// 地址
+     * @param options 接收参数
+     * @param errorMessage 失败时写入错误描述，可为空
+     * @return 失败或当前平台不支持时返回 nullptr
+     */
+    static std::unique_ptr<UdpIngest> create(const QString& uri, const Options& options,
+                                             QString* errorMessage = nullptr);
+
+    /// 是否为 udp:// 或 rtp:// 地址
+    static bool isUdpUrl(const QString& uri);
+
+    /// 析构函数，停止接收线程并关闭套接字
+    ~UdpIngest();
+
+    UdpIngest(const UdpIngest&) = delete;
+    UdpIngest& operator=(const UdpIngest&) = delete;
+
+    /**
+     * @brief 获取可以挂到 AVFormatContext::pb 上的 AVIOContext（不可随机访问）
+     * @note 调用方需设置 AVFMT_FLAG_CUSTOM_IO，并在本对象销毁前关闭 AVFormatContext
+     */
+    AVIOContext* avioContext() const;
+
+    /// 实际绑定的本地端口
+    int port() const;
+
+    Statistics getStatistics() const;
+
+private:
+    UdpIngest(const Options& options);
+
+    bool open(const std::string& uri, QString* errorMessage);
+    static int readPacket(void* opaque, uint8_t* buf, int size);
+    int read(uint8_t* buf, int size);
+    void receiveLoop();
+    void playout();
+    void deliver(const uint8_t* data, int size);
+    void inspect(const uint8_t* data, int size, int64_t arrivalUs);
+
+    Options m_options;
+    int m_socket {-1};
+    int m_port {0};
+    AVIOContext* m_avio {nullptr};
+    std::thread m_receiver;
+    std::atomic<bool> m_stopping {false};
+    std::atomic<bool> m_failed {false};             ///< 接收线程遇到无法恢复的套接字错误
+
+    // 单生产者单消费者环形缓冲区：接收线程写 m_head，解复用线程写 m_tail
+    std::vector<uint8_t> m_ring;                    ///< ringSize 个 maxDatagramSize 字节的槽位
+    std::vector<uint32_t> m_sizes;                  ///< 各槽位中数据报的长度
+    std::vector<uint8_t> m_scratch;                 ///< 环形缓冲区满时接收并丢弃数据报用的缓冲
+    std::atomic<uint64_t> m_head {0};
+    std::atomic<uint64_t> m_tail {0};
+    std::size_t m_readOffset {0};                   ///< 当前槽位已读出的字节数（只在解复用线程使用）
+    std::atomic<int64_t> m_lastArrival {0};         ///< 最近一个数据报的到达时间（单调时钟，微秒）
+    std::mutex m_waitMutex;
+    std::condition_variable m_dataAvailable;
+
+    // 以下只在接收线程中修改，由 m_statisticsMutex 保护读取
+    mutable std::mutex m_statisticsMutex;
+    Statistics m_statistics;
+    std::vector<int8_t> m_continuity;               ///< 每个 PID 上一个有负载的 TS 包的连续计数器，-1 表示未见过
+    int m_pcrPid {-1};                              ///< 用于测量抖动的 PCR 所在 PID（第一个出现的）
+    int64_t m_lastPcrUs {-1};
+    int64_t m_lastPcrArrivalUs {0};
+    int64_t m_previousArrivalUs {0};
+    int64_t m_rateWindowStart {0};
+    uint64_t m_rateWindowPackets {0};
+    uint64_t m_rateWindowBytes {0};
+    uint32_t m_kernelDrops {0};                     ///< SO_RXQ_OVFL 的累计值
+    std::unique_ptr<RtpJitterBuffer> m_jitterBuffer;    ///< 只在 rtp:// 时创建
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_UDPINGEST_H
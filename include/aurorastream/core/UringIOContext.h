@@ -0,0 +1,94 @@
+/********************************************************************************
+ * @file   : UringIOContext.h
+ * @brief  : 定义了 aurorastream::core::UringIOContext 类。
+ *
+ * 该类基于 io_uring 实现了一个带预读的自定义 AVIOContext，
+ * 在解复用游标之前保持多个大块、对齐的异步读请求在途，
+ * 从而将存储延迟从 av_read_frame 的关键路径上隐藏掉。
+ * 可选使用 O_DIRECT 绕过页缓存读取冷归档文件。
+ *
+ * 当编译时未启用 io_uring 或运行时内核不支持时，create() 返回空指针，
+ * 调用方应回退到 FFmpeg 默认的同步文件协议。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_URINGIOCONTEXT_H
+#define AURORASTREAM_CORE_URINGIOCONTEXT_H
+
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+#include "aurorastream/AuroraStream.h"
+
+extern "C" {
+#include <libavformat/avio.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+class AURORASTREAM_API UringIOContext
+{
+public:
+    /**
+     * @brief 预读参数
+     */
+    struct Options {
+        int queueDepth = 8;                 ///< 同时在途的读请求数（预读窗口的块数）
+        std::size_t blockSize = 1 << 20;    ///< 单个读请求大小，会向上对齐到 4 KiB
+        bool directIO = false;              ///< 是否以 O_DIRECT 打开文件（冷归档）
+    };
+
+    /**
+     * @brief I/O 统计信息
+     */
+    struct Statistics {
+        int64_t ioWaitTimeUs;               ///< 解复用线程阻塞等待读完成的累计时间（微秒）
+        uint64_t bytesRead;                 ///< 已完成的读请求字节数
+        uint64_t readsSubmitted;            ///< 已提交的读请求数
+        uint64_t readsWaited;               ///< 需要阻塞等待才完成的读请求数（预读未命中）
+    };
+
+    /**
+     * @brief 创建基于 io_uring 的 I/O 上下文
+     * @param path 本地文件路径
+     * @param options 预读参数
+     * @return 成功返回上下文；io_uring 不可用或打开失败时返回 nullptr
+     */
+    static std::unique_ptr<UringIOContext> create(const std::string& path, const Options& options);
+
+    /**
+     * @brief 检查当前构建和运行的内核是否支持 io_uring
+     * @return 支持返回 true
+     */
+    static bool isAvailable();
+
+    ~UringIOContext();
+
+    UringIOContext(const UringIOContext&) = delete;
+    UringIOContext& operator=(const UringIOContext&) = delete;
+
+    /**
+     * @brief 获取可以挂到 AVFormatContext::pb 上的 AVIOContext
+     * @note 调用方需设置 AVFMT_FLAG_CUSTOM_IO，并在本对象销毁前关闭 AVFormatContext
+     */
+    AVIOContext* avioContext() const;
+
+    /// 获取 I/O 统计信息（线程安全）
+    Statistics getStatistics() const;
+
+private:
+    UringIOContext();
+
+    class Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_URINGIOCONTEXT_H
@@ -0,0 +1,109 @@
+/********************************************************************************
+ * @file   : LoudnessAnalyzer.h
+ * @brief  : 声明 AuroraStream 后台响度分析（LoudnessAnalyzer）。
+ *
+ * LoudnessAnalyzer 用 decoder::Decoder 解码文件的音频流，交给 LoudnessMeter
+ * 测量综合响度和真峰值，结果写入 MediaLibrary 的 loudness / true_peak 列；
+ * 不在媒体库中的文件写入 ProbeCache（同样以路径、大小和修改时间为键）。
+ * 分析任务以 Background 优先级在 TaskScheduler 上执行，多个文件并行；
+ * 单个文件不经过渲染和重采样，速度受解码器限制，通常是实时的数百倍。
+ *
+ * 播放时 Player 从媒体库或探测缓存读取结果，换算为归一化增益交给音频渲染器的增益级；
+ * 尚未分析的文件在第一次播放时提交分析，下一次播放即可生效。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <cstdint>
+#include <unordered_set>
+
+#include "../../../AuroraStream.h"
+#include "aurorastream/core/TaskScheduler.h"
+
+namespace aurorastream {
+namespace core {
+class MediaLibrary;
+}
+namespace modules {
+namespace media {
+namespace audio {
+
+class AURORASTREAM_API LoudnessAnalyzer {
+public:
+    /**
+     * @brief 单个文件的分析结果
+     */
+    struct Result {
+        double loudness = 0.0;      ///< 综合响度（LUFS），静音时为负无穷
+        double truePeak = 0.0;      ///< 真峰值（dBTP）
+        int64_t frames = 0;         ///< 分析的音频帧数
+        int sampleRate = 0;
+    };
+
+    /**
+     * @brief 统计
+     */
+    struct Statistics {
+        uint64_t analyzed = 0;      ///< 完成分析的文件数
+        uint64_t failed = 0;        ///< 无法解码的文件数
+        double audioSeconds = 0.0;  ///< 分析的音频总时长（秒）
+        double busySeconds = 0.0;   ///< 各分析任务耗时之和（秒）
+    };
+
+    /// 进程内共享的实例，结果写入 MediaLibrary::instance()
+    static LoudnessAnalyzer& instance();
+
+    /**
+     * @brief 构造函数
+     * @param library 保存结果的媒体库
+     */
+    explicit LoudnessAnalyzer(core::MediaLibrary& library);
+
+    /// 析构函数，等待进行中的分析任务
+    ~LoudnessAnalyzer();
+
+    LoudnessAnalyzer(const LoudnessAnalyzer&) = delete;
+    LoudnessAnalyzer& operator=(const LoudnessAnalyzer&) = delete;
+
+    /**
+     * @brief 在当前线程分析一个文件，不写入媒体库
+     * @return 文件没有可解码的音频流时返回 false
+     */
+    static bool analyze(const std::string& path, Result* result);
+
+    /**
+     * @brief 在后台分析一个文件并保存结果；已在队列中的文件忽略
+     */
+    void request(const std::string& path);
+
+    /**
+     * @brief 在后台分析媒体库中所有尚未分析响度的文件
+     * @return 提交的文件数
+     */
+    int analyzeLibrary();
+
+    /// 等待所有已提交的分析完成
+    void wait();
+
+    Statistics getStatistics() const;
+
+private:
+    void run(const std::string& path);
+
+    core::MediaLibrary& m_library;
+    core::TaskGroup m_group;
+
+    mutable std::mutex m_mutex;
+    std::unordered_set<std::string> m_pending;      ///< 已提交、尚未完成的文件
+    Statistics m_statistics;
+};
+
+} // namespace audio
+} // namespace media
+} // namespace modules
+} // namespace aurorastream
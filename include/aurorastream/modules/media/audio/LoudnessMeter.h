@@ -0,0 +1,90 @@
+/********************************************************************************
+ * @file   : LoudnessMeter.h
+ * @brief  : 声明 AuroraStream EBU R128 / ITU-R BS.1770 响度测量模块。
+ *
+ * 此文件定义了 aurorastream::modules::media::audio::LoudnessMeter 类，
+ * 它对交错排列的 float 样本做 K 计权（高架预滤波 + RLB 高通），
+ * 按 100 ms 子块累计各声道的加权能量，组成 400 ms、重叠 75% 的测量块，
+ * 再经过 -70 LUFS 绝对门限和 -10 LU 相对门限得到综合响度；
+ * 真峰值通过 4 倍过采样（48 抽头多相插值滤波器）测量。
+ *
+ * 能量累加和过采样滤波使用 SIMD（AVX/SSE2/NEON）实现；K 计权的两级双二阶
+ * 滤波器是递归的，按声道以 double 精度逐样本计算。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "../../../AuroraStream.h"
+
+namespace aurorastream {
+namespace modules {
+namespace media {
+namespace audio {
+
+class AURORASTREAM_API LoudnessMeter {
+public:
+    /// 归一化的默认目标响度（LUFS），与 ReplayGain 2.0 的参考电平相同
+    static constexpr double kTargetLoudness = -18.0;
+
+    /// 归一化后允许的最大真峰值（dBTP）
+    static constexpr double kTruePeakCeiling = -1.0;
+
+    LoudnessMeter();
+    ~LoudnessMeter();
+
+    LoudnessMeter(const LoudnessMeter&) = delete;
+    LoudnessMeter& operator=(const LoudnessMeter&) = delete;
+
+    /**
+     * @brief 初始化
+     * @param sampleRate 采样率
+     * @param channels 声道数
+     * @param weights 各声道权重（BS.1770：左右中 1.0，环绕 1.41，LFE 0）；
+     *                为空时 6 声道按 5.1 布局处理，其余声道数全部为 1.0
+     * @return 参数有效返回 true
+     */
+    bool init(int sampleRate, int channels, const std::vector<float>& weights = std::vector<float>());
+
+    /// 丢弃所有测量结果
+    void reset();
+
+    /**
+     * @brief 处理一段交错排列的样本
+     * @param samples 输入样本
+     * @param frames 帧数（每帧包含 channels 个样本）
+     */
+    void process(const float* samples, int frames);
+
+    /// 综合响度（LUFS），没有高于绝对门限的测量块时为负无穷
+    double integratedLoudness() const;
+
+    /// 真峰值（dBTP），全部为静音时为负无穷
+    double truePeak() const;
+
+    /// 已处理的帧数
+    int64_t frames() const;
+
+    /**
+     * @brief 把响度归一化到目标电平所需的线性增益
+     * 增益受真峰值上限约束，提升不超过 +12 dB，衰减不超过 -30 dB；
+     * 响度无效（静音或未分析）时返回 1.0
+     */
+    static float normalizationGain(double loudness, double truePeak,
+                                   double target = kTargetLoudness, double ceiling = kTruePeakCeiling);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace audio
+} // namespace media
+} // namespace modules
+} // namespace aurorastream
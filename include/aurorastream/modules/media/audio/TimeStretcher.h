@@ -0,0 +1,92 @@
+/********************************************************************************
+ * @file   : TimeStretcher.h
+ * @brief  : 声明 AuroraStream 音频时间伸缩（变速不变调）模块。
+ *
+ * 此文件定义了 aurorastream::modules::media::audio::TimeStretcher 类，
+ * 它基于 WSOLA（波形相似叠加）算法改变音频播放速度而保持音调不变，
+ * 位于解码和音频渲染器之间，用于 0.5x–2x 的用户变速以及直播追帧时的细微加速。
+ *
+ * 输入输出均为交错排列的 float 样本，支持任意声道数。
+ * 互相关搜索使用 SIMD（AVX/SSE2/NEON）实现；速率为 1.0 时直接透传，不引入延迟。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "../../../AuroraStream.h"
+
+namespace aurorastream {
+namespace modules {
+namespace media {
+namespace audio {
+
+class AURORASTREAM_API TimeStretcher {
+public:
+    // WSOLA 参数（毫秒）
+    struct Options {
+        int sequenceMs = 40;    // 每次拼接的片段长度
+        int overlapMs = 8;      // 片段之间交叉淡化的长度
+        int searchMs = 14;      // 寻找最佳拼接位置的搜索范围
+    };
+
+    TimeStretcher();
+    ~TimeStretcher();
+
+    TimeStretcher(const TimeStretcher&) = delete;
+    TimeStretcher& operator=(const TimeStretcher&) = delete;
+
+    /**
+     * @brief 初始化
+     * @param sampleRate 采样率
+     * @param channels 声道数
+     * @param options WSOLA 参数，缺省使用 Options 的默认值
+     * @return 参数有效返回 true
+     */
+    bool init(int sampleRate, int channels);
+    bool init(int sampleRate, int channels, const Options& options);
+
+    /**
+     * @brief 设置速率
+     * @param rate 速率，限制在 [0.25, 4.0]；1.0 时处于透传状态
+     */
+    void setRate(double rate);
+    double rate() const;
+
+    /// 当前是否处于透传状态（速率为 1.0 且内部没有残留样本）
+    bool isBypassed() const;
+
+    /**
+     * @brief 处理一段交错排列的样本
+     * @param input 输入样本
+     * @param frames 输入帧数（每帧包含 channels 个样本）
+     * @param output 输出样本追加到该缓冲
+     */
+    void process(const float* input, int frames, std::vector<float>& output);
+
+    /// 16 位整数样本版本，内部转换为 float 处理
+    void process(const int16_t* input, int frames, std::vector<int16_t>& output);
+
+    /// 输出内部残留的样本（结束或切回 1.0 时调用）
+    void flush(std::vector<float>& output);
+
+    /// 丢弃内部状态（跳转后调用）
+    void reset();
+
+    /// 非透传状态下引入的延迟（帧）
+    int latency() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace audio
+} // namespace media
+} // namespace modules
+} // namespace aurorastream
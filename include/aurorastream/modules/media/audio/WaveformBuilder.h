@@ -0,0 +1,151 @@
+/********************************************************************************
+ * @file   : WaveformBuilder.h
+ * @brief  : 声明 AuroraStream 音频波形概览（Waveform 和 WaveformBuilder）。
+ *
+ * WaveformBuilder 用 decoder::Decoder 流式解码音频流，把样本归约为固定帧数的
+ * 区间（bin），每个区间记录最小值、最大值和均方根；再像 mipmap 一样逐级两两合并，
+ * 得到多分辨率的层级。结果量化为每个区间 4 字节写入缓存目录下的二进制文件，
+ * 之后直接映射到内存，任意缩放级别都只需读取对应层级，不需要重新解码。
+ *
+ *  - 最小值/最大值/平方和的归约使用 SIMD（AVX/SSE2/NEON）实现，
+ *    解码器输出 float 平面格式时直接在解码缓冲区上归约，其他格式先经 swresample 转换；
+ *  - 时长已知且可跳转的文件按时间分段，各段在 TaskScheduler 上并行解码；
+ *  - 缓存键由文件大小、首中尾三段内容的摘要和参数组成，与 ThumbnailService 相同。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#pragma once
+
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "../../../AuroraStream.h"
+
+class QFile;
+
+namespace aurorastream {
+namespace modules {
+namespace media {
+namespace audio {
+
+struct WaveformHeader;
+struct WaveformLevel;
+
+/**
+ * @brief 量化后的区间：最小值、最大值映射到 [-127, 127]，均方根映射到 [0, 255]
+ */
+struct WaveformBin {
+    int8_t min;
+    int8_t max;
+    uint8_t rms;
+    uint8_t reserved;
+};
+
+/**
+ * @brief 映射到内存的只读波形概览
+ */
+class AURORASTREAM_API Waveform {
+public:
+    /**
+     * @brief 映射波形文件
+     * @return 文件不存在或格式不正确时返回 nullptr
+     */
+    static std::shared_ptr<const Waveform> map(const std::string& filePath);
+
+    ~Waveform();
+
+    Waveform(const Waveform&) = delete;
+    Waveform& operator=(const Waveform&) = delete;
+
+    int sampleRate() const;
+    int channels() const;
+    int64_t frames() const;             ///< 总帧数
+    int64_t duration() const;           ///< 时长（毫秒）
+
+    /// 层级数，第 0 层分辨率最高
+    int levelCount() const;
+
+    /// 第 level 层每个区间覆盖的帧数
+    int64_t binFrames(int level) const;
+
+    /// 第 level 层的区间数
+    int64_t binCount(int level) const;
+
+    /// 第 level 层的区间，层级无效时返回 nullptr
+    const WaveformBin* bins(int level) const;
+
+    /**
+     * @brief 把 [start, end) 毫秒的波形归约为 columns 列，用于绘制
+     * 选用每列至少覆盖一个区间的最粗层级，每列只需合并少量区间
+     */
+    std::vector<WaveformBin> peaks(int64_t start, int64_t end, int columns) const;
+
+private:
+    Waveform() = default;
+
+    std::unique_ptr<QFile> m_file;
+    const uint8_t* m_data {nullptr};
+    const WaveformHeader* m_header {nullptr};
+    const WaveformLevel* m_levels {nullptr};
+};
+
+/**
+ * @brief 波形参数，参与缓存键
+ */
+struct WaveformOptions {
+    int binFrames = 512;        ///< 第 0 层每个区间的帧数
+    int segmentSeconds = 300;   ///< 并行解码时每段的最短时长（秒）
+};
+
+class AURORASTREAM_API WaveformBuilder {
+public:
+    using Options = WaveformOptions;
+
+    /**
+     * @brief 统计
+     */
+    struct Statistics {
+        uint64_t built = 0;         ///< 解码生成的波形数
+        uint64_t cacheHits = 0;     ///< 磁盘缓存命中数
+        uint64_t frames = 0;        ///< 解码的音频帧数（每声道样本数）
+        uint64_t segments = 0;      ///< 并行解码的分段数
+    };
+
+    /// 进程内共享的实例，缓存目录位于应用缓存目录下的 waveforms/
+    static WaveformBuilder& instance();
+
+    /**
+     * @brief 构造函数
+     * @param directory 缓存目录，不存在时自动创建
+     */
+    explicit WaveformBuilder(const std::string& directory);
+
+    /**
+     * @brief 获取波形概览，缓存未命中时在当前线程解码生成（各分段在线程池上并行）
+     * @param path 本地媒体文件
+     * @param options 波形参数
+     * @return 文件没有可解码的音频流时返回 nullptr
+     */
+    std::shared_ptr<const Waveform> load(const std::string& path, const Options& options = Options());
+
+    /// 缓存目录
+    std::string directory() const;
+
+    Statistics getStatistics() const;
+
+private:
+    std::string m_directory;
+
+    mutable std::mutex m_mutex;
+    Statistics m_statistics;
+};
+
+} // namespace audio
+} // namespace media
+} // namespace modules
+} // namespace aurorastream
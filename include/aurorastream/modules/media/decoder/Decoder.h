@@ -24,6 +24,10 @@ extern "C" {
 }
 
 namespace aurorastream {
+namespace core {
+class MetricsScope;
+} // namespace core
+
 namespace modules {
 namespace media {
 namespace decoder {
@@ -81,6 +85,9 @@ public:
     // 硬件加速支持
     bool enableHardwareAcceleration(const std::string& deviceType = "auto");
 
+    // 把解码耗时记录到所属播放器的指标子注册表，为空时只记录到进程注册表
+    void setMetricsScope(std::shared_ptr<core::MetricsScope> scope);
+
     // 获取解码器统计信息
     struct Statistics {
         uint64_t framesDecoded;
@@ -1,13 +1,14 @@
 #pragma once
 
 #include <QObject>
-#include <thread>
 #include <atomic>
 #include <mutex>
 #include <QString>
-#include <QProperty>
+#include <QTimer>
 #include <memory>
 #include "aurorastream/AuroraStream.h"
+#include "aurorastream/core/MpscQueue.h"
+#include "aurorastream/core/TaskScheduler.h"
 #include "aurorastream/modules/media/decoder/Decoder.h"
 #include "aurorastream/modules/media/renderer/VideoRenderer.h"
 #include "aurorastream/modules/media/renderer/AudioRenderer.h"
@@ -31,6 +32,8 @@ class AURORASTREAM_API Player : public QObject
     Q_PROPERTY(State state READ state NOTIFY stateChanged)
     Q_PROPERTY(qint64 position READ position NOTIFY positionChanged)
     Q_PROPERTY(qint64 duration READ duration NOTIFY durationChanged)
+    Q_PROPERTY(double playbackRate READ playbackRate WRITE setPlaybackRate NOTIFY playbackRateChanged)
+    Q_PROPERTY(int notifyRate READ notifyRate WRITE setNotifyRate)
 
 public:
     enum class State {
@@ -47,23 +50,55 @@ public:
     explicit Player(QObject* parent = nullptr);
     ~Player() override;
 
+    /**
+     * @brief 状态快照，由播放管线原子地发布，任意线程都可以读取
+     */
+    struct Snapshot {
+        State state = State::Stopped;
+        qint64 position = 0;
+        qint64 duration = 0;
+        double rate = 1.0;
+    };
+
     // 播放控制
+    // open()/stop() 在调用线程同步执行；play()/pause()/seek()/setPlaybackRate()
+    // 只把命令放入队列，由播放管线按顺序执行，返回值表示命令是否被接受
     Q_INVOKABLE bool open(const QString& uri);
     Q_INVOKABLE bool play();
     Q_INVOKABLE bool pause();
     Q_INVOKABLE bool stop();
     Q_INVOKABLE bool seek(qint64 position);
+    Q_INVOKABLE bool setPlaybackRate(double rate);
 
-    // 状态访问
+    // 状态访问（线程安全）
+    Snapshot snapshot() const;
     State state() const;
     qint64 position() const;
     qint64 duration() const;
+    double playbackRate() const;
     QString currentUri() const;
 
+    /**
+     * @brief 设置 UI 通知频率
+     * 状态和位置的变化在 UI 线程上合并，按该频率最多通知一次
+     * @param hz 每秒通知次数，默认 30
+     */
+    void setNotifyRate(int hz);
+    int notifyRate() const;
+
+    /**
+     * @brief 启用或关闭响度归一化
+     * 启用时按媒体库中的响度分析结果为每个播放项设置归一化增益，
+     * 尚未分析的文件在打开时提交后台分析；默认启用，下一次 open() 时生效
+     */
+    void setLoudnessNormalization(bool enabled);
+    bool loudnessNormalization() const;
+
 signals:
     void stateChanged(State newState);
     void positionChanged(qint64 newPosition);
     void durationChanged(qint64 newDuration);
+    void playbackRateChanged(double rate);
     void error(const QString& error);
     void mediaOpened(const QString& uri);
     void finished();
@@ -71,10 +106,23 @@ signals:
     void audioFrameReady(const AudioFrame& frame);
 
 private:
-    QProperty<State> m_state;
-    QProperty<qint64> m_position;
-    QProperty<qint64> m_duration;
+    /**
+     * @brief 控制命令
+     */
+    struct Command {
+        enum class Type {
+            Play,
+            Pause,
+            Seek,
+            Rate
+        };
+        Type type = Type::Play;
+        qint64 position = 0;
+        double rate = 1.0;
+    };
+
     QString m_currentUri;
+    std::shared_ptr<core::MetricsScope> m_metricsScope;    ///< 本播放器的性能指标，快照中以 "player-N" 列出
     std::unique_ptr<decoder::Decoder> m_decoder;
     std::unique_ptr<renderer::VideoRenderer> m_videoRenderer;
     std::unique_ptr<renderer::AudioRenderer> m_audioRenderer;
@@ -83,12 +131,43 @@ private:
     std::unique_ptr<renderer::VideoRenderer> createVideoRenderer();
     std::unique_ptr<renderer::AudioRenderer> createAudioRenderer();
 
-    // 线程相关
-    std::thread m_decodeThread;
-    std::thread m_audioThread;
+    /// 根据媒体库中的响度为当前播放项设置归一化增益
+    void applyLoudnessNormalization(const QString& uri);
+    std::atomic<bool> m_loudnessNormalization {true};
+
+    // 播放管线：在共享线程池中执行，先处理命令，播放时再解码一批帧，然后重新提交自己
+    void postCommand(const Command& command);
+    void schedulePipeline();
+    void runPipeline();
+    void applyCommand(const Command& command);
+    void decodeBatch();
+
+    // 快照发布（顺序锁，同一时刻只有一个写者：管线任务，或管线停止时的调用线程）
+    void publish();
+    void flushNotifications();
+    void reportError(const QString& message);
+
+    core::MpscQueue<Command> m_commands;
+    std::atomic<int> m_pendingCommands {0};
+    std::atomic<bool> m_pipelineScheduled {false};
+    core::TaskGroup m_pipelineTasks;
+    int m_affinity {-1};                    ///< 线程池亲和提示，使同一播放器的任务留在同一工作线程
     std::atomic<bool> m_running {false};
     std::mutex m_mutex;
 
+    Snapshot m_working;                     ///< 管线的工作副本（仅写者访问）
+    std::atomic<uint32_t> m_snapshotSequence {0};
+    std::atomic<int> m_publishedState {static_cast<int>(State::Stopped)};
+    std::atomic<qint64> m_publishedPosition {0};
+    std::atomic<qint64> m_publishedDuration {0};
+    std::atomic<double> m_publishedRate {1.0};
+
+    // UI 通知（仅 UI 线程访问，m_pendingError 除外）
+    QTimer m_notifyTimer;
+    int m_notifyRate {30};
+    Snapshot m_notified;                    ///< 最近一次通知给 UI 的快照
+    QString m_pendingError;                 ///< 由 m_mutex 保护
+
     // SDL窗口相关
     void* m_sdlWindow {nullptr};
     void* m_sdlRenderer {nullptr};
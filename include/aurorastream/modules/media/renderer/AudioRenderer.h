@@ -15,6 +15,7 @@
 #define AURORASTREAM_MODULES_MEDIA_RENDERER_AUDIOOUTPUT_H
 
 #include <QObject>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 
@@ -39,6 +40,7 @@ class AURORASTREAM_API AudioRenderer : public QObject
     Q_PROPERTY(bool initialized READ isInitialized NOTIFY initializedChanged)
     Q_PROPERTY(float volume READ getVolume WRITE setVolume NOTIFY volumeChanged)
     Q_PROPERTY(bool muted READ isMute WRITE setMute NOTIFY muteChanged)
+    Q_PROPERTY(double playbackRate READ getPlaybackRate WRITE setPlaybackRate NOTIFY playbackRateChanged)
 
 public:
     enum class State {
@@ -106,20 +108,42 @@ public:
     virtual void setMute(bool mute);
     virtual bool isMute() const;
 
+    /**
+     * @brief 设置响度归一化增益（每个播放项一个）
+     * 与音量、静音合并为同一个输出增益，输出时每个样本只乘一次
+     * @param gain 线性增益，1.0 表示不调整
+     */
+    virtual void setNormalizationGain(float gain);
+    virtual float getNormalizationGain() const;
+
+    /**
+     * @brief 设置播放速率（变速不变调）
+     * @param rate 速率，1.0 为原速
+     */
+    virtual void setPlaybackRate(double rate);
+    virtual double getPlaybackRate() const;
+
 signals:
     void stateChanged(State newState);
     void errorOccurred(const QString& error);
     void positionChanged(int64_t position);
     void volumeChanged(float volume);
     void muteChanged(bool muted);
+    void playbackRateChanged(double rate);
     void initializedChanged(bool initialized);
 
 protected:
+    /// 重新计算合并后的输出增益
+    void updateOutputGain();
+
     int m_sampleRate {0};
     int m_channels {0};
     int m_format {0};
     float m_volume {1.0f};
     bool m_mute {false};
+    float m_normalizationGain {1.0f};
+    std::atomic<float> m_outputGain {1.0f};    ///< 音量 × 归一化增益，静音时为 0；由音频回调读取
+    double m_playbackRate {1.0};
     bool m_initialized {false};
     State m_state {State::Stopped};
 };
@@ -44,6 +44,9 @@ namespace media {
 namespace renderer {
 class VideoRenderer;
 }
+namespace audio {
+class Waveform;
+}
 }
 namespace ui {
 /**
@@ -145,6 +148,17 @@ private slots:
      */
     void onRtmpOpened(const QString& url);
 
+    /**
+     * @brief 录制按钮点击槽函数，开始或停止把当前流录制到文件
+     */
+    void onRecordClicked();
+
+    /**
+     * @brief 处理录制状态变化事件
+     * @param recording 是否正在录制
+     */
+    void onRecordingChanged(bool recording);
+
 protected:
     /**
      * @brief 重写 QWidget 的 paintEvent 方法，用于绘制视频内容。
@@ -170,6 +184,14 @@ protected:
      */
     void dropEvent(QDropEvent *event) override;
 
+    /**
+     * @brief 监听进度条的鼠标移动和离开事件，显示悬停预览。
+     * @param watched 被监听的对象。
+     * @param event 事件对象。
+     * @return 事件是否已被处理。
+     */
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private:
     /**
      * @brief 初始化窗口 UI。
@@ -201,6 +223,23 @@ private:
      */
     void updateButtons();
 
+    /**
+     * @brief 在进度条上方显示悬停位置的缩略图。
+     * @param x 鼠标在进度条中的横坐标。
+     */
+    void showSeekPreview(int x);
+
+    /**
+     * @brief 在后台生成或加载当前文件的波形概览，完成后重绘进度条。
+     * @param filePath 媒体文件路径。
+     */
+    void requestWaveform(const QString& filePath);
+
+    /**
+     * @brief 在进度条的滑槽下方绘制波形概览。
+     */
+    void paintWaveform();
+
     /**
      * @brief 格式化时间显示。
      * @param milliseconds 毫秒数。
@@ -218,11 +257,14 @@ private:
     QPushButton*       m_pauseButton;               ///< 暂停按钮
     QPushButton*       m_stopButton;                ///< 停止按钮
     QPushButton*       m_connectButton;             ///< RTMP连接按钮
+    QPushButton*       m_recordButton;              ///< 录制按钮
     QLineEdit*         m_rtmpUrlEdit;              ///< RTMP地址输入框
     QSlider*           m_seekSlider;                ///< 进度条
     QSlider*           m_volumeSlider;              ///< 音量条
     QLabel*           m_timeLabel;                 ///< 时间标签
     QLabel*           m_durationLabel;             ///< 时长标签
+    QLabel*           m_seekPreview;               ///< 进度条悬停预览
+    std::shared_ptr<const media::audio::Waveform> m_waveform; ///< 当前文件的波形概览
 
     qint64            m_duration;                  ///< 当前媒体总时长
     QWidget*          m_videoContainer;            ///< 视频显示容器
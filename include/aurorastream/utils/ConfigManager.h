@@ -1,42 +1,161 @@
 /********************************************************************************
- * @file   :
- * @brief  :
+ * @file   : ConfigManager.h
+ * @brief  : 声明 AuroraStream 配置管理模块。
  *
+ * 此文件定义了 aurorastream::utils::ConfigManager 和 ConfigSnapshot 类。
+ * 配置以不可变快照的形式发布：每次修改（set、load 或文件热加载）都复制当前
+ * 快照、应用修改后原子地替换，读取方不会等待写入方。整数、浮点和布尔值在生成快照时
+ * 解析一次，typed 访问器只做一次查找，不分配内存、不抛出异常。
+ *
+ * 每个线程缓存自己看到的快照，只有配置版本变化时才重新获取，因此热路径上的
+ * 读取只有一次原子读取和一次有序表查找。需要在多次读取之间保持一致，或者需要
+ * 无分配地读取字符串时，使用 snapshot()。
+ *
+ * subscribe() 注册变更回调；watch() 通过 inotify（其他平台按修改时间轮询）
+ * 监视配置文件，文件被写入或替换后自动重新加载。
  *
  * @author : polarours
  * @date   : 2025/08/29
  ********************************************************************************/
 
 #pragma once
+#include <map>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
 
 namespace aurorastream {
 namespace utils {
 
+/**
+ * @brief 某一时刻的完整配置，创建后不再修改
+ */
+class ConfigSnapshot {
+public:
+    struct Value {
+        std::string text;
+        bool isInt = false;
+        bool isDouble = false;
+        int64_t intValue = 0;
+        double doubleValue = 0.0;
+        bool boolValue = false;     // "true" 或 "1"
+    };
+
+    using Values = std::map<std::string, Value, std::less<>>;
+
+    /// 查找键，不存在时返回 nullptr
+    const Value* find(std::string_view key) const;
+
+    /// 返回的视图在快照存活期间有效
+    std::string_view get(std::string_view key, std::string_view defaultValue = {}) const;
+    int getInt(std::string_view key, int defaultValue = 0) const;
+    int64_t getInt64(std::string_view key, int64_t defaultValue = 0) const;
+    double getDouble(std::string_view key, double defaultValue = 0.0) const;
+    bool getBool(std::string_view key, bool defaultValue = false) const;
+
+    /// 快照版本，每次发布递增
+    uint64_t version() const { return version_; }
+    const Values& values() const { return values_; }
+
+private:
+    friend class ConfigManager;
+
+    Values values_;
+    uint64_t version_ = 0;
+};
+
 class ConfigManager {
 public:
+    /**
+     * @brief 配置变更回调
+     * 在发布新快照的线程上调用（set() 的调用者或文件监视线程），不持有任何锁
+     * @param key 发生变化的键（新增或修改）
+     * @param snapshot 包含该变化的快照
+     */
+    using ChangeCallback = std::function<void(const std::string& key, const ConfigSnapshot& snapshot)>;
+
     static ConfigManager& instance();
 
-    void load(const std::string& configPath);
-    void save(const std::string& configPath);
+    /**
+     * @brief 从文件加载配置并合并到当前配置
+     * 文件中的键覆盖现有值，文件中没有的键保持不变
+     * @return 文件无法打开时返回 false
+     */
+    bool load(const std::string& configPath);
+    bool save(const std::string& configPath);
+
+    /// 当前快照，持有期间内容不变
+    std::shared_ptr<const ConfigSnapshot> snapshot() const;
 
-    std::string get(const std::string& key, const std::string& defaultValue = "");
+    std::string get(std::string_view key, std::string_view defaultValue = {}) const;
     void set(const std::string& key, const std::string& value);
 
-    int getInt(const std::string& key, int defaultValue = 0);
+    /// 值缺失或不是整数时返回 defaultValue
+    int getInt(std::string_view key, int defaultValue = 0) const;
     void setInt(const std::string& key, int value);
 
-    bool getBool(const std::string& key, bool defaultValue = false);
+    double getDouble(std::string_view key, double defaultValue = 0.0) const;
+    void setDouble(const std::string& key, double value);
+
+    bool getBool(std::string_view key, bool defaultValue = false) const;
     void setBool(const std::string& key, bool value);
 
+    /**
+     * @brief 订阅配置变更
+     * @param key 只关心的键，空字符串表示所有键
+     * @return 订阅 ID，用于 unsubscribe()
+     */
+    int subscribe(const std::string& key, ChangeCallback callback);
+    void unsubscribe(int subscriptionId);
+
+    /**
+     * @brief 监视配置文件，文件变化后重新加载
+     * 监视所在目录，因此编辑器以“写临时文件再重命名”方式保存也能被发现
+     * @return 无法开始监视时返回 false
+     */
+    bool watch(const std::string& configPath);
+    void unwatch();
+
 private:
-    ConfigManager() = default;
-    std::unordered_map<std::string, std::string> configMap_;
-    std::mutex configMutex_;
+    struct Subscription {
+        int id;
+        std::string key;
+        ChangeCallback callback;
+    };
+
+    ConfigManager();
+    ~ConfigManager();
+
+    /// 当前线程缓存的快照，版本变化时刷新
+    const ConfigSnapshot& current() const;
+
+    void apply(ConfigSnapshot::Values&& updates);
+    void notify(const std::vector<std::string>& changedKeys, const ConfigSnapshot& snapshot);
+    void watchLoop(const std::string& configPath);
+
+    std::shared_ptr<const ConfigSnapshot> snapshot_;    // 通过 std::atomic_load/atomic_store 访问
+    std::atomic<uint64_t> version_ {0};
+    std::mutex writeMutex_;                             // 串行化写入方的“复制-修改-发布”
+
+    std::mutex subscribersMutex_;
+    std::vector<Subscription> subscribers_;
+    int nextSubscriptionId_ = 1;
+
+    std::mutex watchControlMutex_;                      // 串行化 watch() 和 unwatch()
+    std::thread watcher_;
+    std::mutex watchMutex_;                             // 保护 watchStopping_
+    std::condition_variable watchWakeup_;
+    bool watchStopping_ = false;
+    int watchFd_ = -1;                                  // inotify 描述符
+    int wakeFd_ = -1;                                   // 用于唤醒监视线程的 eventfd
 };
 
 } // namespace utils
-} // namespace aurorastream
\ No newline at end of file
+} // namespace aurorastream
@@ -1,8 +1,15 @@
 /********************************************************************************
- * @file   :
- * @brief  :
+ * @file   : Logger.h
+ * @brief  : 声明 AuroraStream 异步日志模块。
  *
+ * 此文件定义了 aurorastream::utils::Logger 类。每个写日志的线程拥有一个
+ * 无锁的单生产者环形缓冲区，log() 只把消息放入本线程的缓冲区；后台写线程
+ * 定期收集所有缓冲区中的消息，按时间顺序批量写入文件后统一刷新。
+ * 缓冲区写满时丢弃新消息并计数，写线程随后在日志中记录丢弃的数量。
  *
+ * 使用 AURORASTREAM_LOG_* 宏记录日志：级别低于编译期下限
+ * （AURORASTREAM_LOG_MIN_LEVEL，Release 构建默认为 INFO）的调用在编译期被移除，
+ * 低于运行期级别的调用只做一次原子读取，不会格式化参数。
  *
  * @author : polarours
  * @date   : 2025/08/29
@@ -15,6 +22,21 @@
 #include <fstream>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <sstream>
+#include <cstdint>
+#include <condition_variable>
+
+// 编译期日志级别下限：0 DEBUG，1 INFO，2 WARNING，3 ERROR，4 CRITICAL
+#ifndef AURORASTREAM_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define AURORASTREAM_LOG_MIN_LEVEL 1
+#else
+#define AURORASTREAM_LOG_MIN_LEVEL 0
+#endif
+#endif
 
 namespace aurorastream {
 namespace utils {
@@ -31,9 +53,38 @@ class Logger {
 public:
     static Logger& instance();
 
+    /**
+     * @brief 打开日志文件并启动后台写线程
+     * @param logFilePath 日志文件路径（追加写入）
+     */
     void init(const std::string& logFilePath);
+
+    /**
+     * @brief 停止后台写线程，写出所有剩余消息并关闭文件
+     */
+    void shutdown();
+
+    /**
+     * @brief 记录一条消息
+     * 只把消息放入当前线程的缓冲区，不做 I/O；缓冲区已满时丢弃
+     */
     void log(LogLevel level, const std::string& message);
 
+    /// 设置运行期级别，低于该级别的消息被忽略
+    void setLevel(LogLevel level);
+    LogLevel level() const;
+
+    /// 指定级别当前是否需要记录
+    bool isEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
+    }
+
+    /// 等待当前已提交的消息全部写入文件
+    void flush();
+
+    /// 因缓冲区满而丢弃的消息总数
+    uint64_t droppedCount() const;
+
     // 便捷方法
     void debug(const std::string& msg);
     void info(const std::string& msg);
@@ -42,13 +93,62 @@ public:
     void critical(const std::string& msg);
 
 private:
+    struct Record {
+        LogLevel level = LogLevel::INFO;
+        int64_t timestamp = 0;      // 微秒，系统时钟
+        uint64_t sequence = 0;      // 全局序号，用于合并各线程的消息
+        std::string message;
+    };
+    class Ring;
+
     Logger() = default;
-    std::ofstream logFile_;
-    std::mutex logMutex_;
+    ~Logger();
+
+    Ring* threadRing();
+    void writerLoop();
+    std::size_t drain(std::vector<Record>& batch);
+    void writeBatch(std::vector<Record>& batch);
     std::string getLevelString(LogLevel level);
+
+    std::ofstream logFile_;
+    std::mutex logMutex_;                           // 保护 rings_ 和写线程的启停
+    std::vector<std::shared_ptr<Ring>> rings_;
+    std::thread writer_;
+    std::condition_variable wakeup_;
+    std::condition_variable flushed_;
+    bool stopping_ = false;
+    std::atomic<bool> running_ {false};
+    std::atomic<bool> drainRequested_ {false};      // 有缓冲区过半，请求写线程提前收集
+    uint64_t flushRequests_ = 0;
+    uint64_t flushDone_ = 0;
+
+    std::atomic<int> level_ {AURORASTREAM_LOG_MIN_LEVEL};
+    std::atomic<uint64_t> sequence_ {0};
+    std::atomic<uint64_t> dropped_ {0};
+    uint64_t droppedReported_ = 0;
 };
 
 } // namespace utils
 } // namespace aurorastream
 
-#endif
\ No newline at end of file
+/**
+ * 日志宏：参数以流的形式拼接，只有需要记录时才会求值和格式化，例如
+ * AURORASTREAM_LOG_DEBUG("Decoded frame pts=" << frame->pts);
+ */
+#define AURORASTREAM_LOG(levelValue, stream)                                                        \
+    do {                                                                                            \
+        if (static_cast<int>(levelValue) >= AURORASTREAM_LOG_MIN_LEVEL                              \
+            && ::aurorastream::utils::Logger::instance().isEnabled(levelValue)) {                   \
+            std::ostringstream auroraLogStream_;                                                    \
+            auroraLogStream_ << stream;                                                             \
+            ::aurorastream::utils::Logger::instance().log(levelValue, auroraLogStream_.str());      \
+        }                                                                                           \
+    } while (0)
+
+#define AURORASTREAM_LOG_DEBUG(stream) AURORASTREAM_LOG(::aurorastream::utils::LogLevel::DEBUG, stream)
+#define AURORASTREAM_LOG_INFO(stream) AURORASTREAM_LOG(::aurorastream::utils::LogLevel::INFO, stream)
+#define AURORASTREAM_LOG_WARNING(stream) AURORASTREAM_LOG(::aurorastream::utils::LogLevel::WARNING, stream)
+#define AURORASTREAM_LOG_ERROR(stream) AURORASTREAM_LOG(::aurorastream::utils::LogLevel::ERROR, stream)
+#define AURORASTREAM_LOG_CRITICAL(stream) AURORASTREAM_LOG(::aurorastream::utils::LogLevel::CRITICAL, stream)
+
+#endif
@@ -0,0 +1,129 @@
+/********************************************************************************
+ * @file   : Tracer.h
+ * @brief  : 声明 AuroraStream 跟踪事件记录模块。
+ *
+ * 此文件定义了 aurorastream::utils::Tracer 类和 AURORASTREAM_TRACE_SCOPE 宏，
+ * 用于记录播放管线各阶段（解复用、解码、转换、上传、呈现、音频回调）的耗时区间。
+ *
+ * 每个线程拥有一个固定容量的环形缓冲区，只保留最近的事件（飞行记录器），
+ * 记录时不加锁、不分配内存。exportJson() 把所有线程的事件导出为
+ * Chrome trace-event JSON，可以直接用 Perfetto（ui.perfetto.dev）或
+ * chrome://tracing 打开。
+ *
+ * 跟踪在运行期开关；关闭时每个跟踪点只有一次原子读取和一个分支。
+ * aurorastream-cli 用 --trace=文件 记录整个命令；图形界面在设置 AURORASTREAM_TRACE=文件
+ * 时启动即记录，Ctrl+Shift+T 开关记录，关闭或退出时导出。
+ * 定义 AURORASTREAM_DISABLE_TRACING 可以在编译期移除所有跟踪点。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_UTILS_TRACER_H
+#define AURORASTREAM_UTILS_TRACER_H
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+namespace aurorastream {
+namespace utils {
+
+class Tracer {
+public:
+    static Tracer& instance();
+
+    /// 跟踪是否开启（热路径上只调用这一项）
+    static bool isEnabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /// 开始记录
+    void start();
+
+    /// 停止记录，已记录的事件保留到 clear() 或被新事件覆盖
+    void stop();
+
+    /// 丢弃所有已记录的事件，并释放已退出线程的缓冲区
+    void clear();
+
+    /**
+     * @brief 导出为 Chrome trace-event JSON
+     * 导出期间暂停记录，完成后恢复原来的开关状态；已退出线程的缓冲区导出后释放
+     * @param filePath 输出文件路径
+     * @return 写入成功返回 true
+     */
+    bool exportJson(const std::string& filePath);
+
+    /// 为当前线程命名，显示在跟踪视图的线程轨道上
+    static void setThreadName(const std::string& name);
+
+    /// 当前单调时钟时间（微秒）
+    static int64_t now();
+
+    /**
+     * @brief 记录一个已完成的区间
+     * @param name 区间名，必须是静态字符串
+     * @param category 分类，必须是静态字符串
+     */
+    void record(const char* name, const char* category, int64_t start, int64_t end);
+
+private:
+    class Buffer;
+
+    Tracer() = default;
+    Buffer* threadBuffer();
+    void removeFinishedLocked();
+
+    static std::atomic<bool> enabled_;
+
+    std::mutex mutex_;                                  // 保护 buffers_
+    std::vector<std::shared_ptr<Buffer>> buffers_;
+    std::atomic<int> nextThreadId_ {1};
+};
+
+/**
+ * @brief 作用域跟踪区间：构造时记录开始时间，析构时记录区间
+ */
+class TraceScope {
+public:
+    TraceScope(const char* name, const char* category)
+        : name_(Tracer::isEnabled() ? name : nullptr)
+        , category_(category)
+        , start_(name_ ? Tracer::now() : 0)
+    {
+    }
+
+    ~TraceScope() {
+        if (name_) {
+            Tracer::instance().record(name_, category_, start_, Tracer::now());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    const char* category_;
+    int64_t start_;
+};
+
+} // namespace utils
+} // namespace aurorastream
+
+#define AURORASTREAM_TRACE_CONCAT_INNER(a, b) a##b
+#define AURORASTREAM_TRACE_CONCAT(a, b) AURORASTREAM_TRACE_CONCAT_INNER(a, b)
+
+#ifdef AURORASTREAM_DISABLE_TRACING
+#define AURORASTREAM_TRACE_SCOPE(name, category) do {} while (0)
+#else
+/// 在当前作用域记录一个区间，例如 AURORASTREAM_TRACE_SCOPE("decode.send", "decode");
+#define AURORASTREAM_TRACE_SCOPE(name, category) \
+    ::aurorastream::utils::TraceScope AURORASTREAM_TRACE_CONCAT(auroraTraceScope_, __LINE__)(name, category)
+#endif
+
+#endif // AURORASTREAM_UTILS_TRACER_H
@@ -0,0 +1,211 @@
+/********************************************************************************
+ * @file   : BenchDecodeCommand.cpp
+ * @brief  : 实现 aurorastream-cli bench-decode 子命令。
+ *
+ * 先把所选流的前 N 个数据包读入内存，再对每个线程数分别新建解码器，从内存解码
+ * 同一组数据包，因此结果不含磁盘 I/O 和解复用的时间。单帧耗时是相邻两次输出帧
+ * 之间的时间，反映解码管线的吞吐抖动；帧线程解码的首帧延迟计入第一帧。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "Commands.h"
+
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <algorithm>
+
+#include <QtCore/QFileInfo>
+
+#include "aurorastream/core/ProbeCache.h"
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+}
+
+namespace aurorastream {
+namespace cli {
+
+namespace {
+
+struct RunResult {
+    int threads = 0;
+    int frames = 0;
+    double seconds = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+std::vector<int> parseThreadCounts(const std::string& text)
+{
+    std::vector<int> counts;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        const int count = std::atoi(item.c_str());
+        if (count > 0) {
+            counts.push_back(count);
+        }
+    }
+    return counts;
+}
+
+/**
+ * @brief 用指定线程数解码内存中的数据包
+ * @return 成功返回 true
+ */
+bool decodeRun(const AVStream* stream, const std::vector<AVPacket*>& packets, int threads, RunResult& result)
+{
+    const AVCodec* codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    AVCodecContext* context = codec ? avcodec_alloc_context3(codec) : nullptr;
+    if (!context) {
+        return false;
+    }
+    context->thread_count = threads;
+    context->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    if (avcodec_parameters_to_context(context, stream->codecpar) < 0 || avcodec_open2(context, codec, nullptr) < 0) {
+        avcodec_free_context(&context);
+        return false;
+    }
+
+    AVFrame* frame = av_frame_alloc();
+    std::vector<double> latencies;
+    latencies.reserve(packets.size());
+
+    const double start = now();
+    double last = start;
+    auto drain = [&]() {
+        while (avcodec_receive_frame(context, frame) >= 0) {
+            const double current = now();
+            latencies.push_back((current - last) * 1000.0);
+            last = current;
+            av_frame_unref(frame);
+        }
+    };
+    for (AVPacket* packet : packets) {
+        if (avcodec_send_packet(context, packet) == AVERROR(EAGAIN)) {
+            drain();
+            avcodec_send_packet(context, packet);
+        }
+        drain();
+    }
+    avcodec_send_packet(context, nullptr);
+    drain();
+
+    result.threads = threads;
+    result.frames = static_cast<int>(latencies.size());
+    result.seconds = now() - start;
+    result.p50 = percentile(latencies, 0.50);
+    result.p95 = percentile(latencies, 0.95);
+    result.p99 = percentile(latencies, 0.99);
+    result.max = latencies.empty() ? 0.0 : latencies.back();
+
+    av_frame_free(&frame);
+    avcodec_free_context(&context);
+    return true;
+}
+
+} // namespace
+
+int runBenchDecode(const Arguments& arguments)
+{
+    if (arguments.positional().size() != 1) {
+        std::fprintf(stderr, "bench-decode: exactly one input file expected\n");
+        return 2;
+    }
+    const std::string path = arguments.positional().front();
+    const int maxPackets = std::max(1, arguments.intValue("frames", 500));
+    const bool json = arguments.has("json");
+    const AVMediaType type = arguments.has("audio") ? AVMEDIA_TYPE_AUDIO : AVMEDIA_TYPE_VIDEO;
+
+    std::vector<int> threadCounts = parseThreadCounts(arguments.value("threads"));
+    if (threadCounts.empty()) {
+        const int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        for (int count = 1; count < cores; count *= 2) {
+            threadCounts.push_back(count);
+        }
+        threadCounts.push_back(cores);
+    }
+
+    // 与 MediaSource 相同，缓存按绝对路径查找，命令行中的相对路径也能命中 probe / play 写入的条目
+    const std::string cachePath = QFileInfo(QString::fromStdString(path)).absoluteFilePath().toStdString();
+    AVFormatContext* formatContext = nullptr;
+    if (avformat_open_input(&formatContext, path.c_str(), nullptr, nullptr) < 0
+        || (!core::ProbeCache::instance().restore(cachePath, formatContext)
+            && avformat_find_stream_info(formatContext, nullptr) < 0)) {
+        std::fprintf(stderr, "bench-decode: could not open %s\n", path.c_str());
+        avformat_close_input(&formatContext);
+        return 1;
+    }
+    const int streamIndex = av_find_best_stream(formatContext, type, -1, -1, nullptr, 0);
+    if (streamIndex < 0) {
+        std::fprintf(stderr, "bench-decode: no %s stream in %s\n", av_get_media_type_string(type), path.c_str());
+        avformat_close_input(&formatContext);
+        return 1;
+    }
+
+    // 预读数据包，基准只测量解码
+    std::vector<AVPacket*> packets;
+    AVPacket* packet = av_packet_alloc();
+    while (static_cast<int>(packets.size()) < maxPackets && av_read_frame(formatContext, packet) >= 0) {
+        if (packet->stream_index == streamIndex) {
+            packets.push_back(av_packet_clone(packet));
+        }
+        av_packet_unref(packet);
+    }
+    av_packet_free(&packet);
+
+    const AVStream* stream = formatContext->streams[streamIndex];
+    std::vector<RunResult> results;
+    for (int threads : threadCounts) {
+        RunResult result;
+        if (!decodeRun(stream, packets, threads, result)) {
+            std::fprintf(stderr, "bench-decode: could not open %s decoder\n", avcodec_get_name(stream->codecpar->codec_id));
+            break;
+        }
+        results.push_back(result);
+    }
+
+    const std::string codecName = avcodec_get_name(stream->codecpar->codec_id);
+    for (AVPacket*& buffered : packets) {
+        av_packet_free(&buffered);
+    }
+    avformat_close_input(&formatContext);
+    if (results.empty()) {
+        return 1;
+    }
+
+    const double baseline = results.front().seconds > 0 ? results.front().frames / results.front().seconds : 0.0;
+    if (json) {
+        std::printf("{\"path\":%s,\"codec\":%s,\"packets\":%zu,\"runs\":[",
+                    jsonString(path).c_str(), jsonString(codecName).c_str(), packets.size());
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const RunResult& r = results[i];
+            const double fps = r.seconds > 0 ? r.frames / r.seconds : 0.0;
+            std::printf("%s{\"threads\":%d,\"frames\":%d,\"seconds\":%.4f,\"fps\":%.2f,\"scaling\":%.3f,"
+                        "\"latency_ms\":{\"p50\":%.3f,\"p95\":%.3f,\"p99\":%.3f,\"max\":%.3f}}",
+                        i ? "," : "", r.threads, r.frames, r.seconds, fps, baseline > 0 ? fps / baseline : 0.0,
+                        r.p50, r.p95, r.p99, r.max);
+        }
+        std::printf("]}\n");
+        return 0;
+    }
+
+    std::printf("%s: %s, %zu packets\n", path.c_str(), codecName.c_str(), packets.size());
+    std::printf("%8s %8s %10s %8s %9s %9s %9s %9s\n", "threads", "frames", "fps", "scaling", "p50 ms", "p95 ms", "p99 ms", "max ms");
+    for (const RunResult& r : results) {
+        const double fps = r.seconds > 0 ? r.frames / r.seconds : 0.0;
+        std::printf("%8d %8d %10.1f %7.2fx %9.3f %9.3f %9.3f %9.3f\n",
+                    r.threads, r.frames, fps, baseline > 0 ? fps / baseline : 0.0, r.p50, r.p95, r.p99, r.max);
+    }
+    return 0;
+}
+
+} // namespace cli
+} // namespace aurorastream
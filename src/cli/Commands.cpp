@@ -0,0 +1,103 @@
+/********************************************************************************
+ * @file   : Commands.cpp
+ * @brief  : 实现 aurorastream-cli 的参数解析和输出辅助函数。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "Commands.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace aurorastream {
+namespace cli {
+
+Arguments::Arguments(int argc, char* argv[], int first)
+{
+    bool optionsEnded = false;
+    for (int i = first; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (optionsEnded || argument.size() < 3 || argument.compare(0, 2, "--") != 0) {
+            m_positional.push_back(argument);
+        } else if (argument == "--") {
+            optionsEnded = true;
+        } else {
+            const std::size_t equals = argument.find('=');
+            if (equals == std::string::npos) {
+                m_options[argument.substr(2)] = std::string();
+            } else {
+                m_options[argument.substr(2, equals - 2)] = argument.substr(equals + 1);
+            }
+        }
+    }
+}
+
+bool Arguments::has(const std::string& name) const
+{
+    return m_options.count(name) > 0;
+}
+
+std::string Arguments::value(const std::string& name, const std::string& defaultValue) const
+{
+    auto it = m_options.find(name);
+    return it != m_options.end() && !it->second.empty() ? it->second : defaultValue;
+}
+
+int Arguments::intValue(const std::string& name, int defaultValue) const
+{
+    const std::string text = value(name);
+    return text.empty() ? defaultValue : std::atoi(text.c_str());
+}
+
+double Arguments::doubleValue(const std::string& name, double defaultValue) const
+{
+    const std::string text = value(name);
+    return text.empty() ? defaultValue : std::atof(text.c_str());
+}
+
+std::string jsonString(const std::string& text)
+{
+    std::ostringstream out;
+    out << '"';
+    for (unsigned char c : text) {
+        switch (c) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                        << std::dec << std::setfill(' ');
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+double percentile(std::vector<double>& samples, double quantile)
+{
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::sort(samples.begin(), samples.end());
+    const std::size_t index = std::min(samples.size() - 1, static_cast<std::size_t>(quantile * samples.size()));
+    return samples[index];
+}
+
+double now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace cli
+} // namespace aurorastream
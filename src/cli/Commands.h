@@ -0,0 +1,65 @@
+/********************************************************************************
+ * @file   : Commands.h
+ * @brief  : 声明 aurorastream-cli 的参数解析、JSON 输出辅助函数和各子命令。
+ *
+ * 命令行工具只链接 CoreModule、MediaModule 和 UtilsModule，不依赖 Qt Widgets
+ * 和显示设备，用于在服务器上批量探测、测量解码性能和无头播放。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CLI_COMMANDS_H
+#define AURORASTREAM_CLI_COMMANDS_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace aurorastream {
+namespace cli {
+
+/**
+ * @brief 子命令参数：--name=value 或 --flag 形式的选项，其余为位置参数
+ */
+class Arguments
+{
+public:
+    Arguments(int argc, char* argv[], int first);
+
+    bool has(const std::string& name) const;
+    std::string value(const std::string& name, const std::string& defaultValue = std::string()) const;
+    int intValue(const std::string& name, int defaultValue) const;
+    double doubleValue(const std::string& name, double defaultValue) const;
+
+    const std::vector<std::string>& positional() const { return m_positional; }
+
+private:
+    std::map<std::string, std::string> m_options;
+    std::vector<std::string> m_positional;
+};
+
+/// 转义为 JSON 字符串字面量（含引号）
+std::string jsonString(const std::string& text);
+
+/// 排序后取分位数，samples 为空时返回 0
+double percentile(std::vector<double>& samples, double quantile);
+
+/// 当前单调时钟时间（秒）
+double now();
+
+int runProbe(const Arguments& arguments);
+int runBenchDecode(const Arguments& arguments);
+int runPlay(const Arguments& arguments);
+int runIndex(const Arguments& arguments);
+int runScan(const Arguments& arguments);
+int runThumbnails(const Arguments& arguments);
+int runWaveform(const Arguments& arguments);
+int runLoudness(const Arguments& arguments);
+int runUdpSend(const Arguments& arguments);
+
+} // namespace cli
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CLI_COMMANDS_H
@@ -0,0 +1,48 @@
+/********************************************************************************
+ * @file   : IndexCommand.cpp
+ * @brief  : 实现 aurorastream-cli index 子命令。
+ *
+ * 为每个文件扫描一遍数据包，把关键帧位置写入 SeekIndex 缓存。之后 MediaSource
+ * 打开同一文件时直接加载索引，跳转、倒放和快速浏览不再依赖容器自带的索引。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "Commands.h"
+
+#include <cstdio>
+
+#include "aurorastream/core/SeekIndex.h"
+
+namespace aurorastream {
+namespace cli {
+
+int runIndex(const Arguments& arguments)
+{
+    const std::vector<std::string>& files = arguments.positional();
+    if (files.empty()) {
+        std::fprintf(stderr, "index: no input files\n");
+        return 2;
+    }
+
+    int failures = 0;
+    for (const std::string& path : files) {
+        const double start = now();
+        core::SeekIndex::BuildResult result;
+        if (!core::SeekIndex::instance().build(path, &result)) {
+            std::fprintf(stderr, "index: could not index %s\n", path.c_str());
+            ++failures;
+            continue;
+        }
+        std::printf("%s: %zu keyframes in stream %d (%lld packets, %.1f MiB) in %.1f ms\n",
+                    path.c_str(), result.keyframes, result.streamIndex,
+                    static_cast<long long>(result.packets), result.bytes / (1024.0 * 1024.0),
+                    (now() - start) * 1000.0);
+    }
+    std::printf("index: written to %s\n", core::SeekIndex::instance().directory().c_str());
+    return failures ? 1 : 0;
+}
+
+} // namespace cli
+} // namespace aurorastream
@@ -0,0 +1,79 @@
+/********************************************************************************
+ * @file   : LoudnessCommand.cpp
+ * @brief  : 实现 aurorastream-cli loudness 子命令。
+ *
+ * 给定文件时逐个测量 EBU R128 综合响度和真峰值，输出归一化增益和分析速度
+ * （音频时长 / 耗时）；--library 时在后台并行分析媒体库中所有尚未分析的文件，
+ * 结果写入媒体库，供播放时的响度归一化使用。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "Commands.h"
+
+#include <cmath>
+#include <memory>
+#include <cstdio>
+
+#include "aurorastream/core/MediaLibrary.h"
+#include "aurorastream/modules/media/audio/LoudnessMeter.h"
+#include "aurorastream/modules/media/audio/LoudnessAnalyzer.h"
+
+namespace aurorastream {
+namespace cli {
+
+using modules::media::audio::LoudnessMeter;
+using modules::media::audio::LoudnessAnalyzer;
+
+int runLoudness(const Arguments& arguments)
+{
+    const std::vector<std::string>& files = arguments.positional();
+    if (arguments.has("library")) {
+        std::unique_ptr<core::MediaLibrary> ownLibrary;
+        if (arguments.has("database")) {
+            ownLibrary = std::make_unique<core::MediaLibrary>(arguments.value("database"));
+        }
+        core::MediaLibrary& library = ownLibrary ? *ownLibrary : core::MediaLibrary::instance();
+        if (!library.isOpen()) {
+            std::fprintf(stderr, "loudness: could not open %s\n", library.databasePath().c_str());
+            return 1;
+        }
+
+        LoudnessAnalyzer analyzer(library);
+        const double start = now();
+        const int submitted = analyzer.analyzeLibrary();
+        analyzer.wait();
+        const double elapsed = now() - start;
+        const LoudnessAnalyzer::Statistics s = analyzer.getStatistics();
+        std::printf("loudness: %d files submitted, %llu analyzed, %llu failed, %.0f s of audio in %.2f s "
+                    "(%.0fx realtime)\n",
+                    submitted, static_cast<unsigned long long>(s.analyzed), static_cast<unsigned long long>(s.failed),
+                    s.audioSeconds, elapsed, elapsed > 0.0 ? s.audioSeconds / elapsed : 0.0);
+        return s.failed ? 1 : 0;
+    }
+
+    if (files.empty()) {
+        std::fprintf(stderr, "loudness: no input files\n");
+        return 2;
+    }
+    int failures = 0;
+    for (const std::string& path : files) {
+        const double start = now();
+        LoudnessAnalyzer::Result result;
+        if (!LoudnessAnalyzer::analyze(path, &result)) {
+            std::fprintf(stderr, "loudness: could not analyze %s\n", path.c_str());
+            ++failures;
+            continue;
+        }
+        const double elapsed = now() - start;
+        const double seconds = result.sampleRate > 0 ? static_cast<double>(result.frames) / result.sampleRate : 0.0;
+        const double gain = 20.0 * std::log10(LoudnessMeter::normalizationGain(result.loudness, result.truePeak));
+        std::printf("%s: %.1f LUFS, %.1f dBTP, gain %+.1f dB (%.0f s in %.2f s, %.0fx realtime)\n", path.c_str(),
+                    result.loudness, result.truePeak, gain, seconds, elapsed, elapsed > 0.0 ? seconds / elapsed : 0.0);
+    }
+    return failures ? 1 : 0;
+}
+
+} // namespace cli
+} // namespace aurorastream
@@ -0,0 +1,355 @@
+/********************************************************************************
+ * @file   : PlayCommand.cpp
+ * @brief  : 实现 aurorastream-cli play 子命令。
+ *
+ * 用 MediaSource 打开并解码媒体，把帧交给无头输出（见 Sinks.h）。默认尽快解码，
+ * --realtime 时按帧的显示时间戳节奏输出，用于模拟真实播放的负载。
+ * --record 时同时把读到的数据包原样录制到文件（见 StreamRecorder）；
+ * --restream 时同时通过 HLS / HTTP-TS 转发给本地客户端（见 RestreamServer），
+ * 可配合 --realtime 在回环地址上测试多个客户端。
+ * 输入为 HLS / DASH 清单时使用自适应码率客户端（见 AdaptiveStream），--quality 固定档位，
+ * 结束时输出启动时间、卡顿比例和平均码率。
+ * 输入为 udp:// 或 rtp:// 时批量接收（见 UdpIngest），结束时输出包速率、丢包和到达抖动，
+ * rtp:// 另输出抖动缓冲的重排、迟到丢包和播放延迟；可配合 udp-send 在回环地址上测试。
+ *
+ * 给出 --loop、--loop-range、--rate、--start 或 --step 时经 MediaPlayer::readFrame 读取
+ * 播放时间线：循环（LoopEngine）、负速率倒放（ReverseEngine）、超过 2 倍速的关键帧
+ * 快进（TrickPlayEngine），--step 用缓存逐帧前进再后退；--realtime 按 |rate| 换算节奏。
+ * 多个输入时经 PlaylistEngine 无缝连续播放，--crossfade 设置交叉淡化，--loop 循环整个列表。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "Commands.h"
+#include "Sinks.h"
+
+#include <cmath>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <functional>
+
+#include <QtCore/QStringList>
+
+#include "aurorastream/core/MediaSource.h"
+#include "aurorastream/core/MediaPlayer.h"
+#include "aurorastream/core/PlaylistEngine.h"
+#include "aurorastream/core/AdaptiveStream.h"
+#include "aurorastream/core/UdpIngest.h"
+#include "aurorastream/core/StreamRecorder.h"
+#include "aurorastream/core/RestreamServer.h"
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/error.h>
+}
+
+namespace aurorastream {
+namespace cli {
+
+int runPlay(const Arguments& arguments)
+{
+    const std::vector<std::string>& inputs = arguments.positional();
+    if (inputs.empty()) {
+        std::fprintf(stderr, "play: at least one input file expected\n");
+        return 2;
+    }
+    const std::string path = inputs.front();
+    const std::string sinkName = arguments.value("sink", "null");
+    const bool realtime = arguments.has("realtime");
+    const double maxDuration = arguments.doubleValue("duration", 0.0);
+    const double rate = arguments.doubleValue("rate", 1.0);
+    const int steps = arguments.intValue("step", 0);
+
+    // 多个输入走播放列表；循环、变速、倒放和逐帧走 MediaPlayer 的播放时间线
+    const bool usePlaylist = inputs.size() > 1;
+    const bool usePlayer = !usePlaylist
+        && (arguments.has("loop") || arguments.has("loop-range") || arguments.has("rate")
+            || arguments.has("start") || steps > 0);
+    if (usePlaylist && (arguments.has("record") || arguments.has("restream") || arguments.has("rate")
+                        || arguments.has("start") || arguments.has("step") || arguments.has("loop-range"))) {
+        std::fprintf(stderr, "play: --record, --restream, --rate, --start, --step and --loop-range need a single input\n");
+        return 2;
+    }
+    if (rate == 0.0 || !std::isfinite(rate) || steps < 0) {
+        std::fprintf(stderr, "play: --rate must be non-zero and --step non-negative\n");
+        return 2;
+    }
+
+    std::unique_ptr<FrameSink> sink = FrameSink::create(sinkName, arguments.value("output", "-"));
+    if (!sink) {
+        std::fprintf(stderr, "play: unknown sink %s\n", sinkName.c_str());
+        return 2;
+    }
+
+    core::MediaSource::Options sourceOptions;
+    const std::string quality = arguments.value("quality", "auto");
+    if (quality == "low") {
+        sourceOptions.quality = QualityLevel::LOW;
+    } else if (quality == "medium") {
+        sourceOptions.quality = QualityLevel::MEDIUM;
+    } else if (quality == "high") {
+        sourceOptions.quality = QualityLevel::HIGH;
+    } else if (quality == "uhd") {
+        sourceOptions.quality = QualityLevel::ULTRA_HD;
+    } else if (quality != "auto") {
+        std::fprintf(stderr, "play: unknown quality %s\n", quality.c_str());
+        return 2;
+    }
+
+    QString errorMessage;
+    const double openStart = now();
+    std::unique_ptr<core::MediaSource> ownedSource;
+    std::unique_ptr<core::MediaPlayer> player;
+    std::unique_ptr<core::PlaylistEngine> playlist;
+    core::MediaSource* source = nullptr;
+    std::function<int(AVFrame*, AVMediaType*)> read;
+    std::vector<double> forwardSteps;
+    std::vector<double> backwardSteps;
+
+    if (usePlaylist) {
+        playlist = std::make_unique<core::PlaylistEngine>();
+        QObject::connect(playlist.get(), &core::PlaylistEngine::error,
+                         [&errorMessage](const QString& message) { errorMessage = message; });
+        core::PlaylistEngine::Options playlistOptions;
+        playlistOptions.crossfade = arguments.intValue("crossfade", 0);
+        playlistOptions.loop = arguments.has("loop");
+        playlistOptions.sourceOptions = sourceOptions;
+        playlist->setOptions(playlistOptions);
+        QStringList items;
+        for (const std::string& input : inputs) {
+            items.append(QString::fromStdString(input));
+        }
+        playlist->setItems(items);
+        if (!playlist->start()) {
+            std::fprintf(stderr, "play: could not start playlist: %s\n", errorMessage.toLocal8Bit().constData());
+            return 1;
+        }
+        source = playlist->currentSource();
+        read = [&playlist](AVFrame* frame, AVMediaType* type) { return playlist->readFrame(frame, type); };
+    } else if (usePlayer) {
+        player = std::make_unique<core::MediaPlayer>();
+        QObject::connect(player.get(), &core::MediaPlayer::error,
+                         [&errorMessage](const QString& message) { errorMessage = message; });
+        player->setQualityLevel(sourceOptions.quality);
+        bool ok = player->setSource(QString::fromStdString(path));
+        if (ok && arguments.has("loop-range")) {
+            long long rangeStart = 0;
+            long long rangeEnd = 0;
+            ok = std::sscanf(arguments.value("loop-range").c_str(), "%lld,%lld", &rangeStart, &rangeEnd) == 2
+                 && player->setLoopRange(rangeStart, rangeEnd);
+        }
+        if (ok && arguments.has("loop")) {
+            player->setLoop(true);
+        }
+        if (ok && arguments.has("start")) {
+            player->seek(arguments.intValue("start", 0));
+        }
+        ok = ok && player->setPlaybackRate(rate);
+        if (!ok) {
+            std::fprintf(stderr, "play: could not play %s: %s\n", path.c_str(), errorMessage.toLocal8Bit().constData());
+            return 1;
+        }
+        source = player->source();
+        if (steps > 0) {
+            // 先逐帧前进 steps 帧，再后退 steps 帧，分别记录每一步的耗时
+            read = [&player, &forwardSteps, &backwardSteps, steps](AVFrame* frame, AVMediaType* type) {
+                const bool forward = static_cast<int>(forwardSteps.size()) < steps;
+                if (!forward && static_cast<int>(backwardSteps.size()) >= steps) {
+                    return AVERROR_EOF;
+                }
+                const double stepStart = now();
+                if (!(forward ? player->stepForward(frame) : player->stepBackward(frame))) {
+                    return forward ? AVERROR_EOF : AVERROR(EIO);
+                }
+                (forward ? forwardSteps : backwardSteps).push_back((now() - stepStart) * 1000.0);
+                *type = AVMEDIA_TYPE_VIDEO;
+                return 0;
+            };
+        } else {
+            read = [&player](AVFrame* frame, AVMediaType* type) { return player->readFrame(frame, type); };
+        }
+    } else {
+        ownedSource = core::MediaSource::open(QString::fromStdString(path), sourceOptions, &errorMessage);
+        if (!ownedSource) {
+            std::fprintf(stderr, "play: could not open %s: %s\n", path.c_str(), errorMessage.toLocal8Bit().constData());
+            return 1;
+        }
+        source = ownedSource.get();
+        read = [source](AVFrame* frame, AVMediaType* type) { return source->readFrame(frame, type); };
+    }
+    if (!sink->open(*source)) {
+        return 1;
+    }
+
+    std::shared_ptr<core::StreamRecorder> recorder;
+    if (arguments.has("record")) {
+        core::StreamRecorder::Options recordOptions;
+        recordOptions.segmentSeconds = arguments.doubleValue("segment-seconds", 0.0);
+        recordOptions.segmentBytes = static_cast<int64_t>(arguments.doubleValue("segment-size", 0.0) * (1 << 20));
+        recorder = core::StreamRecorder::create(source->formatContext(), QString::fromStdString(arguments.value("record")),
+                                                recordOptions, &errorMessage);
+        if (!recorder) {
+            std::fprintf(stderr, "play: could not record: %s\n", errorMessage.toLocal8Bit().constData());
+            return 1;
+        }
+        source->addTap(recorder);
+    }
+
+    std::shared_ptr<core::RestreamServer> restream;
+    if (arguments.has("restream")) {
+        core::RestreamServer::Options restreamOptions;
+        restreamOptions.port = arguments.intValue("restream", restreamOptions.port);
+        restreamOptions.address = arguments.value("listen", restreamOptions.address);
+        restreamOptions.segmentSeconds = arguments.doubleValue("hls-segment", restreamOptions.segmentSeconds);
+        restreamOptions.directory = arguments.value("hls-directory");
+        restream = core::RestreamServer::create(source->formatContext(), restreamOptions, &errorMessage);
+        if (!restream) {
+            std::fprintf(stderr, "play: could not restream: %s\n", errorMessage.toLocal8Bit().constData());
+            return 1;
+        }
+        source->addTap(restream);
+        std::fprintf(stderr, "play: serving %slive.m3u8 and %slive.ts\n", restream->url().toLocal8Bit().constData(),
+                     restream->url().toLocal8Bit().constData());
+    }
+
+    const AVMediaType wanted = sink->mediaType();
+    AVFrame* frame = av_frame_alloc();
+    int64_t videoFrames = 0;
+    int64_t audioFrames = 0;
+    double firstTime = -1.0;
+    double firstFrame = -1.0;
+    double mediaTime = 0.0;
+    bool ok = true;
+    int ret = 0;
+
+    const double start = now();
+    AVMediaType type = AVMEDIA_TYPE_UNKNOWN;
+    while ((ret = read(frame, &type)) == 0) {
+        if (firstFrame < 0) {
+            firstFrame = now() - openStart;
+        }
+        if (frame->pts != AV_NOPTS_VALUE) {
+            // 倒放时时间戳递减，按距第一帧的距离计算进度；变速时墙钟节奏为媒体时间除以 |rate|
+            const double time = frame->pts * av_q2d(frame->time_base);
+            if (firstTime < 0) {
+                firstTime = time;
+            }
+            const double offset = std::fabs(time - firstTime);
+            mediaTime = std::max(mediaTime, offset);
+            if (maxDuration > 0 && offset >= maxDuration) {
+                av_frame_unref(frame);
+                break;
+            }
+            if (realtime && steps == 0) {
+                const double wait = offset / std::fabs(rate) - (now() - start);
+                if (wait > 0) {
+                    std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+                }
+            }
+        }
+
+        if (wanted == AVMEDIA_TYPE_UNKNOWN || wanted == type) {
+            if (!sink->write(frame, type)) {
+                std::fprintf(stderr, "play: write failed\n");
+                ok = false;
+                av_frame_unref(frame);
+                break;
+            }
+        }
+        (type == AVMEDIA_TYPE_VIDEO ? videoFrames : audioFrames) += 1;
+        av_frame_unref(frame);
+    }
+    av_frame_free(&frame);
+    ok = sink->close() && ok;
+
+    if (ret < 0 && ret != AVERROR_EOF) {
+        char error[AV_ERROR_MAX_STRING_SIZE] = {0};
+        av_strerror(ret, error, sizeof(error));
+        std::fprintf(stderr, "play: read error: %s\n", error);
+        ok = false;
+    }
+
+    if (steps > 0) {
+        const std::size_t forwardCount = forwardSteps.size();
+        const std::size_t backwardCount = backwardSteps.size();
+        std::fprintf(stderr, "play: step: %zu forward (p50 %.3f ms, p99 %.3f ms), "
+                     "%zu backward (p50 %.3f ms, p99 %.3f ms)\n",
+                     forwardCount, percentile(forwardSteps, 0.5), percentile(forwardSteps, 0.99),
+                     backwardCount, percentile(backwardSteps, 0.5), percentile(backwardSteps, 0.99));
+    }
+
+    if (playlist) {
+        std::fprintf(stderr, "play: playlist: %d items, stopped at item %d, preroll memory %.1f MiB\n",
+                     playlist->count(), playlist->currentIndex(), playlist->prerollMemoryUsage() / 1048576.0);
+        source = playlist->currentSource();
+    }
+
+    if (recorder) {
+        source->removeTap(recorder.get());
+        recorder->stop();
+        recorder->wait();
+        const core::StreamRecorder::Statistics recorded = recorder->getStatistics();
+        std::fprintf(stderr, "play: recorded %llu packets (%.1f MiB) into %d file(s), %llu dropped, %llu write errors\n",
+                     static_cast<unsigned long long>(recorded.packetsWritten), recorded.bytesWritten / 1048576.0,
+                     recorded.segments, static_cast<unsigned long long>(recorded.packetsDropped),
+                     static_cast<unsigned long long>(recorded.writeErrors));
+    }
+
+    if (restream) {
+        source->removeTap(restream.get());
+        const core::RestreamServer::Statistics served = restream->getStatistics();
+        std::fprintf(stderr, "play: restreamed %lld segments, %llu requests, %.1f MiB sent, %llu slow clients, "
+                     "%llu packets dropped\n",
+                     static_cast<long long>(served.segments), static_cast<unsigned long long>(served.requests),
+                     served.bytesSent / 1048576.0, static_cast<unsigned long long>(served.slowClients),
+                     static_cast<unsigned long long>(served.packetsDropped));
+    }
+
+    if (const core::AdaptiveStream* adaptive = source->adaptiveStream()) {
+        const core::AdaptiveStream::Statistics abr = adaptive->getStatistics();
+        std::fprintf(stderr, "play: adaptive: startup %.3f s (first frame %.3f s), %d rebuffers (%.3f s, ratio %.2f%%), "
+                     "average bitrate %.0f kbit/s, %d switches\n",
+                     abr.startupTimeUs / 1e6, std::max(firstFrame, 0.0), abr.rebufferCount, abr.rebufferTimeUs / 1e6,
+                     abr.rebufferRatio * 100.0, abr.averageBitrate / 1000.0, abr.switches);
+        std::fprintf(stderr, "play: adaptive: %llu segments (%.1f MiB), %llu skipped, %llu errors, "
+                     "bandwidth estimate %.0f kbit/s\n",
+                     static_cast<unsigned long long>(abr.segments), abr.bytes / 1048576.0,
+                     static_cast<unsigned long long>(abr.skipped), static_cast<unsigned long long>(abr.errors),
+                     abr.bandwidth / 1000.0);
+    }
+
+    if (const core::UdpIngest* ingest = source->udpIngest()) {
+        const core::UdpIngest::Statistics udp = ingest->getStatistics();
+        std::fprintf(stderr, "play: udp: %llu datagrams in %llu batches, %llu TS packets (%.1f MiB), "
+                     "%.0f packets/s, %.0f kbit/s\n",
+                     static_cast<unsigned long long>(udp.datagrams), static_cast<unsigned long long>(udp.batches),
+                     static_cast<unsigned long long>(udp.packets), udp.bytes / 1048576.0,
+                     udp.packetRate, udp.bitrate / 1000.0);
+        std::fprintf(stderr, "play: udp: %llu CC errors (%llu packets lost), %llu socket drops, %llu ring overflows, "
+                     "%llu sync errors, jitter %.0f us, max gap %.3f ms\n",
+                     static_cast<unsigned long long>(udp.ccErrors), static_cast<unsigned long long>(udp.lostPackets),
+                     static_cast<unsigned long long>(udp.socketDrops), static_cast<unsigned long long>(udp.ringOverflows),
+                     static_cast<unsigned long long>(udp.syncErrors), udp.jitterUs, udp.maxGapUs / 1000.0);
+        if (udp.rtp) {
+            const core::RtpJitterBuffer::Statistics& rtp = udp.jitterBuffer;
+            std::fprintf(stderr, "play: rtp: %llu received, %llu reordered, %llu duplicates, %llu lost, "
+                         "%llu late (%.3f%%), %llu overflows, jitter %.0f us, playout delay %.1f ms\n",
+                         static_cast<unsigned long long>(rtp.received), static_cast<unsigned long long>(rtp.reordered),
+                         static_cast<unsigned long long>(rtp.duplicates), static_cast<unsigned long long>(rtp.lost),
+                         static_cast<unsigned long long>(rtp.late), rtp.lateLossRatio * 100.0,
+                         static_cast<unsigned long long>(rtp.overflows), rtp.jitterUs, rtp.delayUs / 1000.0);
+        }
+    }
+
+    const double elapsed = now() - start;
+    std::fprintf(stderr, "play: %lld video frames, %lld audio frames, %.3f s media in %.3f s (%.2fx)\n",
+                 static_cast<long long>(videoFrames), static_cast<long long>(audioFrames),
+                 mediaTime, elapsed, elapsed > 0 ? mediaTime / elapsed : 0.0);
+    return ok ? 0 : 1;
+}
+
+} // namespace cli
+} // namespace aurorastream
@@ -0,0 +1,138 @@
+/********************************************************************************
+ * @file   : ProbeCommand.cpp
+ * @brief  : 实现 aurorastream-cli probe 子命令。
+ *
+ * 每个文件只做解复用层的探测（优先使用探测缓存），不打开解码器。多个文件在
+ * TaskScheduler 上并行探测，结果按命令行顺序逐行输出为 JSON 对象。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "Commands.h"
+
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <iomanip>
+
+#include <QtCore/QFileInfo>
+
+#include "aurorastream/core/ProbeCache.h"
+#include "aurorastream/core/TaskScheduler.h"
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/pixdesc.h>
+#include <libavutil/error.h>
+}
+
+namespace aurorastream {
+namespace cli {
+
+namespace {
+
+std::string probeFile(const std::string& path, bool useCache, bool* ok)
+{
+    *ok = false;
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"path\":" << jsonString(path);
+
+    const double start = now();
+    const std::string cachePath = QFileInfo(QString::fromStdString(path)).absoluteFilePath().toStdString();
+    AVFormatContext* formatContext = nullptr;
+    int ret = avformat_open_input(&formatContext, path.c_str(), nullptr, nullptr);
+    bool cacheHit = false;
+    if (ret >= 0) {
+        cacheHit = useCache && core::ProbeCache::instance().restore(cachePath, formatContext);
+        if (!cacheHit) {
+            ret = avformat_find_stream_info(formatContext, nullptr);
+            if (ret >= 0 && useCache) {
+                core::ProbeCache::instance().store(cachePath, formatContext);
+            }
+        }
+    }
+    if (ret < 0) {
+        char error[AV_ERROR_MAX_STRING_SIZE] = {0};
+        av_strerror(ret, error, sizeof(error));
+        avformat_close_input(&formatContext);
+        out << ",\"error\":" << jsonString(error) << "}";
+        return out.str();
+    }
+
+    out << ",\"format\":" << jsonString(formatContext->iformat->name)
+        << ",\"probe_ms\":" << (now() - start) * 1000.0
+        << ",\"probe_cache_hit\":" << (cacheHit ? "true" : "false")
+        << ",\"duration\":" << (formatContext->duration != AV_NOPTS_VALUE
+                                ? formatContext->duration / static_cast<double>(AV_TIME_BASE) : 0.0)
+        << ",\"start_time\":" << (formatContext->start_time != AV_NOPTS_VALUE
+                                  ? formatContext->start_time / static_cast<double>(AV_TIME_BASE) : 0.0)
+        << ",\"bit_rate\":" << formatContext->bit_rate
+        << ",\"streams\":[";
+
+    for (unsigned int i = 0; i < formatContext->nb_streams; ++i) {
+        const AVStream* stream = formatContext->streams[i];
+        const AVCodecParameters* par = stream->codecpar;
+        const char* type = av_get_media_type_string(par->codec_type);
+        out << (i ? "," : "") << "{\"index\":" << i
+            << ",\"type\":" << jsonString(type ? type : "unknown")
+            << ",\"codec\":" << jsonString(avcodec_get_name(par->codec_id))
+            << ",\"bit_rate\":" << par->bit_rate
+            << ",\"duration\":" << (stream->duration != AV_NOPTS_VALUE ? stream->duration * av_q2d(stream->time_base) : 0.0)
+            << ",\"index_entries\":" << avformat_index_get_entries_count(const_cast<AVStream*>(stream));
+
+        if (const char* profile = avcodec_profile_name(par->codec_id, par->profile)) {
+            out << ",\"profile\":" << jsonString(profile);
+        }
+        if (par->codec_type == AVMEDIA_TYPE_VIDEO) {
+            const char* pixelFormat = av_get_pix_fmt_name(static_cast<AVPixelFormat>(par->format));
+            const AVRational rate = stream->avg_frame_rate.num ? stream->avg_frame_rate : stream->r_frame_rate;
+            out << ",\"width\":" << par->width << ",\"height\":" << par->height
+                << ",\"pix_fmt\":" << jsonString(pixelFormat ? pixelFormat : "unknown")
+                << ",\"frame_rate\":" << (rate.den ? av_q2d(rate) : 0.0);
+        } else if (par->codec_type == AVMEDIA_TYPE_AUDIO) {
+            const char* sampleFormat = av_get_sample_fmt_name(static_cast<AVSampleFormat>(par->format));
+            out << ",\"sample_rate\":" << par->sample_rate << ",\"channels\":" << par->ch_layout.nb_channels
+                << ",\"sample_fmt\":" << jsonString(sampleFormat ? sampleFormat : "unknown");
+        }
+        out << "}";
+    }
+    out << "]}";
+    avformat_close_input(&formatContext);
+    *ok = true;
+    return out.str();
+}
+
+} // namespace
+
+int runProbe(const Arguments& arguments)
+{
+    const std::vector<std::string>& files = arguments.positional();
+    if (files.empty()) {
+        std::fprintf(stderr, "probe: no input files\n");
+        return 2;
+    }
+
+    const bool useCache = !arguments.has("no-cache");
+    std::vector<std::string> results(files.size());
+    std::unique_ptr<bool[]> succeeded(new bool[files.size()]);
+    core::TaskGroup group;
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        core::TaskScheduler::instance().submit(core::TaskScheduler::Priority::Interactive, [&, i] {
+            results[i] = probeFile(files[i], useCache, &succeeded[i]);
+        }, &group);
+    }
+    group.wait();
+
+    int failures = 0;
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        std::printf("%s\n", results[i].c_str());
+        failures += !succeeded[i];
+    }
+    return failures ? 1 : 0;
+}
+
+} // namespace cli
+} // namespace aurorastream
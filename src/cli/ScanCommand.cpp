@@ -0,0 +1,75 @@
+/********************************************************************************
+ * @file   : ScanCommand.cpp
+ * @brief  : 实现 aurorastream-cli scan 子命令。
+ *
+ * 对给定目录做一次增量媒体库扫描并输出吞吐量，扫描期间每秒向标准错误输出进度。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "Commands.h"
+
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <cstdio>
+
+#include "aurorastream/core/MediaLibrary.h"
+#include "aurorastream/core/LibraryScanner.h"
+
+namespace aurorastream {
+namespace cli {
+
+int runScan(const Arguments& arguments)
+{
+    const std::vector<std::string>& roots = arguments.positional();
+    if (roots.empty()) {
+        std::fprintf(stderr, "scan: no directories\n");
+        return 2;
+    }
+
+    std::unique_ptr<core::MediaLibrary> ownLibrary;
+    if (arguments.has("database")) {
+        ownLibrary = std::make_unique<core::MediaLibrary>(arguments.value("database"));
+    }
+    core::MediaLibrary& library = ownLibrary ? *ownLibrary : core::MediaLibrary::instance();
+    if (!library.isOpen()) {
+        std::fprintf(stderr, "scan: could not open %s\n", library.databasePath().c_str());
+        return 1;
+    }
+
+    core::LibraryScanner scanner(library);
+    scanner.scan(roots);
+    while (scanner.isScanning()) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        const core::LibraryScanner::Statistics progress = scanner.getStatistics();
+        std::fprintf(stderr, "scan: %llu files, %llu probed, %.0f files/s\r",
+                     static_cast<unsigned long long>(progress.files), static_cast<unsigned long long>(progress.probed),
+                     progress.filesPerSecond);
+    }
+    scanner.wait();
+
+    const core::LibraryScanner::Statistics s = scanner.getStatistics();
+    if (arguments.has("json")) {
+        std::printf("{\"database\":%s,\"directories\":%llu,\"files\":%llu,\"unchanged\":%llu,\"probed\":%llu,"
+                    "\"failed\":%llu,\"removed\":%llu,\"batches\":%llu,\"seconds\":%.3f,\"files_per_sec\":%.1f}\n",
+                    jsonString(library.databasePath()).c_str(),
+                    static_cast<unsigned long long>(s.directories), static_cast<unsigned long long>(s.files),
+                    static_cast<unsigned long long>(s.unchanged), static_cast<unsigned long long>(s.probed),
+                    static_cast<unsigned long long>(s.failed), static_cast<unsigned long long>(s.removed),
+                    static_cast<unsigned long long>(s.batches), s.seconds, s.filesPerSecond);
+    } else {
+        std::printf("%llu files in %llu directories: %llu unchanged, %llu probed, %llu failed, %llu removed\n"
+                    "%.2f s, %.1f files/s, %llu transactions, %lld files in library\n",
+                    static_cast<unsigned long long>(s.files), static_cast<unsigned long long>(s.directories),
+                    static_cast<unsigned long long>(s.unchanged), static_cast<unsigned long long>(s.probed),
+                    static_cast<unsigned long long>(s.failed), static_cast<unsigned long long>(s.removed),
+                    s.seconds, s.filesPerSecond, static_cast<unsigned long long>(s.batches),
+                    static_cast<long long>(library.count()));
+    }
+    return s.failed ? 1 : 0;
+}
+
+} // namespace cli
+} // namespace aurorastream
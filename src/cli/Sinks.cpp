@@ -0,0 +1,296 @@
+/********************************************************************************
+ * @file   : Sinks.cpp
+ * @brief  : 实现 aurorastream-cli 的无头输出。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "Sinks.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "aurorastream/core/MediaSource.h"
+
+extern "C" {
+#include <libavutil/imgutils.h>
+#include <libswscale/swscale.h>
+#include <libswresample/swresample.h>
+}
+
+namespace aurorastream {
+namespace cli {
+
+namespace {
+
+/**
+ * @brief 输出文件，"-" 表示标准输出
+ */
+class OutputFile
+{
+public:
+    ~OutputFile()
+    {
+        if (m_file && m_file != stdout) {
+            std::fclose(m_file);
+        }
+    }
+
+    bool open(const std::string& path)
+    {
+        m_file = path == "-" ? stdout : std::fopen(path.c_str(), "wb");
+        if (!m_file) {
+            std::fprintf(stderr, "play: could not open output %s\n", path.c_str());
+        }
+        return m_file != nullptr;
+    }
+
+    bool write(const void* data, std::size_t size)
+    {
+        return std::fwrite(data, 1, size, m_file) == size;
+    }
+
+    bool writeLittleEndian(uint32_t value, int bytes)
+    {
+        uint8_t buffer[4];
+        for (int i = 0; i < bytes; ++i) {
+            buffer[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+        return write(buffer, bytes);
+    }
+
+    /// 标准输出或管道不能回写，返回 false
+    bool seek(long offset)
+    {
+        return m_file != stdout && std::fseek(m_file, offset, SEEK_SET) == 0;
+    }
+
+    bool flush()
+    {
+        return std::fflush(m_file) == 0;
+    }
+
+private:
+    std::FILE* m_file = nullptr;
+};
+
+class NullSink : public FrameSink
+{
+public:
+    bool open(const core::MediaSource&) override { return true; }
+    bool write(const AVFrame*, AVMediaType) override { return true; }
+    bool close() override { return true; }
+    AVMediaType mediaType() const override { return AVMEDIA_TYPE_UNKNOWN; }
+};
+
+class Y4mSink : public FrameSink
+{
+public:
+    explicit Y4mSink(const std::string& output) : m_output(output) {}
+
+    ~Y4mSink() override
+    {
+        sws_freeContext(m_scaler);
+        av_frame_free(&m_converted);
+    }
+
+    bool open(const core::MediaSource& source) override
+    {
+        const AVStream* stream = source.videoStream();
+        if (!stream) {
+            std::fprintf(stderr, "play: y4m output needs a video stream\n");
+            return false;
+        }
+        m_width = stream->codecpar->width;
+        m_height = stream->codecpar->height;
+
+        AVRational rate = stream->avg_frame_rate.num ? stream->avg_frame_rate : stream->r_frame_rate;
+        if (!rate.num || !rate.den) {
+            rate = AVRational {25, 1};
+        }
+        const AVRational aspect = stream->codecpar->sample_aspect_ratio;
+
+        if (!m_file.open(m_output)) {
+            return false;
+        }
+        char header[128];
+        const int length = std::snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:%d Ip A%d:%d C420jpeg\n",
+                                         m_width, m_height, rate.num, rate.den, aspect.num, aspect.den);
+        return m_file.write(header, static_cast<std::size_t>(length));
+    }
+
+    /**
+     * @brief 写一帧；不是 YUV420P 或尺寸变化时先转换到输出格式
+     */
+    bool write(const AVFrame* frame, AVMediaType type) override
+    {
+        if (type != AVMEDIA_TYPE_VIDEO) {
+            return true;
+        }
+
+        const AVFrame* output = frame;
+        if (frame->format != AV_PIX_FMT_YUV420P || frame->width != m_width || frame->height != m_height) {
+            m_scaler = sws_getCachedContext(m_scaler, frame->width, frame->height, static_cast<AVPixelFormat>(frame->format),
+                                            m_width, m_height, AV_PIX_FMT_YUV420P, SWS_BILINEAR, nullptr, nullptr, nullptr);
+            if (!m_scaler) {
+                return false;
+            }
+            if (!m_converted) {
+                m_converted = av_frame_alloc();
+                m_converted->format = AV_PIX_FMT_YUV420P;
+                m_converted->width = m_width;
+                m_converted->height = m_height;
+                if (av_frame_get_buffer(m_converted, 0) < 0) {
+                    return false;
+                }
+            }
+            sws_scale(m_scaler, frame->data, frame->linesize, 0, frame->height, m_converted->data, m_converted->linesize);
+            output = m_converted;
+        }
+
+        static const char kFrameHeader[] = "FRAME\n";
+        bool ok = m_file.write(kFrameHeader, sizeof(kFrameHeader) - 1);
+        for (int plane = 0; plane < 3 && ok; ++plane) {
+            const int width = plane == 0 ? m_width : (m_width + 1) / 2;
+            const int height = plane == 0 ? m_height : (m_height + 1) / 2;
+            for (int row = 0; row < height && ok; ++row) {
+                ok = m_file.write(output->data[plane] + static_cast<std::ptrdiff_t>(row) * output->linesize[plane],
+                                  static_cast<std::size_t>(width));
+            }
+        }
+        return ok;
+    }
+
+    bool close() override
+    {
+        return m_file.flush();
+    }
+
+    AVMediaType mediaType() const override { return AVMEDIA_TYPE_VIDEO; }
+
+private:
+    std::string m_output;
+    OutputFile m_file;
+    int m_width = 0;
+    int m_height = 0;
+    SwsContext* m_scaler = nullptr;
+    AVFrame* m_converted = nullptr;
+};
+
+class WavSink : public FrameSink
+{
+public:
+    explicit WavSink(const std::string& output) : m_output(output) {}
+
+    ~WavSink() override
+    {
+        swr_free(&m_resampler);
+    }
+
+    bool open(const core::MediaSource& source) override
+    {
+        const AVCodecContext* context = source.audioCodecContext();
+        if (!context) {
+            std::fprintf(stderr, "play: wav output needs an audio stream\n");
+            return false;
+        }
+        m_sampleRate = context->sample_rate;
+        m_channels = context->ch_layout.nb_channels;
+        if (m_sampleRate <= 0 || m_channels <= 0 || !m_file.open(m_output)) {
+            return false;
+        }
+        return writeHeader(0xFFFFFFFFu - 36);
+    }
+
+    bool write(const AVFrame* frame, AVMediaType type) override
+    {
+        if (type != AVMEDIA_TYPE_AUDIO) {
+            return true;
+        }
+        // 输入格式以第一帧为准
+        if (!m_resampler) {
+            AVChannelLayout layout;
+            av_channel_layout_default(&layout, m_channels);
+            if (swr_alloc_set_opts2(&m_resampler, &layout, AV_SAMPLE_FMT_S16, m_sampleRate,
+                                    &frame->ch_layout, static_cast<AVSampleFormat>(frame->format), frame->sample_rate,
+                                    0, nullptr) < 0
+                || swr_init(m_resampler) < 0) {
+                std::fprintf(stderr, "play: could not initialise audio conversion\n");
+                return false;
+            }
+        }
+        return convert(const_cast<const uint8_t**>(frame->extended_data), frame->nb_samples);
+    }
+
+    bool close() override
+    {
+        bool ok = !m_resampler || convert(nullptr, 0);
+        // 输出到管道时保留头部的“未知长度”
+        if (m_file.seek(0)) {
+            ok = writeHeader(static_cast<uint32_t>(m_dataBytes)) && ok;
+        }
+        return m_file.flush() && ok;
+    }
+
+    AVMediaType mediaType() const override { return AVMEDIA_TYPE_AUDIO; }
+
+private:
+    bool convert(const uint8_t** input, int samples)
+    {
+        const int capacity = swr_get_out_samples(m_resampler, samples);
+        if (capacity <= 0) {
+            return true;
+        }
+        m_buffer.resize(static_cast<std::size_t>(capacity) * m_channels);
+        uint8_t* output = reinterpret_cast<uint8_t*>(m_buffer.data());
+        const int converted = swr_convert(m_resampler, &output, capacity, input, samples);
+        if (converted < 0) {
+            return false;
+        }
+        const std::size_t bytes = static_cast<std::size_t>(converted) * m_channels * sizeof(int16_t);
+        m_dataBytes += bytes;
+        return m_file.write(m_buffer.data(), bytes);
+    }
+
+    bool writeHeader(uint32_t dataBytes)
+    {
+        const uint32_t blockAlign = static_cast<uint32_t>(m_channels) * 2;
+        return m_file.write("RIFF", 4) && m_file.writeLittleEndian(36 + dataBytes, 4)
+            && m_file.write("WAVEfmt ", 8) && m_file.writeLittleEndian(16, 4)
+            && m_file.writeLittleEndian(1, 2)                                   // PCM
+            && m_file.writeLittleEndian(static_cast<uint32_t>(m_channels), 2)
+            && m_file.writeLittleEndian(static_cast<uint32_t>(m_sampleRate), 4)
+            && m_file.writeLittleEndian(static_cast<uint32_t>(m_sampleRate) * blockAlign, 4)
+            && m_file.writeLittleEndian(blockAlign, 2)
+            && m_file.writeLittleEndian(16, 2)
+            && m_file.write("data", 4) && m_file.writeLittleEndian(dataBytes, 4);
+    }
+
+    std::string m_output;
+    OutputFile m_file;
+    int m_sampleRate = 0;
+    int m_channels = 0;
+    uint64_t m_dataBytes = 0;
+    SwrContext* m_resampler = nullptr;
+    std::vector<int16_t> m_buffer;
+};
+
+} // namespace
+
+std::unique_ptr<FrameSink> FrameSink::create(const std::string& name, const std::string& output)
+{
+    if (name == "null") {
+        return std::make_unique<NullSink>();
+    }
+    if (name == "y4m") {
+        return std::make_unique<Y4mSink>(output);
+    }
+    if (name == "wav") {
+        return std::make_unique<WavSink>(output);
+    }
+    return nullptr;
+}
+
+} // namespace cli
+} // namespace aurorastream
@@ -0,0 +1,61 @@
+/********************************************************************************
+ * @file   : Sinks.h
+ * @brief  : 声明 aurorastream-cli play 子命令使用的无头输出。
+ *
+ * 输出直接接收 MediaSource 解出的 AVFrame：
+ *   - null：只统计帧数，用于测量不含显示的播放吞吐；
+ *   - y4m：视频转换为 YUV420P 后写成 YUV4MPEG2，可直接交给 ffmpeg 或 x264；
+ *   - wav：音频转换为 16 位交错 PCM 写成 WAV。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CLI_SINKS_H
+#define AURORASTREAM_CLI_SINKS_H
+
+#include <memory>
+#include <string>
+#include <cstdint>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+namespace aurorastream {
+namespace core {
+class MediaSource;
+}
+
+namespace cli {
+
+class FrameSink
+{
+public:
+    virtual ~FrameSink() = default;
+
+    /// 根据媒体源的流参数准备输出
+    virtual bool open(const core::MediaSource& source) = 0;
+
+    /// 接收一帧；不处理的类型直接忽略
+    virtual bool write(const AVFrame* frame, AVMediaType type) = 0;
+
+    /// 完成输出（补写文件头等）
+    virtual bool close() = 0;
+
+    /// 输出需要的媒体类型，AVMEDIA_TYPE_UNKNOWN 表示全部
+    virtual AVMediaType mediaType() const = 0;
+
+    /**
+     * @brief 按名字创建输出
+     * @param name null、y4m 或 wav
+     * @param output 输出文件，"-" 表示标准输出；null 输出忽略此参数
+     * @return 名字未知时返回 nullptr
+     */
+    static std::unique_ptr<FrameSink> create(const std::string& name, const std::string& output);
+};
+
+} // namespace cli
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CLI_SINKS_H
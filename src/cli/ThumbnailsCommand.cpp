@@ -0,0 +1,63 @@
+/********************************************************************************
+ * @file   : ThumbnailsCommand.cpp
+ * @brief  : 实现 aurorastream-cli thumbnails 子命令。
+ *
+ * 以批量优先级为文件生成进度条预览精灵图，写入 ThumbnailService 的磁盘缓存。
+ * 多个文件同时提交，文件之间和同一文件的各段之间都并行解码。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "Commands.h"
+
+#include <cstdio>
+
+#include "aurorastream/core/ThumbnailService.h"
+
+namespace aurorastream {
+namespace cli {
+
+int runThumbnails(const Arguments& arguments)
+{
+    const std::vector<std::string>& files = arguments.positional();
+    if (files.empty()) {
+        std::fprintf(stderr, "thumbnails: no input files\n");
+        return 2;
+    }
+
+    core::ThumbnailService::Options options;
+    options.interval = arguments.intValue("interval", static_cast<int>(options.interval));
+    options.tileWidth = arguments.intValue("width", options.tileWidth);
+    options.maxTiles = arguments.intValue("max-tiles", options.maxTiles);
+
+    core::ThumbnailService& service = core::ThumbnailService::instance();
+    const double start = now();
+    for (const std::string& path : files) {
+        service.request(QString::fromStdString(path), core::ThumbnailService::Priority::Batch, options);
+    }
+
+    int failures = 0;
+    for (const std::string& path : files) {
+        const auto sheet = service.generate(QString::fromStdString(path), core::ThumbnailService::Priority::Batch, options);
+        if (!sheet) {
+            std::fprintf(stderr, "thumbnails: could not generate thumbnails for %s\n", path.c_str());
+            ++failures;
+            continue;
+        }
+        std::printf("%s: %d tiles of %dx%d every %lld ms\n", path.c_str(), sheet->count(),
+                    sheet->tileWidth(), sheet->tileHeight(), static_cast<long long>(sheet->interval()));
+    }
+
+    const core::ThumbnailService::Statistics s = service.getStatistics();
+    const double elapsed = now() - start;
+    std::printf("thumbnails: %llu sheets generated, %llu cached, %llu keyframes decoded for %llu tiles "
+                "(%llu reused) in %.2f s\n",
+                static_cast<unsigned long long>(s.sheets), static_cast<unsigned long long>(s.cacheHits),
+                static_cast<unsigned long long>(s.decodedFrames), static_cast<unsigned long long>(s.tiles),
+                static_cast<unsigned long long>(s.reusedTiles), elapsed);
+    return failures ? 1 : 0;
+}
+
+} // namespace cli
+} // namespace aurorastream
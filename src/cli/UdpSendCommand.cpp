@@ -0,0 +1,205 @@
+/********************************************************************************
+ * @file   : UdpSendCommand.cpp
+ * @brief  : 实现 aurorastream-cli udp-send 子命令。
+ *
+ * 把 MPEG-TS 文件按 7 个 TS 包一个数据报以 UDP 发出，用于在回环地址上
+ * 测试 play 的 UDP 接收（见 UdpIngest）。按 --rate 的平均码率发送，
+ * 每次用 sendmmsg 连续发出 --burst 个数据报，突发越大越容易暴露接收端的丢包；
+ * --drop=N 每 N 个数据报故意跳过一个，用来验证连续计数器的丢包统计。
+ * 目标为 rtp:// 时加上 RTP 头（负载类型 33，RFC 2250），时间戳按发送计划换算为 90 kHz；
+ * --reorder=N 每 N 个数据报与下一个交换顺序，用来验证抖动缓冲的重排。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "Commands.h"
+
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+namespace aurorastream {
+namespace cli {
+
+namespace {
+constexpr std::size_t kDatagramSize = 7 * 188;
+constexpr std::size_t kRtpHeaderSize = 12;
+constexpr uint8_t kMp2tPayloadType = 33;
+}
+
+int runUdpSend(const Arguments& arguments)
+{
+#if !defined(__linux__)
+    (void)arguments;
+    std::fprintf(stderr, "udp-send: only supported on Linux\n");
+    return 1;
+#else
+    const std::vector<std::string>& positional = arguments.positional();
+    if (positional.size() != 2) {
+        std::fprintf(stderr, "udp-send: expected <file.ts> <udp://host:port>\n");
+        return 2;
+    }
+    const std::string& path = positional[0];
+    std::string destination = positional[1];
+    const bool rtp = destination.compare(0, 6, "rtp://") == 0;
+    if (rtp || destination.compare(0, 6, "udp://") == 0) {
+        destination.erase(0, 6);
+    }
+    destination = destination.substr(0, destination.find('?'));
+    const std::size_t colon = destination.rfind(':');
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    if (colon == std::string::npos ||
+        inet_pton(AF_INET, destination.substr(0, colon).c_str(), &address.sin_addr) != 1) {
+        std::fprintf(stderr, "udp-send: invalid destination %s (expected an IPv4 address and port)\n",
+                     positional[1].c_str());
+        return 2;
+    }
+    address.sin_port = htons(static_cast<uint16_t>(std::atoi(destination.c_str() + colon + 1)));
+
+    const double rate = arguments.doubleValue("rate", 10.0) * 1e6;
+    const int burst = std::max(1, arguments.intValue("burst", 7));
+    const int drop = arguments.intValue("drop", 0);
+    const int reorder = arguments.intValue("reorder", 0);
+    const bool loop = arguments.has("loop");
+    if (rate <= 0 || drop == 1 || drop < 0 || reorder < 0) {
+        std::fprintf(stderr, "udp-send: --rate must be positive and --drop at least 2\n");
+        return 2;
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::fprintf(stderr, "udp-send: could not open %s\n", path.c_str());
+        return 1;
+    }
+    const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+        std::fprintf(stderr, "udp-send: could not connect to %s: %s\n", positional[1].c_str(), std::strerror(errno));
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        std::fclose(file);
+        return 1;
+    }
+
+    std::vector<uint8_t> buffer(static_cast<std::size_t>(burst) * kDatagramSize);
+    std::vector<mmsghdr> messages(static_cast<std::size_t>(burst));
+    std::vector<iovec> vectors(2 * static_cast<std::size_t>(burst));   // 每个数据报：RTP 头 + 负载
+    std::vector<uint8_t> headers(static_cast<std::size_t>(burst) * kRtpHeaderSize);
+    uint16_t sequence = 0;
+    uint64_t datagrams = 0;
+    uint64_t readCount = 0;
+    uint64_t reorderCount = 0;
+    uint64_t dropped = 0;
+    uint64_t calls = 0;
+    uint64_t bytes = 0;
+    bool ok = true;
+
+    const double start = now();
+    for (;;) {
+        // 读满一批：每个数据报 7 个 TS 包，文件末尾不足一个数据报的部分单独发出
+        int count = 0;
+        for (int i = 0; i < burst; ++i) {
+            uint8_t* data = buffer.data() + static_cast<std::size_t>(i) * kDatagramSize;
+            std::size_t length = std::fread(data, 1, kDatagramSize, file);
+            if (length == 0 && loop && std::ftell(file) > 0) {
+                std::rewind(file);
+                length = std::fread(data, 1, kDatagramSize, file);
+            }
+            if (length == 0) {
+                break;
+            }
+            if (drop > 0 && ++readCount % static_cast<uint64_t>(drop) == 0) {
+                ++dropped;
+                continue;
+            }
+            iovec* parts = &vectors[2 * static_cast<std::size_t>(count)];
+            messages[count].msg_hdr = msghdr {};
+            if (rtp) {
+                uint8_t* header = headers.data() + static_cast<std::size_t>(count) * kRtpHeaderSize;
+                const uint32_t timestamp = static_cast<uint32_t>(static_cast<double>(bytes) * 8.0 / rate * 90000.0);
+                header[0] = 0x80;
+                header[1] = kMp2tPayloadType;
+                header[2] = static_cast<uint8_t>(sequence >> 8);
+                header[3] = static_cast<uint8_t>(sequence);
+                header[4] = static_cast<uint8_t>(timestamp >> 24);
+                header[5] = static_cast<uint8_t>(timestamp >> 16);
+                header[6] = static_cast<uint8_t>(timestamp >> 8);
+                header[7] = static_cast<uint8_t>(timestamp);
+                std::memset(header + 8, 0, 4);      // SSRC
+                ++sequence;
+                parts[0] = iovec {header, kRtpHeaderSize};
+                parts[1] = iovec {data, length};
+                messages[count].msg_hdr.msg_iovlen = 2;
+            } else {
+                parts[0] = iovec {data, length};
+                messages[count].msg_hdr.msg_iovlen = 1;
+            }
+            messages[count].msg_hdr.msg_iov = parts;
+            bytes += length;
+            ++count;
+        }
+        if (reorder > 0) {
+            for (int i = 0; i + 1 < count; ++i) {
+                if (++reorderCount % static_cast<uint64_t>(reorder) == 0) {
+                    std::swap(messages[i], messages[i + 1]);
+                    ++i;
+                }
+            }
+        }
+        if (count == 0 && std::feof(file)) {
+            break;
+        }
+
+        int sent = 0;
+        while (sent < count) {
+            const int ret = sendmmsg(fd, messages.data() + sent, static_cast<unsigned>(count - sent), 0);
+            if (ret < 0) {
+                if (errno == EINTR || errno == ENOBUFS || errno == ECONNREFUSED) {
+                    continue;
+                }
+                std::fprintf(stderr, "udp-send: sendmmsg() failed: %s\n", std::strerror(errno));
+                ok = false;
+                break;
+            }
+            sent += ret;
+            ++calls;
+        }
+        datagrams += static_cast<uint64_t>(sent);
+        if (!ok) {
+            break;
+        }
+
+        // 按平均码率排定下一批的发送时间，落后于排定时间时不睡眠
+        const double due = start + static_cast<double>(bytes) * 8.0 / rate;
+        const double wait = due - now();
+        if (wait > 0) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+        }
+    }
+
+    const double elapsed = now() - start;
+    std::printf("udp-send: %llu datagrams (%.1f MiB) in %llu sendmmsg calls, %llu skipped, %.3f s, %.2f Mbit/s\n",
+                static_cast<unsigned long long>(datagrams), bytes / 1048576.0, static_cast<unsigned long long>(calls),
+                static_cast<unsigned long long>(dropped), elapsed, elapsed > 0 ? bytes * 8.0 / elapsed / 1e6 : 0.0);
+    ::close(fd);
+    std::fclose(file);
+    return ok ? 0 : 1;
+#endif
+}
+
+} // namespace cli
+} // namespace aurorastream
@@ -0,0 +1,70 @@
+/********************************************************************************
+ * @file   : WaveformCommand.cpp
+ * @brief  : 实现 aurorastream-cli waveform 子命令。
+ *
+ * 生成音频波形概览并写入 WaveformBuilder 的磁盘缓存，输出每个文件的层级、
+ * 区间数和耗时；--columns 指定时额外以 JSON 输出整个文件按该列数归约的峰值。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "Commands.h"
+
+#include <cstdio>
+
+#include "aurorastream/modules/media/audio/WaveformBuilder.h"
+
+namespace aurorastream {
+namespace cli {
+
+using modules::media::audio::WaveformBin;
+using modules::media::audio::WaveformBuilder;
+
+int runWaveform(const Arguments& arguments)
+{
+    const std::vector<std::string>& files = arguments.positional();
+    if (files.empty()) {
+        std::fprintf(stderr, "waveform: no input files\n");
+        return 2;
+    }
+
+    WaveformBuilder::Options options;
+    options.binFrames = arguments.intValue("bin-frames", options.binFrames);
+    const int columns = arguments.intValue("columns", 0);
+
+    WaveformBuilder& builder = WaveformBuilder::instance();
+    int failures = 0;
+    const double start = now();
+    for (const std::string& path : files) {
+        const double fileStart = now();
+        const auto waveform = builder.load(path, options);
+        if (!waveform) {
+            std::fprintf(stderr, "waveform: could not build a waveform for %s\n", path.c_str());
+            ++failures;
+            continue;
+        }
+        std::printf("%s: %.1f s of audio, %d levels, %lld bins at level 0, %.2f s\n", path.c_str(),
+                    waveform->duration() / 1000.0, waveform->levelCount(),
+                    static_cast<long long>(waveform->binCount(0)), now() - fileStart);
+
+        if (columns > 0) {
+            const std::vector<WaveformBin> peaks = waveform->peaks(0, waveform->duration(), columns);
+            std::printf("{\"file\":%s,\"peaks\":[", jsonString(path).c_str());
+            for (std::size_t i = 0; i < peaks.size(); ++i) {
+                std::printf("%s[%d,%d,%d]", i ? "," : "", peaks[i].min, peaks[i].max, peaks[i].rms);
+            }
+            std::printf("]}\n");
+        }
+    }
+
+    const WaveformBuilder::Statistics s = builder.getStatistics();
+    std::printf("waveform: %llu built, %llu cached, %llu frames decoded in %llu segments in %.2f s\n",
+                static_cast<unsigned long long>(s.built), static_cast<unsigned long long>(s.cacheHits),
+                static_cast<unsigned long long>(s.frames), static_cast<unsigned long long>(s.segments),
+                now() - start);
+    return failures ? 1 : 0;
+}
+
+} // namespace cli
+} // namespace aurorastream
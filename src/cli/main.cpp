@@ -0,0 +1,224 @@
+/********************************************************************************
+ * @file   : main.cpp
+ * @brief  : aurorastream-cli 命令行工具入口
+ *
+ * 用法：aurorastream-cli <命令> [选项] <文件>...
+ *   probe         以 JSON Lines 输出媒体信息
+ *   bench-decode  测量解码帧率、线程扩展性和单帧耗时分位数
+ *   play          无头播放到 null、y4m 或 wav 输出
+ *   index         离线生成关键帧索引
+ *   scan          增量扫描媒体目录并写入媒体库
+ *   thumbnails    生成进度条预览精灵图
+ *   waveform      生成音频波形概览
+ *   loudness      测量 EBU R128 响度
+ *   udp-send      以 UDP / RTP 发送 MPEG-TS 文件，用于测试 UDP 接收
+ *
+ * 只创建 QCoreApplication，不需要显示设备。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include <QtCore/QCoreApplication>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+
+#include "Commands.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+#include "aurorastream/utils/Tracer.h"
+
+namespace {
+
+bool verbose = false;
+
+/// 默认只输出警告和错误，--verbose 时输出所有 Qt 调试信息
+void messageHandler(QtMsgType type, const QMessageLogContext&, const QString& message)
+{
+    if (type == QtDebugMsg && !verbose) {
+        return;
+    }
+    std::fprintf(stderr, "%s\n", message.toLocal8Bit().constData());
+}
+
+void printUsage()
+{
+    std::fprintf(stderr,
+        "Usage: aurorastream-cli <command> [options] <file>...\n"
+        "\n"
+        "Commands:\n"
+        "  probe [--no-cache] <file>...\n"
+        "      Print stream information as JSON Lines, one object per file.\n"
+        "  bench-decode [--threads=1,2,4,8] [--frames=500] [--audio] [--json] <file>\n"
+        "      Decode from memory with each thread count; report fps, scaling and\n"
+        "      per-frame latency percentiles.\n"
+        "  play [--sink=null|y4m|wav] [--output=FILE|-] [--realtime] [--duration=SEC]\n"
+        "       [--record=FILE [--segment-seconds=SEC] [--segment-size=MB]]\n"
+        "       [--restream=PORT [--listen=ADDR] [--hls-segment=SEC] [--hls-directory=DIR]]\n"
+        "       [--quality=auto|low|medium|high|uhd] [--start=MS] [--rate=R] [--step=N]\n"
+        "       [--loop [--loop-range=START,END]] [--crossfade=MS]\n"
+        "       <file|udp://[@]addr:port|rtp://[@]addr:port>...\n"
+        "      Play without a display into a headless sink, optionally remuxing the\n"
+        "      demuxed packets into an MP4/MKV/TS recording and/or serving them to\n"
+        "      local clients as HLS (/live.m3u8) and HTTP-TS (/live.ts). HLS and DASH\n"
+        "      manifests use the adaptive bitrate client; startup time, rebuffer ratio\n"
+        "      and average bitrate are reported at the end. udp:// and rtp:// MPEG-TS\n"
+        "      input is received in batches; packet rate, loss and arrival jitter are\n"
+        "      reported. rtp:// goes through a reordering jitter buffer with an adaptive\n"
+        "      playout delay. --loop, --rate, --start and --step play through the player\n"
+        "      timeline: looping (optionally an A-B range in ms), reverse for a negative\n"
+        "      rate, keyframe-only trick play above 2x, or N frame steps forward then\n"
+        "      back. Several inputs play as a gapless playlist with an optional crossfade.\n"
+        "  index <file>...\n"
+        "      Build offline keyframe indexes used for seeking, reverse and trick play.\n"
+        "  scan [--database=FILE] [--json] <directory>...\n"
+        "      Incrementally scan directories into the media library and report throughput.\n"
+        "  thumbnails [--interval=MS] [--width=PX] [--max-tiles=N] <file>...\n"
+        "      Generate seek-preview sprite sheets into the thumbnail cache.\n"
+        "  waveform [--bin-frames=N] [--columns=N] <file>...\n"
+        "      Build multi-resolution audio waveform overviews into the waveform cache.\n"
+        "  loudness <file>... | loudness --library [--database=FILE]\n"
+        "      Measure EBU R128 integrated loudness and true peak, or analyse every\n"
+        "      library item that has not been measured yet.\n"
+        "  udp-send [--rate=MBIT] [--burst=N] [--drop=N] [--reorder=N] [--loop]\n"
+        "           <file.ts> <udp://addr:port|rtp://addr:port>\n"
+        "      Send an MPEG-TS file as UDP or RTP datagrams (7 TS packets each) at the\n"
+        "      given average rate, N datagrams per burst; --drop skips every Nth\n"
+        "      datagram and --reorder swaps every Nth datagram with the next one.\n"
+        "\n"
+        "Global options:\n"
+        "  --verbose     Print debug messages\n"
+        "  --trace=FILE  Record pipeline trace spans while the command runs and write\n"
+        "                them as Chrome trace-event JSON (open in ui.perfetto.dev)\n"
+        "  --metrics-snapshot=FILE [--metrics-interval=MS]\n"
+        "                Rewrite FILE with a JSON snapshot of all performance metrics\n"
+        "                every MS milliseconds (default 1000) and once more at exit\n");
+}
+
+/**
+ * @brief 命令运行期间定时采样性能指标并重写快照文件
+ * 命令行工具不运行 Qt 事件循环，PerformanceMonitor 的定时器不会触发，改由这里的线程调用 sample()
+ */
+class MetricsSampler
+{
+public:
+    MetricsSampler(const std::string& snapshotFile, int intervalMs)
+    {
+        using aurorastream::core::PerformanceMonitor;
+        PerformanceMonitor::instance().setSnapshotFile(QString::fromStdString(snapshotFile));
+        m_thread = std::thread([this, intervalMs] {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_condition.wait_for(lock, std::chrono::milliseconds(intervalMs), [this] { return m_stopped; })) {
+                PerformanceMonitor::instance().sample();
+            }
+        });
+    }
+
+    ~MetricsSampler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopped = true;
+        }
+        m_condition.notify_one();
+        m_thread.join();
+        aurorastream::core::PerformanceMonitor::instance().sample();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopped {false};
+    std::thread m_thread;
+};
+
+/// 执行子命令，未知命令返回 -1
+int runCommand(const std::string& command, const aurorastream::cli::Arguments& arguments)
+{
+    using namespace aurorastream::cli;
+
+    if (command == "probe") {
+        return runProbe(arguments);
+    }
+    if (command == "bench-decode") {
+        return runBenchDecode(arguments);
+    }
+    if (command == "play") {
+        return runPlay(arguments);
+    }
+    if (command == "index") {
+        return runIndex(arguments);
+    }
+    if (command == "scan") {
+        return runScan(arguments);
+    }
+    if (command == "thumbnails") {
+        return runThumbnails(arguments);
+    }
+    if (command == "waveform") {
+        return runWaveform(arguments);
+    }
+    if (command == "loudness") {
+        return runLoudness(arguments);
+    }
+    if (command == "udp-send") {
+        return runUdpSend(arguments);
+    }
+
+    return -1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    using namespace aurorastream::cli;
+    using aurorastream::utils::Tracer;
+
+    QCoreApplication application(argc, argv);
+    QCoreApplication::setApplicationName("AuroraStream");
+
+    if (argc < 2 || std::strcmp(argv[1], "--help") == 0 || std::strcmp(argv[1], "-h") == 0) {
+        printUsage();
+        return argc < 2 ? 2 : 0;
+    }
+
+    const std::string command = argv[1];
+    const Arguments arguments(argc, argv, 2);
+    verbose = arguments.has("verbose");
+    qInstallMessageHandler(messageHandler);
+
+    // --trace=FILE：记录整个命令期间的跟踪区间，结束时导出为 Chrome trace-event JSON
+    const std::string traceFile = arguments.value("trace");
+    if (!traceFile.empty()) {
+        Tracer::instance().start();
+    }
+    // --metrics-snapshot=FILE：命令运行期间定时重写性能指标快照，结束时再写一次
+    const std::string metricsFile = arguments.value("metrics-snapshot");
+    std::unique_ptr<MetricsSampler> metricsSampler;
+    if (!metricsFile.empty()) {
+        metricsSampler = std::make_unique<MetricsSampler>(metricsFile,
+                                                          std::max(100, arguments.intValue("metrics-interval", 1000)));
+    }
+    const int result = runCommand(command, arguments);
+    metricsSampler.reset();
+    if (!traceFile.empty()) {
+        Tracer::instance().stop();
+        if (!Tracer::instance().exportJson(traceFile)) {
+            std::fprintf(stderr, "Could not write trace to %s\n", traceFile.c_str());
+        }
+    }
+    if (result >= 0) {
+        return result;
+    }
+
+    std::fprintf(stderr, "Unknown command: %s\n\n", command.c_str());
+    printUsage();
+    return 2;
+}
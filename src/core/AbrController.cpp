@@ -0,0 +1,155 @@
+/********************************************************************************
+ * @file   : AbrController.cpp
+ * @brief  : 实现了 aurorastream::core::AbrController 类。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/AbrController.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+constexpr double kBufferPerLevel = 2.0;         ///< 每多一个档位，BOLA 缓冲目标至少增加的秒数
+constexpr double kMinimumSampleSeconds = 0.05;  ///< 短于该时长的测量噪声太大，忽略
+}
+
+AbrController::AbrController(const std::vector<int64_t>& bitrates, const Options& options)
+    : m_bitrates(bitrates)
+    , m_options(options)
+{
+    if (m_bitrates.empty()) {
+        m_bitrates.push_back(1);
+    }
+    const double lowest = static_cast<double>(std::max<int64_t>(m_bitrates.front(), 1));
+    for (int64_t bitrate : m_bitrates) {
+        m_utilities.push_back(std::log(static_cast<double>(std::max<int64_t>(bitrate, 1)) / lowest) + 1.0);
+    }
+
+    // 选择 γp 和 Vp，使缓冲为 bolaBufferSeconds 时选最低档、为 bufferTime 时选最高档
+    const double bufferTime = std::max(m_options.stableBufferSeconds,
+                                       m_options.bolaBufferSeconds + kBufferPerLevel * static_cast<double>(m_bitrates.size()));
+    const double highest = m_utilities.back();
+    if (highest > 1.0 && m_options.bolaBufferSeconds > 0) {
+        m_gp = (highest - 1.0) / (bufferTime / m_options.bolaBufferSeconds - 1.0);
+        m_vp = m_options.bolaBufferSeconds / m_gp;
+    }
+}
+
+void AbrController::addSample(int64_t bytes, double seconds)
+{
+    if (seconds < kMinimumSampleSeconds || bytes <= 0) {
+        return;
+    }
+    const double sample = static_cast<double>(bytes) * 8.0 / seconds;
+
+    // 按下载时长加权：下载越久的测量越可信
+    auto update = [sample, seconds](double& estimate, double& weight, double halfLife) {
+        const double alpha = std::pow(0.5, seconds / halfLife);
+        estimate = alpha * estimate + (1.0 - alpha) * sample;
+        weight += seconds;
+    };
+    update(m_fastEstimate, m_fastWeight, m_options.fastHalfLife);
+    update(m_slowEstimate, m_slowWeight, m_options.slowHalfLife);
+}
+
+double AbrController::bandwidth() const
+{
+    if (m_fastWeight <= 0.0) {
+        return m_options.initialBandwidth;
+    }
+    // 零偏修正：初始估计为 0，测量较少时按已累计的权重放大
+    const double fast = m_fastEstimate / (1.0 - std::pow(0.5, m_fastWeight / m_options.fastHalfLife));
+    const double slow = m_slowEstimate / (1.0 - std::pow(0.5, m_slowWeight / m_options.slowHalfLife));
+    return std::min(fast, slow);
+}
+
+int AbrController::throughputQuality() const
+{
+    const double budget = bandwidth() * m_options.safetyFactor;
+    int quality = 0;
+    for (int i = 0; i < static_cast<int>(m_bitrates.size()); ++i) {
+        if (static_cast<double>(m_bitrates[i]) <= budget) {
+            quality = i;
+        }
+    }
+    return quality;
+}
+
+int AbrController::bolaQuality(double bufferSeconds) const
+{
+    if (m_gp <= 0.0) {
+        return 0;
+    }
+    int quality = 0;
+    double bestScore = -HUGE_VAL;
+    for (int i = 0; i < static_cast<int>(m_bitrates.size()); ++i) {
+        const double score = (m_vp * (m_utilities[i] + m_gp) - bufferSeconds) / static_cast<double>(m_bitrates[i]);
+        if (score >= bestScore) {
+            bestScore = score;
+            quality = i;
+        }
+    }
+    return quality;
+}
+
+/**
+ * @brief BOLA 选择不低于 quality 的档位所需的最低缓冲
+ */
+double AbrController::minimumBufferFor(int quality) const
+{
+    double level = 0.0;
+    const double bitrate = static_cast<double>(m_bitrates[quality]);
+    for (int i = quality - 1; i >= 0; --i) {
+        if (m_utilities[i] < m_utilities[quality]) {
+            const double lower = static_cast<double>(m_bitrates[i]);
+            level = std::max(level, m_vp * (m_gp + (bitrate * m_utilities[i] - lower * m_utilities[quality]) / (bitrate - lower)));
+        }
+    }
+    return level;
+}
+
+int AbrController::select(double bufferSeconds, int current)
+{
+    if (m_bitrates.size() == 1) {
+        return 0;
+    }
+
+    const int throughput = throughputQuality();
+    if (!m_bufferBased && bufferSeconds >= m_options.bolaBufferSeconds) {
+        // 切到 BOLA 时用虚拟缓冲补足差额，使 BOLA 从当前档位接手，而不是先降到低档
+        m_bufferBased = true;
+        m_placeholder = std::max(0.0, minimumBufferFor(std::max(current, 0)) - bufferSeconds);
+    } else if (m_bufferBased && bufferSeconds < m_options.bolaBufferSeconds * 0.5) {
+        m_bufferBased = false;
+        m_placeholder = 0.0;
+    }
+    if (!m_bufferBased) {
+        return throughput;
+    }
+
+    int quality = bolaQuality(bufferSeconds + m_placeholder);
+    if (quality > throughput && quality > current) {
+        quality = std::max(throughput, current);
+    }
+    return quality;
+}
+
+bool AbrController::isBufferBased() const
+{
+    return m_bufferBased;
+}
+
+void AbrController::reset()
+{
+    m_bufferBased = false;
+    m_placeholder = 0.0;
+}
+
+} // namespace core
+} // namespace aurorastream
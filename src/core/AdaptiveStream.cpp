@@ -0,0 +1,868 @@
+/********************************************************************************
+ * @file   : AdaptiveStream.cpp
+ * @brief  : 实现了 aurorastream::core::AdaptiveStream 类。
+ *
+ * 分段（Slot）按播放顺序排成队列。在途的下载任务少于 maxInFlight 时，取队列中第一个
+ * 等待下载的分段提交到线程池；没有时才调度下一个分段并在此刻选择档位，所以档位决定
+ * 总是基于最新的带宽估计和缓冲水位。读取方（解复用线程）只读取队首分段已下载的部分，
+ * 队首读完后出队，释放的预取额度触发新的下载任务；下载任务结束时也会继续提交。
+ *
+ * 下载是阻塞的网络读写，以后台优先级提交：线程池最多让一半的工作线程执行后台任务，
+ * 慢速网络不会占满解码和音频所需的线程。
+ *
+ * 网络访问使用 FFmpeg 的协议层（avio_open2），与播放器打开网络地址时的
+ * 协议支持、代理和 TLS 设置一致；字节区间用 http 协议的 offset / end_offset 选项。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/AdaptiveStream.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+#include "aurorastream/core/TaskScheduler.h"
+#include "aurorastream/utils/Tracer.h"
+#include "NetworkUtils.h"
+
+#include <QtCore/QUrl>
+#include <QtCore/QDebug>
+#include <QtCore/QFileInfo>
+
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+
+extern "C" {
+#include <libavutil/mem.h>
+#include <libavutil/dict.h>
+#include <libavutil/error.h>
+#include <libavformat/avformat.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+constexpr int kAvioBufferSize = 64 * 1024;      ///< 交给 FFmpeg 的 AVIO 缓冲区大小
+constexpr int kReadSize = 64 * 1024;            ///< 下载时单次读取的大小，也是解复用器能看到新数据的粒度
+constexpr int kLiveStartSegments = 3;           ///< 直播从倒数第几个分段开始（RFC 8216 建议不少于 3 个目标时长）
+
+int64_t nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief 用 FFmpeg 的协议层读取一个资源（或其中的字节区间），边读边交给 sink
+ * @param length 字节数，-1 表示读到结尾
+ * @return 0 表示成功；sink 返回 false 时返回 AVERROR_EXIT；其他为 FFmpeg 错误码
+ */
+int fetch(const QString& url, int64_t offset, int64_t length, double timeout,
+          const AVIOInterruptCB* interrupt, const std::function<bool(const uint8_t*, int)>& sink)
+{
+    const QUrl parsed(url);
+    const std::string location = (parsed.isLocalFile() ? parsed.toLocalFile() : url).toStdString();
+    const bool http = url.startsWith("http://") || url.startsWith("https://");
+
+    AVDictionary* options = nullptr;
+    av_dict_set_int(&options, "rw_timeout", static_cast<int64_t>(timeout * 1e6), 0);
+    if (http && offset > 0) {
+        av_dict_set_int(&options, "offset", offset, 0);
+    }
+    if (http && length >= 0) {
+        av_dict_set_int(&options, "end_offset", offset + length, 0);
+    }
+    AVIOContext* io = nullptr;
+    int ret = avio_open2(&io, location.c_str(), AVIO_FLAG_READ, interrupt, &options);
+    av_dict_free(&options);
+    if (ret < 0) {
+        return ret;
+    }
+    if (!http && offset > 0) {
+        const int64_t position = avio_seek(io, offset, SEEK_SET);
+        if (position < 0) {
+            avio_closep(&io);
+            return static_cast<int>(position);
+        }
+    }
+
+    std::vector<uint8_t> buffer(kReadSize);
+    int64_t remaining = length;
+    ret = 0;
+    while (remaining != 0) {
+        const int want = remaining < 0 ? kReadSize : static_cast<int>(std::min<int64_t>(remaining, kReadSize));
+        // 有数据就返回，不凑满缓冲区，解复用器可以尽早读到
+        const int received = avio_read_partial(io, buffer.data(), want);
+        if (received == AVERROR_EOF || received == 0) {
+            break;
+        }
+        if (received < 0) {
+            ret = received;
+            break;
+        }
+        if (!sink(buffer.data(), received)) {
+            ret = AVERROR_EXIT;
+            break;
+        }
+        if (remaining > 0) {
+            remaining -= received;
+        }
+    }
+    avio_closep(&io);
+    return ret;
+}
+
+int fetchText(const QString& url, double timeout, const AVIOInterruptCB* interrupt, std::string* text)
+{
+    text->clear();
+    return fetch(url, 0, -1, timeout, interrupt, [text](const uint8_t* data, int size) {
+        text->append(reinterpret_cast<const char*>(data), static_cast<std::size_t>(size));
+        return true;
+    });
+}
+
+/**
+ * @brief 视频编码族（avc1、hvc1、vp09、av01 ...），不同编码族的档位不能拼接到同一个解码器
+ */
+std::string videoCodecFamily(const std::string& codecs)
+{
+    std::size_t begin = 0;
+    while (begin < codecs.size()) {
+        std::size_t end = codecs.find(',', begin);
+        if (end == std::string::npos) {
+            end = codecs.size();
+        }
+        std::string codec = codecs.substr(begin, end - begin);
+        codec.erase(0, codec.find_first_not_of(' '));
+        std::string family = codec.substr(0, 4);
+        if (family == "avc3") {
+            family = "avc1";
+        } else if (family == "hev1") {
+            family = "hvc1";
+        }
+        if (family == "avc1" || family == "hvc1" || family == "vp09" || family == "vp08"
+            || family == "av01" || family == "mp4v") {
+            return family;
+        }
+        begin = end + 1;
+    }
+    return std::string();
+}
+
+std::vector<int64_t> bitratesOf(const StreamManifest& manifest)
+{
+    std::vector<int64_t> bitrates;
+    for (int i = 0; i < manifest.renditionCount(); ++i) {
+        bitrates.push_back(manifest.rendition(i).bandwidth);
+    }
+    return bitrates;
+}
+
+/// 下载的中断条件：析构或跳转（代数变化）
+struct InterruptContext {
+    const std::atomic<bool>* stopping;
+    const std::atomic<uint64_t>* generation;
+    uint64_t expected;
+};
+
+} // namespace
+
+/**
+ * @brief 一个待播放的分段（或 fMP4 初始化分段）
+ */
+struct AdaptiveStream::Slot {
+    enum class State {
+        Pending,
+        Fetching,
+        Done,
+        Failed
+    };
+
+    StreamManifest::Segment segment;
+    int rendition = 0;
+    bool init = false;
+    State state = State::Pending;
+    int attempts = 0;
+    std::vector<uint8_t> data;                  ///< 已下载的部分
+    std::size_t readOffset = 0;                 ///< 已交给解复用器的字节数
+};
+
+AdaptiveStream::AdaptiveStream(std::unique_ptr<StreamManifest> manifest, const Options& options)
+    : m_options(options)
+    , m_manifest(std::move(manifest))
+    , m_abr(bitratesOf(*m_manifest), options.abr)
+    , m_quality(options.quality)
+    , m_excluded(m_manifest->renditionCount(), false)
+    , m_loading(m_manifest->renditionCount(), false)
+    , m_lastReload(m_manifest->renditionCount(), 0)
+{
+}
+
+AdaptiveStream::~AdaptiveStream()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_retryWakeup.notify_all();
+    m_dataAvailable.notify_all();
+    // 在途的下载通过中断回调尽快结束
+    m_tasks.wait();
+    if (m_avio) {
+        av_freep(&m_avio->buffer);
+        avio_context_free(&m_avio);
+    }
+}
+
+bool AdaptiveStream::isManifest(const QString& uri)
+{
+    return StreamManifest::isManifestUrl(uri);
+}
+
+std::unique_ptr<AdaptiveStream> AdaptiveStream::open(const QString& uri, const Options& options, QString* errorMessage)
+{
+    AURORASTREAM_TRACE_SCOPE("abr.open", "io");
+
+    auto fail = [errorMessage](const QString& message) {
+        qWarning() << message;
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        return nullptr;
+    };
+
+    const int64_t openStart = nowUs();
+    const bool isUrl = uri.contains("://");
+    const QString url = isUrl ? uri : QUrl::fromLocalFile(QFileInfo(uri).absoluteFilePath()).toString();
+    if (isUrl) {
+        detail::ensureNetworkInitialized();
+    }
+
+    std::string text;
+    int ret = fetchText(url, options.timeoutSeconds, nullptr, &text);
+    if (ret < 0) {
+        char errbuf[AV_ERROR_MAX_STRING_SIZE] = {0};
+        av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
+        return fail(QString("AdaptiveStream::open() failed. Could not read manifest %1: %2").arg(uri, errbuf));
+    }
+    std::unique_ptr<StreamManifest> manifest = StreamManifest::parse(text, url, errorMessage);
+    if (!manifest) {
+        return nullptr;
+    }
+
+    std::unique_ptr<AdaptiveStream> stream(new AdaptiveStream(std::move(manifest), options));
+    stream->m_openStart = openStart;
+    StreamManifest& parsed = *stream->m_manifest;
+
+    // 初始档位：固定画质按分辨率选择，自动时按初始带宽估计选择
+    int initial = options.quality == QualityLevel::ADAPTIVE ? stream->m_abr.throughputQuality()
+                                                            : stream->fixedRenditionLocked(options.quality);
+    if (!parsed.rendition(initial).loaded) {
+        ret = fetchText(parsed.rendition(initial).playlistUrl, options.timeoutSeconds, nullptr, &text);
+        QString playlistError = "could not read playlist";
+        if (ret < 0 || !parsed.loadMediaPlaylist(initial, text, &playlistError)) {
+            return fail(QString("AdaptiveStream::open() failed. Could not load media playlist %1: %2")
+                            .arg(parsed.rendition(initial).playlistUrl, playlistError));
+        }
+        stream->m_lastReload[initial] = nowUs();
+    }
+    const StreamManifest::Rendition& rendition = parsed.rendition(initial);
+    if (rendition.encrypted) {
+        return fail(QString("AdaptiveStream::open() failed. Encrypted segments are not supported: %1").arg(uri));
+    }
+    if (rendition.segments.empty()) {
+        return fail(QString("AdaptiveStream::open() failed. Media playlist has no segments: %1").arg(uri));
+    }
+
+    // 只在同一编码族内切换；带初始化分段的 fMP4 档位在启动后固定
+    const std::string family = videoCodecFamily(rendition.codecs);
+    for (int i = 0; i < parsed.renditionCount(); ++i) {
+        const std::string other = videoCodecFamily(parsed.rendition(i).codecs);
+        stream->m_excluded[i] = !family.empty() && !other.empty() && other != family;
+    }
+    if (!rendition.init.url.isEmpty()) {
+        stream->m_switchable = false;
+        stream->m_lockedRendition = initial;
+        auto slot = std::make_shared<Slot>();
+        slot->segment = rendition.init;
+        slot->rendition = initial;
+        slot->init = true;
+        stream->m_slots.push_back(slot);
+        qDebug() << "AdaptiveStream: Fragmented MP4 renditions, bitrate switching disabled.";
+    }
+    stream->m_lastRendition = initial;
+    const int start = rendition.live ? std::max<int>(0, static_cast<int>(rendition.segments.size()) - kLiveStartSegments) : 0;
+    stream->m_nextNumber = rendition.segments[start].number;
+
+    auto* avioBuffer = static_cast<unsigned char*>(av_malloc(kAvioBufferSize));
+    if (!avioBuffer) {
+        return fail("AdaptiveStream::open() failed. Could not allocate I/O buffer.");
+    }
+    stream->m_avio = avio_alloc_context(avioBuffer, kAvioBufferSize, 0, stream.get(), &AdaptiveStream::readPacket,
+                                       nullptr, &AdaptiveStream::seekPacket);
+    if (!stream->m_avio) {
+        av_free(avioBuffer);
+        return fail("AdaptiveStream::open() failed. Could not allocate I/O context.");
+    }
+    stream->m_avio->seekable = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(stream->m_mutex);
+        stream->dispatchLocked();
+    }
+
+    qDebug() << "AdaptiveStream: Opened" << uri << "with" << parsed.renditionCount() << "renditions, starting at"
+             << rendition.bandwidth << "bit/s" << (rendition.live ? "(live)" : "");
+    return stream;
+}
+
+AVIOContext* AdaptiveStream::avioContext() const
+{
+    return m_avio;
+}
+
+int AdaptiveStream::readPacket(void* opaque, uint8_t* buf, int size)
+{
+    return static_cast<AdaptiveStream*>(opaque)->read(buf, size);
+}
+
+/**
+ * @brief 分段拼接成的字节流既没有总大小，也不能按字节随机访问；
+ * 只接受跳到当前读取位置，seek() 借此让 avio_seek 丢弃缓冲
+ */
+int64_t AdaptiveStream::seekPacket(void* opaque, int64_t offset, int whence)
+{
+    auto* stream = static_cast<AdaptiveStream*>(opaque);
+    if ((whence & ~AVSEEK_FORCE) != SEEK_SET) {
+        return AVERROR(ENOSYS);
+    }
+    std::lock_guard<std::mutex> lock(stream->m_mutex);
+    return offset == stream->m_readPosition ? offset : AVERROR(ENOSYS);
+}
+
+int AdaptiveStream::interrupted(void* opaque)
+{
+    const auto* context = static_cast<const InterruptContext*>(opaque);
+    return context->stopping->load() || context->generation->load() != context->expected;
+}
+
+/**
+ * @brief 解复用线程读取：只读队首分段已下载的部分，没有数据时等待并计入卡顿
+ */
+int AdaptiveStream::read(uint8_t* buf, int size)
+{
+    static PerformanceMonitor& monitor = PerformanceMonitor::instance();
+    static Counter& rebuffers = monitor.counter("abr.rebuffers");
+    static Gauge& bufferGauge = monitor.gauge("abr.buffer_ms");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    int64_t waitStart = 0;
+    bool stalled = false;
+    auto endWait = [&] {
+        if (waitStart && stalled) {
+            m_statistics.rebufferTimeUs += nowUs() - waitStart;
+        }
+    };
+
+    for (;;) {
+        if (m_stopping) {
+            return AVERROR_EXIT;
+        }
+        if (!m_slots.empty()) {
+            Slot& slot = *m_slots.front();
+            const std::size_t available = slot.data.size() - slot.readOffset;
+            if (available > 0) {
+                const int count = static_cast<int>(std::min<std::size_t>(available, static_cast<std::size_t>(size)));
+                std::memcpy(buf, slot.data.data() + slot.readOffset, static_cast<std::size_t>(count));
+                slot.readOffset += static_cast<std::size_t>(count);
+                m_readPosition += count;
+                endWait();
+                if (!m_started) {
+                    m_started = true;
+                    m_statistics.startupTimeUs = nowUs() - m_openStart;
+                }
+                m_afterSeek = false;
+                if (slot.state == Slot::State::Done && slot.readOffset == slot.data.size()) {
+                    popFrontLocked();
+                }
+                bufferGauge.set(static_cast<int64_t>(bufferedLocked(true) * 1000.0));
+                return count;
+            }
+            if (slot.state == Slot::State::Done || slot.state == Slot::State::Failed) {
+                popFrontLocked();
+                continue;
+            }
+        } else if (m_ended) {
+            endWait();
+            return AVERROR_EOF;
+        }
+
+        // 队首分段还没有数据：启动和跳转后的等待不算卡顿
+        if (!waitStart) {
+            waitStart = nowUs();
+            stalled = m_started && !m_afterSeek;
+            if (stalled) {
+                ++m_statistics.rebufferCount;
+                rebuffers.add();
+            }
+        }
+        // 直播在没有新分段时需要定期刷新播放列表，等待期间定时重新调度
+        dispatchLocked();
+        if (m_lastRendition >= 0 && m_manifest->rendition(m_lastRendition).live) {
+            m_dataAvailable.wait_for(lock, std::chrono::milliseconds(250));
+        } else {
+            m_dataAvailable.wait(lock);
+        }
+    }
+}
+
+void AdaptiveStream::popFrontLocked()
+{
+    const std::shared_ptr<Slot> slot = m_slots.front();
+    m_slots.pop_front();
+    if (slot->init) {
+        // 初始化分段不计入播放时长
+    } else if (slot->state == Slot::State::Done) {
+        m_statistics.playedSeconds += slot->segment.duration;
+        m_weightedBitrate += static_cast<double>(m_manifest->rendition(slot->rendition).bandwidth) * slot->segment.duration;
+    } else {
+        ++m_statistics.skipped;
+    }
+    dispatchLocked();
+}
+
+/**
+ * @brief 提交下载任务，直到在途任务数达到 maxInFlight 或没有可做的工作：
+ * 先加载被请求的播放列表，再下载等待中的分段，没有时调度新的分段
+ */
+void AdaptiveStream::dispatchLocked()
+{
+    const int limit = std::max(1, m_options.maxInFlight);
+    while (!m_stopping && m_inFlight < limit) {
+        if (m_reloadRequest >= 0) {
+            const int rendition = m_reloadRequest;
+            m_reloadRequest = -1;
+            m_loading[rendition] = true;
+            submitLocked([this, rendition] { loadPlaylist(rendition); });
+            continue;
+        }
+
+        std::shared_ptr<Slot> slot;
+        for (const std::shared_ptr<Slot>& candidate : m_slots) {
+            if (candidate->state == Slot::State::Pending) {
+                slot = candidate;
+                break;
+            }
+        }
+        if (!slot) {
+            slot = scheduleLocked();
+        }
+        if (!slot) {
+            // 调度时可能请求了播放列表加载
+            if (m_reloadRequest >= 0) {
+                continue;
+            }
+            return;
+        }
+
+        slot->state = Slot::State::Fetching;
+        const uint64_t generation = m_generation;
+        beginFetchLocked();
+        submitLocked([this, slot, generation] {
+            fetchSlot(slot, generation);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            endFetchLocked();
+            m_dataAvailable.notify_all();
+        });
+    }
+}
+
+/**
+ * @brief 把一个下载任务提交到线程池，结束后释放在途名额并继续调度
+ */
+void AdaptiveStream::submitLocked(std::function<void()> task)
+{
+    ++m_inFlight;
+    TaskScheduler::instance().submit(TaskScheduler::Priority::Background, [this, task = std::move(task)] {
+        task();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_inFlight;
+        dispatchLocked();
+    }, &m_tasks);
+}
+
+/**
+ * @brief 调度下一个分段并选择档位
+ * @return 新分段；预取已满、需要先加载播放列表或已经调度完时返回 nullptr
+ */
+std::shared_ptr<AdaptiveStream::Slot> AdaptiveStream::scheduleLocked()
+{
+    static Counter& switches = PerformanceMonitor::instance().counter("abr.switches");
+    static Gauge& bitrateGauge = PerformanceMonitor::instance().gauge("abr.bitrate_kbps");
+
+    if (m_ended || bufferedLocked(false) >= m_options.maxBufferSeconds) {
+        return nullptr;
+    }
+
+    const int rendition = chooseRenditionLocked();
+    const StreamManifest::Rendition& info = m_manifest->rendition(rendition);
+    if (!info.loaded) {
+        return nullptr;
+    }
+
+    int index = m_manifest->findSegment(rendition, m_nextNumber);
+    if (index < 0) {
+        if (!info.segments.empty() && m_nextNumber < info.segments.front().number) {
+            // 直播窗口已经滑过（例如长时间暂停），从窗口开头继续
+            m_nextNumber = info.segments.front().number;
+            index = 0;
+        } else if (info.live) {
+            // 还没有下一个分段：间隔半个目标时长刷新播放列表
+            const int64_t interval = static_cast<int64_t>(std::max(info.targetDuration, 1.0) * 500000.0);
+            if (!m_loading[rendition] && nowUs() - m_lastReload[rendition] >= interval) {
+                m_reloadRequest = rendition;
+            }
+            return nullptr;
+        } else {
+            m_ended = true;
+            m_dataAvailable.notify_all();
+            return nullptr;
+        }
+    }
+
+    auto slot = std::make_shared<Slot>();
+    slot->segment = info.segments[index];
+    slot->rendition = rendition;
+    m_slots.push_back(slot);
+    ++m_nextNumber;
+
+    if (m_lastRendition >= 0 && rendition != m_lastRendition) {
+        ++m_statistics.switches;
+        switches.add();
+        qDebug() << "AdaptiveStream: Switching to" << info.bandwidth << "bit/s at segment" << slot->segment.number;
+    }
+    m_lastRendition = rendition;
+    bitrateGauge.set(info.bandwidth / 1000);
+
+    // 直播：即使还有分段，也按目标时长刷新播放列表
+    if (info.live && !m_loading[rendition]
+        && nowUs() - m_lastReload[rendition] >= static_cast<int64_t>(info.targetDuration * 1e6)) {
+        m_reloadRequest = rendition;
+    }
+    return slot;
+}
+
+int AdaptiveStream::chooseRenditionLocked()
+{
+    if (m_lockedRendition >= 0) {
+        return m_lockedRendition;
+    }
+
+    const int desired = usableRenditionLocked(m_quality == QualityLevel::ADAPTIVE
+                                              ? m_abr.select(bufferedLocked(true), m_lastRendition)
+                                              : fixedRenditionLocked(m_quality));
+    if (m_manifest->rendition(desired).loaded) {
+        return desired;
+    }
+    // 目标档位的播放列表还没有加载：先请求加载，这个分段继续用当前档位
+    if (!m_loading[desired]) {
+        m_reloadRequest = desired;
+    }
+    return m_lastRendition >= 0 ? m_lastRendition : desired;
+}
+
+/**
+ * @brief 跳过被排除的档位：先向下找，找不到再向上找
+ */
+int AdaptiveStream::usableRenditionLocked(int rendition) const
+{
+    for (int i = rendition; i >= 0; --i) {
+        if (!m_excluded[i]) {
+            return i;
+        }
+    }
+    for (int i = rendition + 1; i < m_manifest->renditionCount(); ++i) {
+        if (!m_excluded[i]) {
+            return i;
+        }
+    }
+    return rendition;
+}
+
+/**
+ * @brief 固定画质对应的档位：按分辨率高度上限选择，清单没有分辨率时按码率排序的位置选择
+ */
+int AdaptiveStream::fixedRenditionLocked(QualityLevel quality) const
+{
+    const int count = m_manifest->renditionCount();
+    int maxHeight = 0;
+    double fraction = 1.0;
+    switch (quality) {
+    case QualityLevel::LOW: maxHeight = 480; fraction = 0.0; break;
+    case QualityLevel::MEDIUM: maxHeight = 720; fraction = 1.0 / 3.0; break;
+    case QualityLevel::HIGH: maxHeight = 1080; fraction = 2.0 / 3.0; break;
+    default: maxHeight = 1 << 30; fraction = 1.0; break;
+    }
+
+    bool heightsKnown = true;
+    for (int i = 0; i < count; ++i) {
+        heightsKnown = heightsKnown && m_manifest->rendition(i).height > 0;
+    }
+    if (!heightsKnown) {
+        return static_cast<int>(fraction * (count - 1) + 0.5);
+    }
+    int rendition = 0;
+    for (int i = 0; i < count; ++i) {
+        if (m_manifest->rendition(i).height <= maxHeight) {
+            rendition = i;
+        }
+    }
+    return rendition;
+}
+
+/**
+ * @brief 预取的媒体时长
+ * @param downloadedOnly 只计算已下载完成的分段（ABR 使用）；否则包括正在下载和等待下载的（预取上限使用）
+ */
+double AdaptiveStream::bufferedLocked(bool downloadedOnly) const
+{
+    double seconds = 0.0;
+    for (const std::shared_ptr<Slot>& slot : m_slots) {
+        if (slot->init) {
+            continue;
+        }
+        if (slot->state == Slot::State::Done) {
+            const double unread = slot->data.empty() ? 0.0
+                                  : 1.0 - static_cast<double>(slot->readOffset) / static_cast<double>(slot->data.size());
+            seconds += slot->segment.duration * unread;
+        } else if (!downloadedOnly) {
+            seconds += slot->segment.duration;
+        }
+    }
+    return seconds;
+}
+
+void AdaptiveStream::fetchSlot(const std::shared_ptr<Slot>& slot, uint64_t generation)
+{
+    AURORASTREAM_TRACE_SCOPE("abr.fetch", "io");
+    static PerformanceMonitor& monitor = PerformanceMonitor::instance();
+    static Counter& bytes = monitor.counter("abr.bytes");
+    static Counter& errors = monitor.counter("abr.errors");
+    static Histogram& fetchTime = monitor.histogram("abr.segment_fetch_us");
+    static Gauge& bandwidthGauge = monitor.gauge("abr.bandwidth_kbps");
+
+    InterruptContext context {&m_stopping, &m_generation, generation};
+    const AVIOInterruptCB interrupt {&AdaptiveStream::interrupted, &context};
+    const int64_t started = nowUs();
+    int ret = 0;
+
+    for (;;) {
+        // 重试时从已收到的字节之后继续，解复用器可能已经读走了前面的部分
+        std::size_t received;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            received = slot->data.size();
+        }
+        const StreamManifest::Segment& segment = slot->segment;
+        const int64_t length = segment.length < 0 ? -1 : segment.length - static_cast<int64_t>(received);
+        if (length == 0) {
+            ret = 0;
+            break;
+        }
+
+        ret = fetch(segment.url, segment.offset + static_cast<int64_t>(received), length, m_options.timeoutSeconds,
+                    &interrupt, [this, &slot, generation](const uint8_t* data, int size) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping || m_generation != generation) {
+                return false;
+            }
+            slot->data.insert(slot->data.end(), data, data + size);
+            m_busyBytes += static_cast<uint64_t>(size);
+            m_statistics.bytes += static_cast<uint64_t>(size);
+            bytes.add(static_cast<uint64_t>(size));
+            m_dataAvailable.notify_all();
+            return true;
+        });
+        if (ret >= 0 || interrupted(&context)) {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        ++m_statistics.errors;
+        errors.add();
+        char errbuf[AV_ERROR_MAX_STRING_SIZE] = {0};
+        av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
+        qWarning() << "AdaptiveStream: Segment" << segment.url << "failed:" << errbuf;
+        if (++slot->attempts > m_options.maxRetries) {
+            break;
+        }
+        // 退避后重试，期间析构或跳转会立即唤醒
+        m_retryWakeup.wait_for(lock, std::chrono::milliseconds(200 * slot->attempts),
+                                 [this, generation] { return m_stopping || m_generation != generation; });
+        if (m_stopping || m_generation != generation) {
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stopping || m_generation != generation) {
+        return;
+    }
+    slot->state = ret >= 0 ? Slot::State::Done : Slot::State::Failed;
+    if (ret >= 0) {
+        ++m_statistics.segments;
+        fetchTime.record(nowUs() - started);
+
+        // 测量从上次测量到现在、有下载进行时收到的全部字节，并行下载得到的是总带宽
+        const int64_t busy = static_cast<int64_t>(busyTimeLocked());
+        m_abr.addSample(static_cast<int64_t>(m_busyBytes - m_sampleBytes), static_cast<double>(busy - m_sampleTime) / 1e6);
+        m_sampleTime = busy;
+        m_sampleBytes = m_busyBytes;
+        bandwidthGauge.set(static_cast<int64_t>(m_abr.bandwidth() / 1000.0));
+    }
+}
+
+void AdaptiveStream::loadPlaylist(int rendition)
+{
+    QString url;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        url = m_manifest->rendition(rendition).playlistUrl;
+    }
+    // 跳转不影响播放列表加载，只在析构时中断
+    static const std::atomic<uint64_t> kNoGeneration {0};
+    InterruptContext context {&m_stopping, &kNoGeneration, 0};
+    const AVIOInterruptCB interrupt {&AdaptiveStream::interrupted, &context};
+
+    std::string text;
+    const int ret = fetchText(url, m_options.timeoutSeconds, &interrupt, &text);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_loading[rendition] = false;
+    m_lastReload[rendition] = nowUs();
+    const bool wasLoaded = m_manifest->rendition(rendition).loaded;
+    QString errorMessage = "could not read playlist";
+    if (ret < 0 || !m_manifest->loadMediaPlaylist(rendition, text, &errorMessage)) {
+        ++m_statistics.errors;
+        qWarning() << "AdaptiveStream: Could not load media playlist" << url << ":" << errorMessage;
+        if (!wasLoaded) {
+            m_excluded[rendition] = true;
+        }
+    } else {
+        const StreamManifest::Rendition& info = m_manifest->rendition(rendition);
+        // 加密或 fMP4 的档位不能拼接进当前字节流
+        if (info.encrypted || (!info.init.url.isEmpty() && m_switchable)) {
+            m_excluded[rendition] = true;
+        }
+    }
+}
+
+double AdaptiveStream::busyTimeLocked() const
+{
+    return static_cast<double>(m_busyTime + (m_activeFetches > 0 ? nowUs() - m_busyStart : 0));
+}
+
+void AdaptiveStream::beginFetchLocked()
+{
+    if (m_activeFetches++ == 0) {
+        m_busyStart = nowUs();
+    }
+}
+
+void AdaptiveStream::endFetchLocked()
+{
+    if (--m_activeFetches == 0) {
+        m_busyTime += nowUs() - m_busyStart;
+    }
+}
+
+int64_t AdaptiveStream::seek(int64_t time)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const int rendition = m_lockedRendition >= 0 ? m_lockedRendition : std::max(m_lastRendition, 0);
+    const StreamManifest::Rendition& info = m_manifest->rendition(rendition);
+    if (info.live) {
+        return AVERROR(ENOSYS);
+    }
+    const int index = m_manifest->segmentAt(rendition, static_cast<double>(time) / 1e6);
+    if (index < 0) {
+        return AVERROR(EINVAL);
+    }
+
+    // 正在进行的下载检测到代数变化后中止，已预取的分段全部丢弃
+    ++m_generation;
+    m_slots.clear();
+    m_ended = false;
+    m_afterSeek = true;
+    m_nextNumber = info.segments[index].number;
+    m_abr.reset();
+    m_readPosition = 0;
+    m_retryWakeup.notify_all();
+    dispatchLocked();
+    const int64_t start = static_cast<int64_t>(info.segments[index].start * 1e6);
+    lock.unlock();
+
+    // direct 使 avio_seek 不在缓冲内跳转、也不向前读取，而是调用 seekPacket 并清空缓冲和 EOF 状态
+    const int direct = m_avio->direct;
+    m_avio->direct = 1;
+    const int64_t ret = avio_seek(m_avio, 0, SEEK_SET);
+    m_avio->direct = direct;
+    return ret < 0 ? ret : start;
+}
+
+void AdaptiveStream::setQuality(QualityLevel quality)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quality = quality;
+}
+
+QualityLevel AdaptiveStream::quality() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_quality;
+}
+
+const StreamManifest& AdaptiveStream::manifest() const
+{
+    return *m_manifest;
+}
+
+int64_t AdaptiveStream::duration() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int64_t>(m_manifest->duration() * 1e6);
+}
+
+bool AdaptiveStream::isLive() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastRendition >= 0 && m_manifest->rendition(m_lastRendition).live;
+}
+
+bool AdaptiveStream::isSwitchable() const
+{
+    return m_switchable;
+}
+
+AdaptiveStream::Statistics AdaptiveStream::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Statistics statistics = m_statistics;
+    const double rebuffer = static_cast<double>(statistics.rebufferTimeUs) / 1e6;
+    if (rebuffer + statistics.playedSeconds > 0.0) {
+        statistics.rebufferRatio = rebuffer / (rebuffer + statistics.playedSeconds);
+    }
+    if (statistics.playedSeconds > 0.0) {
+        statistics.averageBitrate = m_weightedBitrate / statistics.playedSeconds;
+    }
+    statistics.bandwidth = m_abr.bandwidth();
+    statistics.bufferSeconds = bufferedLocked(true);
+    statistics.rendition = m_lastRendition;
+    statistics.bitrate = m_lastRendition >= 0 ? m_manifest->rendition(m_lastRendition).bandwidth : 0;
+    return statistics;
+}
+
+} // namespace core
+} // namespace aurorastream
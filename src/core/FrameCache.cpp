@@ -0,0 +1,270 @@
+/********************************************************************************
+ * @file   : FrameCache.cpp
+ * @brief  : 实现了 aurorastream::core::FrameCache 类。
+ *
+ * 两个 GOP 只有在同一解码序列中先后写入时才被视为相邻（Gop::next），
+ * 因此跨越 GOP 的逐帧前进/后退不会越过没有解码过的区域。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/FrameCache.h"
+#include "FrameUtils.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+bool lessPts(const AVFrame* frame, int64_t pts)
+{
+    return frame->pts < pts;
+}
+
+bool ptsLess(int64_t pts, const AVFrame* frame)
+{
+    return pts < frame->pts;
+}
+
+} // namespace
+
+FrameCache::FrameCache(std::size_t memoryLimit)
+    : m_memoryLimit(memoryLimit)
+{
+}
+
+FrameCache::~FrameCache()
+{
+    clear();
+}
+
+void FrameCache::setMemoryLimit(std::size_t memoryLimit)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_memoryLimit = memoryLimit;
+    evict();
+}
+
+std::size_t FrameCache::memoryLimit() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_memoryLimit;
+}
+
+void FrameCache::insert(const AVFrame* frame)
+{
+    if (frame->pts == AV_NOPTS_VALUE) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_memoryLimit == 0) {
+        return;
+    }
+
+    GopMap::iterator gop;
+    if (frame->flags & AV_FRAME_FLAG_KEY) {
+        // 关键帧开启新的 GOP，并与同一序列中的上一个 GOP 相连
+        gop = m_gops.find(frame->pts);
+        if (gop == m_gops.end()) {
+            gop = m_gops.emplace(frame->pts, Gop()).first;
+            m_lru.push_front(frame->pts);
+            gop->second.lru = m_lru.begin();
+        }
+        auto open = m_gops.find(m_openGop);
+        if (open != m_gops.end() && open->first < frame->pts) {
+            open->second.next = frame->pts;
+        }
+        m_openGop = frame->pts;
+    } else {
+        gop = m_gops.find(m_openGop);
+        // 开放式 GOP 中显示顺序早于关键帧的前导帧无法保证可解码，不缓存
+        if (gop == m_gops.end() || frame->pts < gop->first) {
+            return;
+        }
+    }
+
+    std::vector<AVFrame*>& frames = gop->second.frames;
+    auto pos = std::lower_bound(frames.begin(), frames.end(), frame->pts, lessPts);
+    if (pos != frames.end() && (*pos)->pts == frame->pts) {
+        touch(gop);
+        return;
+    }
+
+    AVFrame* ref = av_frame_clone(frame);
+    if (!ref) {
+        return;
+    }
+    const std::size_t bytes = detail::frameBytes(ref);
+    frames.insert(pos, ref);
+    gop->second.bytes += bytes;
+    m_stats.bytes += bytes;
+    ++m_stats.frames;
+
+    touch(gop);
+    evict();
+}
+
+void FrameCache::resetSequence()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_openGop = AV_NOPTS_VALUE;
+}
+
+bool FrameCache::find(int64_t pts, AVFrame* out)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto gop = gopContaining(pts);
+    if (gop != m_gops.end()) {
+        const std::vector<AVFrame*>& frames = gop->second.frames;
+        auto pos = std::upper_bound(frames.begin(), frames.end(), pts, ptsLess);
+        if (pos != frames.begin()) {
+            const AVFrame* candidate = *std::prev(pos);
+            // 目标落在最后一帧之后时，需要确认中间没有未解码的帧
+            const bool covered = pos != frames.end()
+                || (gop->second.next != AV_NOPTS_VALUE && pts < gop->second.next)
+                || (candidate->duration > 0 && pts < candidate->pts + candidate->duration);
+            if (covered) {
+                touch(gop);
+                return output(candidate, out);
+            }
+        }
+    }
+    ++m_stats.misses;
+    return false;
+}
+
+bool FrameCache::next(int64_t pts, AVFrame* out)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto gop = gopContaining(pts);
+    if (gop != m_gops.end()) {
+        const std::vector<AVFrame*>& frames = gop->second.frames;
+        auto pos = std::upper_bound(frames.begin(), frames.end(), pts, ptsLess);
+        if (pos != frames.end()) {
+            touch(gop);
+            return output(*pos, out);
+        }
+
+        auto following = m_gops.find(gop->second.next);
+        if (following != m_gops.end() && !following->second.frames.empty()) {
+            touch(following);
+            return output(following->second.frames.front(), out);
+        }
+    }
+    ++m_stats.misses;
+    return false;
+}
+
+bool FrameCache::previous(int64_t pts, AVFrame* out)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto gop = gopContaining(pts);
+    if (gop != m_gops.end()) {
+        const std::vector<AVFrame*>& frames = gop->second.frames;
+        auto pos = std::lower_bound(frames.begin(), frames.end(), pts, lessPts);
+        const bool covered = pos != frames.end() || gop->second.next != AV_NOPTS_VALUE
+            || (!frames.empty() && frames.back()->duration > 0
+                && pts <= frames.back()->pts + frames.back()->duration);
+        if (pos != frames.begin() && covered) {
+            touch(gop);
+            return output(*std::prev(pos), out);
+        }
+
+        if (pos == frames.begin()) {
+            auto preceding = gopBefore(gop);
+            if (preceding != m_gops.end() && !preceding->second.frames.empty()) {
+                touch(preceding);
+                return output(preceding->second.frames.back(), out);
+            }
+        }
+    }
+    ++m_stats.misses;
+    return false;
+}
+
+void FrameCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    while (!m_gops.empty()) {
+        erase(m_gops.begin());
+    }
+    m_openGop = AV_NOPTS_VALUE;
+}
+
+FrameCache::Statistics FrameCache::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+FrameCache::GopMap::iterator FrameCache::gopContaining(int64_t pts)
+{
+    auto gop = m_gops.upper_bound(pts);
+    if (gop == m_gops.begin()) {
+        return m_gops.end();
+    }
+    return std::prev(gop);
+}
+
+FrameCache::GopMap::iterator FrameCache::gopBefore(GopMap::iterator gop)
+{
+    if (gop == m_gops.begin()) {
+        return m_gops.end();
+    }
+    auto preceding = std::prev(gop);
+    return preceding->second.next == gop->first ? preceding : m_gops.end();
+}
+
+void FrameCache::touch(GopMap::iterator gop)
+{
+    m_lru.splice(m_lru.begin(), m_lru, gop->second.lru);
+}
+
+/**
+ * @brief 按 LRU 淘汰 GOP，直到内存占用不超过上限
+ * 正在写入的 GOP 最后才被淘汰
+ */
+void FrameCache::evict()
+{
+    while (m_stats.bytes > m_memoryLimit && !m_lru.empty()) {
+        auto victim = std::prev(m_lru.end());
+        if (*victim == m_openGop && m_lru.size() > 1) {
+            victim = std::prev(victim);
+        }
+        if (*victim == m_openGop) {
+            m_openGop = AV_NOPTS_VALUE;
+        }
+        erase(m_gops.find(*victim));
+        ++m_stats.evictions;
+    }
+}
+
+void FrameCache::erase(GopMap::iterator gop)
+{
+    for (AVFrame*& frame : gop->second.frames) {
+        av_frame_free(&frame);
+    }
+    m_stats.bytes -= gop->second.bytes;
+    m_stats.frames -= gop->second.frames.size();
+    m_lru.erase(gop->second.lru);
+    m_gops.erase(gop);
+}
+
+bool FrameCache::output(const AVFrame* frame, AVFrame* out)
+{
+    av_frame_unref(out);
+    if (av_frame_ref(out, frame) < 0) {
+        ++m_stats.misses;
+        return false;
+    }
+    ++m_stats.hits;
+    return true;
+}
+
+} // namespace core
+} // namespace aurorastream
@@ -0,0 +1,76 @@
+/********************************************************************************
+ * @file   : FrameUtils.h
+ * @brief  : Core 模块内部使用的 AVFrame 辅助函数。
+ *
+ * 供帧缓存、循环、倒放和播放列表引擎共用，不属于公共接口。
+ *
+ * @author : polarours
+ * @date   : 2026/10/19
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_FRAMEUTILS_H
+#define AURORASTREAM_CORE_FRAMEUTILS_H
+
+#include <cstddef>
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/mathematics.h>
+#include <libavutil/samplefmt.h>
+}
+
+namespace aurorastream {
+namespace core {
+namespace detail {
+
+/**
+ * @brief 帧引用的缓冲区占用的内存（字节），用于各缓存的内存上限
+ */
+inline std::size_t frameBytes(const AVFrame* frame)
+{
+    std::size_t bytes = 0;
+    for (int i = 0; i < AV_NUM_DATA_POINTERS && frame->buf[i]; ++i) {
+        bytes += frame->buf[i]->size;
+    }
+    for (int i = 0; i < frame->nb_extended_buf; ++i) {
+        bytes += frame->extended_buf[i]->size;
+    }
+    return bytes;
+}
+
+/**
+ * @brief 去掉音频帧开头的若干样本
+ * 剩余样本拷贝到新分配的缓冲区（原帧可能被缓存共享），pts 和 duration
+ * 按帧自身的 time_base 换算。
+ * @param frame 音频帧，0 < samples < nb_samples
+ * @param samples 去掉的样本数
+ * @return 新分配的帧；失败时返回 nullptr
+ */
+inline AVFrame* trimFront(const AVFrame* frame, int samples)
+{
+    AVFrame* trimmed = av_frame_alloc();
+    if (!trimmed) {
+        return nullptr;
+    }
+    trimmed->format = frame->format;
+    trimmed->sample_rate = frame->sample_rate;
+    trimmed->nb_samples = frame->nb_samples - samples;
+    if (av_channel_layout_copy(&trimmed->ch_layout, &frame->ch_layout) < 0
+        || av_frame_get_buffer(trimmed, 0) < 0) {
+        av_frame_free(&trimmed);
+        return nullptr;
+    }
+    av_samples_copy(trimmed->extended_data, frame->extended_data, 0, samples, trimmed->nb_samples,
+                    frame->ch_layout.nb_channels, static_cast<AVSampleFormat>(frame->format));
+    const AVRational sampleBase {1, frame->sample_rate};
+    trimmed->time_base = frame->time_base;
+    trimmed->pts = frame->pts + av_rescale_q(samples, sampleBase, frame->time_base);
+    trimmed->duration = av_rescale_q(trimmed->nb_samples, sampleBase, frame->time_base);
+    return trimmed;
+}
+
+} // namespace detail
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_FRAMEUTILS_H
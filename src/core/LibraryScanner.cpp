@@ -0,0 +1,613 @@
+/********************************************************************************
+ * @file   : LibraryScanner.cpp
+ * @brief  : 实现了 aurorastream::core::LibraryScanner 类。
+ *
+ * 扫描线程本身只负责汇总和写库：开始时一次性读出各目标目录下已入库文件的
+ * (大小, 修改时间)，之后目录遍历和探测都在 TaskScheduler 的后台任务中进行，
+ * 结果经 MpscQueue 回到扫描线程，攒满一批或超过写入间隔就提交一个事务。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/LibraryScanner.h"
+#include "aurorastream/core/MediaLibrary.h"
+#include "aurorastream/core/MpscQueue.h"
+#include "aurorastream/core/ProbeCache.h"
+#include "aurorastream/core/TaskScheduler.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QDebug>
+#include <QtCore/QFileInfo>
+#include <QtCore/QDateTime>
+#include <QtCore/QDirIterator>
+
+#include <mutex>
+#include <cctype>
+#include <chrono>
+#include <algorithm>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#endif
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavutil/dict.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+constexpr std::size_t kBatchSize = 512;
+constexpr auto kFlushInterval = std::chrono::milliseconds(500);
+constexpr auto kWatchDebounce = std::chrono::seconds(1);
+
+struct ScanResult {
+    enum class Kind { Unchanged, Probed, Failed, DirectoryFailed };
+
+    Kind kind = Kind::Unchanged;
+    MediaLibrary::MediaFile file;   ///< Probed 时为完整记录，其余只有 path
+};
+
+/**
+ * @brief 一次扫描中各任务共享的状态
+ */
+struct ScanState {
+    MpscQueue<ScanResult> results;
+    std::atomic<int64_t> pending {0};       ///< 已入队、尚未被扫描线程取出的结果数
+    std::atomic<int64_t> running {0};       ///< 已提交、尚未结束的遍历和探测任务数
+    std::atomic<uint64_t> directories {0};
+    std::unordered_map<std::string, MediaLibrary::FileState> known;    ///< 扫描开始后只读
+    const std::atomic<bool>* cancelled = nullptr;
+    std::mutex mutex;                       ///< 与 wakeup 配合，避免扫描线程错过通知
+    std::condition_variable wakeup;         ///< 有新结果或所有任务结束时通知扫描线程
+
+    void push(ScanResult result)
+    {
+        results.push(std::move(result));
+        pending.fetch_add(1, std::memory_order_release);
+        notify();
+    }
+
+    void notify()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+        }
+        wakeup.notify_one();
+    }
+};
+
+/**
+ * @brief 在线程池中执行一个扫描任务，任务结束时减少 running 计数
+ * 结果总是在任务结束之前入队，因此 running 为 0 时 pending 已经包含所有结果。
+ */
+template <typename Task>
+void submitScanTask(const std::shared_ptr<ScanState>& state, Task task)
+{
+    state->running.fetch_add(1, std::memory_order_acq_rel);
+    TaskScheduler::instance().submit(TaskScheduler::Priority::Background, [state, task = std::move(task)]() mutable {
+        task();
+        if (state->running.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            state->notify();
+        }
+    });
+}
+
+int64_t steadyMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief 只做解复用层的探测，提取媒体库需要的字段
+ */
+bool probeFile(MediaLibrary::MediaFile& file)
+{
+    static Histogram& probeTime = PerformanceMonitor::instance().histogram("library.probe_us");
+    const int64_t start = steadyMicros();
+
+    AVFormatContext* formatContext = nullptr;
+    if (avformat_open_input(&formatContext, file.path.c_str(), nullptr, nullptr) < 0) {
+        return false;
+    }
+    if (!ProbeCache::instance().restore(file.path, formatContext)) {
+        if (avformat_find_stream_info(formatContext, nullptr) < 0) {
+            avformat_close_input(&formatContext);
+            return false;
+        }
+        ProbeCache::instance().store(file.path, formatContext);
+    }
+
+    const AVDictionaryEntry* title = av_dict_get(formatContext->metadata, "title", nullptr, 0);
+    file.title = title && title->value[0]
+        ? std::string(title->value)
+        : QFileInfo(QString::fromStdString(file.path)).completeBaseName().toStdString();
+    file.format = formatContext->iformat->name;
+    file.duration = formatContext->duration != AV_NOPTS_VALUE
+        ? formatContext->duration / static_cast<double>(AV_TIME_BASE) : 0.0;
+    file.bitRate = formatContext->bit_rate;
+
+    for (unsigned int i = 0; i < formatContext->nb_streams; ++i) {
+        const AVStream* stream = formatContext->streams[i];
+        const AVCodecParameters* par = stream->codecpar;
+        // 音频文件的封面图不算视频流
+        if (par->codec_type == AVMEDIA_TYPE_VIDEO && file.videoCodec.empty()
+            && !(stream->disposition & AV_DISPOSITION_ATTACHED_PIC)) {
+            file.videoCodec = avcodec_get_name(par->codec_id);
+            file.width = par->width;
+            file.height = par->height;
+        } else if (par->codec_type == AVMEDIA_TYPE_AUDIO && file.audioCodec.empty()) {
+            file.audioCodec = avcodec_get_name(par->codec_id);
+        }
+    }
+    avformat_close_input(&formatContext);
+
+    probeTime.record(steadyMicros() - start);
+    return true;
+}
+
+/**
+ * @brief 遍历一个目录：未变化的文件直接回报，变化的文件提交探测任务，子目录提交新的遍历任务
+ */
+void crawlDirectory(const std::shared_ptr<ScanState>& state, const QString& directory, bool recursive)
+{
+    if (state->cancelled->load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    const QDir dir(directory);
+    if (!dir.exists() || !dir.isReadable()) {
+        ScanResult result;
+        result.kind = ScanResult::Kind::DirectoryFailed;
+        result.file.path = directory.toStdString();
+        state->push(std::move(result));
+        return;
+    }
+    state->directories.fetch_add(1, std::memory_order_relaxed);
+
+    QDirIterator it(directory, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        if (info.isDir()) {
+            // 不跟随目录符号链接，避免循环
+            if (recursive && !info.isSymLink()) {
+                const QString child = info.absoluteFilePath();
+                submitScanTask(state, [state, child] {
+                    crawlDirectory(state, child, true);
+                });
+            }
+            continue;
+        }
+
+        std::string path = info.absoluteFilePath().toStdString();
+        if (!LibraryScanner::isMediaFile(path)) {
+            continue;
+        }
+
+        ScanResult result;
+        result.file.path = std::move(path);
+        result.file.fileSize = info.size();
+        result.file.modifiedTime = info.lastModified().toMSecsSinceEpoch();
+
+        const auto known = state->known.find(result.file.path);
+        if (known != state->known.end() && known->second.fileSize == result.file.fileSize
+            && known->second.modifiedTime == result.file.modifiedTime) {
+            state->push(std::move(result));
+            continue;
+        }
+
+        submitScanTask(state, [state, result = std::move(result)]() mutable {
+            if (state->cancelled->load(std::memory_order_relaxed)) {
+                return;
+            }
+            result.kind = probeFile(result.file) ? ScanResult::Kind::Probed : ScanResult::Kind::Failed;
+            state->push(std::move(result));
+        });
+    }
+}
+
+bool isUnder(const std::string& path, const std::string& directory)
+{
+    return path.size() > directory.size() && path.compare(0, directory.size(), directory) == 0
+        && path[directory.size()] == '/';
+}
+
+} // namespace
+
+LibraryScanner::LibraryScanner(MediaLibrary& library, QObject* parent)
+    : QObject(parent)
+    , m_library(library)
+{
+}
+
+LibraryScanner::~LibraryScanner()
+{
+    unwatch();
+    cancel();
+    wait();
+}
+
+bool LibraryScanner::scan(const std::vector<std::string>& roots)
+{
+    std::vector<Target> targets;
+    for (const std::string& root : roots) {
+        Target target;
+        target.directory = QDir(QString::fromStdString(root)).absolutePath().toStdString();
+        targets.push_back(target);
+    }
+    return start(targets);
+}
+
+bool LibraryScanner::start(const std::vector<Target>& targets)
+{
+    bool expected = false;
+    if (!m_scanning.compare_exchange_strong(expected, true)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_threadMutex);
+    if (m_scanThread.joinable()) {
+        m_scanThread.join();
+    }
+    m_cancelled.store(false);
+    m_scanThread = std::thread(&LibraryScanner::run, this, targets);
+    return true;
+}
+
+void LibraryScanner::cancel()
+{
+    m_cancelled.store(true);
+}
+
+void LibraryScanner::wait()
+{
+    std::lock_guard<std::mutex> lock(m_threadMutex);
+    if (m_scanThread.joinable()) {
+        m_scanThread.join();
+    }
+}
+
+bool LibraryScanner::isScanning() const
+{
+    return m_scanning.load();
+}
+
+LibraryScanner::Statistics LibraryScanner::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+bool LibraryScanner::isMediaFile(const std::string& path)
+{
+    static const std::unordered_set<std::string> kExtensions = {
+        "3gp", "aac", "ac3", "aif", "aiff", "alac", "ape", "asf", "avi", "dts", "f4v", "flac", "flv",
+        "m2ts", "m4a", "m4v", "mka", "mkv", "mov", "mp2", "mp3", "mp4", "mpeg", "mpg", "mts", "mxf",
+        "ogg", "ogv", "opus", "rm", "rmvb", "ts", "vob", "wav", "webm", "wma", "wmv", "wv", "y4m",
+    };
+
+    const std::size_t dot = path.rfind('.');
+    if (dot == std::string::npos || path.find('/', dot) != std::string::npos) {
+        return false;
+    }
+    std::string extension = path.substr(dot + 1);
+    for (char& c : extension) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return kExtensions.count(extension) > 0;
+}
+
+/**
+ * @brief 扫描线程：分发遍历任务，汇总结果并分批写库，最后删除已消失的文件
+ */
+void LibraryScanner::run(std::vector<Target> targets)
+{
+    static Counter& filesCounter = PerformanceMonitor::instance().counter("library.files");
+    static Counter& probedCounter = PerformanceMonitor::instance().counter("library.probed");
+    static Counter& removedCounter = PerformanceMonitor::instance().counter("library.removed");
+    static Gauge& throughput = PerformanceMonitor::instance().gauge("library.files_per_sec");
+
+    const auto start = std::chrono::steady_clock::now();
+    auto state = std::make_shared<ScanState>();
+    state->cancelled = &m_cancelled;
+    for (const Target& target : targets) {
+        state->known.merge(m_library.fileStates(target.directory, target.recursive));
+    }
+
+    for (const Target& target : targets) {
+        const QString directory = QString::fromStdString(target.directory);
+        const bool recursive = target.recursive;
+        submitScanTask(state, [state, directory, recursive] {
+            crawlDirectory(state, directory, recursive);
+        });
+    }
+
+    Statistics statistics;
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> failedDirectories;
+    std::vector<MediaLibrary::MediaFile> batch;
+    batch.reserve(kBatchSize);
+    auto lastFlush = std::chrono::steady_clock::now();
+
+    auto publish = [&] {
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        statistics.directories = state->directories.load(std::memory_order_relaxed);
+        statistics.seconds = seconds;
+        statistics.filesPerSecond = seconds > 0 ? statistics.files / seconds : 0.0;
+        throughput.set(static_cast<int64_t>(statistics.filesPerSecond));
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_statistics = statistics;
+    };
+    auto flush = [&] {
+        if (!batch.empty()) {
+            m_library.write(batch, {});
+            ++statistics.batches;
+            batch.clear();
+        }
+        lastFlush = std::chrono::steady_clock::now();
+        publish();
+        emit scanProgress(static_cast<qint64>(statistics.files), static_cast<qint64>(statistics.probed));
+    };
+
+    for (;;) {
+        ScanResult result;
+        if (!state->results.pop(result)) {
+            // 所有任务结束且没有未取出的结果时扫描完成；否则结果可能正在入队
+            auto ready = [&state] {
+                return state->pending.load(std::memory_order_acquire) > 0
+                    || state->running.load(std::memory_order_acquire) == 0;
+            };
+            std::unique_lock<std::mutex> lock(state->mutex);
+            if (state->running.load(std::memory_order_acquire) == 0
+                && state->pending.load(std::memory_order_acquire) == 0) {
+                break;
+            }
+            if (batch.empty()) {
+                state->wakeup.wait(lock, ready);
+            } else if (!state->wakeup.wait_until(lock, lastFlush + kFlushInterval, ready)) {
+                // 超过写入间隔仍没有新结果，先提交已攒下的记录
+                lock.unlock();
+                flush();
+            }
+            continue;
+        }
+        state->pending.fetch_sub(1, std::memory_order_acq_rel);
+
+        switch (result.kind) {
+        case ScanResult::Kind::DirectoryFailed:
+            failedDirectories.push_back(result.file.path);
+            continue;
+        case ScanResult::Kind::Unchanged:
+            ++statistics.unchanged;
+            break;
+        case ScanResult::Kind::Probed:
+            ++statistics.probed;
+            probedCounter.add();
+            break;
+        case ScanResult::Kind::Failed:
+            ++statistics.failed;
+            break;
+        }
+        ++statistics.files;
+        filesCounter.add();
+        if (result.kind == ScanResult::Kind::Probed) {
+            seen.insert(result.file.path);
+            batch.push_back(std::move(result.file));
+        } else {
+            seen.insert(std::move(result.file.path));
+        }
+
+        if (batch.size() >= kBatchSize || std::chrono::steady_clock::now() - lastFlush >= kFlushInterval) {
+            flush();
+        }
+    }
+
+    // 取消的扫描不完整，不删除任何记录；无法读取的目录下的记录保留
+    std::vector<std::string> removed;
+    if (!m_cancelled.load()) {
+        for (const auto& entry : state->known) {
+            const std::string& path = entry.first;
+            if (seen.count(path)) {
+                continue;
+            }
+            bool keep = false;
+            for (const std::string& directory : failedDirectories) {
+                const bool deleted = std::any_of(targets.begin(), targets.end(), [&](const Target& target) {
+                    return target.removeIfMissing && target.directory == directory;
+                }) && !QFileInfo::exists(QString::fromStdString(directory));
+                if (!deleted && isUnder(path, directory)) {
+                    keep = true;
+                    break;
+                }
+            }
+            if (!keep) {
+                removed.push_back(path);
+            }
+        }
+    }
+    if (!m_library.write(batch, removed)) {
+        qWarning() << "LibraryScanner: Final batch write failed";
+    } else {
+        statistics.removed = removed.size();
+        removedCounter.add(removed.size());
+    }
+    batch.clear();
+    ++statistics.batches;
+    publish();
+
+    qDebug() << "LibraryScanner: Scanned" << statistics.files << "files in" << statistics.directories << "directories,"
+             << statistics.probed << "probed," << statistics.removed << "removed in" << statistics.seconds << "s ("
+             << statistics.filesPerSecond << "files/s)";
+
+    m_scanning.store(false);
+    emit scanProgress(static_cast<qint64>(statistics.files), static_cast<qint64>(statistics.probed));
+    emit scanFinished();
+}
+
+bool LibraryScanner::watch(const std::vector<std::string>& roots)
+{
+#ifdef __linux__
+    if (m_watchThread.joinable()) {
+        qWarning() << "LibraryScanner: Already watching";
+        return false;
+    }
+    const int watchFd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    m_wakeFd = eventfd(0, EFD_CLOEXEC);
+    if (watchFd < 0 || m_wakeFd < 0) {
+        qWarning() << "LibraryScanner: Could not initialise inotify, errno" << errno;
+        if (watchFd >= 0) close(watchFd);
+        if (m_wakeFd >= 0) close(m_wakeFd);
+        m_wakeFd = -1;
+        return false;
+    }
+
+    std::vector<std::string> absoluteRoots;
+    for (const std::string& root : roots) {
+        absoluteRoots.push_back(QDir(QString::fromStdString(root)).absolutePath().toStdString());
+    }
+    m_watchThread = std::thread(&LibraryScanner::watchLoop, this, watchFd, absoluteRoots);
+    return true;
+#else
+    Q_UNUSED(roots);
+    qWarning() << "LibraryScanner: Directory watching requires inotify";
+    return false;
+#endif
+}
+
+void LibraryScanner::unwatch()
+{
+#ifdef __linux__
+    if (!m_watchThread.joinable()) {
+        return;
+    }
+    const uint64_t one = 1;
+    [[maybe_unused]] const ssize_t written = write(m_wakeFd, &one, sizeof(one));
+    m_watchThread.join();
+    close(m_wakeFd);
+    m_wakeFd = -1;
+#endif
+}
+
+/**
+ * @brief 监视线程：为目录树中的每个目录添加 inotify 监视，把事件归并为待扫描目录，
+ *        静默一段时间且当前没有扫描时提交增量扫描
+ */
+void LibraryScanner::watchLoop(int watchFd, std::vector<std::string> roots)
+{
+#ifdef __linux__
+    constexpr uint32_t kMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE
+                             | IN_DELETE_SELF | IN_ONLYDIR;
+    std::unordered_map<int, std::string> directories;
+    auto addTree = [&](const std::string& root) {
+        auto add = [&](const QString& path) {
+            const int wd = inotify_add_watch(watchFd, path.toLocal8Bit().constData(), kMask);
+            if (wd >= 0) {
+                directories[wd] = path.toStdString();
+            } else if (errno == ENOSPC) {
+                qWarning() << "LibraryScanner: inotify watch limit reached (fs.inotify.max_user_watches)";
+            }
+        };
+        add(QString::fromStdString(root));
+        QDirIterator it(QString::fromStdString(root), QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden,
+                        QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            add(it.next());
+        }
+    };
+    for (const std::string& root : roots) {
+        addTree(root);
+    }
+
+    std::unordered_map<std::string, Target> pending;
+    auto enqueue = [&](const std::string& directory, bool recursive, bool removeIfMissing) {
+        const auto inserted = pending.try_emplace(directory);
+        Target& target = inserted.first->second;
+        target.directory = directory;
+        target.recursive = inserted.second ? recursive : (target.recursive || recursive);
+        target.removeIfMissing = target.removeIfMissing || removeIfMissing;
+    };
+
+    pollfd fds[2] = {{watchFd, POLLIN, 0}, {m_wakeFd, POLLIN, 0}};
+    alignas(inotify_event) char buffer[16 * 1024];
+    for (;;) {
+        const int timeout = pending.empty() ? -1 : static_cast<int>(std::chrono::milliseconds(kWatchDebounce).count());
+        const int ready = poll(fds, 2, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            qWarning() << "LibraryScanner: Watcher poll failed, errno" << errno;
+            break;
+        }
+        if (fds[1].revents) {
+            break;
+        }
+
+        if (ready == 0) {
+            // 静默超时：没有扫描在进行时提交，否则等下一个周期
+            std::vector<Target> targets;
+            for (auto& entry : pending) {
+                targets.push_back(std::move(entry.second));
+            }
+            if (start(targets)) {
+                pending.clear();
+            }
+            continue;
+        }
+
+        ssize_t length;
+        while ((length = read(watchFd, buffer, sizeof(buffer))) > 0) {
+            for (ssize_t offset = 0; offset < length; ) {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW) {
+                    // 事件丢失，退回到全量增量扫描
+                    for (const std::string& root : roots) {
+                        enqueue(root, true, false);
+                    }
+                    continue;
+                }
+                if (event->mask & IN_IGNORED) {
+                    directories.erase(event->wd);
+                    continue;
+                }
+                const auto directory = directories.find(event->wd);
+                if (directory == directories.end() || event->len == 0) {
+                    continue;
+                }
+
+                const std::string path = directory->second + "/" + event->name;
+                if (event->mask & IN_ISDIR) {
+                    if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                        addTree(path);
+                        enqueue(path, true, false);
+                    } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                        enqueue(path, true, true);
+                    }
+                } else if (isMediaFile(path) && (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM))) {
+                    enqueue(directory->second, false, false);
+                }
+            }
+        }
+    }
+    close(watchFd);
+#else
+    Q_UNUSED(watchFd);
+    Q_UNUSED(roots);
+#endif
+}
+
+} // namespace core
+} // namespace aurorastream
@@ -0,0 +1,520 @@
+/********************************************************************************
+ * @file   : LoopEngine.cpp
+ * @brief  : 实现了 aurorastream::core::LoopEngine 类。
+ *
+ * 开头缓存从区间起点开始，至少覆盖 headDuration，并延伸到下一个视频关键帧，
+ * 使缓存之后的内容可以从关键帧直接解码。每次循环回到缓存时，后台线程把
+ * 媒体源定位到缓存结尾之前的关键帧，解码并丢弃已缓存的部分，
+ * 得到的第一批衔接帧在缓存输出完毕后接上。
+ *
+ * 内部时间戳统一为源时间线上的微秒值，输出时再加上循环偏移。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/LoopEngine.h"
+#include "FrameUtils.h"
+
+#include <QtCore/QDebug>
+
+#include <algorithm>
+
+extern "C" {
+#include <libavutil/error.h>
+#include <libavutil/mathematics.h>
+#include <libavutil/samplefmt.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+/// 把帧的时间戳和时长换算为微秒
+void normalize(AVFrame* frame, AVMediaType type)
+{
+    if (type == AVMEDIA_TYPE_AUDIO && frame->sample_rate > 0) {
+        frame->duration = av_rescale(frame->nb_samples, AV_TIME_BASE, frame->sample_rate);
+    } else {
+        frame->duration = av_rescale_q(frame->duration, frame->time_base, AV_TIME_BASE_Q);
+    }
+    if (frame->pts != AV_NOPTS_VALUE) {
+        frame->pts = av_rescale_q(frame->pts, frame->time_base, AV_TIME_BASE_Q);
+    }
+    frame->time_base = AV_TIME_BASE_Q;
+}
+
+} // namespace
+
+LoopEngine::LoopEngine(QObject* parent)
+    : QObject(parent)
+{
+}
+
+LoopEngine::~LoopEngine()
+{
+    detach();
+}
+
+void LoopEngine::setOptions(const Options& options)
+{
+    m_options = options;
+}
+
+LoopEngine::Options LoopEngine::options() const
+{
+    return m_options;
+}
+
+bool LoopEngine::attach(MediaSource* source)
+{
+    detach();
+    if (!source) {
+        return false;
+    }
+
+    m_source = source;
+    m_iterations = 0;
+    m_offset = 0;
+    m_audioEnd = AV_NOPTS_VALUE;
+    m_videoEnd = AV_NOPTS_VALUE;
+    if (!buildHead()) {
+        emit error("LoopEngine::attach() failed. Could not cache the head of the loop range.");
+        clearFrames();
+        m_source = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void LoopEngine::detach()
+{
+    if (m_resyncPending) {
+        finishResync();
+    }
+    clearFrames();
+    m_source = nullptr;
+}
+
+bool LoopEngine::setRange(qint64 start, qint64 end)
+{
+    if (start < 0 || (end > 0 && end <= start)) {
+        emit error(QString("LoopEngine::setRange() failed. Invalid range: %1-%2").arg(start).arg(end));
+        return false;
+    }
+
+    m_rangeStart = start;
+    m_rangeEnd = end;
+    qDebug() << "LoopEngine: Range set to" << start << "-" << end;
+    return m_source ? buildHead() : true;
+}
+
+bool LoopEngine::clearRange()
+{
+    return setRange(0, 0);
+}
+
+qint64 LoopEngine::rangeStart() const
+{
+    return m_rangeStart;
+}
+
+qint64 LoopEngine::rangeEnd() const
+{
+    return m_rangeEnd;
+}
+
+bool LoopEngine::seek(qint64 position)
+{
+    if (!m_source) {
+        return false;
+    }
+    if (m_resyncPending) {
+        finishResync();
+    }
+
+    const qint64 end = m_rangeEnd > 0 ? m_rangeEnd : m_source->duration();
+    position = std::max(position, m_rangeStart);
+    if (end > 0) {
+        position = std::min(position, end);
+    }
+    if (m_source->seek(position) < 0) {
+        return false;
+    }
+
+    for (CachedFrame& cached : m_bridge) {
+        av_frame_free(&cached.frame);
+    }
+    m_bridge.clear();
+    m_videoDone = false;
+    m_audioDone = false;
+    m_phase = Phase::Source;
+    return true;
+}
+
+int LoopEngine::readFrame(AVFrame* frame, AVMediaType* type)
+{
+    if (!m_source) {
+        return AVERROR(EINVAL);
+    }
+
+    for (;;) {
+        switch (m_phase) {
+        case Phase::Head:
+            if (m_headCursor < m_head.size()) {
+                const CachedFrame& cached = m_head[m_headCursor++];
+                int ret = av_frame_ref(frame, cached.frame);
+                if (ret < 0) {
+                    return ret;
+                }
+                *type = cached.type;
+                return emitFrame(frame, *type);
+            }
+            if (m_headComplete) {
+                splice();
+                continue;
+            }
+            if (m_resyncPending && !finishResync()) {
+                emit error("LoopEngine: Could not reposition the source after the loop head.");
+                return AVERROR(EIO);
+            }
+            m_phase = Phase::Bridge;
+            continue;
+
+        case Phase::Bridge:
+            if (!m_bridge.empty()) {
+                CachedFrame cached = m_bridge.front();
+                m_bridge.pop_front();
+                av_frame_move_ref(frame, cached.frame);
+                av_frame_free(&cached.frame);
+                *type = cached.type;
+                return emitFrame(frame, *type);
+            }
+            m_phase = Phase::Source;
+            continue;
+
+        case Phase::Source: {
+            int ret = m_source->readFrame(frame, type);
+            if (ret == AVERROR_EOF) {
+                if (!splice()) {
+                    return AVERROR_EOF;
+                }
+                continue;
+            }
+            if (ret < 0) {
+                return ret;
+            }
+
+            const int64_t floor = m_source->startTime() + m_rangeStart * 1000;
+            if (!filter(frame, *type, floor, floor)) {
+                av_frame_unref(frame);
+                if (rangeFinished() && !splice()) {
+                    return AVERROR_EOF;
+                }
+                continue;
+            }
+            return emitFrame(frame, *type);
+        }
+        }
+    }
+}
+
+qint64 LoopEngine::position() const
+{
+    return m_source ? (m_lastSourcePts - m_source->startTime()) / 1000 : 0;
+}
+
+int LoopEngine::iterations() const
+{
+    return m_iterations;
+}
+
+std::size_t LoopEngine::cachedBytes() const
+{
+    return m_headBytes;
+}
+
+/**
+ * @brief 定位到区间起点并缓存区间开头
+ * 缓存在达到 headDuration 后的第一个视频关键帧处结束（纯音频时直接结束），
+ * 该关键帧作为第一轮的衔接帧，媒体源随后自然地继续读取，第一轮不需要重定位。
+ */
+bool LoopEngine::buildHead()
+{
+    if (m_resyncPending) {
+        finishResync();
+    }
+    clearFrames();
+    m_videoDone = false;
+    m_audioDone = false;
+
+    if (m_source->seek(m_rangeStart) < 0) {
+        return false;
+    }
+
+    const bool hasVideo = m_source->videoStream() != nullptr;
+    const bool primaryIsAudio = m_source->audioStream() != nullptr;
+    const int64_t floor = m_source->startTime() + m_rangeStart * 1000;
+    const int64_t target = m_options.headDuration * 1000;
+    int64_t primaryEnd = AV_NOPTS_VALUE;
+    int64_t videoEnd = AV_NOPTS_VALUE;
+
+    for (;;) {
+        AVFrame* frame = av_frame_alloc();
+        AVMediaType type = AVMEDIA_TYPE_UNKNOWN;
+        int ret = frame ? m_source->readFrame(frame, &type) : AVERROR(ENOMEM);
+        if (ret < 0) {
+            av_frame_free(&frame);
+            if (ret != AVERROR_EOF && m_head.empty()) {
+                return false;
+            }
+            m_headComplete = true;
+            break;
+        }
+
+        if (!filter(frame, type, floor, floor)) {
+            av_frame_free(&frame);
+            if (rangeFinished()) {
+                m_headComplete = true;
+                break;
+            }
+            continue;
+        }
+
+        // 达到目标时长后，在下一个可独立解码的位置结束缓存
+        const bool reached = m_headStart != AV_NOPTS_VALUE && primaryEnd - m_headStart >= target;
+        const bool boundary = type == AVMEDIA_TYPE_VIDEO ? (frame->flags & AV_FRAME_FLAG_KEY) != 0 : !hasVideo;
+        if (reached && boundary) {
+            m_bridge.push_back({frame, type});
+            break;
+        }
+
+        m_head.push_back({frame, type});
+        m_headBytes += detail::frameBytes(frame);
+        if (frame->pts != AV_NOPTS_VALUE) {
+            const int64_t end = frame->pts + frame->duration;
+            if ((type == AVMEDIA_TYPE_AUDIO) == primaryIsAudio) {
+                if (m_headStart == AV_NOPTS_VALUE) {
+                    m_headStart = frame->pts;
+                }
+                primaryEnd = end;
+            }
+            if (type == AVMEDIA_TYPE_VIDEO) {
+                videoEnd = end;
+            } else {
+                m_audioResume = end;
+            }
+        }
+
+        if (m_headBytes >= m_options.headMemoryLimit) {
+            qWarning() << "LoopEngine: Head cache reached its memory limit before a keyframe boundary.";
+            break;
+        }
+    }
+
+    if (m_head.empty() || m_headStart == AV_NOPTS_VALUE) {
+        return false;
+    }
+
+    m_videoResume = videoEnd;
+    for (const CachedFrame& cached : m_bridge) {
+        if (cached.type == AVMEDIA_TYPE_VIDEO) {
+            m_videoResume = cached.frame->pts;
+        }
+    }
+
+    // 重建缓存时保持输出时间线连续
+    const int64_t end = m_audioEnd != AV_NOPTS_VALUE ? m_audioEnd : m_videoEnd;
+    m_offset = end != AV_NOPTS_VALUE ? end - m_headStart : 0;
+    m_phase = Phase::Head;
+    m_headCursor = 0;
+
+    qDebug() << "LoopEngine: Cached" << m_head.size() << "frames," << m_headBytes << "bytes"
+             << (m_headComplete ? "(entire range)" : "");
+    return true;
+}
+
+void LoopEngine::clearFrames()
+{
+    for (CachedFrame& cached : m_head) {
+        av_frame_free(&cached.frame);
+    }
+    for (CachedFrame& cached : m_bridge) {
+        av_frame_free(&cached.frame);
+    }
+    m_head.clear();
+    m_bridge.clear();
+    m_headBytes = 0;
+    m_headCursor = 0;
+    m_headComplete = false;
+    m_headStart = AV_NOPTS_VALUE;
+    m_videoResume = AV_NOPTS_VALUE;
+    m_audioResume = AV_NOPTS_VALUE;
+}
+
+/**
+ * @brief 换算时间戳并按下限和区间终点裁剪帧
+ * @param videoFloor 早于该时间的视频帧被丢弃（微秒，AV_NOPTS_VALUE 表示不限）
+ * @param audioFloor 早于该时间的音频样本被丢弃
+ * @return 帧应当保留时返回 true
+ */
+bool LoopEngine::filter(AVFrame* frame, AVMediaType type, int64_t videoFloor, int64_t audioFloor)
+{
+    const bool isAudio = type == AVMEDIA_TYPE_AUDIO;
+    if (isAudio ? m_audioDone : m_videoDone) {
+        return false;
+    }
+
+    normalize(frame, type);
+    if (frame->pts == AV_NOPTS_VALUE) {
+        return true;
+    }
+
+    const int64_t rangeEnd = m_rangeEnd > 0 ? m_source->startTime() + m_rangeEnd * 1000 : AV_NOPTS_VALUE;
+    if (rangeEnd != AV_NOPTS_VALUE && frame->pts >= rangeEnd) {
+        (isAudio ? m_audioDone : m_videoDone) = true;
+        return false;
+    }
+
+    if (!isAudio) {
+        return frame->pts >= videoFloor;
+    }
+
+    if (frame->pts + frame->duration <= audioFloor) {
+        return false;
+    }
+    if (frame->pts < audioFloor) {
+        const int samples = static_cast<int>(av_rescale(audioFloor - frame->pts, frame->sample_rate, AV_TIME_BASE));
+        if (samples > 0 && samples < frame->nb_samples) {
+            // 拷贝剩余样本，原帧可能被开头缓存共享
+            AVFrame* trimmed = detail::trimFront(frame, samples);
+            if (!trimmed) {
+                return false;
+            }
+            av_frame_unref(frame);
+            av_frame_move_ref(frame, trimmed);
+            av_frame_free(&trimmed);
+        }
+    }
+    if (rangeEnd != AV_NOPTS_VALUE && frame->pts + frame->duration > rangeEnd) {
+        frame->nb_samples = static_cast<int>(av_rescale(rangeEnd - frame->pts, frame->sample_rate, AV_TIME_BASE));
+        frame->duration = av_rescale(frame->nb_samples, AV_TIME_BASE, frame->sample_rate);
+        m_audioDone = true;
+    }
+    return frame->nb_samples > 0;
+}
+
+bool LoopEngine::rangeFinished() const
+{
+    return (!m_source->videoStream() || m_videoDone) && (!m_source->audioStream() || m_audioDone);
+}
+
+/**
+ * @brief 回到开头缓存，开始新一轮循环
+ * @return 没有可用缓存时返回 false
+ */
+bool LoopEngine::splice()
+{
+    if (m_head.empty()) {
+        return false;
+    }
+
+    for (CachedFrame& cached : m_bridge) {
+        av_frame_free(&cached.frame);
+    }
+    m_bridge.clear();
+
+    const int64_t end = m_audioEnd != AV_NOPTS_VALUE ? m_audioEnd : m_videoEnd;
+    if (end != AV_NOPTS_VALUE) {
+        m_offset = end - m_headStart;
+    }
+    m_phase = Phase::Head;
+    m_headCursor = 0;
+    ++m_iterations;
+    emit loopCompleted(m_iterations);
+
+    if (!m_headComplete) {
+        startResync();
+    }
+    return true;
+}
+
+void LoopEngine::startResync()
+{
+    m_resyncOk.store(false);
+    m_resyncPending = true;
+    TaskScheduler::instance().submit(TaskScheduler::Priority::PlaybackDecode, [this] {
+        m_resyncOk.store(resync());
+    }, &m_resync);
+}
+
+bool LoopEngine::finishResync()
+{
+    m_resync.wait();
+    m_resyncPending = false;
+    return m_resyncOk.load();
+}
+
+/**
+ * @brief 把媒体源重新定位到开头缓存之后（在共享线程池中执行）
+ * 缓存输出期间只有该线程访问媒体源和衔接队列。
+ */
+bool LoopEngine::resync()
+{
+    m_videoDone = false;
+    m_audioDone = false;
+
+    // 音频数据包可能交错在视频关键帧之前，因此定位到两者中较早的位置
+    int64_t target = m_videoResume;
+    if (target == AV_NOPTS_VALUE || (m_audioResume != AV_NOPTS_VALUE && m_audioResume < target)) {
+        target = m_audioResume;
+    }
+    if (target == AV_NOPTS_VALUE || m_source->seek((target - m_source->startTime()) / 1000) < 0) {
+        return false;
+    }
+
+    bool needVideo = m_videoResume != AV_NOPTS_VALUE;
+    bool needAudio = m_audioResume != AV_NOPTS_VALUE;
+    while (needVideo || needAudio) {
+        AVFrame* frame = av_frame_alloc();
+        AVMediaType type = AVMEDIA_TYPE_UNKNOWN;
+        int ret = frame ? m_source->readFrame(frame, &type) : AVERROR(ENOMEM);
+        if (ret < 0) {
+            av_frame_free(&frame);
+            return ret == AVERROR_EOF;
+        }
+        if (!filter(frame, type, m_videoResume, m_audioResume)) {
+            av_frame_free(&frame);
+            if (rangeFinished()) {
+                return true;
+            }
+            continue;
+        }
+        m_bridge.push_back({frame, type});
+        (type == AVMEDIA_TYPE_VIDEO ? needVideo : needAudio) = false;
+    }
+    return true;
+}
+
+/**
+ * @brief 把源时间线上的帧放到输出时间线上
+ */
+int LoopEngine::emitFrame(AVFrame* frame, AVMediaType type)
+{
+    const bool isAudio = type == AVMEDIA_TYPE_AUDIO;
+    int64_t& end = isAudio ? m_audioEnd : m_videoEnd;
+    if (frame->pts == AV_NOPTS_VALUE) {
+        frame->pts = end != AV_NOPTS_VALUE ? end : 0;
+    } else {
+        if (isAudio == (m_source->audioStream() != nullptr)) {
+            m_lastSourcePts = frame->pts;
+        }
+        frame->pts += m_offset;
+    }
+    end = frame->pts + frame->duration;
+    return 0;
+}
+
+} // namespace core
+} // namespace aurorastream
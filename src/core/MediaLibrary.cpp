@@ -0,0 +1,415 @@
+/********************************************************************************
+ * @file   : MediaLibrary.cpp
+ * @brief  : 实现了 aurorastream::core::MediaLibrary 类。
+ *
+ * 表结构版本记录在 PRAGMA user_version 中，migrate() 依次执行缺失的升级步骤。
+ * 批量写入使用预编译语句和 UPSERT，一个事务写完一批，避免每行一次 fsync。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/MediaLibrary.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QDebug>
+#include <QtCore/QVariant>
+#include <QtCore/QFileInfo>
+#include <QtCore/QStringList>
+#include <QtCore/QStandardPaths>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlDatabase>
+
+#include <mutex>
+#include <atomic>
+#include <sstream>
+#include <algorithm>
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+constexpr int kSchemaVersion = 2;
+
+const char* const kSchema[kSchemaVersion] = {
+    // 1：docs/architecture 中的 media_files / playlists，加上增量扫描所需的列
+    "CREATE TABLE IF NOT EXISTS media_files ("
+    "  id INTEGER PRIMARY KEY,"
+    "  path TEXT UNIQUE NOT NULL,"
+    "  title TEXT,"
+    "  duration REAL,"
+    "  file_size INTEGER,"
+    "  last_played INTEGER NOT NULL DEFAULT 0,"
+    "  mtime INTEGER,"
+    "  format TEXT,"
+    "  video_codec TEXT,"
+    "  audio_codec TEXT,"
+    "  width INTEGER,"
+    "  height INTEGER,"
+    "  bit_rate INTEGER"
+    ");"
+    "CREATE TABLE IF NOT EXISTS playlists ("
+    "  id INTEGER PRIMARY KEY,"
+    "  name TEXT,"
+    "  created_date INTEGER"
+    ");",
+    // 2：EBU R128 响度分析结果，NULL 表示尚未分析
+    "ALTER TABLE media_files ADD COLUMN loudness REAL;"
+    "ALTER TABLE media_files ADD COLUMN true_peak REAL;",
+};
+
+const char* const kColumns =
+    "id, path, title, duration, file_size, mtime, last_played, format, video_codec, audio_codec, width, height, bit_rate,"
+    " loudness, true_peak";
+
+MediaLibrary::MediaFile fromQuery(const QSqlQuery& query)
+{
+    MediaLibrary::MediaFile file;
+    file.id = query.value(0).toLongLong();
+    file.path = query.value(1).toString().toStdString();
+    file.title = query.value(2).toString().toStdString();
+    file.duration = query.value(3).toDouble();
+    file.fileSize = query.value(4).toLongLong();
+    file.modifiedTime = query.value(5).toLongLong();
+    file.lastPlayed = query.value(6).toLongLong();
+    file.format = query.value(7).toString().toStdString();
+    file.videoCodec = query.value(8).toString().toStdString();
+    file.audioCodec = query.value(9).toString().toStdString();
+    file.width = query.value(10).toInt();
+    file.height = query.value(11).toInt();
+    file.bitRate = query.value(12).toLongLong();
+    file.hasLoudness = !query.value(13).isNull();
+    file.loudness = query.value(13).toDouble();
+    file.truePeak = query.value(14).toDouble();
+    return file;
+}
+
+/// 去掉末尾的 '/'，根目录返回空字符串
+std::string directoryPrefix(const std::string& directory)
+{
+    const std::string cleaned = QDir::cleanPath(QString::fromStdString(directory)).toStdString();
+    return cleaned == "/" ? std::string() : cleaned;
+}
+
+/// 目录前缀的半开区间 [directory/, directory0)，'0' 紧跟在 '/' 之后，可以使用 path 上的唯一索引
+void bindDirectory(QSqlQuery& query, const std::string& directory)
+{
+    const std::string prefix = directoryPrefix(directory);
+    query.addBindValue(QString::fromStdString(prefix + "/"));
+    query.addBindValue(QString::fromStdString(prefix + "0"));
+}
+
+std::atomic<uint64_t> g_connectionSerial {0};
+
+} // namespace
+
+struct MediaLibrary::Connections {
+    std::mutex mutex;
+    std::unordered_set<std::string> names;
+};
+
+/**
+ * @brief 当前线程打开的连接，线程结束时移除
+ * 连接名用递增序号区分而不是线程 ID：线程结束后 ID 可能被新线程复用，
+ * 而 QSqlDatabase 连接不能交给另一个线程使用。
+ */
+struct MediaLibrary::ThreadConnections {
+    struct Entry {
+        std::weak_ptr<Connections> owner;
+        std::string name;
+    };
+    std::vector<Entry> entries;
+
+    ~ThreadConnections()
+    {
+        for (const Entry& entry : entries) {
+            // 媒体库已经析构时连接已被一并移除
+            std::shared_ptr<Connections> owner = entry.owner.lock();
+            if (!owner) {
+                continue;
+            }
+            {
+                std::lock_guard<std::mutex> lock(owner->mutex);
+                if (owner->names.erase(entry.name) == 0) {
+                    continue;
+                }
+            }
+            QSqlDatabase::removeDatabase(QString::fromStdString(entry.name));
+        }
+    }
+};
+
+MediaLibrary& MediaLibrary::instance()
+{
+    static MediaLibrary instance([] {
+        QString base = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+        if (base.isEmpty()) {
+            base = QDir::homePath() + "/.aurorastream";
+        }
+        QDir().mkpath(base);
+        return (base + "/library.db").toStdString();
+    }());
+    return instance;
+}
+
+MediaLibrary::MediaLibrary(const std::string& databasePath)
+    : m_databasePath(databasePath)
+    , m_connections(std::make_shared<Connections>())
+{
+    std::ostringstream prefix;
+    prefix << "aurorastream.library." << static_cast<const void*>(this) << ".";
+    m_connectionPrefix = prefix.str();
+
+    QDir().mkpath(QFileInfo(QString::fromStdString(m_databasePath)).absolutePath());
+    m_open = connection().isOpen() && migrate();
+}
+
+MediaLibrary::~MediaLibrary()
+{
+    std::lock_guard<std::mutex> lock(m_connections->mutex);
+    for (const std::string& name : m_connections->names) {
+        QSqlDatabase::removeDatabase(QString::fromStdString(name));
+    }
+    m_connections->names.clear();
+}
+
+bool MediaLibrary::isOpen() const
+{
+    return m_open;
+}
+
+QSqlDatabase MediaLibrary::connection() const
+{
+    thread_local ThreadConnections threadConnections;
+    std::vector<ThreadConnections::Entry>& entries = threadConnections.entries;
+    for (const ThreadConnections::Entry& entry : entries) {
+        if (entry.owner.lock() == m_connections) {
+            return QSqlDatabase::database(QString::fromStdString(entry.name));
+        }
+    }
+    // 顺带清理已析构的媒体库留下的记录
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [](const ThreadConnections::Entry& entry) {
+        return entry.owner.expired();
+    }), entries.end());
+
+    const std::string name = m_connectionPrefix + std::to_string(g_connectionSerial.fetch_add(1));
+    const QString connectionName = QString::fromStdString(name);
+    QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    database.setDatabaseName(QString::fromStdString(m_databasePath));
+    database.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+    if (!database.open()) {
+        qWarning() << "MediaLibrary: Could not open database" << QString::fromStdString(m_databasePath)
+                   << ":" << database.lastError().text();
+    } else {
+        // WAL：写事务不阻塞其他连接的读取；NORMAL 在 WAL 下只在检查点时同步
+        QSqlQuery query(database);
+        query.exec("PRAGMA journal_mode=WAL");
+        query.exec("PRAGMA synchronous=NORMAL");
+        query.exec("PRAGMA temp_store=MEMORY");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_connections->mutex);
+        m_connections->names.insert(name);
+    }
+    entries.push_back({m_connections, name});
+    return database;
+}
+
+bool MediaLibrary::migrate()
+{
+    QSqlDatabase database = connection();
+    QSqlQuery query(database);
+    int version = 0;
+    if (query.exec("PRAGMA user_version") && query.next()) {
+        version = query.value(0).toInt();
+    }
+
+    for (; version < kSchemaVersion; ++version) {
+        database.transaction();
+        bool ok = true;
+        // QSqlQuery 一次只执行一条语句
+        const QStringList statements = QString(kSchema[version]).split(';', Qt::SkipEmptyParts);
+        for (const QString& statement : statements) {
+            if (!statement.trimmed().isEmpty() && !query.exec(statement)) {
+                ok = false;
+                break;
+            }
+        }
+        ok = ok && query.exec(QString("PRAGMA user_version=%1").arg(version + 1));
+        if (!ok || !database.commit()) {
+            qWarning() << "MediaLibrary: Schema upgrade to version" << version + 1 << "failed:" << query.lastError().text();
+            database.rollback();
+            return false;
+        }
+    }
+    return true;
+}
+
+std::unordered_map<std::string, MediaLibrary::FileState> MediaLibrary::fileStates(const std::string& directory,
+                                                                                  bool recursive) const
+{
+    std::unordered_map<std::string, FileState> states;
+    QSqlQuery query(connection());
+    query.setForwardOnly(true);
+    query.prepare("SELECT path, file_size, mtime FROM media_files WHERE path >= ? AND path < ?");
+    bindDirectory(query, directory);
+    if (!query.exec()) {
+        qWarning() << "MediaLibrary: Query failed:" << query.lastError().text();
+        return states;
+    }
+
+    const std::size_t prefixLength = directoryPrefix(directory).size() + 1;
+    while (query.next()) {
+        std::string path = query.value(0).toString().toStdString();
+        if (!recursive && path.find('/', prefixLength) != std::string::npos) {
+            continue;
+        }
+        states.emplace(std::move(path), FileState {query.value(1).toLongLong(), query.value(2).toLongLong()});
+    }
+    return states;
+}
+
+bool MediaLibrary::write(const std::vector<MediaFile>& files, const std::vector<std::string>& removed)
+{
+    if (files.empty() && removed.empty()) {
+        return true;
+    }
+
+    QSqlDatabase database = connection();
+    if (!database.transaction()) {
+        qWarning() << "MediaLibrary: Could not begin transaction:" << database.lastError().text();
+        return false;
+    }
+
+    bool ok = true;
+    QSqlQuery upsert(database);
+    upsert.prepare(
+        "INSERT INTO media_files (path, title, duration, file_size, mtime, format, video_codec, audio_codec,"
+        " width, height, bit_rate) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"
+        " ON CONFLICT(path) DO UPDATE SET title = excluded.title, duration = excluded.duration,"
+        " file_size = excluded.file_size, mtime = excluded.mtime, format = excluded.format,"
+        " video_codec = excluded.video_codec, audio_codec = excluded.audio_codec, width = excluded.width,"
+        " height = excluded.height, bit_rate = excluded.bit_rate, loudness = NULL, true_peak = NULL");
+    for (const MediaFile& file : files) {
+        upsert.addBindValue(QString::fromStdString(file.path));
+        upsert.addBindValue(QString::fromStdString(file.title));
+        upsert.addBindValue(file.duration);
+        upsert.addBindValue(static_cast<qlonglong>(file.fileSize));
+        upsert.addBindValue(static_cast<qlonglong>(file.modifiedTime));
+        upsert.addBindValue(QString::fromStdString(file.format));
+        upsert.addBindValue(QString::fromStdString(file.videoCodec));
+        upsert.addBindValue(QString::fromStdString(file.audioCodec));
+        upsert.addBindValue(file.width);
+        upsert.addBindValue(file.height);
+        upsert.addBindValue(static_cast<qlonglong>(file.bitRate));
+        if (!upsert.exec()) {
+            ok = false;
+            break;
+        }
+    }
+
+    QSqlQuery remove(database);
+    remove.prepare("DELETE FROM media_files WHERE path = ?");
+    for (std::size_t i = 0; ok && i < removed.size(); ++i) {
+        remove.addBindValue(QString::fromStdString(removed[i]));
+        ok = remove.exec();
+    }
+
+    if (!ok || !database.commit()) {
+        qWarning() << "MediaLibrary: Batch write failed:" << upsert.lastError().text() << remove.lastError().text();
+        database.rollback();
+        return false;
+    }
+    return true;
+}
+
+bool MediaLibrary::find(const std::string& path, MediaFile* file) const
+{
+    QSqlQuery query(connection());
+    query.prepare(QString("SELECT %1 FROM media_files WHERE path = ?").arg(kColumns));
+    query.addBindValue(QString::fromStdString(path));
+    if (!query.exec() || !query.next()) {
+        return false;
+    }
+    if (file) {
+        *file = fromQuery(query);
+    }
+    return true;
+}
+
+std::vector<MediaLibrary::MediaFile> MediaLibrary::files(const std::string& directory) const
+{
+    std::vector<MediaFile> result;
+    QSqlQuery query(connection());
+    query.setForwardOnly(true);
+    if (directory.empty()) {
+        query.prepare(QString("SELECT %1 FROM media_files ORDER BY path").arg(kColumns));
+    } else {
+        query.prepare(QString("SELECT %1 FROM media_files WHERE path >= ? AND path < ? ORDER BY path").arg(kColumns));
+        bindDirectory(query, directory);
+    }
+    if (!query.exec()) {
+        qWarning() << "MediaLibrary: Query failed:" << query.lastError().text();
+        return result;
+    }
+    while (query.next()) {
+        result.push_back(fromQuery(query));
+    }
+    return result;
+}
+
+bool MediaLibrary::setLoudness(const std::string& path, double loudness, double truePeak)
+{
+    QSqlQuery query(connection());
+    query.prepare("UPDATE media_files SET loudness = ?, true_peak = ? WHERE path = ?");
+    query.addBindValue(loudness);
+    query.addBindValue(truePeak);
+    query.addBindValue(QString::fromStdString(path));
+    return query.exec() && query.numRowsAffected() > 0;
+}
+
+std::vector<std::string> MediaLibrary::withoutLoudness(int limit) const
+{
+    std::vector<std::string> result;
+    QSqlQuery query(connection());
+    query.setForwardOnly(true);
+    query.prepare("SELECT path FROM media_files WHERE loudness IS NULL AND COALESCE(audio_codec, '') <> '' ORDER BY path LIMIT ?");
+    query.addBindValue(limit);
+    if (!query.exec()) {
+        qWarning() << "MediaLibrary: Query failed:" << query.lastError().text();
+        return result;
+    }
+    while (query.next()) {
+        result.push_back(query.value(0).toString().toStdString());
+    }
+    return result;
+}
+
+bool MediaLibrary::markPlayed(const std::string& path, int64_t time)
+{
+    QSqlQuery query(connection());
+    query.prepare("UPDATE media_files SET last_played = ? WHERE path = ?");
+    query.addBindValue(static_cast<qlonglong>(time));
+    query.addBindValue(QString::fromStdString(path));
+    return query.exec() && query.numRowsAffected() > 0;
+}
+
+int64_t MediaLibrary::count() const
+{
+    QSqlQuery query(connection());
+    if (!query.exec("SELECT COUNT(*) FROM media_files") || !query.next()) {
+        return 0;
+    }
+    return query.value(0).toLongLong();
+}
+
+std::string MediaLibrary::databasePath() const
+{
+    return m_databasePath;
+}
+
+} // namespace core
+} // namespace aurorastream
@@ -20,8 +20,20 @@
 #include <chrono>
 #include <atomic>
 #include <functional>
+#include <algorithm>
+#include <cmath>
 
 #include "AuroraStream/core/MediaPlayer.h"
+#include "aurorastream/core/MediaSource.h"
+#include "aurorastream/core/LoopEngine.h"
+#include "aurorastream/core/FrameCache.h"
+#include "aurorastream/core/ReverseEngine.h"
+#include "aurorastream/core/TrickPlayEngine.h"
+#include "aurorastream/core/UringIOContext.h"
+#include "aurorastream/core/StartupProfiler.h"
+#include "aurorastream/core/TaskScheduler.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+#include "aurorastream/core/PlaylistEngine.h"
 
 // ---  FFmpeg 相关头文件 ---
 extern "C" {
@@ -42,7 +54,8 @@ namespace core{
 /**
  * @brief 构造函数，初始化播放器状态
  * @param parent QObject指针，用于Qt对象树管理
- * @note 该构造函数会初始化 FFmpeg 网络模块
+ * @note FFmpeg 网络模块在第一次打开网络地址时才初始化（见 MediaSource::open），
+ *       构造播放器本身不做耗时的初始化
  */
 MediaPlayer::MediaPlayer(QObject* parent)
     : QObject(parent)               // 调用基类 QObject 的构造函数
@@ -50,17 +63,24 @@ MediaPlayer::MediaPlayer(QObject* parent)
     , m_state(MediaState::STOPPED)       // 初始状态为停止
     , m_duration(0)                 // 初始媒体时长为0毫秒
     , m_position(0)                 // 初始播放位置为0毫秒
-    // --- 初始化 FFmpeg 相关指针 ---
-    , m_formatContext(nullptr)      // FFmpeg 格式上下文指针初始化为空
-    , m_videoCodecContext(nullptr)  // FFmpeg 视频解码器上下文指针初始化为空
-    , m_audioCodecContext(nullptr)  // FFmpeg 音频解码器上下文指针初始化为空
-    , m_videoStreamIndex(-1)        // -1 表示未找到有效的视频流
-    , m_audioStreamIndex(-1)        // -1 表示未找到有效的音频流
+    , m_frameCache(std::make_unique<FrameCache>()) // 已解码帧缓存，默认上限 256 MiB
+    , m_videoPts(AV_NOPTS_VALUE)
+    , m_decodePts(AV_NOPTS_VALUE)
+    , m_pendingFrame(av_frame_alloc())
+    , m_resumePending(false)
     , m_volume(1.0f)                // 默认音量为100%
     , m_loop(false)                 // 默认不循环播放
+    , m_playbackRate(1.0)           // 默认正常速率
+    , m_loopStart(0)                // 默认从开头循环
+    , m_loopEnd(0)                  // 默认循环到结尾
+    , m_asyncIo(false)              // 默认使用 FFmpeg 同步文件读取
+    , m_directIo(false)             // 默认经过页缓存读取
+    , m_probeCache(true)            // 默认启用持久化探测缓存
+    , m_quality(QualityLevel::ADAPTIVE) // 默认自动选择自适应流的档位
+    , m_crossfade(0)                // 默认播放列表逐样本硬切
+    , m_playlistHandoff(false)
+    , m_metricsScope(PerformanceMonitor::instance().createScope("media_player")) // 本实例的性能指标
 {
-	avformat_network_init(); // 初始化 FFmpeg 网络模块
-
     qDebug() << "MediaPlayer created.";
 }
 
@@ -72,21 +92,27 @@ MediaPlayer::~MediaPlayer()
 {
 	stop(); // 确保停止播放
 
-    // 释放视频解码器上下文
-    if (m_videoCodecContext) {
-        avcodec_free_context(&m_videoCodecContext);
-	}
+	// 播放列表只持有读取用的指针，先于媒体源释放（会等待后台预打开结束）
+	m_playlist.reset();
 
-    // 释放音频解码器上下文
-	if (m_audioCodecContext) {
-	    avcodec_free_context(&m_audioCodecContext);
+	// 退出时同步等待录制写完，保证文件尾完整
+	if (m_recorder) {
+		m_source->removeTap(m_recorder.get());
+		m_recorder.reset();
 	}
-
-	// 释放格式上下文
-	if (m_formatContext) {
-	    avformat_free_context(m_formatContext);
+	if (m_restream) {
+		m_source->removeTap(m_restream.get());
+		m_restream.reset();
 	}
 
+	// 释放媒体源（格式上下文、解码器和自定义 I/O），循环缓存引用了媒体源，需先释放
+	m_reverseEngine.reset();
+	m_trickPlay.reset();
+	m_loopEngine.reset();
+	av_frame_free(&m_pendingFrame);
+	m_frameCache->clear();
+	m_source.reset();
+
 	qDebug() << "MediaPlayer destroyed."; // 生成销毁日志
 }
 
@@ -172,146 +198,209 @@ bool MediaPlayer::setSource(const QString& source)
 {
 	qDebug() << "MediaPlayer::openFile() called with filename:" << source;
 
-	QFileInfo fileInfo(source);
+	stop(); // 停止当前播放
+
+	MediaSource::Options options;
+	options.asyncIo = m_asyncIo;
+	options.directIo = m_directIo;
+	options.probeCache = m_probeCache;
+	options.quality = m_quality;
 
-	// 检查文件是否存在或者是否是普通文件
-	if (!fileInfo.exists() && !fileInfo.isFile()) {
-		QString errorMessage = QString("MediaPlayer::openFile() failed. File does not exist or is not a regular file: %1").arg(source);
-		qWarning() << errorMessage;
+	QString errorMessage;
+	std::unique_ptr<MediaSource> mediaSource = MediaSource::open(source, options, &errorMessage);
+	if (!mediaSource) {
 		emit error(errorMessage);
 		return false;
 	}
 
-	stop(); // 停止当前播放
+	return adoptSource(std::move(mediaSource));
+}
+
+/**
+ * @brief 接管一个已经打开的媒体源
+ * @param source 已完成打开和解码器初始化的媒体源
+ * @return 成功返回 true
+ * @note 播放列表在后台预打开下一项后，通过该接口把它交给播放器（见 createPlaylist）
+ */
+bool MediaPlayer::adoptSource(std::unique_ptr<MediaSource> source)
+{
+	if (!source) {
+		return false;
+	}
+
+	// 调用方直接交来的媒体源结束播放列表；播放列表自己切换到下一项时保留
+	if (!m_playlistHandoff) {
+		m_playlist.reset();
+	}
+
+	// 录制和转发属于之前的媒体，切换媒体时停止
+	stopRecording();
+	stopRestreaming();
 
 	// 释放之前加载的媒体资源
-	if (m_formatContext) {
-		avformat_close_input(&m_formatContext);
-        avformat_free_context(m_formatContext);
-		m_formatContext = nullptr;
-		m_videoCodecContext = nullptr;
-		m_audioCodecContext = nullptr;
-		m_videoStreamIndex = -1;
-		m_audioStreamIndex = -1;
-		m_duration = 0;
-		m_currentMedia.clear();
+	m_reverseEngine.reset();
+	m_trickPlay.reset();
+	m_loopEngine.reset();
+	m_frameCache->clear();
+	av_frame_unref(m_pendingFrame);
+	m_videoPts = AV_NOPTS_VALUE;
+	m_decodePts = AV_NOPTS_VALUE;
+	m_resumePending = false;
+	m_source = std::move(source);
+	m_source->setMetricsScope(m_metricsScope);
+	m_currentMedia = m_source->uri();
+	m_duration = m_source->duration();
+	m_position = 0;
+
+	qDebug() << "MediaPlayer::openFile(): Successfully opened file:" << m_currentMedia
+	         << "in" << m_source->openTime() << "us" << (m_source->probeCacheHit() ? "(probe cache hit)" : "");
+
+	emit mediaOpened(m_currentMedia);
+
+	if (m_duration > 0) {
+		emit durationChanged(m_duration);
 	}
 
-	AVFormatContext* formatContext = nullptr;
-	int ret = avformat_open_input(&formatContext, source.toStdString().c_str(), nullptr, nullptr);
+	if (m_loop) {
+		attachLoopEngine();
+	}
 
-	// 检查文件是否成功打开
-	if (ret < 0) {
-		QString errorMessage = QString("MediaPlayer::openFile() failed. Could not open file: %1").arg(source);
-		char errbuf[AV_ERROR_MAX_STRING_SIZE] = {0};
-		av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
-		QString detailMessage = QString("FFmpeg error: %1 (%2)").arg(errorMessage).arg(errbuf);
-	    qWarning() << detailMessage;
-		emit error(detailMessage);
-		return false;
+	// 新媒体沿用当前的播放速率
+	if (m_playbackRate != 1.0) {
+		setPlaybackRate(m_playbackRate);
 	}
 
-    ret = avformat_find_stream_info(formatContext, nullptr);
+	return true;
+}
 
-	// 如果未找到流信息，则返回 false
-	if (ret < 0) {
-		QString errorMessage = QString("MediaPlayer::openFile() failed. Could not find stream information in file: %1").arg(source);
-	   	char errbuf[AV_ERROR_MAX_STRING_SIZE] = {0};
-		av_strerror(ret, errbuf, AV_ERROR_MAX_STRING_SIZE);
-		QString detailMessage = QString("FFmpeg error: %1 (%2)").arg(errorMessage).arg(errbuf);
-		qWarning() << detailMessage;
-		avformat_close_input(&formatContext);
-		emit error(detailMessage);
+/**
+ * @brief 设置播放列表并打开指定项
+ * @param items 各项的文件路径或网络地址
+ * @param index 起始项
+ * @return 成功返回 true
+ */
+bool MediaPlayer::setPlaylist(const QStringList& items, int index)
+{
+	stop();
+
+	if (items.isEmpty()) {
+		m_playlist.reset();
 		return false;
 	}
 
-	int videoStreamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0); // 查找视频流
-	int audioStreamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0); // 查找音频流
-
-	AVCodecContext* videoCodecContext = nullptr; // 视频解码器上下文
-	AVCodecContext* audioCodecContext = nullptr; // 音频解码器上下文
-
-	// 查找并初始化视频解码器
-	if (videoStreamIndex >= 0) {
-		AVStream* videoStream = formatContext->streams[videoStreamIndex];
-		const AVCodec* videoCodec = avcodec_find_decoder(videoStream->codecpar->codec_id);
-
-		if (videoCodec) {
-			videoCodecContext = avcodec_alloc_context3(videoCodec);
-			if (videoCodecContext && avcodec_parameters_to_context(videoCodecContext, videoStream->codecpar) >= 0) {
-				if (avcodec_open2(videoCodecContext, videoCodec, nullptr) >= 0) {
-					qDebug() << "MediaPlayer::openFile(): Video stream found and decoder initialized.";
-				}else {
-					qWarning() << "MediaPlayer::openFile(): Could not open video codec.";
-					avcodec_free_context(&videoCodecContext);
-					videoStreamIndex = -1;
-				}
-			}
-		} else {
-			qWarning() << "MediaPlayer::openFile(): Could not find video decoder.";
-			avcodec_free_context(&videoCodecContext);
-			videoStreamIndex = -1;
-		}
+	createPlaylist(items);
+	if (!m_playlist->start(index)) {
+		m_playlist.reset();
+		return false;
 	}
+	return true;
+}
 
-    // 查找并初始化音频解码器
-    if (audioStreamIndex >= 0) {
-       AVStream* audioStream = formatContext->streams[audioStreamIndex];
-       const AVCodec* audioCodec = avcodec_find_decoder(audioStream->codecpar->codec_id);
-       if (audioCodec) {
-           audioCodecContext = avcodec_alloc_context3(audioCodec);
-           if (audioCodecContext && avcodec_parameters_to_context(audioCodecContext, audioStream->codecpar) >= 0) {
-               if (avcodec_open2(audioCodecContext, audioCodec, nullptr) >= 0) {
-                   qDebug() << "MediaPlayer::openFile(): Audio stream found and decoder initialized.";
-               }else {
-                   qWarning() << "MediaPlayer::openFile(): Could not open audio codec.";
-                   avcodec_free_context(&audioCodecContext);
-                   audioStreamIndex = -1;
-               }
-           }else {
-               qWarning() << "MediaPlayer::openFile(): Could not allocate audio codec context.";
-               audioStreamIndex = -1;
-           }
-       }else {
-           qWarning() << "MediaPlayer::openFile(): Could not find audio decoder.";
-           audioStreamIndex = -1;
-       }
+/**
+ * @brief 追加到播放列表末尾
+ * @param uri 文件路径或网络地址
+ */
+void MediaPlayer::enqueue(const QString& uri)
+{
+	if (m_playlist) {
+		m_playlist->append(uri);
+		return;
 	}
 
-	// 检查是否找到有效的流
-    if (videoStreamIndex < 0 && audioStreamIndex < 0) {
-       QString errorMessage = QString("MediaPlayer::openFile() failed. No valid video or audio streams found in file: %1").arg(source);
-       qWarning() << errorMessage;
-       avcodec_free_context(&videoCodecContext);
-       avcodec_free_context(&audioCodecContext);
-       avformat_close_input(&formatContext);
-       emit error(errorMessage);
-       return false;
-    }
-
-	m_formatContext = formatContext;
-    m_videoCodecContext = videoCodecContext;
-    m_audioCodecContext = audioCodecContext;
-    m_videoStreamIndex = videoStreamIndex;
-    m_audioStreamIndex = audioStreamIndex;
-    m_position = 0;
-    m_currentMedia = source;
-
-    if (m_formatContext->duration != AV_NOPTS_VALUE) {
-		m_duration = m_formatContext->duration / AV_TIME_BASE;
-	}else {
-		m_duration = 0;
+	if (!m_source) {
+		setPlaylist(QStringList{uri});
+		return;
 	}
 
-	qDebug() << "MediaPlayer::openFile(): Successfully opened file:" << source;
+	// 当前媒体作为第一项，不重新打开，从当前位置继续读取
+	createPlaylist(QStringList{m_source->uri(), uri});
+	if (!m_playlist->attach(0, m_source.get())) {
+		m_playlist.reset();
+	}
+}
 
-	emit mediaOpened(source);
+/**
+ * @brief 切换到播放列表的下一项
+ * @return 成功返回 true
+ */
+bool MediaPlayer::next()
+{
+	return m_playlist && m_playlist->next();
+}
 
-	if (m_duration > 0) {
-		emit durationChanged(m_duration);
+QStringList MediaPlayer::getPlaylist() const
+{
+	return m_playlist ? m_playlist->items() : QStringList();
+}
+
+int MediaPlayer::getPlaylistIndex() const
+{
+	return m_playlist ? m_playlist->currentIndex() : -1;
+}
+
+/**
+ * @brief 设置交叉淡化时长，从下一次衔接起生效
+ * @param crossfade 时长（毫秒）
+ */
+void MediaPlayer::setCrossfade(qint64 crossfade)
+{
+	m_crossfade = std::max<qint64>(crossfade, 0);
+	if (m_playlist) {
+		PlaylistEngine::Options options = m_playlist->options();
+		options.crossfade = m_crossfade;
+		m_playlist->setOptions(options);
 	}
+}
 
-	return true;
+qint64 MediaPlayer::getCrossfade() const
+{
+	return m_crossfade;
+}
+
+/**
+ * @brief 建立播放列表
+ * 每一项成为当前项时，其媒体源（已在后台预打开和预解码）经 adoptSource 交给播放器，
+ * 录制、循环、倒放等功能照常作用于当前项
+ */
+void MediaPlayer::createPlaylist(const QStringList& items)
+{
+	PlaylistEngine::Options options;
+	options.crossfade = m_crossfade;
+	options.sourceOptions.asyncIo = m_asyncIo;
+	options.sourceOptions.directIo = m_directIo;
+	options.sourceOptions.probeCache = m_probeCache;
+	options.sourceOptions.quality = m_quality;
+
+	m_playlist = std::make_unique<PlaylistEngine>();
+	m_playlist->setOptions(options);
+	m_playlist->setItems(items);
+	m_playlist->setSourceHandler([this](std::unique_ptr<MediaSource> source) {
+		m_playlistHandoff = true;
+		adoptSource(std::move(source));
+		m_playlistHandoff = false;
+		return m_source.get();
+	});
+	connect(m_playlist.get(), &PlaylistEngine::error, this, &MediaPlayer::error);
+	connect(m_playlist.get(), &PlaylistEngine::currentItemChanged, this,
+	        [this](int index) { emit playlistIndexChanged(index); });
+}
+
+/**
+ * @brief 获取当前媒体源
+ * @return 当前媒体源，未加载时返回 nullptr
+ */
+MediaSource* MediaPlayer::source() const
+{
+	return m_source.get();
+}
+
+/**
+ * @brief 获取本播放器的性能指标子注册表
+ * @return 子注册表，其中的计数器和直方图同时累加到进程注册表
+ */
+std::shared_ptr<MetricsScope> MediaPlayer::metricsScope() const
+{
+	return m_metricsScope;
 }
 
 /**
@@ -323,7 +412,7 @@ void MediaPlayer::seek(int64_t position)
 	qDebug() << "MediaPlayer::seek() called with position:" << position; // 生成日志，记录跳转位置
 
 	// 检查是否加载了媒体文件
-	if (!m_formatContext) {
+	if (!m_source) {
 		QString errorMessage = "MediaPlayer::seek() failed. No media is loaded.";
 		qWarning() << errorMessage;
 		emit error(errorMessage);
@@ -340,8 +429,23 @@ void MediaPlayer::seek(int64_t position)
 		position = m_duration;
 	}
 
-	int64_t timestamp_us = position * 1000;
-	int ret = av_seek_frame(m_formatContext, -1, timestamp_us, AVSEEK_FLAG_BACKWARD);
+	// 倒放时从新位置重新开始倒放
+	if (m_reverseEngine && !m_reverseEngine->start(m_currentMedia, position)) {
+		m_reverseEngine.reset();
+	}
+
+	if (m_trickPlay) {
+		m_trickPlay->reset(position);
+	}
+
+	int ret;
+	if (m_loopEngine) {
+		ret = m_loopEngine->seek(position) ? 0 : AVERROR(EINVAL);
+	} else if (m_playlist) {
+		ret = m_playlist->seek(position) ? 0 : AVERROR(EINVAL);
+	} else {
+		ret = m_source->seek(position);
+	}
 
 	// 检查跳转是否成功
 	if (ret < 0) {
@@ -354,15 +458,12 @@ void MediaPlayer::seek(int64_t position)
         return;
 	}
 
-	// 刷新视频解码器缓冲区
-	if (m_videoCodecContext) {
-        avcodec_flush_buffers(m_videoCodecContext);
-    }
-
-	// 刷新音频解码器缓冲区
-    if (m_audioCodecContext) {
-        avcodec_flush_buffers(m_audioCodecContext);
-    }
+	// 跳转后解码序列不再连续，已缓存的帧保留，供之后的逐帧操作使用
+	m_frameCache->resetSequence();
+	av_frame_unref(m_pendingFrame);
+	m_videoPts = AV_NOPTS_VALUE;
+	m_decodePts = AV_NOPTS_VALUE;
+	m_resumePending = false;
 
     qint64 oldPosition = m_position;
     m_position = position;
@@ -463,10 +564,688 @@ void MediaPlayer::setLoop(bool loop) {
     if (m_loop != loop) {
         m_loop = loop;
         qDebug() << "MediaPlayer: Loop set to:" << loop;
+
+        // 开启循环时缓存区间开头，关闭时释放缓存并从当前位置继续顺序播放
+        if (m_loop && m_source) {
+            attachLoopEngine();
+        } else if (m_loopEngine) {
+            // 先释放循环引擎（会等待其后台重定位结束），再把媒体源定位回当前位置
+            m_loopEngine.reset();
+            av_frame_unref(m_pendingFrame);
+            m_decodePts = AV_NOPTS_VALUE;
+            m_frameCache->resetSequence();
+            const bool resumed = m_playlist ? m_playlist->seek(m_position) : (m_source && m_source->seek(m_position) >= 0);
+            if (!resumed) {
+                qWarning() << "MediaPlayer: Could not resume sequential playback at" << m_position << "ms.";
+            }
+        }
+
         emit loopChanged(m_loop);
     }
 }
 
+/**
+ * @brief 设置 A-B 循环区间
+ * @param start 区间起点（毫秒）
+ * @param end 区间终点（毫秒），小于等于 0 表示媒体结尾
+ * @return 成功返回 true
+ */
+bool MediaPlayer::setLoopRange(qint64 start, qint64 end) {
+    if (start < 0 || (end > 0 && end <= start)) {
+        QString errorMessage = QString("MediaPlayer::setLoopRange() failed. Invalid range: %1-%2").arg(start).arg(end);
+        qWarning() << errorMessage;
+        emit error(errorMessage);
+        return false;
+    }
+
+    m_loopStart = start;
+    m_loopEnd = end;
+    qDebug() << "MediaPlayer: Loop range set to:" << start << "-" << end;
+    return m_loopEngine ? m_loopEngine->setRange(start, end) : true;
+}
+
+/**
+ * @brief 取消 A-B 循环区间，恢复整段循环
+ */
+void MediaPlayer::clearLoopRange() {
+    setLoopRange(0, 0);
+}
+
+/**
+ * @brief 获取 A-B 循环区间起点
+ * @return 起点（毫秒）
+ */
+qint64 MediaPlayer::getLoopStart() const {
+    return m_loopStart;
+}
+
+/**
+ * @brief 获取 A-B 循环区间终点
+ * @return 终点（毫秒），0 表示媒体结尾
+ */
+qint64 MediaPlayer::getLoopEnd() const {
+    return m_loopEnd;
+}
+
+/**
+ * @brief 为当前媒体源创建循环引擎并缓存循环区间的开头
+ * @return 成功返回 true
+ */
+bool MediaPlayer::attachLoopEngine() {
+    auto engine = std::make_unique<LoopEngine>();
+    connect(engine.get(), &LoopEngine::error, this, &MediaPlayer::error);
+    if (!engine->setRange(m_loopStart, m_loopEnd) || !engine->attach(m_source.get())) {
+        qWarning() << "MediaPlayer: Could not prepare seamless loop, falling back to sequential playback.";
+        m_loopEngine.reset();
+        return false;
+    }
+
+    // attach() 把媒体源定位到了区间起点；播放中途开启循环时，下一次读取从当前位置继续
+    m_loopEngine = std::move(engine);
+    if (m_position > m_loopStart) {
+        m_resumePending = true;
+    }
+    return true;
+}
+
+/**
+ * @brief 读取播放时间线上的下一帧
+ * @param frame 输出帧
+ * @param type 输出帧的媒体类型
+ * @return 0 表示成功，负值为错误码
+ */
+int MediaPlayer::readFrame(AVFrame* frame, AVMediaType* type) {
+    if (!m_source) {
+        return AVERROR(EINVAL);
+    }
+
+    if (m_reverseEngine) {
+        int ret = m_reverseEngine->readFrame(frame);
+        if (ret >= 0) {
+            *type = AVMEDIA_TYPE_VIDEO;
+            m_videoPts = frame->pts;
+            m_position = m_reverseEngine->position();
+        }
+        return ret;
+    }
+
+    if (m_trickPlay) {
+        int ret = m_trickPlay->readFrame(frame);
+        if (ret >= 0) {
+            *type = AVMEDIA_TYPE_VIDEO;
+            m_videoPts = frame->pts;
+            m_decodePts = AV_NOPTS_VALUE;
+            m_position = m_trickPlay->position();
+        }
+        return ret;
+    }
+
+    if (m_loopEngine) {
+        if (m_resumePending) {
+            m_resumePending = false;
+            m_loopEngine->seek(m_position);
+        }
+        int ret = m_loopEngine->readFrame(frame, type);
+        if (ret >= 0) {
+            m_position = m_loopEngine->position();
+            if (*type == AVMEDIA_TYPE_VIDEO) {
+                m_videoPts = av_rescale_q(m_position * 1000 + m_source->startTime(), AV_TIME_BASE_Q,
+                                          m_source->videoStream()->time_base);
+                m_decodePts = AV_NOPTS_VALUE;
+            }
+        }
+        return ret;
+    }
+
+    // 播放列表：时间线跨项目连续，位置和当前帧按当前项计算
+    if (m_playlist) {
+        if (m_resumePending) {
+            m_resumePending = false;
+            m_playlist->seek(m_position);
+        }
+        int ret = m_playlist->readFrame(frame, type);
+        if (ret >= 0 && frame->pts != AV_NOPTS_VALUE) {
+            const int64_t itemPts = frame->pts - m_playlist->timelineOffset();
+            m_position = (itemPts - m_source->startTime()) / 1000;
+            if (*type == AVMEDIA_TYPE_VIDEO && m_source->videoStream()) {
+                m_videoPts = av_rescale_q(itemPts, AV_TIME_BASE_Q, m_source->videoStream()->time_base);
+                m_decodePts = AV_NOPTS_VALUE;
+            }
+        }
+        return ret;
+    }
+
+    // 逐帧操作之后，从当前显示帧之后继续播放
+    if (m_resumePending) {
+        m_resumePending = false;
+        if (m_videoPts != AV_NOPTS_VALUE && m_decodePts != m_videoPts && !seekVideo(m_videoPts, nullptr)) {
+            return AVERROR(EIO);
+        }
+    }
+
+    int ret = 0;
+    if (m_pendingFrame->buf[0]) {
+        av_frame_move_ref(frame, m_pendingFrame);
+        *type = AVMEDIA_TYPE_VIDEO;
+    } else {
+        ret = m_source->readFrame(frame, type);
+    }
+    if (ret < 0) {
+        return ret;
+    }
+
+    if (*type == AVMEDIA_TYPE_VIDEO) {
+        m_frameCache->insert(frame);
+        m_videoPts = frame->pts;
+        m_decodePts = frame->pts;
+    }
+    if (frame->pts != AV_NOPTS_VALUE) {
+        m_position = (av_rescale_q(frame->pts, frame->time_base, AV_TIME_BASE_Q) - m_source->startTime()) / 1000;
+    }
+    return 0;
+}
+
+/**
+ * @brief 逐帧前进
+ * @param frame 输出的视频帧
+ * @return 成功返回 true
+ */
+bool MediaPlayer::stepForward(AVFrame* frame) {
+    if (!m_source || !m_source->videoStream()) {
+        return false;
+    }
+    suspendLoopEngine();
+
+    if (m_videoPts != AV_NOPTS_VALUE && m_frameCache->next(m_videoPts, frame)) {
+        presentFrame(frame);
+        return true;
+    }
+
+    // 缓存未命中：确保媒体源停在当前帧之后，再向前解码一帧
+    if (m_videoPts != AV_NOPTS_VALUE && m_decodePts != m_videoPts && !seekVideo(m_videoPts, nullptr)) {
+        return false;
+    }
+    do {
+        if (decodeVideoFrame(frame) < 0) {
+            return false;
+        }
+    } while (m_videoPts != AV_NOPTS_VALUE && frame->pts <= m_videoPts);
+
+    presentFrame(frame);
+    return true;
+}
+
+/**
+ * @brief 逐帧后退
+ * @param frame 输出的视频帧
+ * @return 成功返回 true
+ */
+bool MediaPlayer::stepBackward(AVFrame* frame) {
+    if (!m_source || !m_source->videoStream() || m_videoPts == AV_NOPTS_VALUE) {
+        return false;
+    }
+    suspendLoopEngine();
+
+    if (m_frameCache->previous(m_videoPts, frame)) {
+        presentFrame(frame);
+        return true;
+    }
+
+    // 缓存未命中：从上一个关键帧解码到当前帧，沿途的帧都会进入缓存
+    if (!seekVideo(m_videoPts - 1, frame)) {
+        return false;
+    }
+    presentFrame(frame);
+    return true;
+}
+
+/**
+ * @brief 精确跳转到指定位置显示的视频帧
+ * @param position 目标位置（毫秒）
+ * @param frame 输出的视频帧
+ * @return 成功返回 true
+ */
+bool MediaPlayer::seekToFrame(qint64 position, AVFrame* frame) {
+    if (!m_source || !m_source->videoStream()) {
+        return false;
+    }
+    suspendLoopEngine();
+
+    const int64_t target = av_rescale_q(std::max<qint64>(position, 0) * 1000 + m_source->startTime(),
+                                        AV_TIME_BASE_Q, m_source->videoStream()->time_base);
+    if (m_frameCache->find(target, frame) || seekVideo(target, frame)) {
+        presentFrame(frame);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 设置播放速率
+ * @param rate 速率，不能为 0，负值表示倒放
+ * @return 成功返回 true
+ */
+bool MediaPlayer::setPlaybackRate(double rate) {
+    if (rate == 0.0 || !std::isfinite(rate)) {
+        QString errorMessage = QString("MediaPlayer::setPlaybackRate() failed. Invalid rate: %1").arg(rate);
+        qWarning() << errorMessage;
+        emit error(errorMessage);
+        return false;
+    }
+
+    const bool changed = m_playbackRate != rate;
+    m_playbackRate = rate;
+    if (!m_source) {
+        if (changed) {
+            emit playbackRateChanged(m_playbackRate);
+        }
+        return true;
+    }
+
+    // 倒放由 ReverseEngine 负责，速率只影响呈现节奏
+    if (!setReverse(rate < 0)) {
+        return false;
+    }
+
+    const bool keyframesOnly = rate > kFullDecodeMaxRate && m_source->videoStream();
+    if (keyframesOnly) {
+        if (!m_trickPlay) {
+            suspendLoopEngine();
+            av_frame_unref(m_pendingFrame);
+            m_trickPlay = std::make_unique<TrickPlayEngine>(m_source.get());
+            m_trickPlay->reset(m_position);
+            m_resumePending = true;
+            qDebug() << "MediaPlayer: Keyframe-only trick play enabled.";
+        }
+        m_trickPlay->setRate(rate);
+    } else if (m_trickPlay) {
+        // 恢复完整解码，从最后显示的关键帧之后继续
+        m_trickPlay.reset();
+        m_decodePts = AV_NOPTS_VALUE;
+        m_resumePending = true;
+        qDebug() << "MediaPlayer: Keyframe-only trick play disabled.";
+    }
+
+    qDebug() << "MediaPlayer: Playback rate set to:" << rate;
+    if (changed) {
+        emit playbackRateChanged(m_playbackRate);
+    }
+    return true;
+}
+
+/**
+ * @brief 获取当前播放速率
+ * @return 播放速率
+ */
+double MediaPlayer::getPlaybackRate() const {
+    return m_playbackRate;
+}
+
+/**
+ * @brief 开始或结束倒放
+ * @param reverse 是否倒放
+ * @return 成功返回 true
+ */
+bool MediaPlayer::setReverse(bool reverse) {
+    if (reverse == isReverse()) {
+        return true;
+    }
+
+    if (!reverse) {
+        // 从倒放停下的帧之后恢复正向播放
+        m_reverseEngine.reset();
+        m_decodePts = AV_NOPTS_VALUE;
+        m_resumePending = true;
+        qDebug() << "MediaPlayer: Reverse playback stopped at:" << m_position;
+        return true;
+    }
+
+    if (!m_source || !m_source->videoStream()) {
+        QString errorMessage = "MediaPlayer::setReverse() failed. No video is loaded.";
+        qWarning() << errorMessage;
+        emit error(errorMessage);
+        return false;
+    }
+
+    // 倒放使用独立打开的解码器，不影响当前媒体源
+    suspendLoopEngine();
+    ReverseEngine::Options options;
+    options.sourceOptions.asyncIo = m_asyncIo;
+    options.sourceOptions.directIo = m_directIo;
+    options.sourceOptions.probeCache = m_probeCache;
+    options.sourceOptions.quality = m_quality;
+
+    auto engine = std::make_unique<ReverseEngine>();
+    engine->setOptions(options);
+    connect(engine.get(), &ReverseEngine::error, this, &MediaPlayer::error);
+    if (!engine->start(m_currentMedia, m_position)) {
+        return false;
+    }
+
+    m_reverseEngine = std::move(engine);
+    m_resumePending = true;
+    qDebug() << "MediaPlayer: Reverse playback started at:" << m_position;
+    return true;
+}
+
+/**
+ * @brief 获取当前是否在倒放
+ * @return 是否倒放
+ */
+bool MediaPlayer::isReverse() const {
+    return m_reverseEngine != nullptr;
+}
+
+/**
+ * @brief 设置已解码帧缓存的内存上限
+ * @param bytes 上限（字节），0 表示禁用缓存
+ */
+void MediaPlayer::setFrameCacheLimit(std::size_t bytes) {
+    m_frameCache->setMemoryLimit(bytes);
+}
+
+/**
+ * @brief 获取已解码帧缓存当前占用的内存
+ * @return 占用内存（字节）
+ */
+std::size_t MediaPlayer::getFrameCacheUsage() const {
+    return m_frameCache->getStatistics().bytes;
+}
+
+/**
+ * @brief 逐帧操作前等待循环引擎的后台重定位结束，之后由本类直接驱动媒体源
+ */
+void MediaPlayer::suspendLoopEngine() {
+    if (m_loopEngine && !m_resumePending) {
+        m_loopEngine->seek(m_position);
+        av_frame_unref(m_pendingFrame);
+        m_decodePts = AV_NOPTS_VALUE;
+    }
+}
+
+/**
+ * @brief 把媒体源定位到目标视频帧之后
+ * 跳转到目标之前的关键帧，解码（并缓存）到第一帧晚于目标的帧为止，
+ * 该帧暂存在 m_pendingFrame 中，供之后的播放或逐帧前进使用。
+ * @param target 目标时间戳（视频流时间基）
+ * @param shown 输出在目标时间显示的帧（pts 不大于目标的最后一帧），可为空
+ * @return 成功返回 true
+ */
+bool MediaPlayer::seekVideo(int64_t target, AVFrame* shown) {
+    const int64_t timestamp = av_rescale_q(target, m_source->videoStream()->time_base, AV_TIME_BASE_Q)
+        - m_source->startTime();
+    if (m_source->seek(std::max<int64_t>(timestamp, 0) / 1000) < 0) {
+        return false;
+    }
+
+    m_frameCache->resetSequence();
+    av_frame_unref(m_pendingFrame);
+    m_decodePts = AV_NOPTS_VALUE;
+
+    bool found = false;
+    for (;;) {
+        int ret = readVideoFrame(m_pendingFrame);
+        if (ret < 0) {
+            return ret == AVERROR_EOF && (found || !shown);
+        }
+        if (m_pendingFrame->pts > target) {
+            break;
+        }
+
+        m_decodePts = m_pendingFrame->pts;
+        found = true;
+        if (shown) {
+            av_frame_unref(shown);
+            av_frame_move_ref(shown, m_pendingFrame);
+        } else {
+            av_frame_unref(m_pendingFrame);
+        }
+    }
+    return found || !shown;
+}
+
+/**
+ * @brief 从媒体源读取下一帧视频帧并写入缓存，音频帧被丢弃
+ */
+int MediaPlayer::readVideoFrame(AVFrame* frame) {
+    for (;;) {
+        AVMediaType type = AVMEDIA_TYPE_UNKNOWN;
+        int ret = m_source->readFrame(frame, &type);
+        if (ret < 0) {
+            return ret;
+        }
+        if (type == AVMEDIA_TYPE_VIDEO) {
+            m_frameCache->insert(frame);
+            return 0;
+        }
+        av_frame_unref(frame);
+    }
+}
+
+/**
+ * @brief 取出解码顺序上的下一帧视频帧（优先使用暂存帧）
+ */
+int MediaPlayer::decodeVideoFrame(AVFrame* frame) {
+    av_frame_unref(frame);
+    int ret = 0;
+    if (m_pendingFrame->buf[0]) {
+        av_frame_move_ref(frame, m_pendingFrame);
+    } else {
+        ret = readVideoFrame(frame);
+    }
+    if (ret >= 0) {
+        m_decodePts = frame->pts;
+    }
+    return ret;
+}
+
+/**
+ * @brief 把逐帧操作得到的帧设为当前显示帧
+ */
+void MediaPlayer::presentFrame(const AVFrame* frame) {
+    StartupProfiler::instance().mark(StartupProfiler::Phase::FirstFrame);
+    m_videoPts = frame->pts;
+    m_resumePending = true;
+
+    const qint64 oldPosition = m_position;
+    m_position = (av_rescale_q(frame->pts, m_source->videoStream()->time_base, AV_TIME_BASE_Q)
+                  - m_source->startTime()) / 1000;
+    if (oldPosition != m_position) {
+        emit positionChanged(m_position);
+    }
+}
+
+/**
+ * @brief 启用或禁用基于 io_uring 的异步预读 I/O
+ * @param enabled 是否启用
+ * @param directIo 是否以 O_DIRECT 读取
+ */
+void MediaPlayer::setAsyncIoEnabled(bool enabled, bool directIo) {
+    m_asyncIo = enabled;
+    m_directIo = directIo;
+    qDebug() << "MediaPlayer: Async I/O set to:" << enabled << "direct:" << directIo;
+}
+
+/**
+ * @brief 获取是否启用了异步预读 I/O
+ * @return 是否启用
+ */
+bool MediaPlayer::isAsyncIoEnabled() const {
+    return m_asyncIo;
+}
+
+/**
+ * @brief 获取当前媒体阻塞等待 I/O 的累计时间
+ * @return 等待时间（微秒）
+ */
+qint64 MediaPlayer::getIoWaitTime() const {
+    const UringIOContext* ioContext = m_source ? m_source->ioContext() : nullptr;
+    return ioContext ? ioContext->getStatistics().ioWaitTimeUs : 0;
+}
+
+/**
+ * @brief 启用或禁用持久化探测缓存
+ * @param enabled 是否启用
+ */
+void MediaPlayer::setProbeCacheEnabled(bool enabled) {
+    m_probeCache = enabled;
+}
+
+/**
+ * @brief 获取是否启用了持久化探测缓存
+ * @return 是否启用
+ */
+bool MediaPlayer::isProbeCacheEnabled() const {
+    return m_probeCache;
+}
+
+/**
+ * @brief 获取最近一次打开媒体的耗时
+ * @return 耗时（微秒）
+ */
+qint64 MediaPlayer::getOpenTime() const {
+    return m_source ? m_source->openTime() : 0;
+}
+
+/**
+ * @brief 设置自适应流的画质
+ * @param quality 画质，ADAPTIVE 为自动选择
+ */
+void MediaPlayer::setQualityLevel(QualityLevel quality) {
+    m_quality = quality;
+    AdaptiveStream* stream = m_source ? m_source->adaptiveStream() : nullptr;
+    if (stream) {
+        stream->setQuality(quality);
+    }
+    qDebug() << "MediaPlayer: Quality level set to:" << static_cast<int>(quality);
+}
+
+/**
+ * @brief 获取自适应流的画质设置
+ * @return 画质
+ */
+QualityLevel MediaPlayer::getQualityLevel() const {
+    return m_quality;
+}
+
+/**
+ * @brief 获取当前自适应流的统计
+ * @return 统计，不是自适应流时返回空统计
+ */
+AdaptiveStream::Statistics MediaPlayer::getAdaptiveStatistics() const {
+    const AdaptiveStream* stream = m_source ? m_source->adaptiveStream() : nullptr;
+    return stream ? stream->getStatistics() : AdaptiveStream::Statistics();
+}
+
+/**
+ * @brief 开始录制当前媒体
+ * @param path 输出文件路径
+ * @param options 录制选项
+ * @return 成功返回 true
+ */
+bool MediaPlayer::startRecording(const QString& path, const StreamRecorder::Options& options) {
+    if (!m_source) {
+        emit error("MediaPlayer::startRecording() failed. No media loaded.");
+        return false;
+    }
+    stopRecording();
+
+    QString errorMessage;
+    std::unique_ptr<StreamRecorder> recorder =
+        StreamRecorder::create(m_source->formatContext(), path, options, &errorMessage);
+    if (!recorder) {
+        emit error(errorMessage);
+        return false;
+    }
+    m_recorder = std::move(recorder);
+    m_source->addTap(m_recorder);
+    emit recordingChanged(true);
+    return true;
+}
+
+/**
+ * @brief 停止录制
+ * 写线程可能还要写出队列中的数据包和文件尾，不在调用线程等待
+ */
+void MediaPlayer::stopRecording() {
+    if (!m_recorder) {
+        return;
+    }
+    detachTap(std::move(m_recorder));
+    emit recordingChanged(false);
+}
+
+/**
+ * @brief 从媒体源移除数据包分支并停止它
+ * 工作线程可能还要处理队列中的数据包，在后台任务中等待它退出并释放
+ */
+void MediaPlayer::detachTap(std::shared_ptr<PacketTap> tap) {
+    if (m_source) {
+        m_source->removeTap(tap.get());
+    }
+    tap->stop();
+    TaskScheduler::instance().submit(TaskScheduler::Priority::Background, [tap] { tap->wait(); });
+}
+
+/**
+ * @brief 获取是否正在录制
+ * @return 是否正在录制
+ */
+bool MediaPlayer::isRecording() const {
+    return m_recorder != nullptr;
+}
+
+/**
+ * @brief 获取当前录制的统计
+ * @return 录制统计
+ */
+StreamRecorder::Statistics MediaPlayer::getRecordingStatistics() const {
+    return m_recorder ? m_recorder->getStatistics() : StreamRecorder::Statistics();
+}
+
+/**
+ * @brief 开始转发当前媒体
+ * @param options 服务选项
+ * @return 成功返回 true
+ */
+bool MediaPlayer::startRestreaming(const RestreamServer::Options& options) {
+    if (!m_source) {
+        emit error("MediaPlayer::startRestreaming() failed. No media loaded.");
+        return false;
+    }
+    stopRestreaming();
+
+    QString errorMessage;
+    std::unique_ptr<RestreamServer> server = RestreamServer::create(m_source->formatContext(), options, &errorMessage);
+    if (!server) {
+        emit error(errorMessage);
+        return false;
+    }
+    m_restream = std::move(server);
+    m_source->addTap(m_restream);
+    emit restreamingChanged(true);
+    return true;
+}
+
+/**
+ * @brief 停止转发并断开所有客户端
+ */
+void MediaPlayer::stopRestreaming() {
+    if (!m_restream) {
+        return;
+    }
+    detachTap(std::move(m_restream));
+    emit restreamingChanged(false);
+}
+
+/**
+ * @brief 获取当前的转发服务
+ * @return 转发服务，未转发时返回 nullptr
+ */
+RestreamServer* MediaPlayer::restreamServer() const {
+    return m_restream.get();
+}
+
 /**
  * @brief 获取当前是否循环播放
  * @return 是否循环播放
@@ -0,0 +1,428 @@
+/********************************************************************************
+ * @file   : MediaSource.cpp
+ * @brief  : 实现了 aurorastream::core::MediaSource 类。
+ *
+ * 打开流程：可选的 io_uring、自适应流（HLS / DASH）或 UDP 批量接收自定义 I/O → avformat_open_input →
+ * 探测缓存重建或 avformat_find_stream_info → 查找并打开音视频解码器。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/MediaSource.h"
+#include "aurorastream/core/AdaptiveStream.h"
+#include "aurorastream/core/ProbeCache.h"
+#include "aurorastream/core/SeekIndex.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+#include "aurorastream/core/StartupProfiler.h"
+#include "aurorastream/core/PacketTap.h"
+#include "aurorastream/core/UringIOContext.h"
+#include "aurorastream/core/UdpIngest.h"
+#include "aurorastream/utils/Tracer.h"
+#include "NetworkUtils.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QFileInfo>
+#include <QtCore/QElapsedTimer>
+
+#include <algorithm>
+
+extern "C" {
+#include <libavutil/error.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+QString ffmpegError(const QString& message, int errorCode)
+{
+    char errbuf[AV_ERROR_MAX_STRING_SIZE] = {0};
+    av_strerror(errorCode, errbuf, AV_ERROR_MAX_STRING_SIZE);
+    return QString("FFmpeg error: %1 (%2)").arg(message).arg(errbuf);
+}
+
+/**
+ * @brief 查找并打开指定流的解码器
+ * @return 成功返回解码器上下文，失败返回 nullptr
+ */
+AVCodecContext* openDecoder(AVStream* stream, const char* kind)
+{
+    const AVCodec* codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    if (!codec) {
+        qWarning() << "MediaSource::open(): Could not find" << kind << "decoder.";
+        return nullptr;
+    }
+
+    AVCodecContext* codecContext = avcodec_alloc_context3(codec);
+    if (!codecContext) {
+        qWarning() << "MediaSource::open(): Could not allocate" << kind << "codec context.";
+        return nullptr;
+    }
+
+    if (avcodec_parameters_to_context(codecContext, stream->codecpar) < 0
+        || avcodec_open2(codecContext, codec, nullptr) < 0) {
+        qWarning() << "MediaSource::open(): Could not open" << kind << "codec.";
+        avcodec_free_context(&codecContext);
+        return nullptr;
+    }
+
+    codecContext->pkt_timebase = stream->time_base;
+    qDebug() << "MediaSource::open():" << kind << "stream found and decoder initialized.";
+    return codecContext;
+}
+
+} // namespace
+
+MediaSource::MediaSource()
+{
+    setMetricsScope(nullptr);
+}
+
+/**
+ * @brief 析构函数，负责释放 FFmpeg 资源
+ * 自定义 I/O 上下文必须在格式上下文关闭之后释放
+ */
+MediaSource::~MediaSource()
+{
+    av_packet_free(&m_packet);
+    avcodec_free_context(&m_videoCodecContext);
+    avcodec_free_context(&m_audioCodecContext);
+    if (m_formatContext) {
+        avformat_close_input(&m_formatContext);
+    }
+    m_ioContext.reset();
+    m_adaptiveStream.reset();
+    m_udpIngest.reset();
+}
+
+std::unique_ptr<MediaSource> MediaSource::open(const QString& uri, const Options& options, QString* errorMessage)
+{
+    auto fail = [errorMessage](const QString& message) {
+        qWarning() << message;
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        return nullptr;
+    };
+
+    QElapsedTimer openTimer;
+    openTimer.start();
+
+    // 网络地址（rtmp://、http:// 等）不做本地文件检查
+    const bool isUrl = uri.contains("://");
+    QFileInfo fileInfo(uri);
+    if (!isUrl && !fileInfo.isFile()) {
+        return fail(QString("MediaSource::open() failed. File does not exist or is not a regular file: %1").arg(uri));
+    }
+    if (isUrl) {
+        detail::ensureNetworkInitialized();
+    }
+
+    std::unique_ptr<MediaSource> source(new MediaSource());
+    source->m_uri = uri;
+
+    AVFormatContext* formatContext = nullptr;
+
+    // 本地文件可选使用 io_uring 预读，不可用时回退到 FFmpeg 的同步文件协议
+    if (options.asyncIo && !isUrl) {
+        UringIOContext::Options ioOptions;
+        ioOptions.directIO = options.directIo;
+        source->m_ioContext = UringIOContext::create(fileInfo.absoluteFilePath().toStdString(), ioOptions);
+        if (source->m_ioContext) {
+            formatContext = avformat_alloc_context();
+            formatContext->pb = source->m_ioContext->avioContext();
+            formatContext->flags |= AVFMT_FLAG_CUSTOM_IO;
+            qDebug() << "MediaSource::open(): Using io_uring read-ahead I/O.";
+        }
+    }
+
+    // HLS / DASH 清单由自适应码率客户端拼接成连续的字节流；不支持的情况（如加密分段）回退到 FFmpeg 自带的解复用器
+    if (options.adaptiveStreaming && AdaptiveStream::isManifest(uri)) {
+        AdaptiveStream::Options adaptiveOptions;
+        adaptiveOptions.quality = options.quality;
+        source->m_adaptiveStream = AdaptiveStream::open(uri, adaptiveOptions);
+        if (source->m_adaptiveStream) {
+            formatContext = avformat_alloc_context();
+            formatContext->pb = source->m_adaptiveStream->avioContext();
+            formatContext->flags |= AVFMT_FLAG_CUSTOM_IO;
+            qDebug() << "MediaSource::open(): Using adaptive streaming client.";
+        } else {
+            qDebug() << "MediaSource::open(): Falling back to the FFmpeg demuxer for" << uri;
+        }
+    }
+    const bool adaptive = source->m_adaptiveStream != nullptr;
+
+    // udp:// 的 MPEG-TS 由独立线程批量接收，rtp:// 另经抖动缓冲重排；平台不支持或地址无法解析时回退到 FFmpeg 的 udp / rtp 协议
+    const AVInputFormat* inputFormat = nullptr;
+    if (options.batchedUdp && UdpIngest::isUdpUrl(uri)) {
+        source->m_udpIngest = UdpIngest::create(uri, UdpIngest::Options());
+        if (source->m_udpIngest) {
+            formatContext = avformat_alloc_context();
+            formatContext->pb = source->m_udpIngest->avioContext();
+            formatContext->flags |= AVFMT_FLAG_CUSTOM_IO;
+            inputFormat = av_find_input_format("mpegts");
+            qDebug() << "MediaSource::open(): Using batched UDP ingest on port" << source->m_udpIngest->port();
+        } else {
+            qDebug() << "MediaSource::open(): Falling back to the FFmpeg protocol for" << uri;
+        }
+    }
+    const bool customInput = adaptive || source->m_udpIngest;
+
+    // 自定义 I/O 不传地址：自适应流按内容探测格式，避免按扩展名选中 hls / dash 解复用器；UDP / RTP 直接指定 mpegts
+    int ret = avformat_open_input(&formatContext, customInput ? "" : uri.toStdString().c_str(), inputFormat, nullptr);
+    if (ret < 0) {
+        return fail(ffmpegError(QString("MediaSource::open() failed. Could not open file: %1").arg(uri), ret));
+    }
+    source->m_formatContext = formatContext;
+
+    // 命中探测缓存时直接用缓存结果重建流，跳过 avformat_find_stream_info
+    const bool cacheable = options.probeCache && !isUrl && !adaptive;
+    const std::string cachePath = fileInfo.absoluteFilePath().toStdString();
+    source->m_probeCacheHit = cacheable && ProbeCache::instance().restore(cachePath, formatContext);
+    ret = source->m_probeCacheHit ? 0 : avformat_find_stream_info(formatContext, nullptr);
+    if (ret < 0) {
+        return fail(ffmpegError(QString("MediaSource::open() failed. Could not find stream information in file: %1").arg(uri), ret));
+    }
+    if (cacheable && !source->m_probeCacheHit) {
+        ProbeCache::instance().store(cachePath, formatContext);
+    }
+    if (options.seekIndex && !isUrl && !adaptive && SeekIndex::instance().apply(cachePath, formatContext)) {
+        qDebug() << "MediaSource::open(): Using offline keyframe index.";
+    }
+
+    // 不可随机访问的拼接字节流无法估计时长，使用清单中的节目时长
+    if (adaptive) {
+        const int64_t duration = source->m_adaptiveStream->duration();
+        formatContext->duration = duration > 0 ? duration : AV_NOPTS_VALUE;
+    }
+
+    int videoStreamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0); // 查找视频流
+    int audioStreamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0); // 查找音频流
+
+    if (videoStreamIndex >= 0) {
+        source->m_videoCodecContext = openDecoder(formatContext->streams[videoStreamIndex], "Video");
+        source->m_videoStreamIndex = source->m_videoCodecContext ? videoStreamIndex : -1;
+    }
+    if (audioStreamIndex >= 0) {
+        source->m_audioCodecContext = openDecoder(formatContext->streams[audioStreamIndex], "Audio");
+        source->m_audioStreamIndex = source->m_audioCodecContext ? audioStreamIndex : -1;
+    }
+
+    // 检查是否找到有效的流
+    if (source->m_videoStreamIndex < 0 && source->m_audioStreamIndex < 0) {
+        return fail(QString("MediaSource::open() failed. No valid video or audio streams found in file: %1").arg(uri));
+    }
+
+    source->m_packet = av_packet_alloc();
+    source->m_openTime = openTimer.nsecsElapsed() / 1000;
+    StartupProfiler::instance().mark(StartupProfiler::Phase::MediaOpened);
+    return source;
+}
+
+/**
+ * @brief 读取并解码下一帧
+ * 每送入一个数据包后先把对应解码器取空，再读取下一个数据包；
+ * 输入结束后依次向各解码器发送空包并排空。
+ */
+int MediaSource::readFrame(AVFrame* frame, AVMediaType* type)
+{
+    for (;;) {
+        if (m_activeDecoder) {
+            int ret;
+            {
+                AURORASTREAM_TRACE_SCOPE("decode.receive", "decode");
+                ScopedTimer timer(*m_receiveTime);
+                ret = avcodec_receive_frame(m_activeDecoder, frame);
+            }
+            if (ret >= 0) {
+                (m_activeDecoder->codec_type == AVMEDIA_TYPE_VIDEO ? m_videoFrames : m_audioFrames)->add();
+                const int streamIndex = m_activeDecoder == m_videoCodecContext ? m_videoStreamIndex : m_audioStreamIndex;
+                frame->time_base = m_formatContext->streams[streamIndex]->time_base;
+                if (frame->pts == AV_NOPTS_VALUE) {
+                    frame->pts = frame->best_effort_timestamp;
+                }
+                *type = m_activeDecoder->codec_type;
+                return 0;
+            }
+            if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF) {
+                return ret;
+            }
+            m_activeDecoder = nullptr;
+        }
+
+        if (m_inputEnded) {
+            if (m_drainQueue.empty()) {
+                return AVERROR_EOF;
+            }
+            m_activeDecoder = m_drainQueue.back();
+            m_drainQueue.pop_back();
+            avcodec_send_packet(m_activeDecoder, nullptr);
+            continue;
+        }
+
+        int ret;
+        {
+            AURORASTREAM_TRACE_SCOPE("demux.read", "demux");
+            ret = av_read_frame(m_formatContext, m_packet);
+        }
+        if (ret == AVERROR_EOF) {
+            m_inputEnded = true;
+            if (m_audioCodecContext) {
+                m_drainQueue.push_back(m_audioCodecContext);
+            }
+            if (m_videoCodecContext) {
+                m_drainQueue.push_back(m_videoCodecContext);
+            }
+            continue;
+        }
+        if (ret < 0) {
+            return ret;
+        }
+        m_demuxBytes->add(static_cast<uint64_t>(m_packet->size));
+        m_demuxPackets->add();
+
+        // 数据包分支共享同一个数据包缓冲区，不复制数据；分支跟不上时自行丢包，不会阻塞这里
+        for (const std::shared_ptr<PacketTap>& tap : m_taps) {
+            tap->push(m_packet);
+        }
+
+        AVCodecContext* decoder = decoderFor(m_packet->stream_index);
+        if (decoder) {
+            // 单个损坏的数据包不应中断播放，丢弃后继续
+            AURORASTREAM_TRACE_SCOPE("decode.send", "decode");
+            ScopedTimer timer(*m_sendTime);
+            if (avcodec_send_packet(decoder, m_packet) >= 0) {
+                m_activeDecoder = decoder;
+            }
+        }
+        av_packet_unref(m_packet);
+    }
+}
+
+int MediaSource::seek(qint64 position)
+{
+    return seekStream(-1, std::max<qint64>(position, 0) * 1000 + startTime());
+}
+
+int MediaSource::seekStream(int streamIndex, int64_t timestamp, int flags)
+{
+    int ret;
+    if (m_adaptiveStream) {
+        // 自适应流从包含目标时间的分段重新下载（同时清空 AVIO 缓冲），再丢弃解复用器中的旧数据
+        const int64_t time = streamIndex < 0
+                             ? timestamp
+                             : av_rescale_q(timestamp, m_formatContext->streams[streamIndex]->time_base, AV_TIME_BASE_Q);
+        const int64_t position = m_adaptiveStream->seek(time - startTime());
+        if (position < 0) {
+            return static_cast<int>(position);
+        }
+        avformat_flush(m_formatContext);
+        ret = 0;
+    } else {
+        ret = av_seek_frame(m_formatContext, streamIndex, timestamp, flags);
+    }
+    if (ret < 0) {
+        return ret;
+    }
+
+    if (m_videoCodecContext) {
+        avcodec_flush_buffers(m_videoCodecContext);
+    }
+    if (m_audioCodecContext) {
+        avcodec_flush_buffers(m_audioCodecContext);
+    }
+    m_activeDecoder = nullptr;
+    m_drainQueue.clear();
+    m_inputEnded = false;
+    for (const std::shared_ptr<PacketTap>& tap : m_taps) {
+        tap->split();
+    }
+    return 0;
+}
+
+AVCodecContext* MediaSource::decoderFor(int streamIndex) const
+{
+    if (streamIndex == m_videoStreamIndex) {
+        return m_videoCodecContext;
+    }
+    if (streamIndex == m_audioStreamIndex) {
+        return m_audioCodecContext;
+    }
+    return nullptr;
+}
+
+QString MediaSource::uri() const { return m_uri; }
+AVFormatContext* MediaSource::formatContext() const { return m_formatContext; }
+AVCodecContext* MediaSource::videoCodecContext() const { return m_videoCodecContext; }
+AVCodecContext* MediaSource::audioCodecContext() const { return m_audioCodecContext; }
+int MediaSource::videoStreamIndex() const { return m_videoStreamIndex; }
+int MediaSource::audioStreamIndex() const { return m_audioStreamIndex; }
+qint64 MediaSource::openTime() const { return m_openTime; }
+bool MediaSource::probeCacheHit() const { return m_probeCacheHit; }
+const UringIOContext* MediaSource::ioContext() const { return m_ioContext.get(); }
+AdaptiveStream* MediaSource::adaptiveStream() const { return m_adaptiveStream.get(); }
+const UdpIngest* MediaSource::udpIngest() const { return m_udpIngest.get(); }
+
+void MediaSource::addTap(std::shared_ptr<PacketTap> tap)
+{
+    if (tap) {
+        m_taps.push_back(std::move(tap));
+    }
+}
+
+void MediaSource::removeTap(const PacketTap* tap)
+{
+    m_taps.erase(std::remove_if(m_taps.begin(), m_taps.end(),
+                                [tap](const std::shared_ptr<PacketTap>& item) { return item.get() == tap; }),
+                 m_taps.end());
+}
+
+/**
+ * @brief 设置指标子注册表
+ * 指标引用在这里解析一次，readFrame 热路径上不再按名字查找
+ */
+void MediaSource::setMetricsScope(std::shared_ptr<MetricsScope> scope)
+{
+    m_metricsScope = std::move(scope);
+    if (m_metricsScope) {
+        m_demuxBytes = &m_metricsScope->counter("demux.bytes");
+        m_demuxPackets = &m_metricsScope->counter("demux.packets");
+        m_videoFrames = &m_metricsScope->counter("decode.video_frames");
+        m_audioFrames = &m_metricsScope->counter("decode.audio_frames");
+        m_sendTime = &m_metricsScope->histogram("decode.send_us");
+        m_receiveTime = &m_metricsScope->histogram("decode.receive_us");
+    } else {
+        PerformanceMonitor& monitor = PerformanceMonitor::instance();
+        m_demuxBytes = &monitor.counter("demux.bytes");
+        m_demuxPackets = &monitor.counter("demux.packets");
+        m_videoFrames = &monitor.counter("decode.video_frames");
+        m_audioFrames = &monitor.counter("decode.audio_frames");
+        m_sendTime = &monitor.histogram("decode.send_us");
+        m_receiveTime = &monitor.histogram("decode.receive_us");
+    }
+}
+
+AVStream* MediaSource::videoStream() const
+{
+    return m_videoStreamIndex >= 0 ? m_formatContext->streams[m_videoStreamIndex] : nullptr;
+}
+
+AVStream* MediaSource::audioStream() const
+{
+    return m_audioStreamIndex >= 0 ? m_formatContext->streams[m_audioStreamIndex] : nullptr;
+}
+
+int64_t MediaSource::startTime() const
+{
+    return m_formatContext->start_time != AV_NOPTS_VALUE ? m_formatContext->start_time : 0;
+}
+
+qint64 MediaSource::duration() const
+{
+    return m_formatContext->duration != AV_NOPTS_VALUE ? m_formatContext->duration / 1000 : 0;
+}
+
+} // namespace core
+} // namespace aurorastream
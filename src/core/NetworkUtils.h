@@ -0,0 +1,40 @@
+/********************************************************************************
+ * @file   : NetworkUtils.h
+ * @brief  : Core 模块内部使用的网络初始化辅助函数。
+ *
+ * 供 MediaSource 和 AdaptiveStream 共用，不属于公共接口。
+ *
+ * @author : polarours
+ * @date   : 2026/10/19
+ ********************************************************************************/
+
+#ifndef AURORASTREAM_CORE_NETWORKUTILS_H
+#define AURORASTREAM_CORE_NETWORKUTILS_H
+
+#include <mutex>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+namespace aurorastream {
+namespace core {
+namespace detail {
+
+/**
+ * @brief 第一次打开网络地址时初始化 FFmpeg 网络模块（TLS 等），本地播放不付出这部分启动开销
+ * 内联函数的静态局部变量在所有翻译单元中只有一份，整个进程只初始化一次。
+ */
+inline void ensureNetworkInitialized()
+{
+    static std::once_flag initialized;
+    std::call_once(initialized, [] {
+        avformat_network_init();
+    });
+}
+
+} // namespace detail
+} // namespace core
+} // namespace aurorastream
+
+#endif // AURORASTREAM_CORE_NETWORKUTILS_H
@@ -0,0 +1,191 @@
+/********************************************************************************
+ * @file   : PacketTap.cpp
+ * @brief  : 实现了 aurorastream::core::PacketTap 类。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/PacketTap.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+
+namespace aurorastream {
+namespace core {
+
+PacketTap::PacketTap(const std::string& metricPrefix, const Limits& limits)
+    : m_limits(limits)
+    , m_droppedCounter(PerformanceMonitor::instance().counter(metricPrefix + ".dropped_packets"))
+    , m_queuedGauge(PerformanceMonitor::instance().gauge(metricPrefix + ".queued_bytes"))
+{
+}
+
+PacketTap::~PacketTap()
+{
+    stop();
+    wait();
+    for (AVPacket* packet : m_queue) {
+        av_packet_free(&packet);
+    }
+}
+
+int PacketTap::addStream(int inputIndex, AVRational timeBase, bool video)
+{
+    if (inputIndex >= static_cast<int>(m_streamMap.size())) {
+        m_streamMap.resize(inputIndex + 1, -1);
+    }
+    const int outputIndex = static_cast<int>(m_inputTimeBases.size());
+    if (video && m_videoStream < 0) {
+        m_videoStream = outputIndex;
+    }
+    m_streamMap[inputIndex] = outputIndex;
+    m_inputTimeBases.push_back(timeBase);
+    return outputIndex;
+}
+
+void PacketTap::start()
+{
+    m_running = true;
+    m_worker = std::thread(&PacketTap::workerLoop, this);
+}
+
+int PacketTap::streamCount() const
+{
+    return static_cast<int>(m_inputTimeBases.size());
+}
+
+AVRational PacketTap::inputTimeBase(int outputIndex) const
+{
+    return m_inputTimeBases[outputIndex];
+}
+
+int PacketTap::videoStream() const
+{
+    return m_videoStream;
+}
+
+bool PacketTap::push(const AVPacket* packet)
+{
+    if (!packet || packet->stream_index < 0 || packet->stream_index >= static_cast<int>(m_streamMap.size())) {
+        return false;
+    }
+    const int outputIndex = m_streamMap[packet->stream_index];
+    if (outputIndex < 0) {
+        return false;
+    }
+
+    // 引用计数的数据包只增加引用，不复制数据；锁外完成以缩短临界区
+    AVPacket* reference = av_packet_alloc();
+    if (!reference || av_packet_ref(reference, packet) < 0) {
+        av_packet_free(&reference);
+        return false;
+    }
+    reference->stream_index = outputIndex;
+
+    const bool keyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+    bool queued = false;
+    bool dropped = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            // 已停止，直接丢弃
+        } else if (m_waitKeyframe && m_videoStream >= 0 && !(outputIndex == m_videoStream && keyframe)) {
+            dropped = true;
+        } else if (m_queue.size() >= m_limits.maxQueuedPackets
+                   || m_queuedBytes + static_cast<std::size_t>(packet->size) > m_limits.maxQueuedBytes) {
+            // 工作线程跟不上（例如磁盘慢）：丢弃而不是阻塞解复用，并从下一个关键帧恢复
+            m_waitKeyframe = true;
+            dropped = true;
+        } else {
+            m_waitKeyframe = false;
+            m_queue.push_back(reference);
+            m_queuedBytes += static_cast<std::size_t>(packet->size);
+            m_queuedGauge.set(static_cast<int64_t>(m_queuedBytes));
+            queued = true;
+        }
+        if (dropped) {
+            ++m_dropped;
+        }
+    }
+    if (!queued) {
+        av_packet_free(&reference);
+        if (dropped) {
+            m_droppedCounter.add();
+        }
+        return false;
+    }
+    m_wakeup.notify_one();
+    return true;
+}
+
+void PacketTap::split()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            return;
+        }
+        m_queue.push_back(nullptr);
+        m_waitKeyframe = true;
+    }
+    m_wakeup.notify_one();
+}
+
+void PacketTap::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeup.notify_all();
+}
+
+void PacketTap::wait()
+{
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+bool PacketTap::isRunning() const
+{
+    return m_running.load();
+}
+
+uint64_t PacketTap::droppedPackets() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dropped;
+}
+
+/**
+ * @brief 工作线程：按队列顺序处理数据包，停止后处理完剩余数据包再退出
+ */
+void PacketTap::workerLoop()
+{
+    for (;;) {
+        AVPacket* packet = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeup.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                break;
+            }
+            packet = m_queue.front();
+            m_queue.pop_front();
+            if (packet) {
+                m_queuedBytes -= static_cast<std::size_t>(packet->size);
+                m_queuedGauge.set(static_cast<int64_t>(m_queuedBytes));
+            }
+        }
+        if (packet) {
+            consume(packet);
+        } else {
+            discontinuity();
+        }
+    }
+    finish();
+    m_running = false;
+}
+
+} // namespace core
+} // namespace aurorastream
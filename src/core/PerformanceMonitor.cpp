@@ -0,0 +1,409 @@
+/********************************************************************************
+ * @file   : PerformanceMonitor.cpp
+ * @brief  : 实现了 aurorastream::core::PerformanceMonitor 类。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/PerformanceMonitor.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QCoreApplication>
+
+#include <cstdio>
+#include <algorithm>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+/// 进程常驻内存（字节），不支持的平台返回 0
+std::size_t residentMemory()
+{
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    std::size_t pages = 0;
+    std::size_t resident = 0;
+    if (statm >> pages >> resident) {
+        return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+void writeName(std::ostream& out, const std::string& name)
+{
+    out << '"';
+    for (char c : name) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+/// 写出 "counters":{...},"gauges":{...},"histograms":{...}（调用方持有对应注册表的锁）
+template <typename Counters, typename Gauges, typename Histograms>
+void writeRegistry(std::ostream& out, const Counters& counters, const Gauges& gauges, const Histograms& histograms)
+{
+    out << "\"counters\":{";
+    bool first = true;
+    for (const auto& [name, metric] : counters) {
+        out << (first ? "" : ",");
+        writeName(out, name);
+        out << ':' << metric->value();
+        first = false;
+    }
+
+    out << "},\"gauges\":{";
+    first = true;
+    for (const auto& [name, metric] : gauges) {
+        out << (first ? "" : ",");
+        writeName(out, name);
+        out << ':' << metric->value();
+        first = false;
+    }
+
+    out << "},\"histograms\":{";
+    first = true;
+    for (const auto& [name, metric] : histograms) {
+        const uint64_t count = metric->count();
+        out << (first ? "" : ",");
+        writeName(out, name);
+        out << ":{\"count\":" << count
+            << ",\"mean\":" << (count ? static_cast<double>(metric->sum()) / count : 0.0)
+            << ",\"p50\":" << metric->percentile(0.50)
+            << ",\"p95\":" << metric->percentile(0.95)
+            << ",\"p99\":" << metric->percentile(0.99)
+            << ",\"max\":" << metric->max() << "}";
+        first = false;
+    }
+    out << "}";
+}
+
+} // namespace
+
+void Histogram::record(int64_t micros)
+{
+    if (micros < 0) {
+        micros = 0;
+    }
+    int bucket = 0;
+    for (uint64_t v = static_cast<uint64_t>(micros); v != 0 && bucket < kBuckets - 1; v >>= 1) {
+        ++bucket;
+    }
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(static_cast<uint64_t>(micros), std::memory_order_relaxed);
+
+    int64_t current = m_max.load(std::memory_order_relaxed);
+    while (micros > current && !m_max.compare_exchange_weak(current, micros, std::memory_order_relaxed)) {
+    }
+    if (m_parent) {
+        m_parent->record(micros);
+    }
+}
+
+int64_t Histogram::percentile(double quantile) const
+{
+    const uint64_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+    const uint64_t target = static_cast<uint64_t>(quantile * total);
+    uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen > target) {
+            return i == 0 ? 0 : (int64_t {1} << i) - 1;
+        }
+    }
+    return max();
+}
+
+MetricsScope::MetricsScope(PerformanceMonitor& monitor, std::string label)
+    : m_monitor(monitor)
+    , m_label(std::move(label))
+{
+}
+
+// 先在进程注册表中取得父指标再加本作用域的锁，与 toJson() 不会形成锁顺序环
+Counter& MetricsScope::counter(const std::string& name)
+{
+    Counter& parent = m_monitor.counter(name);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<Counter>& metric = m_counters[name];
+    if (!metric) {
+        metric = std::make_unique<Counter>();
+        metric->m_parent = &parent;
+    }
+    return *metric;
+}
+
+Gauge& MetricsScope::gauge(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<Gauge>& metric = m_gauges[name];
+    if (!metric) {
+        metric = std::make_unique<Gauge>();
+    }
+    return *metric;
+}
+
+Histogram& MetricsScope::histogram(const std::string& name)
+{
+    Histogram& parent = m_monitor.histogram(name);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<Histogram>& metric = m_histograms[name];
+    if (!metric) {
+        metric = std::make_unique<Histogram>();
+        metric->m_parent = &parent;
+    }
+    return *metric;
+}
+
+void MetricsScope::writeJson(std::ostream& out) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    out << '{';
+    writeRegistry(out, m_counters, m_gauges, m_histograms);
+    out << '}';
+}
+
+PerformanceMonitor& PerformanceMonitor::instance()
+{
+    // 第一次访问可能发生在解码或渲染线程上，定时器需要属于主线程的事件循环
+    static PerformanceMonitor& monitor = []() -> PerformanceMonitor& {
+        static PerformanceMonitor instance;
+        if (QCoreApplication* application = QCoreApplication::instance()) {
+            instance.moveToThread(application->thread());
+        }
+        return instance;
+    }();
+    return monitor;
+}
+
+PerformanceMonitor::PerformanceMonitor(QObject* parent)
+    : QObject(parent)
+    , m_timer(this)
+{
+    connect(&m_timer, &QTimer::timeout, this, &PerformanceMonitor::sample);
+}
+
+Counter& PerformanceMonitor::counter(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<Counter>& metric = m_counters[name];
+    if (!metric) {
+        metric = std::make_unique<Counter>();
+    }
+    return *metric;
+}
+
+Gauge& PerformanceMonitor::gauge(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<Gauge>& metric = m_gauges[name];
+    if (!metric) {
+        metric = std::make_unique<Gauge>();
+    }
+    return *metric;
+}
+
+Histogram& PerformanceMonitor::histogram(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<Histogram>& metric = m_histograms[name];
+    if (!metric) {
+        metric = std::make_unique<Histogram>();
+    }
+    return *metric;
+}
+
+std::shared_ptr<MetricsScope> PerformanceMonitor::createScope(const std::string& kind)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_scopes.erase(std::remove_if(m_scopes.begin(), m_scopes.end(),
+                                  [](const std::weak_ptr<MetricsScope>& scope) { return scope.expired(); }),
+                   m_scopes.end());
+    std::shared_ptr<MetricsScope> scope(new MetricsScope(*this, kind + "-" + std::to_string(m_nextScope++)));
+    m_scopes.push_back(scope);
+    return scope;
+}
+
+PerformanceMonitor::Metrics PerformanceMonitor::getCurrentMetrics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_metrics;
+}
+
+void PerformanceMonitor::startMonitoring(int intervalMs)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lastSample = std::chrono::steady_clock::now();
+    }
+    m_timer.setInterval(std::max(100, intervalMs));
+    m_timer.start();
+    qDebug() << "PerformanceMonitor: Monitoring every" << intervalMs << "ms";
+}
+
+void PerformanceMonitor::stopMonitoring()
+{
+    if (!m_timer.isActive()) {
+        return;
+    }
+    m_timer.stop();
+    sample();
+}
+
+bool PerformanceMonitor::isMonitoring() const
+{
+    return m_timer.isActive();
+}
+
+void PerformanceMonitor::setSnapshotFile(const QString& filePath)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_snapshotFile = filePath;
+}
+
+QString PerformanceMonitor::snapshotFile() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_snapshotFile;
+}
+
+/**
+ * @brief 采样一次：由累计值的差计算最近一个间隔内的速率和平均耗时
+ */
+void PerformanceMonitor::sample()
+{
+    Counter& renderFrames = counter("render.frames");
+    Counter& videoFrames = counter("decode.video_frames");
+    Counter& demuxBytes = counter("demux.bytes");
+    Histogram& sendTime = histogram("decode.send_us");
+    Histogram& receiveTime = histogram("decode.receive_us");
+    Histogram& renderTime = histogram("render.time_us");
+    Gauge& rss = gauge("process.rss_bytes");
+
+    const std::size_t memory = residentMemory();
+    rss.set(static_cast<int64_t>(memory));
+
+    Metrics metrics;
+    QString snapshotFile;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto now = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(now - m_lastSample).count();
+        m_lastSample = now;
+
+        // 有渲染时按实际显示的帧计算帧率，否则按解码出的视频帧
+        const uint64_t frames = renderFrames.value() > 0 ? renderFrames.value() : videoFrames.value();
+        const uint64_t bytes = demuxBytes.value();
+        // 每个数据包的解码耗时 = 送入耗时 + 取出其帧的耗时，按送入次数平均
+        const uint64_t decodeCount = sendTime.count();
+        const uint64_t decodeSum = sendTime.sum() + receiveTime.sum();
+        const uint64_t renderCount = renderTime.count();
+        const uint64_t renderSum = renderTime.sum();
+
+        if (seconds > 0.0) {
+            metrics.frameRate = (frames - std::min(frames, m_lastFrames)) / seconds;
+            metrics.networkThroughput = (bytes - std::min(bytes, m_lastBytes)) / seconds;
+        }
+        if (decodeCount > m_lastDecodeCount) {
+            metrics.decodeTime = (decodeSum - m_lastDecodeSum) / 1000.0 / (decodeCount - m_lastDecodeCount);
+        }
+        if (renderCount > m_lastRenderCount) {
+            metrics.renderTime = (renderSum - m_lastRenderSum) / 1000.0 / (renderCount - m_lastRenderCount);
+        }
+        metrics.memoryUsage = memory;
+
+        m_lastFrames = frames;
+        m_lastBytes = bytes;
+        m_lastDecodeCount = decodeCount;
+        m_lastDecodeSum = decodeSum;
+        m_lastRenderCount = renderCount;
+        m_lastRenderSum = renderSum;
+        m_metrics = metrics;
+        snapshotFile = m_snapshotFile;
+    }
+
+    emit metricsUpdated(metrics);
+
+    if (!snapshotFile.isEmpty() && !writeSnapshot(toJson())) {
+        qWarning() << "PerformanceMonitor: Could not write snapshot to" << snapshotFile;
+    }
+}
+
+std::string PerformanceMonitor::toJson() const
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+
+    std::vector<std::shared_ptr<MetricsScope>> scopes;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        out << "{\"timestamp\":" << timestamp
+            << ",\"metrics\":{\"frame_rate\":" << m_metrics.frameRate
+            << ",\"decode_time\":" << m_metrics.decodeTime
+            << ",\"render_time\":" << m_metrics.renderTime
+            << ",\"memory_usage\":" << m_metrics.memoryUsage
+            << ",\"network_throughput\":" << m_metrics.networkThroughput << "},";
+        writeRegistry(out, m_counters, m_gauges, m_histograms);
+        for (const std::weak_ptr<MetricsScope>& weak : m_scopes) {
+            if (std::shared_ptr<MetricsScope> scope = weak.lock()) {
+                scopes.push_back(std::move(scope));
+            }
+        }
+    }
+
+    // 子注册表在释放进程注册表的锁之后写出，各自加自己的锁
+    out << ",\"instances\":{";
+    bool first = true;
+    for (const std::shared_ptr<MetricsScope>& scope : scopes) {
+        out << (first ? "" : ",");
+        writeName(out, scope->label());
+        out << ':';
+        scope->writeJson(out);
+        first = false;
+    }
+    out << "}}\n";
+    return out.str();
+}
+
+/**
+ * @brief 先写临时文件再重命名，采集方不会读到写了一半的快照
+ */
+bool PerformanceMonitor::writeSnapshot(const std::string& json) const
+{
+    const std::string path = snapshotFile().toStdString();
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::out | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        out << json;
+        if (!out.good()) {
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+} // namespace core
+} // namespace aurorastream
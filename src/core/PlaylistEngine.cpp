@@ -0,0 +1,643 @@
+/********************************************************************************
+ * @file   : PlaylistEngine.cpp
+ * @brief  : 实现了 aurorastream::core::PlaylistEngine 类。
+ *
+ * 衔接规则：下一项首个音频样本被放在上一项最后一个已输出音频样本之后
+ * （无音频时以视频结束时间为准）。交叉淡化时，下一项开头的样本被提前
+ * 混入上一项结尾，衔接点相应前移被混入的样本数；与上一项重叠的下一项
+ * 视频帧会被丢弃，画面在衔接点硬切。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/PlaylistEngine.h"
+#include "FrameUtils.h"
+
+#include <QtCore/QDebug>
+
+#include <cmath>
+#include <algorithm>
+
+extern "C" {
+#include <libavutil/mathematics.h>
+#include <libavutil/samplefmt.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+constexpr double kHalfPi = 1.57079632679489661923;
+
+int64_t toMicros(int64_t timestamp, AVRational timeBase)
+{
+    return av_rescale_q(timestamp, timeBase, AV_TIME_BASE_Q);
+}
+
+int nextIndexOf(int index, int count, bool loop)
+{
+    if (count <= 0) {
+        return -1;
+    }
+    if (index + 1 < count) {
+        return index + 1;
+    }
+    return loop ? 0 : -1;
+}
+
+bool isMixableFormat(int format)
+{
+    return format == AV_SAMPLE_FMT_FLT || format == AV_SAMPLE_FMT_FLTP
+        || format == AV_SAMPLE_FMT_S16 || format == AV_SAMPLE_FMT_S16P;
+}
+
+bool isCompatible(const AVFrame* a, const AVFrame* b)
+{
+    return a->format == b->format && a->sample_rate == b->sample_rate
+        && a->ch_layout.nb_channels == b->ch_layout.nb_channels && isMixableFormat(a->format);
+}
+
+/// 读取归一化到 [-1, 1] 的样本
+float sampleAt(const AVFrame* frame, int channel, int index)
+{
+    const int channels = frame->ch_layout.nb_channels;
+    switch (frame->format) {
+    case AV_SAMPLE_FMT_FLT:
+        return reinterpret_cast<const float*>(frame->extended_data[0])[index * channels + channel];
+    case AV_SAMPLE_FMT_FLTP:
+        return reinterpret_cast<const float*>(frame->extended_data[channel])[index];
+    case AV_SAMPLE_FMT_S16:
+        return reinterpret_cast<const int16_t*>(frame->extended_data[0])[index * channels + channel] / 32768.0f;
+    case AV_SAMPLE_FMT_S16P:
+        return reinterpret_cast<const int16_t*>(frame->extended_data[channel])[index] / 32768.0f;
+    default:
+        return 0.0f;
+    }
+}
+
+void setSample(AVFrame* frame, int channel, int index, float value)
+{
+    const int channels = frame->ch_layout.nb_channels;
+    const auto toS16 = [](float v) {
+        return static_cast<int16_t>(std::clamp(std::lround(v * 32768.0f), -32768L, 32767L));
+    };
+    switch (frame->format) {
+    case AV_SAMPLE_FMT_FLT:
+        reinterpret_cast<float*>(frame->extended_data[0])[index * channels + channel] = value;
+        break;
+    case AV_SAMPLE_FMT_FLTP:
+        reinterpret_cast<float*>(frame->extended_data[channel])[index] = value;
+        break;
+    case AV_SAMPLE_FMT_S16:
+        reinterpret_cast<int16_t*>(frame->extended_data[0])[index * channels + channel] = toS16(value);
+        break;
+    case AV_SAMPLE_FMT_S16P:
+        reinterpret_cast<int16_t*>(frame->extended_data[channel])[index] = toS16(value);
+        break;
+    default:
+        break;
+    }
+}
+
+} // namespace
+
+PlaylistEngine::PreparedItem::~PreparedItem()
+{
+    for (QueuedFrame& queued : frames) {
+        av_frame_free(&queued.frame);
+    }
+}
+
+/**
+ * @brief 从媒体源再解码一帧追加到预解码队列
+ * @return 成功返回 true，媒体源结束或出错返回 false
+ */
+bool PlaylistEngine::PreparedItem::decodeOne()
+{
+    if (sourceEnded) {
+        return false;
+    }
+
+    AVFrame* frame = av_frame_alloc();
+    AVMediaType type = AVMEDIA_TYPE_UNKNOWN;
+    if (!frame || source->readFrame(frame, &type) < 0) {
+        av_frame_free(&frame);
+        sourceEnded = true;
+        return false;
+    }
+
+    const bool primary = type == AVMEDIA_TYPE_AUDIO || !source->audioStream();
+    if (primary && firstPts == AV_NOPTS_VALUE && frame->pts != AV_NOPTS_VALUE) {
+        firstPts = toMicros(frame->pts, frame->time_base);
+    }
+    bytes += detail::frameBytes(frame);
+    frames.push_back({frame, type});
+    return true;
+}
+
+PlaylistEngine::PlaylistEngine(QObject* parent)
+    : QObject(parent)
+{
+}
+
+PlaylistEngine::~PlaylistEngine()
+{
+    stop();
+}
+
+void PlaylistEngine::setOptions(const Options& options)
+{
+    m_options = options;
+}
+
+PlaylistEngine::Options PlaylistEngine::options() const
+{
+    return m_options;
+}
+
+void PlaylistEngine::setSourceHandler(SourceHandler handler)
+{
+    m_sourceHandler = std::move(handler);
+}
+
+void PlaylistEngine::setItems(const QStringList& items)
+{
+    m_items = items;
+}
+
+void PlaylistEngine::append(const QString& uri)
+{
+    m_items.push_back(uri);
+}
+
+QStringList PlaylistEngine::items() const
+{
+    return m_items;
+}
+
+int PlaylistEngine::count() const
+{
+    return static_cast<int>(m_items.size());
+}
+
+int PlaylistEngine::currentIndex() const
+{
+    return m_current ? m_current->index : -1;
+}
+
+MediaSource* PlaylistEngine::currentSource() const
+{
+    return m_current ? m_current->active : nullptr;
+}
+
+int64_t PlaylistEngine::timelineOffset() const
+{
+    return m_offset;
+}
+
+std::size_t PlaylistEngine::prerollMemoryUsage() const
+{
+    return m_prerollBytes.load(std::memory_order_relaxed);
+}
+
+bool PlaylistEngine::start(int index)
+{
+    stop();
+
+    if (index < 0 || index >= count()) {
+        emit error(QString("PlaylistEngine::start() failed. Invalid index: %1").arg(index));
+        return false;
+    }
+
+    QString errorMessage;
+    auto item = std::make_unique<PreparedItem>();
+    item->index = index;
+    item->source = MediaSource::open(m_items[index], m_options.sourceOptions, &errorMessage);
+    if (!item->source) {
+        emit error(errorMessage);
+        return false;
+    }
+
+    activate(std::move(item), 0);
+    return true;
+}
+
+bool PlaylistEngine::attach(int index, MediaSource* source)
+{
+    stop();
+
+    if (index < 0 || index >= count() || !source) {
+        emit error(QString("PlaylistEngine::attach() failed. Invalid index: %1").arg(index));
+        return false;
+    }
+
+    auto item = std::make_unique<PreparedItem>();
+    item->index = index;
+    item->active = source;
+    activate(std::move(item), 0);
+    return true;
+}
+
+bool PlaylistEngine::next()
+{
+    if (!m_current) {
+        return false;
+    }
+    return advance();
+}
+
+void PlaylistEngine::stop()
+{
+    cancelPreroll();
+    m_pending.reset();
+    m_current.reset();
+    m_offset = 0;
+    m_currentEnd = AV_NOPTS_VALUE;
+    m_audioEnd = AV_NOPTS_VALUE;
+    m_videoEnd = AV_NOPTS_VALUE;
+    m_lastVideoPts = AV_NOPTS_VALUE;
+}
+
+bool PlaylistEngine::seek(qint64 position)
+{
+    if (!m_current) {
+        return false;
+    }
+
+    if (m_current->active->seek(position) < 0) {
+        emit error("PlaylistEngine::seek() failed. Could not seek to position.");
+        return false;
+    }
+
+    // 丢弃预解码的开头帧，时间线随当前项的时间戳跳转
+    for (QueuedFrame& queued : m_current->frames) {
+        av_frame_free(&queued.frame);
+    }
+    m_current->frames.clear();
+    m_current->bytes = 0;
+    m_current->sourceEnded = false;
+    m_audioEnd = AV_NOPTS_VALUE;
+    m_videoEnd = AV_NOPTS_VALUE;
+    m_lastVideoPts = AV_NOPTS_VALUE;
+    return true;
+}
+
+int PlaylistEngine::readFrame(AVFrame* frame, AVMediaType* type)
+{
+    while (m_current) {
+        int ret = 0;
+        if (!m_current->frames.empty()) {
+            QueuedFrame queued = m_current->frames.front();
+            m_current->frames.pop_front();
+            av_frame_move_ref(frame, queued.frame);
+            av_frame_free(&queued.frame);
+            *type = queued.type;
+        } else {
+            ret = m_current->active->readFrame(frame, type);
+        }
+
+        if (ret < 0) {
+            if (ret != AVERROR_EOF) {
+                emit error(QString("PlaylistEngine: Read error in %1, skipping to next item.")
+                           .arg(m_current->active->uri()));
+            }
+            if (!advance()) {
+                m_current.reset();
+                emit finished();
+                return AVERROR_EOF;
+            }
+            continue;
+        }
+
+        // 统一到以微秒为单位的连续时间线
+        const bool isAudio = *type == AVMEDIA_TYPE_AUDIO;
+        const int64_t duration = isAudio && frame->sample_rate > 0
+            ? av_rescale(frame->nb_samples, AV_TIME_BASE, frame->sample_rate)
+            : toMicros(frame->duration, frame->time_base);
+        int64_t pts;
+        if (frame->pts != AV_NOPTS_VALUE) {
+            pts = toMicros(frame->pts, frame->time_base) + m_offset;
+        } else {
+            const int64_t end = isAudio ? m_audioEnd : m_videoEnd;
+            pts = end != AV_NOPTS_VALUE ? end : 0;
+        }
+        frame->pts = pts;
+        frame->duration = duration;
+        frame->time_base = AV_TIME_BASE_Q;
+
+        if (isAudio) {
+            if (m_options.crossfade > 0) {
+                mixCrossfade(frame);
+            }
+            m_audioEnd = pts + duration;
+        } else {
+            // 交叉淡化时下一项开头与上一项结尾重叠的视频帧
+            if (m_lastVideoPts != AV_NOPTS_VALUE && pts < m_lastVideoPts) {
+                av_frame_unref(frame);
+                continue;
+            }
+            m_lastVideoPts = pts;
+            m_videoEnd = pts + duration;
+        }
+
+        if (!m_prerollStarted && !m_pending && m_currentEnd != AV_NOPTS_VALUE
+            && m_currentEnd - pts <= m_options.prerollWindow * 1000) {
+            startPreroll();
+        }
+        return 0;
+    }
+    return AVERROR_EOF;
+}
+
+/**
+ * @brief 在线程池中预打开下一项
+ */
+void PlaylistEngine::startPreroll()
+{
+    // 没有下一项时不标记为已开始，之后追加的项仍会被预打开
+    const int index = nextIndexOf(currentIndex(), count(), m_options.loop);
+    if (index < 0) {
+        return;
+    }
+    m_prerollStarted = true;
+
+    m_prerollCancel.store(false);
+    TaskScheduler::instance().submit(TaskScheduler::Priority::Interactive,
+                                     [this, index, items = m_items, options = m_options] {
+        std::unique_ptr<PreparedItem> item = prepare(index, items, options);
+        const int preparedIndex = item ? item->index : -1;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_prepared = std::move(item);
+        }
+        if (preparedIndex >= 0) {
+            emit prerollReady(preparedIndex);
+        }
+    }, &m_preroll);
+}
+
+void PlaylistEngine::cancelPreroll()
+{
+    m_prerollCancel.store(true);
+    m_preroll.wait();
+    m_prerollCancel.store(false);
+    m_prerollStarted = false;
+    m_prerollBytes.store(0);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_prepared.reset();
+}
+
+/**
+ * @brief 打开并预解码指定项（在预打开任务中执行）
+ * 打开失败的项会被跳过，依次尝试后续项。
+ */
+std::unique_ptr<PlaylistEngine::PreparedItem> PlaylistEngine::prepare(int index, const QStringList& items,
+                                                                       const Options& options)
+{
+    const int total = static_cast<int>(items.size());
+    auto item = std::make_unique<PreparedItem>();
+
+    for (int attempt = 0; attempt < total && index >= 0 && !m_prerollCancel.load(); ++attempt) {
+        QString errorMessage;
+        item->source = MediaSource::open(items[index], options.sourceOptions, &errorMessage);
+        if (item->source) {
+            item->index = index;
+            break;
+        }
+        emit error(errorMessage);
+        index = nextIndexOf(index, total, options.loop);
+    }
+    if (!item->source) {
+        return nullptr;
+    }
+
+    // 预解码开头的帧，使解码器在衔接前已经“热”起来；交叉淡化要混入的整段音频
+    // 也在这里解码好，读取线程在衔接处只混合已解码的帧
+    const int64_t target = std::max(options.prerollDuration, options.crossfade) * 1000;
+    int64_t lastEnd = AV_NOPTS_VALUE;
+    while (!m_prerollCancel.load() && item->bytes < options.prerollMemoryLimit) {
+        if (!item->decodeOne()) {
+            break;
+        }
+        const QueuedFrame& last = item->frames.back();
+        if ((last.type == AVMEDIA_TYPE_AUDIO || !item->source->audioStream()) && last.frame->pts != AV_NOPTS_VALUE) {
+            const int64_t duration = last.type == AVMEDIA_TYPE_AUDIO && last.frame->sample_rate > 0
+                ? av_rescale(last.frame->nb_samples, AV_TIME_BASE, last.frame->sample_rate)
+                : toMicros(last.frame->duration, last.frame->time_base);
+            lastEnd = toMicros(last.frame->pts, last.frame->time_base) + duration;
+        }
+        m_prerollBytes.store(item->bytes, std::memory_order_relaxed);
+        if (item->firstPts != AV_NOPTS_VALUE && lastEnd != AV_NOPTS_VALUE && lastEnd - item->firstPts >= target) {
+            break;
+        }
+    }
+    if (options.crossfade > 0 && item->bytes >= options.prerollMemoryLimit
+        && (lastEnd == AV_NOPTS_VALUE || lastEnd - item->firstPts < options.crossfade * 1000)) {
+        qWarning() << "PlaylistEngine: Preroll memory limit reached before the crossfade was fully decoded,"
+                   << "the remainder of the fade will be a fade-out only.";
+    }
+
+    qDebug() << "PlaylistEngine: Prerolled item" << item->index << "with" << item->frames.size()
+             << "frames," << item->bytes << "bytes";
+    return item;
+}
+
+/**
+ * @brief 取出预打开任务的产出
+ * @param wait 是否等待预打开完成
+ */
+std::unique_ptr<PlaylistEngine::PreparedItem> PlaylistEngine::takePrepared(bool wait)
+{
+    if (!m_prerollStarted) {
+        return nullptr;
+    }
+
+    if (!wait) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_prepared) {
+            return nullptr;
+        }
+    }
+
+    m_preroll.wait();
+    m_prerollStarted = false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::move(m_prepared);
+}
+
+/**
+ * @brief 切换到下一项
+ * @return 成功返回 true；列表结束或下一项不可用返回 false
+ */
+bool PlaylistEngine::advance()
+{
+    if (!m_pending) {
+        m_pending = takePrepared(false);
+    }
+    if (!m_pending) {
+        // 当前项时长未知（或比预打开窗口还短）时，只能在结尾同步等待
+        if (!m_prerollStarted) {
+            startPreroll();
+        }
+        m_pending = takePrepared(true);
+    }
+    if (!m_pending) {
+        return false;
+    }
+
+    // 衔接点为已输出音频的最后一个样本之后；交叉淡化中已混入的样本需要前移
+    int64_t boundary = m_audioEnd != AV_NOPTS_VALUE ? m_audioEnd : m_videoEnd;
+    if (boundary == AV_NOPTS_VALUE) {
+        boundary = 0;
+    }
+    const AVStream* audioStream = m_pending->source->audioStream();
+    const int sampleRate = audioStream ? audioStream->codecpar->sample_rate : 0;
+    const int64_t consumed = sampleRate > 0 ? av_rescale(m_pending->audioConsumed, AV_TIME_BASE, sampleRate) : 0;
+    trimConsumedAudio(*m_pending);
+
+    activate(std::move(m_pending), boundary - consumed);
+    m_prerollBytes.store(0);
+    return true;
+}
+
+void PlaylistEngine::activate(std::unique_ptr<PreparedItem> item, int64_t timelineStart)
+{
+    if (item->source) {
+        item->active = m_sourceHandler ? m_sourceHandler(std::move(item->source)) : item->source.get();
+    }
+    MediaSource* source = item->active;
+    const int64_t first = item->firstPts != AV_NOPTS_VALUE ? item->firstPts : source->startTime();
+    m_offset = timelineStart - first;
+    m_currentEnd = source->duration() > 0
+        ? source->startTime() + source->duration() * 1000 + m_offset
+        : AV_NOPTS_VALUE;
+
+    m_current = std::move(item);
+    qDebug() << "PlaylistEngine: Switched to item" << m_current->index << source->uri();
+    emit currentItemChanged(m_current->index, source->uri(), source->duration());
+}
+
+/**
+ * @brief 在当前项结尾混入下一项开头的音频（等功率交叉淡化）
+ * @param frame 当前项的音频帧，时间戳已位于时间线上
+ * @note 只使用预打开任务已解码的帧，不在读取线程中解码；预解码的音频不足时
+ *       剩余部分只做淡出，未混入的样本在衔接点之后照常播放
+ */
+void PlaylistEngine::mixCrossfade(AVFrame* frame)
+{
+    if (!m_pending) {
+        m_pending = takePrepared(false);
+    }
+    if (!m_pending || m_currentEnd == AV_NOPTS_VALUE) {
+        return;
+    }
+
+    const int64_t fade = m_options.crossfade * 1000;
+    const int64_t zoneStart = m_currentEnd - fade;
+    if (frame->pts + frame->duration <= zoneStart) {
+        return;
+    }
+
+    // 找到下一项的首个音频帧以确认格式一致
+    PreparedItem& next = *m_pending;
+    auto firstAudio = [&next]() -> const AVFrame* {
+        for (const QueuedFrame& queued : next.frames) {
+            if (queued.type == AVMEDIA_TYPE_AUDIO) {
+                return queued.frame;
+            }
+        }
+        return nullptr;
+    };
+    const AVFrame* reference = firstAudio();
+    if (!reference) {
+        return;
+    }
+    if (!isCompatible(frame, reference)) {
+        if (!m_crossfadeWarned) {
+            qWarning() << "PlaylistEngine: Audio formats differ between items, crossfade disabled.";
+            m_crossfadeWarned = true;
+        }
+        return;
+    }
+    if (av_frame_make_writable(frame) < 0) {
+        return;
+    }
+
+    // 跳过已经混入的样本，定位读取游标
+    std::size_t cursor = 0;
+    int offset = 0;
+    int64_t skip = next.audioConsumed;
+    for (; cursor < next.frames.size(); ++cursor) {
+        if (next.frames[cursor].type != AVMEDIA_TYPE_AUDIO) {
+            continue;
+        }
+        if (skip < next.frames[cursor].frame->nb_samples) {
+            offset = static_cast<int>(skip);
+            break;
+        }
+        skip -= next.frames[cursor].frame->nb_samples;
+    }
+
+    const int channels = frame->ch_layout.nb_channels;
+    const int startSample = frame->pts >= zoneStart
+        ? 0 : static_cast<int>(av_rescale(zoneStart - frame->pts, frame->sample_rate, AV_TIME_BASE));
+
+    for (int i = startSample; i < frame->nb_samples; ++i) {
+        // 找到下一个已解码的音频样本
+        while (cursor < next.frames.size()
+               && (next.frames[cursor].type != AVMEDIA_TYPE_AUDIO || offset >= next.frames[cursor].frame->nb_samples)) {
+            ++cursor;
+            offset = 0;
+        }
+        const AVFrame* incoming = cursor < next.frames.size() ? next.frames[cursor].frame : nullptr;
+
+        const int64_t t = frame->pts + av_rescale(i, AV_TIME_BASE, frame->sample_rate);
+        const double progress = std::clamp(static_cast<double>(t - zoneStart) / fade, 0.0, 1.0);
+        const float gainOut = static_cast<float>(std::cos(progress * kHalfPi));
+        const float gainIn = static_cast<float>(std::sin(progress * kHalfPi));
+
+        for (int ch = 0; ch < channels; ++ch) {
+            const float in = incoming ? sampleAt(incoming, ch, offset) : 0.0f;
+            setSample(frame, ch, i, sampleAt(frame, ch, i) * gainOut + in * gainIn);
+        }
+        if (incoming) {
+            ++offset;
+            ++next.audioConsumed;
+        }
+    }
+}
+
+/**
+ * @brief 从下一项的预解码队列中移除已在交叉淡化中混入的音频样本
+ */
+void PlaylistEngine::trimConsumedAudio(PreparedItem& item)
+{
+    int64_t consumed = item.audioConsumed;
+    for (std::size_t i = 0; i < item.frames.size() && consumed > 0;) {
+        QueuedFrame& queued = item.frames[i];
+        if (queued.type != AVMEDIA_TYPE_AUDIO) {
+            ++i;
+            continue;
+        }
+        if (consumed >= queued.frame->nb_samples) {
+            consumed -= queued.frame->nb_samples;
+            av_frame_free(&queued.frame);
+            item.frames.erase(item.frames.begin() + static_cast<std::ptrdiff_t>(i));
+            continue;
+        }
+        AVFrame* trimmed = detail::trimFront(queued.frame, static_cast<int>(consumed));
+        if (trimmed) {
+            av_frame_free(&queued.frame);
+            queued.frame = trimmed;
+        }
+        consumed = 0;
+    }
+    item.audioConsumed = 0;
+}
+
+} // namespace core
+} // namespace aurorastream
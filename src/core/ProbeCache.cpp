@@ -0,0 +1,579 @@
+/********************************************************************************
+ * @file   : ProbeCache.cpp
+ * @brief  : 实现了 aurorastream::core::ProbeCache 类。
+ *
+ * 每个缓存条目保存为一个小的二进制文件，文件名为 (路径, 大小, 修改时间) 的 SHA-1。
+ * 文件被修改后键随之变化，旧条目自然失效；写入时先写临时文件再重命名，
+ * 多个进程并发写同一条目也不会读到半个文件。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/ProbeCache.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QDebug>
+#include <QtCore/QFileInfo>
+#include <QtCore/QDateTime>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QCryptographicHash>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+extern "C" {
+#include <libavutil/mem.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/channel_layout.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x43505341;    // "ASPC"
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kLoudnessMagic = 0x4C505341;    // "ASPL"
+constexpr uint32_t kMaxStreams = 1024;
+constexpr uint32_t kMaxBlobSize = 64 * 1024 * 1024;
+
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::ostream& out) : m_out(out) {}
+
+    template <typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "POD only");
+        m_out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void putBlob(const void* data, std::size_t size) {
+        put(static_cast<uint32_t>(size));
+        if (size > 0) {
+            m_out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        }
+    }
+
+    bool ok() const { return static_cast<bool>(m_out); }
+
+private:
+    std::ostream& m_out;
+};
+
+class BinaryReader {
+public:
+    explicit BinaryReader(std::istream& in) : m_in(in) {}
+
+    template <typename T>
+    T get() {
+        static_assert(std::is_trivially_copyable<T>::value, "POD only");
+        T value {};
+        m_in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return value;
+    }
+
+    template <typename Container>
+    void getBlob(Container& blob) {
+        const uint32_t size = get<uint32_t>();
+        if (!m_in || size > kMaxBlobSize) {
+            m_in.setstate(std::ios::failbit);
+            return;
+        }
+        blob.resize(size);
+        if (size > 0) {
+            m_in.read(reinterpret_cast<char*>(&blob[0]), size);
+        }
+    }
+
+    bool ok() const { return static_cast<bool>(m_in); }
+
+private:
+    std::istream& m_in;
+};
+
+} // namespace
+
+/**
+ * @brief 获取进程内共享的探测缓存
+ * @return 缓存实例
+ */
+ProbeCache& ProbeCache::instance()
+{
+    static ProbeCache instance([] {
+        QString base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        if (base.isEmpty()) {
+            base = QDir::tempPath() + "/aurorastream";
+        }
+        return (base + "/probe").toStdString();
+    }());
+    return instance;
+}
+
+ProbeCache::ProbeCache(const std::string& directory)
+    : m_directory(directory)
+{
+    if (!QDir().mkpath(QString::fromStdString(m_directory))) {
+        qWarning() << "ProbeCache: Could not create cache directory:" << QString::fromStdString(m_directory);
+    }
+}
+
+std::string ProbeCache::directory() const
+{
+    return m_directory;
+}
+
+ProbeCache::Statistics ProbeCache::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    return m_stats;
+}
+
+/**
+ * @brief 计算缓存键
+ * @param path 媒体文件路径
+ * @return 键；文件不存在时返回空字符串
+ */
+std::string ProbeCache::keyFor(const std::string& path) const
+{
+    QFileInfo info(QString::fromStdString(path));
+    if (!info.isFile()) {
+        return std::string();
+    }
+
+    const QString identity = QString("%1|%2|%3")
+        .arg(info.absoluteFilePath())
+        .arg(info.size())
+        .arg(info.lastModified().toMSecsSinceEpoch());
+    return QCryptographicHash::hash(identity.toUtf8(), QCryptographicHash::Sha1).toHex().toStdString();
+}
+
+std::string ProbeCache::fileFor(const std::string& key) const
+{
+    return m_directory + "/" + key + ".probe";
+}
+
+bool ProbeCache::restore(const std::string& path, AVFormatContext* formatContext)
+{
+    if (!formatContext || !formatContext->iformat) {
+        return false;
+    }
+
+    const std::string key = keyFor(path);
+    std::shared_ptr<const Entry> entry = key.empty() ? nullptr : load(key);
+
+    bool restored = entry
+        && entry->formatName == formatContext->iformat->name
+        && apply(*entry, formatContext);
+
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    if (restored) {
+        m_stats.hits++;
+    } else {
+        m_stats.misses++;
+    }
+    return restored;
+}
+
+void ProbeCache::store(const std::string& path, const AVFormatContext* formatContext)
+{
+    if (!formatContext || !formatContext->iformat) {
+        return;
+    }
+
+    const std::string key = keyFor(path);
+    if (key.empty()) {
+        return;
+    }
+
+    auto entry = std::make_shared<Entry>();
+    entry->formatName = formatContext->iformat->name;
+    entry->startTime = formatContext->start_time;
+    entry->duration = formatContext->duration;
+    entry->bitRate = formatContext->bit_rate;
+    entry->streams.reserve(formatContext->nb_streams);
+
+    for (unsigned int i = 0; i < formatContext->nb_streams; ++i) {
+        const AVStream* stream = formatContext->streams[i];
+        const AVCodecParameters* par = stream->codecpar;
+        StreamEntry s;
+        s.id = stream->id;
+        s.timeBase = stream->time_base;
+        s.avgFrameRate = stream->avg_frame_rate;
+        s.realFrameRate = stream->r_frame_rate;
+        s.sampleAspectRatio = stream->sample_aspect_ratio;
+        s.startTime = stream->start_time;
+        s.duration = stream->duration;
+        s.frameCount = stream->nb_frames;
+        s.disposition = stream->disposition;
+
+        s.codecType = par->codec_type;
+        s.codecId = par->codec_id;
+        s.codecTag = par->codec_tag;
+        if (par->extradata && par->extradata_size > 0) {
+            s.extradata.assign(par->extradata, par->extradata + par->extradata_size);
+        }
+        s.format = par->format;
+        s.bitRate = par->bit_rate;
+        s.bitsPerCodedSample = par->bits_per_coded_sample;
+        s.bitsPerRawSample = par->bits_per_raw_sample;
+        s.profile = par->profile;
+        s.level = par->level;
+        s.width = par->width;
+        s.height = par->height;
+        s.codecSampleAspectRatio = par->sample_aspect_ratio;
+        s.framerate = par->framerate;
+        s.fieldOrder = par->field_order;
+        s.colorRange = par->color_range;
+        s.colorPrimaries = par->color_primaries;
+        s.colorTrc = par->color_trc;
+        s.colorSpace = par->color_space;
+        s.chromaLocation = par->chroma_location;
+        s.videoDelay = par->video_delay;
+        // 自定义声道映射无法用掩码表达，仅保留声道数
+        s.channelOrder = par->ch_layout.order == AV_CHANNEL_ORDER_CUSTOM
+            ? AV_CHANNEL_ORDER_UNSPEC : par->ch_layout.order;
+        s.channels = par->ch_layout.nb_channels;
+        s.channelMask = s.channelOrder == AV_CHANNEL_ORDER_UNSPEC ? 0 : par->ch_layout.u.mask;
+        s.sampleRate = par->sample_rate;
+        s.blockAlign = par->block_align;
+        s.frameSize = par->frame_size;
+        s.initialPadding = par->initial_padding;
+        s.trailingPadding = par->trailing_padding;
+        s.seekPreroll = par->seek_preroll;
+        entry->streams.push_back(std::move(s));
+    }
+
+    const std::string file = fileFor(key);
+    const std::string temp = file + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        BinaryWriter writer(out);
+        writer.put(kMagic);
+        writer.put(kVersion);
+        writer.putBlob(entry->formatName.data(), entry->formatName.size());
+        writer.put(entry->startTime);
+        writer.put(entry->duration);
+        writer.put(entry->bitRate);
+        writer.put(static_cast<uint32_t>(entry->streams.size()));
+        for (const StreamEntry& s : entry->streams) {
+            writer.put(s.id);
+            writer.put(s.timeBase);
+            writer.put(s.avgFrameRate);
+            writer.put(s.realFrameRate);
+            writer.put(s.sampleAspectRatio);
+            writer.put(s.startTime);
+            writer.put(s.duration);
+            writer.put(s.frameCount);
+            writer.put(s.disposition);
+            writer.put(s.codecType);
+            writer.put(s.codecId);
+            writer.put(s.codecTag);
+            writer.putBlob(s.extradata.data(), s.extradata.size());
+            writer.put(s.format);
+            writer.put(s.bitRate);
+            writer.put(s.bitsPerCodedSample);
+            writer.put(s.bitsPerRawSample);
+            writer.put(s.profile);
+            writer.put(s.level);
+            writer.put(s.width);
+            writer.put(s.height);
+            writer.put(s.codecSampleAspectRatio);
+            writer.put(s.framerate);
+            writer.put(s.fieldOrder);
+            writer.put(s.colorRange);
+            writer.put(s.colorPrimaries);
+            writer.put(s.colorTrc);
+            writer.put(s.colorSpace);
+            writer.put(s.chromaLocation);
+            writer.put(s.videoDelay);
+            writer.put(s.channelOrder);
+            writer.put(s.channels);
+            writer.put(s.channelMask);
+            writer.put(s.sampleRate);
+            writer.put(s.blockAlign);
+            writer.put(s.frameSize);
+            writer.put(s.initialPadding);
+            writer.put(s.trailingPadding);
+            writer.put(s.seekPreroll);
+        }
+        if (!writer.ok()) {
+            qWarning() << "ProbeCache: Could not write cache entry:" << QString::fromStdString(temp);
+            std::remove(temp.c_str());
+            return;
+        }
+    }
+
+    if (std::rename(temp.c_str(), file.c_str()) != 0) {
+        std::remove(temp.c_str());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    m_entries[key] = std::move(entry);
+    m_stats.stores++;
+}
+
+/**
+ * @brief 保存不在媒体库中的文件的响度分析结果
+ * 与探测结果分开存放（.loudness），不要求已有探测条目；键相同，文件变化后自然失效。
+ */
+void ProbeCache::storeLoudness(const std::string& path, double loudness, double truePeak)
+{
+    const std::string key = keyFor(path);
+    if (key.empty()) {
+        return;
+    }
+
+    const std::string file = m_directory + "/" + key + ".loudness";
+    const std::string temp = file + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        BinaryWriter writer(out);
+        writer.put(kLoudnessMagic);
+        writer.put(loudness);
+        writer.put(truePeak);
+        if (!writer.ok()) {
+            qWarning() << "ProbeCache: Could not write loudness entry:" << QString::fromStdString(temp);
+            std::remove(temp.c_str());
+            return;
+        }
+    }
+    if (std::rename(temp.c_str(), file.c_str()) != 0) {
+        std::remove(temp.c_str());
+    }
+}
+
+bool ProbeCache::loudness(const std::string& path, double* loudness, double* truePeak) const
+{
+    const std::string key = keyFor(path);
+    if (key.empty()) {
+        return false;
+    }
+
+    std::ifstream in(m_directory + "/" + key + ".loudness", std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    BinaryReader reader(in);
+    if (reader.get<uint32_t>() != kLoudnessMagic) {
+        return false;
+    }
+    const double integrated = reader.get<double>();
+    const double peak = reader.get<double>();
+    if (!reader.ok()) {
+        return false;
+    }
+    if (loudness) {
+        *loudness = integrated;
+    }
+    if (truePeak) {
+        *truePeak = peak;
+    }
+    return true;
+}
+
+void ProbeCache::remove(const std::string& path)
+{
+    const std::string key = keyFor(path);
+    if (key.empty()) {
+        return;
+    }
+
+    std::remove(fileFor(key).c_str());
+    std::remove((m_directory + "/" + key + ".loudness").c_str());
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    m_entries.erase(key);
+}
+
+/**
+ * @brief 从内存或磁盘加载缓存条目
+ * @param key 缓存键
+ * @return 条目；不存在或文件损坏时返回 nullptr
+ */
+std::shared_ptr<const ProbeCache::Entry> ProbeCache::load(const std::string& key)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        auto it = m_entries.find(key);
+        if (it != m_entries.end()) {
+            return it->second;
+        }
+    }
+
+    std::ifstream in(fileFor(key), std::ios::binary);
+    if (!in) {
+        return nullptr;
+    }
+
+    BinaryReader reader(in);
+    if (reader.get<uint32_t>() != kMagic || reader.get<uint32_t>() != kVersion) {
+        return nullptr;
+    }
+
+    auto entry = std::make_shared<Entry>();
+    reader.getBlob(entry->formatName);
+    entry->startTime = reader.get<int64_t>();
+    entry->duration = reader.get<int64_t>();
+    entry->bitRate = reader.get<int64_t>();
+    const uint32_t streamCount = reader.get<uint32_t>();
+    if (!reader.ok() || streamCount > kMaxStreams) {
+        return nullptr;
+    }
+
+    entry->streams.resize(streamCount);
+    for (StreamEntry& s : entry->streams) {
+        s.id = reader.get<int>();
+        s.timeBase = reader.get<AVRational>();
+        s.avgFrameRate = reader.get<AVRational>();
+        s.realFrameRate = reader.get<AVRational>();
+        s.sampleAspectRatio = reader.get<AVRational>();
+        s.startTime = reader.get<int64_t>();
+        s.duration = reader.get<int64_t>();
+        s.frameCount = reader.get<int64_t>();
+        s.disposition = reader.get<int>();
+        s.codecType = reader.get<int>();
+        s.codecId = reader.get<int>();
+        s.codecTag = reader.get<uint32_t>();
+        reader.getBlob(s.extradata);
+        s.format = reader.get<int>();
+        s.bitRate = reader.get<int64_t>();
+        s.bitsPerCodedSample = reader.get<int>();
+        s.bitsPerRawSample = reader.get<int>();
+        s.profile = reader.get<int>();
+        s.level = reader.get<int>();
+        s.width = reader.get<int>();
+        s.height = reader.get<int>();
+        s.codecSampleAspectRatio = reader.get<AVRational>();
+        s.framerate = reader.get<AVRational>();
+        s.fieldOrder = reader.get<int>();
+        s.colorRange = reader.get<int>();
+        s.colorPrimaries = reader.get<int>();
+        s.colorTrc = reader.get<int>();
+        s.colorSpace = reader.get<int>();
+        s.chromaLocation = reader.get<int>();
+        s.videoDelay = reader.get<int>();
+        s.channelOrder = reader.get<int>();
+        s.channels = reader.get<int>();
+        s.channelMask = reader.get<uint64_t>();
+        s.sampleRate = reader.get<int>();
+        s.blockAlign = reader.get<int>();
+        s.frameSize = reader.get<int>();
+        s.initialPadding = reader.get<int>();
+        s.trailingPadding = reader.get<int>();
+        s.seekPreroll = reader.get<int>();
+    }
+    if (!reader.ok()) {
+        qWarning() << "ProbeCache: Corrupted cache entry ignored:" << QString::fromStdString(key);
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    m_entries[key] = entry;
+    return entry;
+}
+
+/**
+ * @brief 把缓存条目写回格式上下文
+ * 只有当文件头解析出的流布局与缓存一致时才会覆盖，否则视为未命中，
+ * 交由 avformat_find_stream_info 完整探测。
+ */
+bool ProbeCache::apply(const Entry& entry, AVFormatContext* formatContext)
+{
+    if (formatContext->nb_streams != entry.streams.size()) {
+        return false;
+    }
+
+    for (unsigned int i = 0; i < formatContext->nb_streams; ++i) {
+        const AVCodecParameters* par = formatContext->streams[i]->codecpar;
+        const StreamEntry& s = entry.streams[i];
+        if (par->codec_type != AVMEDIA_TYPE_UNKNOWN && par->codec_type != s.codecType) {
+            return false;
+        }
+        if (par->codec_id != AV_CODEC_ID_NONE && par->codec_id != s.codecId) {
+            return false;
+        }
+    }
+
+    // 先分配所有的 extradata，全部成功后才开始改写，避免分配失败时留下改了一半的上下文
+    std::vector<uint8_t*> extradata(formatContext->nb_streams, nullptr);
+    for (unsigned int i = 0; i < formatContext->nb_streams; ++i) {
+        const std::vector<uint8_t>& blob = entry.streams[i].extradata;
+        if (blob.empty()) {
+            continue;
+        }
+        extradata[i] = static_cast<uint8_t*>(av_mallocz(blob.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+        if (!extradata[i]) {
+            for (uint8_t*& data : extradata) {
+                av_freep(&data);
+            }
+            return false;
+        }
+        std::memcpy(extradata[i], blob.data(), blob.size());
+    }
+
+    for (unsigned int i = 0; i < formatContext->nb_streams; ++i) {
+        AVStream* stream = formatContext->streams[i];
+        AVCodecParameters* par = stream->codecpar;
+        const StreamEntry& s = entry.streams[i];
+
+        stream->id = s.id;
+        stream->time_base = s.timeBase;
+        stream->avg_frame_rate = s.avgFrameRate;
+        stream->r_frame_rate = s.realFrameRate;
+        stream->sample_aspect_ratio = s.sampleAspectRatio;
+        stream->start_time = s.startTime;
+        stream->duration = s.duration;
+        stream->nb_frames = s.frameCount;
+        stream->disposition = s.disposition;
+
+        par->codec_type = static_cast<AVMediaType>(s.codecType);
+        par->codec_id = static_cast<AVCodecID>(s.codecId);
+        par->codec_tag = s.codecTag;
+
+        av_freep(&par->extradata);
+        par->extradata = extradata[i];
+        par->extradata_size = static_cast<int>(s.extradata.size());
+
+        par->format = s.format;
+        par->bit_rate = s.bitRate;
+        par->bits_per_coded_sample = s.bitsPerCodedSample;
+        par->bits_per_raw_sample = s.bitsPerRawSample;
+        par->profile = s.profile;
+        par->level = s.level;
+        par->width = s.width;
+        par->height = s.height;
+        par->sample_aspect_ratio = s.codecSampleAspectRatio;
+        par->framerate = s.framerate;
+        par->field_order = static_cast<AVFieldOrder>(s.fieldOrder);
+        par->color_range = static_cast<AVColorRange>(s.colorRange);
+        par->color_primaries = static_cast<AVColorPrimaries>(s.colorPrimaries);
+        par->color_trc = static_cast<AVColorTransferCharacteristic>(s.colorTrc);
+        par->color_space = static_cast<AVColorSpace>(s.colorSpace);
+        par->chroma_location = static_cast<AVChromaLocation>(s.chromaLocation);
+        par->video_delay = s.videoDelay;
+
+        av_channel_layout_uninit(&par->ch_layout);
+        par->ch_layout.order = static_cast<AVChannelOrder>(s.channelOrder);
+        par->ch_layout.nb_channels = s.channels;
+        par->ch_layout.u.mask = s.channelMask;
+
+        par->sample_rate = s.sampleRate;
+        par->block_align = s.blockAlign;
+        par->frame_size = s.frameSize;
+        par->initial_padding = s.initialPadding;
+        par->trailing_padding = s.trailingPadding;
+        par->seek_preroll = s.seekPreroll;
+    }
+
+    formatContext->start_time = entry.startTime;
+    formatContext->duration = entry.duration;
+    formatContext->bit_rate = entry.bitRate;
+    return true;
+}
+
+} // namespace core
+} // namespace aurorastream
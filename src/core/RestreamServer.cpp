@@ -0,0 +1,984 @@
+/********************************************************************************
+ * @file   : RestreamServer.cpp
+ * @brief  : 实现了 aurorastream::core::RestreamServer 类。
+ *
+ * 封装线程：每个数据包写入 MPEG-TS 封装器后立即取出封装器的输出，作为一个
+ * 引用计数的数据块追加到当前分段，并经 MpscQueue 发布给服务线程；切分分段时
+ * 先刷新封装器内部缓冲，再让封装器在新分段开头重新写出 PAT/PMT。
+ *
+ * 服务线程：水平触发的 epoll 事件循环。所有连接都以
+ * Connection: close 响应；HLS 请求发完即关闭，直连客户端持续接收新的数据块。
+ * 客户端积压的是数据块的引用，不是数据副本。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/RestreamServer.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+#include "aurorastream/utils/Tracer.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QDebug>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <csignal>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+extern "C" {
+#include <libavutil/opt.h>
+#include <libavutil/mem.h>
+#include <libavutil/mathematics.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+constexpr int kIoBufferSize = 64 * 1024;        ///< 封装器 I/O 缓冲区大小
+constexpr std::size_t kMaxRequestSize = 8192;   ///< 请求头的最大长度
+constexpr int kMaxIovecs = 64;                  ///< 单次 sendmsg 聚集的数据块数
+constexpr int kExtraSegments = 2;               ///< 移出播放列表后再保留的分段数，供刚取到旧播放列表的客户端下载
+
+std::string jsonEscape(const std::string& text)
+{
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+/**
+ * @brief 一个 HTTP 连接
+ * 发送队列中每一项是共享的数据块，或者一个落盘分段的文件区间（用 sendfile 发送）
+ */
+struct RestreamServer::Client {
+    struct Item {
+        std::shared_ptr<const Chunk> chunk;
+        int file = -1;
+        int64_t fileOffset = 0;
+        int64_t fileEnd = 0;
+    };
+
+    ~Client()
+    {
+#if defined(__linux__)
+        for (const Item& item : queue) {
+            if (item.file >= 0) {
+                ::close(item.file);
+            }
+        }
+#endif
+    }
+
+    int fd = -1;
+    int id = 0;
+    std::string address;
+    std::string request;
+    std::string path;
+    bool responded = false;
+    bool live = false;
+    bool wantWrite = false;
+    std::deque<Item> queue;
+    std::size_t offset = 0;                     ///< 队首数据块已发送的字节数
+    std::size_t queuedBytes = 0;
+    uint64_t bytesSent = 0;
+    double lagSeconds = 0.0;
+};
+
+RestreamServer::RestreamServer(const Options& options)
+    : PacketTap("restream", options.limits)
+    , m_options(options)
+{
+}
+
+RestreamServer::~RestreamServer()
+{
+    // 封装线程和服务线程都会访问本类的成员，必须在成员析构之前退出
+    stop();
+    wait();
+    m_serverStopping = true;
+    wakeServer();
+    if (m_server.joinable()) {
+        m_server.join();
+    }
+#if defined(__linux__)
+    m_clients.clear();
+    for (int fd : {m_listenFd, m_epollFd, m_wakeFd}) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+#endif
+    Publication publication;
+    while (m_publications.pop(publication)) {
+    }
+    for (AVCodecParameters* parameters : m_parameters) {
+        avcodec_parameters_free(&parameters);
+    }
+}
+
+std::unique_ptr<RestreamServer> RestreamServer::create(const AVFormatContext* input, const Options& options,
+                                                       QString* errorMessage)
+{
+    auto fail = [errorMessage](const QString& message) {
+        qWarning() << message;
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        return nullptr;
+    };
+
+#if !defined(__linux__)
+    Q_UNUSED(input);
+    Q_UNUSED(options);
+    return fail("RestreamServer::create() failed. Restreaming is only supported on Linux.");
+#else
+    if (!input) {
+        return fail("RestreamServer::create() failed. No input.");
+    }
+    const AVOutputFormat* format = av_guess_format("mpegts", nullptr, nullptr);
+    if (!format) {
+        return fail("RestreamServer::create() failed. MPEG-TS muxer is not available.");
+    }
+
+    std::unique_ptr<RestreamServer> server(new RestreamServer(options));
+    for (unsigned i = 0; i < input->nb_streams; ++i) {
+        const AVStream* stream = input->streams[i];
+        const AVMediaType type = stream->codecpar->codec_type;
+        if ((type != AVMEDIA_TYPE_VIDEO && type != AVMEDIA_TYPE_AUDIO)
+            || (stream->disposition & AV_DISPOSITION_ATTACHED_PIC)
+            || avformat_query_codec(format, stream->codecpar->codec_id, FF_COMPLIANCE_NORMAL) == 0) {
+            continue;
+        }
+        AVCodecParameters* parameters = avcodec_parameters_alloc();
+        if (!parameters || avcodec_parameters_copy(parameters, stream->codecpar) < 0) {
+            avcodec_parameters_free(&parameters);
+            return fail("RestreamServer::create() failed. Could not copy codec parameters.");
+        }
+        parameters->codec_tag = 0;
+        server->addStream(static_cast<int>(i), stream->time_base, type == AVMEDIA_TYPE_VIDEO);
+        server->m_parameters.push_back(parameters);
+    }
+    if (server->m_parameters.empty()) {
+        return fail("RestreamServer::create() failed. No stream can be carried in MPEG-TS.");
+    }
+    if (!options.directory.empty() && !QDir().mkpath(QString::fromStdString(options.directory))) {
+        return fail(QString("RestreamServer::create() failed. Could not create %1")
+                        .arg(QString::fromStdString(options.directory)));
+    }
+
+    QString listenError;
+    if (!server->listen(&listenError)) {
+        return fail(listenError);
+    }
+
+    server->start();
+    server->m_server = std::thread(&RestreamServer::serverLoop, server.get());
+    qDebug() << "RestreamServer: Serving" << server->m_parameters.size() << "streams at" << server->url();
+    return server;
+#endif
+}
+
+int RestreamServer::port() const
+{
+    return m_port;
+}
+
+QString RestreamServer::url() const
+{
+    return QString("http://%1:%2/").arg(QString::fromStdString(m_options.address)).arg(m_port);
+}
+
+std::vector<RestreamServer::ClientStatistics> RestreamServer::getClients() const
+{
+    std::lock_guard<std::mutex> lock(m_clientsMutex);
+    std::vector<ClientStatistics> clients;
+    clients.reserve(m_clients.size());
+    for (const auto& entry : m_clients) {
+        const Client& client = *entry.second;
+        ClientStatistics statistics;
+        statistics.id = client.id;
+        statistics.address = client.address;
+        statistics.path = client.path;
+        statistics.live = client.live;
+        statistics.bytesSent = client.bytesSent;
+        statistics.queuedBytes = client.queuedBytes;
+        statistics.lagSeconds = client.lagSeconds;
+        clients.push_back(statistics);
+    }
+    return clients;
+}
+
+RestreamServer::Statistics RestreamServer::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_clientsMutex);
+    Statistics statistics = m_statistics;
+    statistics.clients = static_cast<int>(m_clients.size());
+    statistics.packetsDropped = droppedPackets();
+    return statistics;
+}
+
+// ---- 封装线程 ----
+
+int RestreamServer::writePacket(void* opaque, const uint8_t* data, int size)
+{
+    RestreamServer* server = static_cast<RestreamServer*>(opaque);
+    server->m_pending.insert(server->m_pending.end(), data, data + size);
+    return size;
+}
+
+bool RestreamServer::openMuxer()
+{
+    AVFormatContext* muxer = nullptr;
+    if (avformat_alloc_output_context2(&muxer, nullptr, "mpegts", nullptr) < 0) {
+        return false;
+    }
+    for (std::size_t i = 0; i < m_parameters.size(); ++i) {
+        AVStream* stream = avformat_new_stream(muxer, nullptr);
+        if (!stream || avcodec_parameters_copy(stream->codecpar, m_parameters[i]) < 0) {
+            avformat_free_context(muxer);
+            return false;
+        }
+        stream->time_base = inputTimeBase(static_cast<int>(i));
+    }
+
+    uint8_t* buffer = static_cast<uint8_t*>(av_malloc(kIoBufferSize));
+    muxer->pb = buffer ? avio_alloc_context(buffer, kIoBufferSize, 1, this, nullptr, &RestreamServer::writePacket,
+                                            nullptr)
+                       : nullptr;
+    if (!muxer->pb) {
+        av_free(buffer);
+        avformat_free_context(muxer);
+        return false;
+    }
+    muxer->flags |= AVFMT_FLAG_CUSTOM_IO;
+
+    if (avformat_write_header(muxer, nullptr) < 0) {
+        av_freep(&muxer->pb->buffer);
+        avio_context_free(&muxer->pb);
+        avformat_free_context(muxer);
+        return false;
+    }
+    m_muxer = muxer;
+    return true;
+}
+
+void RestreamServer::closeMuxer()
+{
+    if (!m_muxer) {
+        return;
+    }
+    av_write_trailer(m_muxer);
+    av_freep(&m_muxer->pb->buffer);
+    avio_context_free(&m_muxer->pb);
+    avformat_free_context(m_muxer);
+    m_muxer = nullptr;
+    m_pending.clear();
+}
+
+/**
+ * @brief 把封装器已写出的数据作为一个数据块发布
+ */
+void RestreamServer::flushChunk(int64_t time)
+{
+    avio_flush(m_muxer->pb);
+    if (m_pending.empty() || !m_current) {
+        return;
+    }
+    auto chunk = std::make_shared<Chunk>();
+    chunk->data.swap(m_pending);
+    chunk->time = time;
+    m_current->bytes += chunk->data.size();
+    m_current->chunks.push_back(chunk);
+
+    Publication publication;
+    publication.chunk = std::move(chunk);
+    publication.segmentStart = m_segmentStartPending;
+    m_segmentStartPending = false;
+    m_publications.push(std::move(publication));
+    wakeServer();
+}
+
+/**
+ * @brief 结束当前分段：可选写入磁盘，加入分段窗口并淘汰旧分段
+ */
+void RestreamServer::finishSegment(int64_t endTime)
+{
+    static Counter& segmentCounter = PerformanceMonitor::instance().counter("restream.segments");
+    if (!m_current) {
+        return;
+    }
+    if (endTime != AV_NOPTS_VALUE && endTime > m_current->startTime) {
+        m_current->duration = (endTime - m_current->startTime) / static_cast<double>(AV_TIME_BASE);
+    }
+
+    if (!m_options.directory.empty()) {
+        const std::string file = m_options.directory + "/segment" + std::to_string(m_current->sequence) + ".ts";
+        FILE* output = std::fopen(file.c_str(), "wb");
+        bool ok = output != nullptr;
+        for (std::size_t i = 0; ok && i < m_current->chunks.size(); ++i) {
+            const std::vector<uint8_t>& data = m_current->chunks[i]->data;
+            ok = std::fwrite(data.data(), 1, data.size(), output) == data.size();
+        }
+        if (output) {
+            ok = std::fclose(output) == 0 && ok;
+        }
+        if (ok) {
+            m_current->file = file;
+        } else {
+            qWarning() << "RestreamServer: Could not write" << QString::fromStdString(file);
+            std::remove(file.c_str());
+        }
+    }
+
+    std::vector<std::string> expired;
+    {
+        std::lock_guard<std::mutex> lock(m_segmentsMutex);
+        m_segments.push_back(std::move(m_current));
+        while (static_cast<int>(m_segments.size()) > m_options.playlistSize + kExtraSegments) {
+            if (!m_segments.front()->file.empty()) {
+                expired.push_back(m_segments.front()->file);
+            }
+            m_segments.pop_front();
+        }
+    }
+    // 正在用 sendfile 发送的客户端持有打开的文件描述符，删除不影响它们
+    for (const std::string& file : expired) {
+        std::remove(file.c_str());
+    }
+    m_current.reset();
+    segmentCounter.add();
+    std::lock_guard<std::mutex> lock(m_clientsMutex);
+    ++m_statistics.segments;
+}
+
+void RestreamServer::consume(AVPacket* packet)
+{
+    const AVRational timeBase = inputTimeBase(packet->stream_index);
+    const int64_t timestamp = packet->dts != AV_NOPTS_VALUE ? packet->dts : packet->pts;
+    const int64_t time = timestamp != AV_NOPTS_VALUE ? av_rescale_q(timestamp, timeBase, AV_TIME_BASE_Q)
+                                                     : m_lastTime;
+    const bool boundary = videoStream() < 0
+        || (packet->stream_index == videoStream() && (packet->flags & AV_PKT_FLAG_KEY));
+
+    bool startSegment = false;
+    if (!m_muxer) {
+        if (!boundary || !openMuxer()) {
+            av_packet_free(&packet);
+            return;
+        }
+        startSegment = true;
+    } else if (boundary && m_current && time != AV_NOPTS_VALUE
+               && time - m_current->startTime >= static_cast<int64_t>(m_options.segmentSeconds * AV_TIME_BASE)) {
+        // 先把缓冲在封装器里的数据归入上一个分段，再让新分段以 PAT/PMT 开头
+        av_write_frame(m_muxer, nullptr);
+        flushChunk(m_lastTime);
+        finishSegment(time);
+        av_opt_set(m_muxer->priv_data, "mpegts_flags", "+resend_headers", 0);
+        startSegment = true;
+    }
+    if (startSegment) {
+        m_current = std::make_shared<Segment>();
+        m_current->sequence = m_nextSequence++;
+        m_current->startTime = time != AV_NOPTS_VALUE ? time : 0;
+        m_current->discontinuity = m_discontinuity;
+        m_current->discontinuitySequence = m_discontinuityCount;
+        m_discontinuityCount += m_discontinuity ? 1 : 0;
+        m_discontinuity = false;
+        m_segmentStartPending = true;
+    }
+
+    av_packet_rescale_ts(packet, timeBase, m_muxer->streams[packet->stream_index]->time_base);
+    packet->pos = -1;
+    {
+        AURORASTREAM_TRACE_SCOPE("restream.mux", "restream");
+        av_write_frame(m_muxer, packet);
+    }
+    av_packet_free(&packet);
+    m_lastTime = time;
+    flushChunk(time);
+}
+
+void RestreamServer::discontinuity()
+{
+    if (!m_muxer) {
+        return;
+    }
+    // 时间线跳变后重新开始封装，播放列表中标记 EXT-X-DISCONTINUITY
+    av_write_frame(m_muxer, nullptr);
+    flushChunk(m_lastTime);
+    finishSegment(m_lastTime);
+    closeMuxer();
+    m_discontinuity = true;
+}
+
+void RestreamServer::finish()
+{
+    if (m_muxer) {
+        av_write_frame(m_muxer, nullptr);
+        flushChunk(m_lastTime);
+        finishSegment(m_lastTime);
+        closeMuxer();
+    }
+}
+
+// ---- 服务线程 ----
+
+#if defined(__linux__)
+
+bool RestreamServer::listen(QString* errorMessage)
+{
+    // sendfile 写入已关闭的连接会触发 SIGPIPE；sendmsg 使用 MSG_NOSIGNAL
+    static std::once_flag ignoreSigpipe;
+    std::call_once(ignoreSigpipe, [] { std::signal(SIGPIPE, SIG_IGN); });
+
+    sockaddr_in address {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(m_options.port));
+    if (inet_pton(AF_INET, m_options.address.c_str(), &address.sin_addr) != 1) {
+        *errorMessage = QString("RestreamServer: Invalid address %1").arg(QString::fromStdString(m_options.address));
+        return false;
+    }
+
+    m_listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    const int enable = 1;
+    if (m_listenFd < 0
+        || setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) < 0
+        || ::bind(m_listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0
+        || ::listen(m_listenFd, SOMAXCONN) < 0) {
+        *errorMessage = QString("RestreamServer: Could not listen on %1:%2: %3")
+                            .arg(QString::fromStdString(m_options.address)).arg(m_options.port)
+                            .arg(QString::fromLocal8Bit(std::strerror(errno)));
+        return false;
+    }
+    socklen_t length = sizeof(address);
+    getsockname(m_listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+    m_port = ntohs(address.sin_port);
+
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epollFd < 0 || m_wakeFd < 0) {
+        *errorMessage = "RestreamServer: Could not create epoll instance.";
+        return false;
+    }
+    for (int fd : {m_listenFd, m_wakeFd}) {
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+    return true;
+}
+
+void RestreamServer::wakeServer()
+{
+    if (m_wakeFd >= 0) {
+        const uint64_t one = 1;
+        [[maybe_unused]] ssize_t written = ::write(m_wakeFd, &one, sizeof(one));
+    }
+}
+
+void RestreamServer::serverLoop()
+{
+    constexpr int kMaxEvents = 256;
+    epoll_event events[kMaxEvents];
+    auto lastLagUpdate = std::chrono::steady_clock::now();
+
+    while (!m_serverStopping.load()) {
+        const int count = epoll_wait(m_epollFd, events, kMaxEvents, 1000);
+        if (count < 0 && errno != EINTR) {
+            qWarning() << "RestreamServer: epoll_wait failed:" << std::strerror(errno);
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(m_clientsMutex);
+        for (int i = 0; i < count; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == m_listenFd) {
+                acceptClients();
+                continue;
+            }
+            if (fd == m_wakeFd) {
+                uint64_t value = 0;
+                [[maybe_unused]] ssize_t bytes = ::read(m_wakeFd, &value, sizeof(value));
+                continue;
+            }
+            auto it = m_clients.find(fd);
+            if (it == m_clients.end()) {
+                continue;
+            }
+            Client& client = *it->second;
+            bool keep = !(events[i].events & (EPOLLERR | EPOLLHUP));
+            if (keep && (events[i].events & EPOLLIN)) {
+                keep = readRequest(client);
+            }
+            if (keep && (events[i].events & EPOLLOUT)) {
+                keep = writeClient(client);
+            }
+            if (!keep) {
+                closeClient(fd);
+            }
+        }
+        drainPublications();
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastLagUpdate >= std::chrono::seconds(1)) {
+            lastLagUpdate = now;
+            updateLag();
+        }
+    }
+}
+
+void RestreamServer::acceptClients()
+{
+    static Gauge& clientGauge = PerformanceMonitor::instance().gauge("restream.clients");
+    for (;;) {
+        sockaddr_in address {};
+        socklen_t length = sizeof(address);
+        const int fd = accept4(m_listenFd, reinterpret_cast<sockaddr*>(&address), &length,
+                               SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (static_cast<int>(m_clients.size()) >= m_options.maxClients) {
+            ::close(fd);
+            continue;
+        }
+        const int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+        auto client = std::make_unique<Client>();
+        client->fd = fd;
+        client->id = m_nextClientId++;
+        char text[INET_ADDRSTRLEN] = {0};
+        inet_ntop(AF_INET, &address.sin_addr, text, sizeof(text));
+        client->address = std::string(text) + ":" + std::to_string(ntohs(address.sin_port));
+
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            ::close(fd);
+            continue;
+        }
+        m_clients[fd] = std::move(client);
+    }
+    clientGauge.set(static_cast<int64_t>(m_clients.size()));
+}
+
+/**
+ * @brief 读取请求头，读完整后处理请求
+ * @return 需要关闭连接时返回 false
+ */
+bool RestreamServer::readRequest(Client& client)
+{
+    char buffer[4096];
+    for (;;) {
+        const ssize_t received = ::recv(client.fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            // 已响应后对端发来的数据（例如多余的请求）忽略
+            if (!client.responded) {
+                client.request.append(buffer, static_cast<std::size_t>(received));
+            }
+            continue;
+        }
+        if (received == 0) {
+            return false;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        return false;
+    }
+
+    if (client.responded) {
+        return true;
+    }
+    if (client.request.find("\r\n\r\n") == std::string::npos) {
+        if (client.request.size() > kMaxRequestSize) {
+            sendResponse(client, 431, "Request Header Fields Too Large", "text/plain", "Request too large\n");
+            return writeClient(client);
+        }
+        return true;
+    }
+    return handleRequest(client);
+}
+
+bool RestreamServer::handleRequest(Client& client)
+{
+    static Counter& requestCounter = PerformanceMonitor::instance().counter("restream.requests");
+    requestCounter.add();
+    ++m_statistics.requests;
+    client.responded = true;
+
+    const std::size_t methodEnd = client.request.find(' ');
+    const std::size_t pathEnd = methodEnd == std::string::npos ? std::string::npos
+                                                               : client.request.find(' ', methodEnd + 1);
+    if (pathEnd == std::string::npos) {
+        sendResponse(client, 400, "Bad Request", "text/plain", "Bad request\n");
+        return writeClient(client);
+    }
+    const std::string method = client.request.substr(0, methodEnd);
+    std::string path = client.request.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+    path = path.substr(0, path.find('?'));
+    client.path = path;
+    client.request.clear();
+
+    if (method != "GET") {
+        sendResponse(client, 405, "Method Not Allowed", "text/plain", "Only GET is supported\n");
+    } else if (path == "/" || path == "/live.m3u8") {
+        sendPlaylist(client);
+    } else if (path == "/live.ts") {
+        // 从当前分段的开头（关键帧和 PAT/PMT）开始，之后持续接收新的数据块
+        queueText(client, "HTTP/1.1 200 OK\r\nContent-Type: video/mp2t\r\nCache-Control: no-cache\r\n"
+                          "Connection: close\r\n\r\n");
+        for (const std::shared_ptr<const Chunk>& chunk : m_joinChunks) {
+            client.queue.push_back({chunk});
+            client.queuedBytes += chunk->data.size();
+        }
+        client.live = true;
+    } else if (path == "/clients") {
+        sendClients(client);
+    } else if (path.compare(0, 8, "/segment") == 0 && path.size() > 11
+               && path.compare(path.size() - 3, 3, ".ts") == 0) {
+        char* end = nullptr;
+        const long long sequence = std::strtoll(path.c_str() + 8, &end, 10);
+        if (end == path.c_str() + path.size() - 3) {
+            sendSegment(client, sequence);
+        } else {
+            sendResponse(client, 404, "Not Found", "text/plain", "Not found\n");
+        }
+    } else {
+        sendResponse(client, 404, "Not Found", "text/plain", "Not found\n");
+    }
+    return writeClient(client);
+}
+
+void RestreamServer::sendPlaylist(Client& client)
+{
+    std::vector<std::shared_ptr<const Segment>> segments;
+    {
+        std::lock_guard<std::mutex> lock(m_segmentsMutex);
+        const std::size_t first = m_segments.size() > static_cast<std::size_t>(m_options.playlistSize)
+                                      ? m_segments.size() - m_options.playlistSize
+                                      : 0;
+        segments.assign(m_segments.begin() + static_cast<std::ptrdiff_t>(first), m_segments.end());
+    }
+
+    double targetDuration = m_options.segmentSeconds;
+    for (const std::shared_ptr<const Segment>& segment : segments) {
+        targetDuration = std::max(targetDuration, segment->duration);
+    }
+    std::string playlist = "#EXTM3U\n#EXT-X-VERSION:3\n";
+    playlist += "#EXT-X-TARGETDURATION:" + std::to_string(static_cast<int>(std::ceil(targetDuration))) + "\n";
+    playlist += "#EXT-X-MEDIA-SEQUENCE:" + std::to_string(segments.empty() ? 0 : segments.front()->sequence) + "\n";
+    // 已移出窗口的 EXT-X-DISCONTINUITY 个数，客户端据此对齐窗口内各分段的时间线
+    const int64_t discontinuitySequence = segments.empty() ? 0 : segments.front()->discontinuitySequence;
+    if (discontinuitySequence > 0) {
+        playlist += "#EXT-X-DISCONTINUITY-SEQUENCE:" + std::to_string(discontinuitySequence) + "\n";
+    }
+    char line[64];
+    for (const std::shared_ptr<const Segment>& segment : segments) {
+        if (segment->discontinuity) {
+            playlist += "#EXT-X-DISCONTINUITY\n";
+        }
+        std::snprintf(line, sizeof(line), "#EXTINF:%.3f,\n", segment->duration);
+        playlist += line;
+        playlist += "segment" + std::to_string(segment->sequence) + ".ts\n";
+    }
+    sendResponse(client, 200, "OK", "application/vnd.apple.mpegurl", playlist);
+}
+
+void RestreamServer::sendSegment(Client& client, int64_t sequence)
+{
+    std::shared_ptr<const Segment> segment;
+    {
+        std::lock_guard<std::mutex> lock(m_segmentsMutex);
+        for (const std::shared_ptr<const Segment>& candidate : m_segments) {
+            if (candidate->sequence == sequence) {
+                segment = candidate;
+                break;
+            }
+        }
+    }
+    if (!segment) {
+        sendResponse(client, 404, "Not Found", "text/plain", "Segment expired or not yet available\n");
+        return;
+    }
+    if (m_latestTime != AV_NOPTS_VALUE) {
+        client.lagSeconds = std::max<int64_t>(m_latestTime - segment->startTime, 0) / static_cast<double>(AV_TIME_BASE);
+    }
+
+    const std::string header = "HTTP/1.1 200 OK\r\nContent-Type: video/mp2t\r\nContent-Length: "
+        + std::to_string(segment->bytes) + "\r\nCache-Control: max-age=60\r\nConnection: close\r\n\r\n";
+
+    // 落盘的分段用 sendfile 由内核直接发送；文件打不开时回退到内存中的数据块
+    const int file = segment->file.empty() ? -1 : ::open(segment->file.c_str(), O_RDONLY | O_CLOEXEC);
+    queueText(client, header);
+    if (file >= 0) {
+        Client::Item item;
+        item.file = file;
+        item.fileEnd = static_cast<int64_t>(segment->bytes);
+        client.queue.push_back(item);
+    } else {
+        for (const std::shared_ptr<const Chunk>& chunk : segment->chunks) {
+            client.queue.push_back({chunk});
+        }
+    }
+    client.queuedBytes += segment->bytes;
+}
+
+void RestreamServer::sendClients(Client& client)
+{
+    std::string body = "[";
+    char line[128];
+    bool first = true;
+    for (const auto& entry : m_clients) {
+        const Client& other = *entry.second;
+        if (!first) {
+            body += ",";
+        }
+        first = false;
+        body += "\n{\"id\":" + std::to_string(other.id) + ",\"address\":\"" + jsonEscape(other.address)
+              + "\",\"path\":\"" + jsonEscape(other.path) + "\",\"live\":" + (other.live ? "true" : "false");
+        std::snprintf(line, sizeof(line), ",\"bytes_sent\":%llu,\"queued_bytes\":%zu,\"lag_seconds\":%.3f}",
+                      static_cast<unsigned long long>(other.bytesSent), other.queuedBytes, other.lagSeconds);
+        body += line;
+    }
+    body += "\n]\n";
+    sendResponse(client, 200, "OK", "application/json", body);
+}
+
+void RestreamServer::sendResponse(Client& client, int status, const char* reason, const char* contentType,
+                                  const std::string& body)
+{
+    client.responded = true;
+    std::string response = "HTTP/1.1 " + std::to_string(status) + " " + reason + "\r\nContent-Type: " + contentType
+        + "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nCache-Control: no-cache\r\nConnection: close\r\n\r\n";
+    response += body;
+    queueText(client, response);
+}
+
+void RestreamServer::queueText(Client& client, const std::string& text)
+{
+    auto chunk = std::make_shared<Chunk>();
+    chunk->data.assign(text.begin(), text.end());
+    client.queuedBytes += chunk->data.size();
+    client.queue.push_back({std::move(chunk)});
+}
+
+/**
+ * @brief 尽量写出发送队列：连续的数据块用一次 sendmsg 聚集发送，文件区间用 sendfile
+ * @return 需要关闭连接（出错或非直连响应已发完）时返回 false
+ */
+bool RestreamServer::writeClient(Client& client)
+{
+    static Counter& sentBytes = PerformanceMonitor::instance().counter("restream.bytes");
+    auto account = [&](std::size_t bytes) {
+        client.bytesSent += bytes;
+        client.queuedBytes -= std::min(client.queuedBytes, bytes);
+        m_statistics.bytesSent += bytes;
+        sentBytes.add(bytes);
+    };
+
+    while (!client.queue.empty()) {
+        Client::Item& front = client.queue.front();
+        if (front.file >= 0) {
+            off_t offset = static_cast<off_t>(front.fileOffset);
+            const ssize_t sent = ::sendfile(client.fd, front.file, &offset,
+                                            static_cast<std::size_t>(front.fileEnd - front.fileOffset));
+            if (sent > 0) {
+                front.fileOffset = offset;
+                account(static_cast<std::size_t>(sent));
+                if (front.fileOffset >= front.fileEnd) {
+                    ::close(front.file);
+                    client.queue.pop_front();
+                }
+                continue;
+            }
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            return false;
+        }
+
+        iovec vectors[kMaxIovecs];
+        int count = 0;
+        std::size_t offset = client.offset;
+        for (auto it = client.queue.begin(); it != client.queue.end() && count < kMaxIovecs && it->file < 0; ++it) {
+            vectors[count].iov_base = const_cast<uint8_t*>(it->chunk->data.data()) + offset;
+            vectors[count].iov_len = it->chunk->data.size() - offset;
+            offset = 0;
+            ++count;
+        }
+        msghdr message {};
+        message.msg_iov = vectors;
+        message.msg_iovlen = static_cast<std::size_t>(count);
+        ssize_t sent = ::sendmsg(client.fd, &message, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return false;
+        }
+        account(static_cast<std::size_t>(sent));
+        while (sent > 0) {
+            const std::size_t remaining = client.queue.front().chunk->data.size() - client.offset;
+            if (static_cast<std::size_t>(sent) >= remaining) {
+                sent -= static_cast<ssize_t>(remaining);
+                client.queue.pop_front();
+                client.offset = 0;
+            } else {
+                client.offset += static_cast<std::size_t>(sent);
+                sent = 0;
+            }
+        }
+    }
+
+    if (client.queue.empty() && client.responded && !client.live) {
+        return false;
+    }
+    updateInterest(client);
+    return true;
+}
+
+void RestreamServer::updateInterest(Client& client)
+{
+    const bool wantWrite = !client.queue.empty();
+    if (wantWrite == client.wantWrite) {
+        return;
+    }
+    client.wantWrite = wantWrite;
+    epoll_event event {};
+    event.events = EPOLLIN | (wantWrite ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    event.data.fd = client.fd;
+    epoll_ctl(m_epollFd, EPOLL_CTL_MOD, client.fd, &event);
+}
+
+void RestreamServer::closeClient(int fd)
+{
+    static Gauge& clientGauge = PerformanceMonitor::instance().gauge("restream.clients");
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    m_clients.erase(fd);
+    clientGauge.set(static_cast<int64_t>(m_clients.size()));
+}
+
+/**
+ * @brief 把封装线程发布的数据块追加到所有直连客户端，积压过多的客户端断开
+ */
+void RestreamServer::drainPublications()
+{
+    static Counter& slowCounter = PerformanceMonitor::instance().counter("restream.slow_clients");
+    bool published = false;
+    Publication publication;
+    while (m_publications.pop(publication)) {
+        if (publication.segmentStart) {
+            m_joinChunks.clear();
+        }
+        m_joinChunks.push_back(publication.chunk);
+        if (publication.chunk->time != AV_NOPTS_VALUE) {
+            m_latestTime = publication.chunk->time;
+        }
+        for (auto& entry : m_clients) {
+            Client& client = *entry.second;
+            if (client.live) {
+                client.queue.push_back({publication.chunk});
+                client.queuedBytes += publication.chunk->data.size();
+            }
+        }
+        published = true;
+    }
+    if (!published) {
+        return;
+    }
+
+    std::vector<int> closing;
+    for (auto& entry : m_clients) {
+        Client& client = *entry.second;
+        if (!client.live) {
+            continue;
+        }
+        if (client.queuedBytes > m_options.maxClientBytes) {
+            qWarning() << "RestreamServer: Disconnecting slow client" << QString::fromStdString(client.address);
+            slowCounter.add();
+            ++m_statistics.slowClients;
+            closing.push_back(entry.first);
+        } else if (!writeClient(client)) {
+            closing.push_back(entry.first);
+        }
+    }
+    for (int fd : closing) {
+        closeClient(fd);
+    }
+}
+
+/**
+ * @brief 更新直连客户端的延迟：正在发送的数据块与最新数据块的时间差
+ */
+void RestreamServer::updateLag()
+{
+    static Histogram& lagHistogram = PerformanceMonitor::instance().histogram("restream.client_lag_ms");
+    for (auto& entry : m_clients) {
+        Client& client = *entry.second;
+        if (!client.live) {
+            continue;
+        }
+        client.lagSeconds = 0.0;
+        for (const Client::Item& item : client.queue) {
+            if (item.chunk && item.chunk->time != AV_NOPTS_VALUE && m_latestTime != AV_NOPTS_VALUE) {
+                client.lagSeconds = std::max<int64_t>(m_latestTime - item.chunk->time, 0)
+                    / static_cast<double>(AV_TIME_BASE);
+                break;
+            }
+        }
+        lagHistogram.record(static_cast<int64_t>(client.lagSeconds * 1000.0));
+    }
+}
+
+#else
+
+bool RestreamServer::listen(QString*) { return false; }
+void RestreamServer::wakeServer() {}
+void RestreamServer::serverLoop() {}
+
+#endif
+
+} // namespace core
+} // namespace aurorastream
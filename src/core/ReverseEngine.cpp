@@ -0,0 +1,341 @@
+/********************************************************************************
+ * @file   : ReverseEngine.cpp
+ * @brief  : 实现了 aurorastream::core::ReverseEngine 类。
+ *
+ * 段的调度：输出线程按时间从后往前维护待解码段队列，每当有空闲的解码器
+ * （MediaSource），就把最早排队、尚未分配的段作为一个解码任务提交到共享线程池。有索引时，下一段的上界就是本段的关键帧，
+ * 可以提前排队；没有索引时要等本段解码完成、得到实际关键帧后才能排队。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/ReverseEngine.h"
+#include "FrameUtils.h"
+
+#include <QtCore/QDebug>
+
+#include <algorithm>
+
+extern "C" {
+#include <libavutil/error.h>
+#include <libavutil/mathematics.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+ReverseEngine::ReverseEngine(QObject* parent)
+    : QObject(parent)
+{
+}
+
+ReverseEngine::~ReverseEngine()
+{
+    stop();
+    for (AVFrame*& frame : m_framePool) {
+        av_frame_free(&frame);
+    }
+}
+
+void ReverseEngine::setOptions(const Options& options)
+{
+    m_options = options;
+}
+
+ReverseEngine::Options ReverseEngine::options() const
+{
+    return m_options;
+}
+
+bool ReverseEngine::start(const QString& uri, qint64 position)
+{
+    stop();
+
+    const int decoders = std::max(1, m_options.decoders);
+    for (int i = 0; i < decoders; ++i) {
+        QString errorMessage;
+        std::unique_ptr<MediaSource> source = MediaSource::open(uri, m_options.sourceOptions, &errorMessage);
+        if (!source || !source->videoStream()) {
+            emit error(source ? QString("ReverseEngine::start() failed. No video stream in: %1").arg(uri) : errorMessage);
+            m_sources.clear();
+            return false;
+        }
+        m_sources.push_back(std::move(source));
+    }
+
+    AVStream* stream = m_sources.front()->videoStream();
+    m_timeBase = stream->time_base;
+    m_startTime = m_sources.front()->startTime();
+
+    // 解复用器索引中的关键帧位置，可用于提前调度更早的 GOP
+    m_keyframes.clear();
+    const int entries = avformat_index_get_entries_count(stream);
+    for (int i = 0; i < entries; ++i) {
+        const AVIndexEntry* entry = avformat_index_get_entry(stream, i);
+        if (entry && (entry->flags & AVINDEX_KEYFRAME)) {
+            m_keyframes.push_back(entry->timestamp);
+        }
+    }
+    std::sort(m_keyframes.begin(), m_keyframes.end());
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = false;
+        m_reachedStart = false;
+        m_nextEnd = av_rescale_q(std::max<qint64>(position, 0) * 1000 + m_startTime, AV_TIME_BASE_Q, m_timeBase) + 1;
+        for (const std::unique_ptr<MediaSource>& source : m_sources) {
+            m_idleSources.push_back(source.get());
+        }
+        schedule();
+        dispatch();
+    }
+
+    qDebug() << "ReverseEngine: Started at" << position << "ms with" << decoders << "decoders,"
+             << m_keyframes.size() << "indexed keyframes.";
+    return true;
+}
+
+void ReverseEngine::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_segmentDone.notify_all();
+    m_tasks.wait();
+    m_idleSources.clear();
+
+    for (const std::shared_ptr<Segment>& segment : m_segments) {
+        releaseFrames(segment->frames);
+    }
+    m_segments.clear();
+    releaseFrames(m_current);
+    m_sources.clear();
+    m_lastPts = AV_NOPTS_VALUE;
+}
+
+bool ReverseEngine::isActive() const
+{
+    return !m_sources.empty();
+}
+
+int ReverseEngine::readFrame(AVFrame* frame)
+{
+    if (m_sources.empty()) {
+        return AVERROR(EINVAL);
+    }
+
+    while (m_current.empty()) {
+        std::shared_ptr<Segment> segment;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_segments.empty()) {
+                return AVERROR_EOF;
+            }
+            segment = m_segments.front();
+            m_segmentDone.wait(lock, [&] { return segment->done || m_stopping; });
+            if (m_stopping) {
+                return AVERROR_EOF;
+            }
+            m_segments.pop_front();
+
+            if (segment->ok) {
+                if (segment->truncatedStart != AV_NOPTS_VALUE) {
+                    // GOP 超出内存上限：剩余的前半部分紧接着重新解码
+                    auto remainder = std::make_shared<Segment>();
+                    remainder->start = segment->start;
+                    remainder->end = segment->truncatedStart;
+                    m_segments.push_front(remainder);
+                } else if (segment->frames.empty()) {
+                    m_reachedStart = true;
+                } else if (m_keyframes.empty()) {
+                    m_nextEnd = segment->gopStart;
+                }
+                std::swap(m_current, segment->frames);
+                schedule();
+                dispatch();
+            }
+        }
+
+        if (!segment->ok) {
+            emit error("ReverseEngine: Could not decode the previous GOP.");
+            return AVERROR(EIO);
+        }
+    }
+
+    AVFrame* next = m_current.back();
+    m_current.pop_back();
+    av_frame_unref(frame);
+    av_frame_move_ref(frame, next);
+    releaseFrame(next);
+    m_lastPts = frame->pts;
+    return 0;
+}
+
+qint64 ReverseEngine::position() const
+{
+    if (m_lastPts == AV_NOPTS_VALUE) {
+        return 0;
+    }
+    return (av_rescale_q(m_lastPts, m_timeBase, AV_TIME_BASE_Q) - m_startTime) / 1000;
+}
+
+/**
+ * @brief 补充待解码段，使每个解码器都有活可干（调用者持有 m_mutex）
+ * 排队的段数不超过解码器数，加上正在输出的 m_current，
+ * 同时持有解码帧的段最多为 decoders + 1 个。
+ */
+void ReverseEngine::schedule()
+{
+    const std::size_t depth = m_sources.size();
+    while (!m_reachedStart && m_nextEnd != AV_NOPTS_VALUE && m_segments.size() < depth) {
+        auto segment = std::make_shared<Segment>();
+        segment->end = m_nextEnd;
+        segment->start = keyframeBefore(m_nextEnd);
+        m_segments.push_back(segment);
+
+        if (m_keyframes.empty()) {
+            m_nextEnd = AV_NOPTS_VALUE;
+        } else if (segment->start == AV_NOPTS_VALUE || segment->start <= m_keyframes.front()) {
+            // 已经排到第一个 GOP，关键帧之前的帧（如果有）也一并输出
+            segment->start = AV_NOPTS_VALUE;
+            m_nextEnd = AV_NOPTS_VALUE;
+            m_reachedStart = true;
+        } else {
+            m_nextEnd = segment->start;
+        }
+    }
+}
+
+/**
+ * @brief 索引中早于 end 的最后一个关键帧
+ */
+int64_t ReverseEngine::keyframeBefore(int64_t end) const
+{
+    auto it = std::lower_bound(m_keyframes.begin(), m_keyframes.end(), end);
+    if (it == m_keyframes.begin()) {
+        return AV_NOPTS_VALUE;
+    }
+    return *std::prev(it);
+}
+
+/**
+ * @brief 把尚未分配的段交给空闲的解码器，在线程池中解码（调用者持有 m_mutex）
+ */
+void ReverseEngine::dispatch()
+{
+    for (const std::shared_ptr<Segment>& segment : m_segments) {
+        if (m_stopping || m_idleSources.empty()) {
+            return;
+        }
+        if (segment->assigned) {
+            continue;
+        }
+        segment->assigned = true;
+        MediaSource* source = m_idleSources.back();
+        m_idleSources.pop_back();
+
+        TaskScheduler::instance().submit(TaskScheduler::Priority::PlaybackDecode, [this, source, segment] {
+            decodeSegment(source, *segment);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                segment->done = true;
+                m_idleSources.push_back(source);
+                dispatch();
+            }
+            m_segmentDone.notify_all();
+        }, &m_tasks);
+    }
+}
+
+/**
+ * @brief 从 end 之前的关键帧正向解码，收集 [start, end) 内的帧
+ * 缓冲超过内存上限时丢弃最早的帧，并记录保留部分的起点。
+ */
+void ReverseEngine::decodeSegment(MediaSource* source, Segment& segment)
+{
+    const int64_t target = av_rescale_q(segment.end - 1, m_timeBase, AV_TIME_BASE_Q) - m_startTime;
+    if (source->seek(std::max<int64_t>(target, 0) / 1000) < 0) {
+        segment.ok = false;
+        return;
+    }
+
+    std::deque<AVFrame*> window;
+    std::size_t bytes = 0;
+    segment.ok = true;
+
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping) {
+                break;
+            }
+        }
+
+        AVFrame* frame = acquireFrame();
+        AVMediaType type = AVMEDIA_TYPE_UNKNOWN;
+        int ret = source->readFrame(frame, &type);
+        if (ret < 0) {
+            releaseFrame(frame);
+            segment.ok = ret == AVERROR_EOF;
+            break;
+        }
+        if (type != AVMEDIA_TYPE_VIDEO || frame->pts == AV_NOPTS_VALUE) {
+            releaseFrame(frame);
+            continue;
+        }
+
+        if (segment.gopStart == AV_NOPTS_VALUE) {
+            segment.gopStart = frame->pts;
+        }
+        if (frame->pts >= segment.end) {
+            releaseFrame(frame);
+            break;
+        }
+        if (segment.start != AV_NOPTS_VALUE && frame->pts < segment.start) {
+            releaseFrame(frame);
+            continue;
+        }
+
+        bytes += detail::frameBytes(frame);
+        window.push_back(frame);
+        while (bytes > m_options.gopMemoryLimit && window.size() > 1) {
+            bytes -= detail::frameBytes(window.front());
+            releaseFrame(window.front());
+            window.pop_front();
+            segment.truncatedStart = window.front()->pts;
+        }
+    }
+
+    segment.frames.assign(window.begin(), window.end());
+}
+
+AVFrame* ReverseEngine::acquireFrame()
+{
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    if (m_framePool.empty()) {
+        return av_frame_alloc();
+    }
+    AVFrame* frame = m_framePool.back();
+    m_framePool.pop_back();
+    return frame;
+}
+
+void ReverseEngine::releaseFrame(AVFrame* frame)
+{
+    av_frame_unref(frame);
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    m_framePool.push_back(frame);
+}
+
+void ReverseEngine::releaseFrames(std::vector<AVFrame*>& frames)
+{
+    for (AVFrame* frame : frames) {
+        releaseFrame(frame);
+    }
+    frames.clear();
+}
+
+} // namespace core
+} // namespace aurorastream
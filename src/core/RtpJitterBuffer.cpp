@@ -0,0 +1,332 @@
+/********************************************************************************
+ * @file   : RtpJitterBuffer.cpp
+ * @brief  : 实现了 aurorastream::core::RtpJitterBuffer 类。
+ *
+ * 已占用的槽位总是落在 [m_next, m_next + capacity) 的序号范围内，所以一个槽位
+ * 被占用时，其中必然是窗口内对应该槽位的那个序号，查找时不需要比较序号。
+ * 跳过的序号在槽位中留下标记，之后到达的同一序号据此记为迟到；
+ * 已放出的包重复到达记为重复，不影响播放延迟的控制。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/RtpJitterBuffer.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+constexpr int kRtpHeaderSize = 12;
+constexpr int64_t kMinDropout = 3000;           ///< 序号跳变超过该值（且超过两倍容量）视为发送端重新开始（RFC 3550 的 MAX_DROPOUT）
+constexpr int64_t kOffsetWindowUs = 10000000;   ///< 基准传输时延的重新取值周期
+constexpr int64_t kControlWindowUs = 2000000;   ///< 迟到丢包率的统计窗口
+constexpr double kMaxFactor = 16.0;
+constexpr double kFactorIncrease = 1.5;
+constexpr double kFactorDecay = 0.9;
+constexpr double kDelayDecreaseRate = 0.05;     ///< 延迟减小的速率（每秒减少的秒数）
+constexpr uint64_t kSequenceOrigin = uint64_t(1) << 32;     ///< 扩展序号的起点，为首包之前乱序到达的包留出余量
+
+} // namespace
+
+RtpJitterBuffer::RtpJitterBuffer(const Options& options, Sink sink)
+    : m_options(options)
+    , m_sink(std::move(sink))
+{
+    m_options.capacity = std::max(16, m_options.capacity);
+    m_options.maxPacketSize = std::max(kRtpHeaderSize, m_options.maxPacketSize);
+    m_options.clockRate = std::max(1, m_options.clockRate);
+    m_options.maxDelayUs = std::max(m_options.minDelayUs, m_options.maxDelayUs);
+    m_slots.resize(static_cast<std::size_t>(m_options.capacity));
+    m_storage.resize(static_cast<std::size_t>(m_options.capacity) * static_cast<std::size_t>(m_options.maxPacketSize));
+    m_factor = m_options.jitterFactor;
+    m_delay = m_target = m_options.minDelayUs;
+}
+
+RtpJitterBuffer::Slot& RtpJitterBuffer::slotFor(uint64_t sequence)
+{
+    return m_slots[static_cast<std::size_t>(sequence % m_slots.size())];
+}
+
+const RtpJitterBuffer::Slot& RtpJitterBuffer::slotFor(uint64_t sequence) const
+{
+    return m_slots[static_cast<std::size_t>(sequence % m_slots.size())];
+}
+
+int64_t RtpJitterBuffer::deadline(const Slot& slot) const
+{
+    return slot.timestampUs + m_offset + m_delay;
+}
+
+bool RtpJitterBuffer::push(const uint8_t* datagram, int size, int64_t arrivalUs)
+{
+    // RTP 头部（RFC 3550 5.1）：版本、填充、扩展头、CSRC 列表
+    if (size < kRtpHeaderSize || (datagram[0] >> 6) != 2) {
+        return false;
+    }
+    int header = kRtpHeaderSize + 4 * (datagram[0] & 0x0F);
+    if ((datagram[0] & 0x10) && size >= header + 4) {
+        header += 4 + 4 * ((datagram[header + 2] << 8) | datagram[header + 3]);
+    }
+    int end = size;
+    if (datagram[0] & 0x20) {
+        end -= datagram[size - 1];
+    }
+    if (header > end) {
+        return false;
+    }
+    const uint16_t sequence = static_cast<uint16_t>((datagram[2] << 8) | datagram[3]);
+    const uint32_t timestamp = (static_cast<uint32_t>(datagram[4]) << 24) | (static_cast<uint32_t>(datagram[5]) << 16) |
+                               (static_cast<uint32_t>(datagram[6]) << 8) | datagram[7];
+    ++m_statistics.received;
+
+    if (!m_started) {
+        restart(sequence, timestamp);
+    }
+    // 16 位序号和 32 位时间戳按与最大值的有符号差扩展，能处理回绕和乱序
+    int64_t delta = static_cast<int16_t>(static_cast<uint16_t>(sequence - static_cast<uint16_t>(m_highest)));
+    const int64_t maxDropout = std::max<int64_t>(kMinDropout, 2 * static_cast<int64_t>(m_options.capacity));
+    if (delta > maxDropout || delta < -maxDropout ||
+        static_cast<int64_t>(m_highest + delta - m_next) >= maxDropout) {
+        ++m_statistics.resyncs;
+        flush();
+        restart(sequence, timestamp);
+        delta = 0;
+    }
+    const uint64_t extended = m_highest + static_cast<uint64_t>(delta);
+    const int32_t timestampDelta = static_cast<int32_t>(timestamp - static_cast<uint32_t>(m_highestTimestamp));
+    const int64_t extendedTimestamp = m_highestTimestamp + timestampDelta;
+    if (delta > 0) {
+        m_highest = extended;
+    }
+    if (timestampDelta > 0) {
+        m_highestTimestamp = extendedTimestamp;
+    }
+    const int64_t timestampUs = (extendedTimestamp - m_firstTimestamp) * 1000000 / m_options.clockRate;
+
+    // 到达抖动（RFC 3550 6.4.1）和基准传输时延
+    const int64_t transit = arrivalUs - timestampUs;
+    if (m_haveTransit) {
+        const int64_t difference = transit - m_lastTransit;
+        m_statistics.jitterUs += (static_cast<double>(std::llabs(difference)) - m_statistics.jitterUs) / 16.0;
+        m_offset = std::min(m_offset, transit);
+        m_windowOffset = std::min(m_windowOffset, transit);
+        if (arrivalUs - m_offsetWindowStart >= kOffsetWindowUs) {
+            m_offset = m_windowOffset;
+            m_windowOffset = transit;
+            m_offsetWindowStart = arrivalUs;
+        }
+    } else {
+        m_haveTransit = true;
+        m_offset = m_windowOffset = transit;
+        m_offsetWindowStart = arrivalUs;
+    }
+    m_lastTransit = transit;
+
+    const uint64_t capacity = static_cast<uint64_t>(m_options.capacity);
+    if (extended < m_next) {
+        // 开始放出之前，比首包更早的包只要仍在窗口内就往前扩展
+        if (!m_playing && m_highest - extended < capacity) {
+            m_next = extended;
+        } else {
+            // 槽位里还留着该序号放出后的记录时才是重复；跳过标记或记录已被新包覆盖时按迟到处理
+            Slot& slot = slotFor(extended);
+            if (slot.sequence != extended || slot.skipped) {
+                slot.skipped = false;
+                ++m_statistics.late;
+                ++m_windowLate;
+                m_windowLateness = std::max(m_windowLateness, arrivalUs - (timestampUs + m_offset + m_delay));
+            } else {
+                ++m_statistics.duplicates;
+            }
+            return true;
+        }
+    }
+
+    // 超出序号窗口：提前放出（或跳过）最旧的序号，保证占用的槽位不超过容量
+    while (extended - m_next >= capacity) {
+        Slot& slot = slotFor(m_next);
+        if (slot.used) {
+            ++m_statistics.overflows;
+            release(slot);
+        } else {
+            slot.sequence = m_next;
+            slot.skipped = true;
+            ++m_statistics.lost;
+            ++m_windowDone;
+        }
+        ++m_next;
+    }
+
+    Slot& slot = slotFor(extended);
+    if (slot.used) {
+        ++m_statistics.duplicates;
+        return true;
+    }
+    if (delta < 0) {
+        ++m_statistics.reordered;
+    }
+    const int payload = std::min(end - header, m_options.maxPacketSize);
+    std::memcpy(m_storage.data() + (extended % capacity) * static_cast<std::size_t>(m_options.maxPacketSize),
+                datagram + header, static_cast<std::size_t>(payload));
+    slot.sequence = extended;
+    slot.timestampUs = timestampUs;
+    slot.size = payload;
+    slot.used = true;
+    slot.skipped = false;
+    ++m_count;
+    return true;
+}
+
+void RtpJitterBuffer::restart(uint16_t sequence, uint32_t timestamp)
+{
+    m_started = true;
+    m_playing = false;
+    m_highest = m_next = kSequenceOrigin + sequence;
+    m_highestTimestamp = m_firstTimestamp = timestamp;
+    m_haveTransit = false;
+}
+
+void RtpJitterBuffer::release(Slot& slot)
+{
+    const std::size_t index = static_cast<std::size_t>(slot.sequence % m_slots.size());
+    m_sink(m_storage.data() + index * static_cast<std::size_t>(m_options.maxPacketSize), slot.size);
+    slot.used = false;
+    slot.skipped = false;
+    --m_count;
+    m_playing = true;
+    ++m_statistics.played;
+    ++m_windowDone;
+}
+
+uint64_t RtpJitterBuffer::firstBuffered() const
+{
+    uint64_t sequence = m_next;
+    while (!slotFor(sequence).used) {
+        ++sequence;
+    }
+    return sequence;
+}
+
+void RtpJitterBuffer::drain(int64_t nowUs)
+{
+    updateDelay(nowUs);
+    while (m_count > 0) {
+        Slot& slot = slotFor(m_next);
+        if (slot.used) {
+            if (deadline(slot) > nowUs) {
+                break;
+            }
+            release(slot);
+            ++m_next;
+            continue;
+        }
+        // 缺失的序号最多等到其后第一个已到达的包的放出时间
+        const uint64_t available = firstBuffered();
+        if (deadline(slotFor(available)) > nowUs) {
+            break;
+        }
+        for (; m_next < available; ++m_next) {
+            Slot& missing = slotFor(m_next);
+            missing.sequence = m_next;
+            missing.skipped = true;
+            ++m_statistics.lost;
+            ++m_windowDone;
+        }
+    }
+    publishMetrics();
+}
+
+int64_t RtpJitterBuffer::nextDeadline() const
+{
+    if (m_count == 0) {
+        return -1;
+    }
+    return deadline(slotFor(firstBuffered()));
+}
+
+void RtpJitterBuffer::flush()
+{
+    while (m_count > 0) {
+        const uint64_t available = firstBuffered();
+        m_statistics.lost += available - m_next;
+        release(slotFor(available));
+        m_next = available + 1;
+    }
+    publishMetrics();
+}
+
+/**
+ * @brief 播放延迟控制：目标跟随到达抖动，迟到丢包率超标时按窗口提高
+ */
+void RtpJitterBuffer::updateDelay(int64_t nowUs)
+{
+    const int64_t elapsed = m_lastDrain ? std::max<int64_t>(nowUs - m_lastDrain, 0) : 0;
+    m_lastDrain = nowUs;
+    if (m_controlWindowStart == 0) {
+        m_controlWindowStart = nowUs;
+    }
+
+    if (nowUs - m_controlWindowStart >= kControlWindowUs) {
+        const double ratio = m_windowDone ? static_cast<double>(m_windowLate) / static_cast<double>(m_windowDone) : 0.0;
+        if (ratio > m_options.targetLateLoss) {
+            m_factor = std::min(m_factor * kFactorIncrease, kMaxFactor);
+            m_lateFloor = std::max(m_lateFloor, m_delay + m_windowLateness);
+        } else if (m_windowLate == 0) {
+            m_factor = std::max(m_options.jitterFactor, m_factor * kFactorDecay);
+            m_lateFloor = static_cast<int64_t>(static_cast<double>(m_lateFloor) * kFactorDecay);
+        }
+        m_controlWindowStart = nowUs;
+        m_windowDone = 0;
+        m_windowLate = 0;
+        m_windowLateness = 0;
+    }
+
+    const int64_t fromJitter = static_cast<int64_t>(m_factor * m_statistics.jitterUs);
+    m_target = std::clamp(std::max(fromJitter, m_lateFloor), m_options.minDelayUs, m_options.maxDelayUs);
+    if (m_target > m_delay) {
+        m_delay = m_target;
+    } else if (m_delay > m_target) {
+        m_delay = std::max(m_target, m_delay - static_cast<int64_t>(static_cast<double>(elapsed) * kDelayDecreaseRate));
+    }
+}
+
+void RtpJitterBuffer::publishMetrics()
+{
+    static PerformanceMonitor& monitor = PerformanceMonitor::instance();
+    static Counter& lost = monitor.counter("rtp.lost");
+    static Counter& late = monitor.counter("rtp.late");
+    static Counter& reordered = monitor.counter("rtp.reordered");
+    static Counter& duplicates = monitor.counter("rtp.duplicates");
+    static Counter& overflows = monitor.counter("rtp.overflows");
+    static Gauge& jitter = monitor.gauge("rtp.jitter_us");
+    static Gauge& delay = monitor.gauge("rtp.playout_delay_ms");
+
+    lost.add(m_statistics.lost - m_published.lost);
+    late.add(m_statistics.late - m_published.late);
+    reordered.add(m_statistics.reordered - m_published.reordered);
+    duplicates.add(m_statistics.duplicates - m_published.duplicates);
+    overflows.add(m_statistics.overflows - m_published.overflows);
+    jitter.set(static_cast<int64_t>(m_statistics.jitterUs));
+    delay.set(m_delay / 1000);
+    m_published = m_statistics;
+}
+
+RtpJitterBuffer::Statistics RtpJitterBuffer::getStatistics() const
+{
+    Statistics statistics = m_statistics;
+    statistics.delayUs = m_delay;
+    statistics.targetDelayUs = m_target;
+    const uint64_t done = m_statistics.played + m_statistics.lost;
+    statistics.lateLossRatio = done ? static_cast<double>(m_statistics.late) / static_cast<double>(done) : 0.0;
+    return statistics;
+}
+
+} // namespace core
+} // namespace aurorastream
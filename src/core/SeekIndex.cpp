@@ -0,0 +1,237 @@
+/********************************************************************************
+ * @file   : SeekIndex.cpp
+ * @brief  : 实现了 aurorastream::core::SeekIndex 类。
+ *
+ * 索引文件格式（小端，与 ProbeCache 一样只在本机使用）：
+ *   magic, version, 流序号, codec_id, time_base, 关键帧数, 关键帧数组。
+ * 应用索引前核对流序号、编解码器和时间基，文件头与索引不一致时忽略索引。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/SeekIndex.h"
+#include "aurorastream/core/ProbeCache.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QDebug>
+#include <QtCore/QFileInfo>
+#include <QtCore/QDateTime>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QCryptographicHash>
+
+#include <cstdio>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x494B5341;    // "ASKI"
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kMaxEntries = 16 * 1024 * 1024;
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    int32_t streamIndex;
+    int32_t codecId;
+    AVRational timeBase;
+    uint32_t count;
+};
+
+struct Keyframe {
+    int64_t timestamp;      ///< 流时间基
+    int64_t position;       ///< 字节位置
+    int32_t size;
+    int32_t reserved;
+};
+
+} // namespace
+
+SeekIndex& SeekIndex::instance()
+{
+    static SeekIndex instance([] {
+        QString base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        if (base.isEmpty()) {
+            base = QDir::tempPath() + "/aurorastream";
+        }
+        return (base + "/index").toStdString();
+    }());
+    return instance;
+}
+
+SeekIndex::SeekIndex(const std::string& directory)
+    : directory_(directory)
+{
+    if (!QDir().mkpath(QString::fromStdString(directory_))) {
+        qWarning() << "SeekIndex: Could not create index directory:" << QString::fromStdString(directory_);
+    }
+}
+
+std::string SeekIndex::directory() const
+{
+    return directory_;
+}
+
+std::string SeekIndex::keyFor(const std::string& path) const
+{
+    QFileInfo info(QString::fromStdString(path));
+    if (!info.isFile()) {
+        return std::string();
+    }
+
+    const QString identity = QString("%1|%2|%3")
+        .arg(info.absoluteFilePath())
+        .arg(info.size())
+        .arg(info.lastModified().toMSecsSinceEpoch());
+    return QCryptographicHash::hash(identity.toUtf8(), QCryptographicHash::Sha1).toHex().toStdString();
+}
+
+std::string SeekIndex::fileFor(const std::string& key) const
+{
+    return directory_ + "/" + key + ".index";
+}
+
+/**
+ * @brief 顺序读取所有数据包，记录主流上带关键帧标记的数据包
+ */
+bool SeekIndex::build(const std::string& path, BuildResult* result)
+{
+    const std::string key = keyFor(path);
+    if (key.empty()) {
+        return false;
+    }
+
+    AVFormatContext* formatContext = nullptr;
+    if (avformat_open_input(&formatContext, path.c_str(), nullptr, nullptr) < 0) {
+        return false;
+    }
+    if (!ProbeCache::instance().restore(path, formatContext)
+        && avformat_find_stream_info(formatContext, nullptr) < 0) {
+        avformat_close_input(&formatContext);
+        return false;
+    }
+
+    int streamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (streamIndex < 0) {
+        streamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    }
+    if (streamIndex < 0) {
+        avformat_close_input(&formatContext);
+        return false;
+    }
+
+    BuildResult stats;
+    stats.streamIndex = streamIndex;
+    std::vector<Keyframe> keyframes;
+
+    AVPacket* packet = av_packet_alloc();
+    while (av_read_frame(formatContext, packet) >= 0) {
+        stats.packets++;
+        stats.bytes += packet->size;
+        if (packet->stream_index == streamIndex && (packet->flags & AV_PKT_FLAG_KEY)) {
+            const int64_t timestamp = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+            if (timestamp != AV_NOPTS_VALUE && packet->pos >= 0) {
+                keyframes.push_back(Keyframe {timestamp, packet->pos, packet->size, 0});
+            }
+        }
+        av_packet_unref(packet);
+    }
+    av_packet_free(&packet);
+
+    const AVStream* stream = formatContext->streams[streamIndex];
+    const Header header {kMagic, kVersion, streamIndex, static_cast<int32_t>(stream->codecpar->codec_id),
+                         stream->time_base, 0};
+    avformat_close_input(&formatContext);
+
+    std::sort(keyframes.begin(), keyframes.end(), [](const Keyframe& a, const Keyframe& b) {
+        return a.timestamp < b.timestamp;
+    });
+    keyframes.erase(std::unique(keyframes.begin(), keyframes.end(), [](const Keyframe& a, const Keyframe& b) {
+        return a.timestamp == b.timestamp;
+    }), keyframes.end());
+    stats.keyframes = keyframes.size();
+    if (result) {
+        *result = stats;
+    }
+    if (keyframes.empty() || keyframes.size() > kMaxEntries) {
+        return false;
+    }
+
+    const std::string file = fileFor(key);
+    const std::string temp = file + ".tmp";
+    {
+        Header counted = header;
+        counted.count = static_cast<uint32_t>(keyframes.size());
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&counted), sizeof(counted));
+        out.write(reinterpret_cast<const char*>(keyframes.data()),
+                  static_cast<std::streamsize>(keyframes.size() * sizeof(Keyframe)));
+        if (!out) {
+            qWarning() << "SeekIndex: Could not write index:" << QString::fromStdString(temp);
+            std::remove(temp.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temp.c_str(), file.c_str()) != 0) {
+        std::remove(temp.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SeekIndex::apply(const std::string& path, AVFormatContext* formatContext) const
+{
+    const std::string key = keyFor(path);
+    if (key.empty() || !formatContext) {
+        return false;
+    }
+
+    std::ifstream in(fileFor(key), std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    Header header {};
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || header.magic != kMagic || header.version != kVersion || header.count > kMaxEntries
+        || header.streamIndex < 0 || static_cast<unsigned int>(header.streamIndex) >= formatContext->nb_streams) {
+        return false;
+    }
+
+    AVStream* stream = formatContext->streams[header.streamIndex];
+    if (stream->codecpar->codec_id != header.codecId || av_cmp_q(stream->time_base, header.timeBase) != 0) {
+        qWarning() << "SeekIndex: Index does not match stream layout, ignored:" << QString::fromStdString(path);
+        return false;
+    }
+    if (avformat_index_get_entries_count(stream) >= static_cast<int>(header.count)) {
+        return false;
+    }
+
+    std::vector<Keyframe> keyframes(header.count);
+    in.read(reinterpret_cast<char*>(keyframes.data()), static_cast<std::streamsize>(header.count * sizeof(Keyframe)));
+    if (!in) {
+        qWarning() << "SeekIndex: Corrupted index ignored:" << QString::fromStdString(key);
+        return false;
+    }
+
+    for (const Keyframe& keyframe : keyframes) {
+        av_add_index_entry(stream, keyframe.position, keyframe.timestamp, keyframe.size, 0, AVINDEX_KEYFRAME);
+    }
+    return true;
+}
+
+void SeekIndex::remove(const std::string& path)
+{
+    const std::string key = keyFor(path);
+    if (!key.empty()) {
+        std::remove(fileFor(key).c_str());
+    }
+}
+
+} // namespace core
+} // namespace aurorastream
@@ -0,0 +1,171 @@
+/********************************************************************************
+ * @file   : StartupProfiler.cpp
+ * @brief  : 实现了 aurorastream::core::StartupProfiler 类。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/StartupProfiler.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+#include "aurorastream/utils/Logger.h"
+
+#include <chrono>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+
+#ifdef __linux__
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+/// 当前时间（微秒）；Linux 上使用与 /proc 进程启动时间相同的 CLOCK_BOOTTIME
+int64_t now()
+{
+#ifdef __linux__
+    timespec ts;
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+#else
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// 静态初始化的时刻，无法取得进程启动时间时作为起点
+const int64_t kStaticInitTime = now();
+
+/**
+ * @brief 进程启动时间（微秒）
+ * 读取 /proc/self/stat 的第 22 个字段 starttime（开机以来的时钟滴答数）
+ */
+int64_t processStartTime()
+{
+#ifdef __linux__
+    std::ifstream stat("/proc/self/stat");
+    std::string content;
+    std::getline(stat, content);
+
+    // 第 2 个字段是带括号的进程名，可能包含空格，从最后一个 ')' 之后开始计数
+    const std::size_t nameEnd = content.rfind(')');
+    if (nameEnd != std::string::npos) {
+        std::istringstream fields(content.substr(nameEnd + 1));
+        std::string field;
+        for (int index = 3; index < 22 && fields >> field; ++index) {
+        }
+        unsigned long long ticks = 0;
+        if (fields >> ticks) {
+            const int64_t start = static_cast<int64_t>(ticks) * 1000000 / sysconf(_SC_CLK_TCK);
+            if (start > 0 && start <= kStaticInitTime) {
+                return start;
+            }
+        }
+    }
+#endif
+    return kStaticInitTime;
+}
+
+} // namespace
+
+StartupProfiler& StartupProfiler::instance()
+{
+    static StartupProfiler profiler;
+    return profiler;
+}
+
+StartupProfiler::StartupProfiler()
+    : m_processStart(processStartTime())
+{
+    for (std::atomic<int64_t>& mark : m_marks) {
+        mark.store(-1, std::memory_order_relaxed);
+    }
+}
+
+int64_t StartupProfiler::elapsed(Phase phase) const
+{
+    return m_marks[static_cast<int>(phase)].load(std::memory_order_acquire);
+}
+
+void StartupProfiler::setBudget(int64_t milliseconds)
+{
+    m_budget.store(std::max<int64_t>(0, milliseconds), std::memory_order_relaxed);
+}
+
+int64_t StartupProfiler::budget() const
+{
+    return m_budget.load(std::memory_order_relaxed);
+}
+
+const char* StartupProfiler::phaseName(Phase phase)
+{
+    switch (phase) {
+        case Phase::Main:           return "main";
+        case Phase::Application:    return "application";
+        case Phase::Player:         return "player";
+        case Phase::Window:         return "window";
+        case Phase::MediaOpened:    return "media_opened";
+        case Phase::FirstFrame:     return "first_frame";
+        default:                    return "unknown";
+    }
+}
+
+std::string StartupProfiler::report() const
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << "Startup profile (ms since process start):";
+
+    int64_t previous = 0;
+    for (int i = 0; i < static_cast<int>(Phase::Count); ++i) {
+        const Phase phase = static_cast<Phase>(i);
+        const int64_t value = elapsed(phase);
+        out << "\n  " << std::left << std::setw(14) << phaseName(phase) << std::right;
+        if (value < 0) {
+            out << std::setw(10) << "-";
+            continue;
+        }
+        out << std::setw(10) << value / 1000.0;
+        if (value >= previous) {
+            out << "  (+" << (value - previous) / 1000.0 << ")";
+            previous = value;
+        }
+    }
+
+    const int64_t limit = budget();
+    if (limit > 0) {
+        out << "\n  budget        " << std::setw(10) << limit;
+    }
+    return out.str();
+}
+
+/**
+ * @brief 首次到达某阶段：记录耗时、更新仪表，第一帧时输出报告并检查预算
+ */
+void StartupProfiler::record(Phase phase)
+{
+    const int64_t value = now() - m_processStart;
+    int64_t expected = -1;
+    if (!m_marks[static_cast<int>(phase)].compare_exchange_strong(expected, value, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    PerformanceMonitor::instance().gauge(std::string("startup.") + phaseName(phase) + "_us").set(value);
+    AURORASTREAM_LOG_DEBUG("Startup phase " << phaseName(phase) << " reached at " << value / 1000 << " ms");
+
+    if (phase == Phase::FirstFrame) {
+        AURORASTREAM_LOG_INFO(report());
+        const int64_t limit = budget();
+        if (limit > 0 && value / 1000 > limit) {
+            AURORASTREAM_LOG_WARNING("Cold start took " << value / 1000 << " ms, over the " << limit << " ms budget");
+        }
+    }
+}
+
+} // namespace core
+} // namespace aurorastream
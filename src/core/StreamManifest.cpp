@@ -0,0 +1,695 @@
+/********************************************************************************
+ * @file   : StreamManifest.cpp
+ * @brief  : 实现了 aurorastream::core::StreamManifest 类。
+ *
+ * HLS 按行解析（RFC 8216）。DASH 先用 QXmlStreamReader 读成一棵简单的元素树，
+ * 再按 MPD → Period → AdaptationSet → Representation 逐层继承 BaseURL 和
+ * SegmentTemplate 属性。只解析第一个 Period 和视频所在的 AdaptationSet
+ * （没有视频时取第一个），不支持 SegmentBase（需要解析 sidx）和动态 MPD。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/StreamManifest.h"
+
+#include <QtCore/QUrl>
+#include <QtCore/QDebug>
+#include <QtCore/QXmlStreamReader>
+
+#include <map>
+#include <cmath>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cinttypes>
+#include <algorithm>
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+QString resolveUrl(const QString& base, const std::string& reference)
+{
+    return QUrl(base).resolved(QUrl(QString::fromStdString(reference))).toString();
+}
+
+std::string trim(const std::string& text)
+{
+    const std::size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    const std::size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+bool startsWith(const std::string& text, const char* prefix)
+{
+    return text.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+}
+
+std::vector<std::string> splitLines(const std::string& text)
+{
+    std::vector<std::string> lines;
+    std::size_t begin = 0;
+    while (begin <= text.size()) {
+        std::size_t end = text.find('\n', begin);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        const std::string line = trim(text.substr(begin, end - begin));
+        if (!line.empty()) {
+            lines.push_back(line);
+        }
+        begin = end + 1;
+    }
+    return lines;
+}
+
+/**
+ * @brief 解析 HLS 属性列表：KEY=VALUE,KEY="quoted, value"
+ */
+std::map<std::string, std::string> parseAttributes(const std::string& text)
+{
+    std::map<std::string, std::string> attributes;
+    std::size_t i = 0;
+    while (i < text.size()) {
+        const std::size_t equal = text.find('=', i);
+        if (equal == std::string::npos) {
+            break;
+        }
+        const std::string key = trim(text.substr(i, equal - i));
+        std::string value;
+        i = equal + 1;
+        if (i < text.size() && text[i] == '"') {
+            const std::size_t close = text.find('"', i + 1);
+            value = text.substr(i + 1, close == std::string::npos ? std::string::npos : close - i - 1);
+            i = close == std::string::npos ? text.size() : close + 1;
+        } else {
+            const std::size_t comma = text.find(',', i);
+            value = text.substr(i, comma == std::string::npos ? std::string::npos : comma - i);
+            i = comma == std::string::npos ? text.size() : comma;
+        }
+        attributes[key] = trim(value);
+        if (i < text.size() && text[i] == ',') {
+            ++i;
+        }
+    }
+    return attributes;
+}
+
+/**
+ * @brief 解析字节区间 "length[@offset]"，没有 offset 时接在上一个区间之后
+ */
+void parseByteRange(const std::string& text, int64_t previousEnd, int64_t* offset, int64_t* length)
+{
+    const std::size_t at = text.find('@');
+    *length = std::strtoll(text.c_str(), nullptr, 10);
+    *offset = at != std::string::npos ? std::strtoll(text.c_str() + at + 1, nullptr, 10) : previousEnd;
+}
+
+/**
+ * @brief 解析 ISO 8601 时长，例如 PT1H2M3.5S、P1DT2H
+ */
+double parseIsoDuration(const std::string& text)
+{
+    double seconds = 0.0;
+    bool time = false;
+    const char* p = text.c_str();
+    if (*p != 'P') {
+        return 0.0;
+    }
+    ++p;
+    while (*p) {
+        if (*p == 'T') {
+            time = true;
+            ++p;
+            continue;
+        }
+        char* end = nullptr;
+        const double value = std::strtod(p, &end);
+        if (end == p || !*end) {
+            break;
+        }
+        switch (*end) {
+        case 'D': seconds += value * 86400.0; break;
+        case 'H': seconds += value * 3600.0; break;
+        case 'M': seconds += time ? value * 60.0 : value * 30.0 * 86400.0; break;
+        case 'S': seconds += value; break;
+        default: break;
+        }
+        p = end + 1;
+    }
+    return seconds;
+}
+
+/**
+ * @brief 简单的 XML 元素树（只保留本地名、属性和文本）
+ */
+struct XmlElement {
+    std::string name;
+    std::map<std::string, std::string> attributes;
+    std::string text;
+    std::vector<std::unique_ptr<XmlElement>> children;
+
+    const XmlElement* child(const char* childName) const {
+        for (const auto& element : children) {
+            if (element->name == childName) {
+                return element.get();
+            }
+        }
+        return nullptr;
+    }
+
+    std::vector<const XmlElement*> childrenNamed(const char* childName) const {
+        std::vector<const XmlElement*> result;
+        for (const auto& element : children) {
+            if (element->name == childName) {
+                result.push_back(element.get());
+            }
+        }
+        return result;
+    }
+
+    std::string attribute(const char* key, const std::string& fallback = std::string()) const {
+        auto it = attributes.find(key);
+        return it != attributes.end() ? it->second : fallback;
+    }
+};
+
+std::unique_ptr<XmlElement> parseXml(const std::string& text, QString* errorMessage)
+{
+    QXmlStreamReader reader(QByteArray(text.data(), static_cast<int>(text.size())));
+    std::unique_ptr<XmlElement> root;
+    std::vector<XmlElement*> stack;
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (reader.isStartElement()) {
+            auto element = std::make_unique<XmlElement>();
+            element->name = reader.name().toString().toStdString();
+            for (const QXmlStreamAttribute& attribute : reader.attributes()) {
+                element->attributes[attribute.name().toString().toStdString()] = attribute.value().toString().toStdString();
+            }
+            XmlElement* raw = element.get();
+            if (stack.empty()) {
+                if (root) {
+                    break;
+                }
+                root = std::move(element);
+            } else {
+                stack.back()->children.push_back(std::move(element));
+            }
+            stack.push_back(raw);
+        } else if (reader.isEndElement()) {
+            if (!stack.empty()) {
+                stack.pop_back();
+            }
+        } else if (reader.isCharacters() && !stack.empty()) {
+            stack.back()->text += reader.text().toString().toStdString();
+        }
+    }
+    if (reader.hasError() || !root) {
+        if (errorMessage) {
+            *errorMessage = QString("Invalid XML: %1").arg(reader.errorString());
+        }
+        return nullptr;
+    }
+    return root;
+}
+
+/// 沿元素链解析 BaseURL
+QString applyBaseUrl(const QString& base, const XmlElement* element)
+{
+    const XmlElement* baseUrl = element ? element->child("BaseURL") : nullptr;
+    return baseUrl ? resolveUrl(base, trim(baseUrl->text)) : base;
+}
+
+/**
+ * @brief 展开 SegmentTemplate 中的 $RepresentationID$、$Number%05d$、$Bandwidth$、$Time$ 和 $$
+ */
+std::string expandTemplate(const std::string& pattern, const std::string& id, int64_t bandwidth,
+                           int64_t number, int64_t time)
+{
+    std::string result;
+    std::size_t i = 0;
+    while (i < pattern.size()) {
+        const std::size_t open = pattern.find('$', i);
+        if (open == std::string::npos) {
+            result += pattern.substr(i);
+            break;
+        }
+        result += pattern.substr(i, open - i);
+        const std::size_t close = pattern.find('$', open + 1);
+        if (close == std::string::npos) {
+            result += pattern.substr(open);
+            break;
+        }
+        const std::string token = pattern.substr(open + 1, close - open - 1);
+        i = close + 1;
+        if (token.empty()) {
+            result += '$';
+            continue;
+        }
+        const std::size_t percent = token.find('%');
+        const std::string name = token.substr(0, percent);
+        std::string format = percent != std::string::npos ? token.substr(percent) : std::string("%d");
+        if (name == "RepresentationID") {
+            result += id;
+            continue;
+        }
+        int64_t value = 0;
+        if (name == "Number") {
+            value = number;
+        } else if (name == "Bandwidth") {
+            value = bandwidth;
+        } else if (name == "Time") {
+            value = time;
+        } else {
+            result += '$' + token + '$';
+            continue;
+        }
+        // 只接受 %0Nd 形式的宽度，换成 64 位格式
+        if (format.size() < 2 || format.back() != 'd' || format.find_first_not_of("%0123456789d") != std::string::npos) {
+            format = "%d";
+        }
+        format.pop_back();
+        format += PRId64;
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), format.c_str(), value);
+        result += buffer;
+    }
+    return result;
+}
+
+double parseFrameRate(const std::string& text)
+{
+    const std::size_t slash = text.find('/');
+    const double numerator = std::strtod(text.c_str(), nullptr);
+    if (slash == std::string::npos) {
+        return numerator;
+    }
+    const double denominator = std::strtod(text.c_str() + slash + 1, nullptr);
+    return denominator > 0 ? numerator / denominator : 0.0;
+}
+
+} // namespace
+
+std::unique_ptr<StreamManifest> StreamManifest::parse(const std::string& text, const QString& url, QString* errorMessage)
+{
+    auto fail = [errorMessage](const QString& message) {
+        qWarning() << message;
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        return nullptr;
+    };
+
+    std::unique_ptr<StreamManifest> manifest(new StreamManifest());
+    manifest->m_url = url;
+
+    QString parseError;
+    const std::string head = trim(text.substr(0, 512));
+    bool ok = false;
+    if (head.find("#EXTM3U") != std::string::npos) {
+        manifest->m_kind = Kind::Hls;
+        ok = manifest->parseHls(text, &parseError);
+    } else if (head.find("<MPD") != std::string::npos || text.find("<MPD") != std::string::npos) {
+        manifest->m_kind = Kind::Dash;
+        ok = manifest->parseDash(text, &parseError);
+    } else {
+        parseError = "Unrecognized manifest format";
+    }
+    if (!ok) {
+        return fail(QString("StreamManifest::parse() failed for %1: %2").arg(url, parseError));
+    }
+    if (manifest->m_renditions.empty()) {
+        return fail(QString("StreamManifest::parse() failed for %1: No playable renditions").arg(url));
+    }
+
+    std::stable_sort(manifest->m_renditions.begin(), manifest->m_renditions.end(),
+                     [](const Rendition& a, const Rendition& b) { return a.bandwidth < b.bandwidth; });
+    return manifest;
+}
+
+bool StreamManifest::isManifestUrl(const QString& uri)
+{
+    std::string path = uri.toStdString();
+    path = path.substr(0, path.find_first_of("?#"));
+    std::transform(path.begin(), path.end(), path.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    auto endsWith = [&path](const char* suffix) {
+        const std::size_t length = std::char_traits<char>::length(suffix);
+        return path.size() >= length && path.compare(path.size() - length, length, suffix) == 0;
+    };
+    return endsWith(".m3u8") || endsWith(".mpd");
+}
+
+bool StreamManifest::parseHls(const std::string& text, QString* errorMessage)
+{
+    // 没有 EXT-X-STREAM-INF 时本身就是一个媒体播放列表
+    if (text.find("#EXT-X-STREAM-INF") == std::string::npos) {
+        Rendition rendition;
+        rendition.id = "0";
+        rendition.playlistUrl = m_url;
+        m_renditions.push_back(rendition);
+        return loadMediaPlaylist(0, text, errorMessage);
+    }
+
+    std::map<std::string, std::string> pending;
+    bool hasPending = false;
+    for (const std::string& line : splitLines(text)) {
+        if (startsWith(line, "#EXT-X-STREAM-INF:")) {
+            pending = parseAttributes(line.substr(18));
+            hasPending = true;
+        } else if (line[0] != '#' && hasPending) {
+            Rendition rendition;
+            rendition.id = QString::number(static_cast<long long>(m_renditions.size()));
+            rendition.bandwidth = std::strtoll(pending["BANDWIDTH"].c_str(), nullptr, 10);
+            const std::string& resolution = pending["RESOLUTION"];
+            const std::size_t x = resolution.find('x');
+            if (x != std::string::npos) {
+                rendition.width = std::atoi(resolution.c_str());
+                rendition.height = std::atoi(resolution.c_str() + x + 1);
+            }
+            rendition.frameRate = std::strtod(pending["FRAME-RATE"].c_str(), nullptr);
+            rendition.codecs = pending["CODECS"];
+            rendition.playlistUrl = resolveUrl(m_url, line);
+            m_renditions.push_back(rendition);
+            hasPending = false;
+        }
+    }
+    return true;
+}
+
+bool StreamManifest::loadMediaPlaylist(int index, const std::string& text, QString* errorMessage)
+{
+    if (index < 0 || index >= static_cast<int>(m_renditions.size())) {
+        return false;
+    }
+    Rendition& rendition = m_renditions[index];
+    if (trim(text.substr(0, 64)).compare(0, 7, "#EXTM3U") != 0) {
+        if (errorMessage) {
+            *errorMessage = "Media playlist does not start with #EXTM3U";
+        }
+        return false;
+    }
+
+    std::vector<Segment> segments;
+    int64_t sequence = 0;
+    double targetDuration = 0.0;
+    double duration = 0.0;
+    bool endList = false;
+    bool encrypted = false;
+    bool discontinuity = false;
+    bool hasRange = false;
+    int64_t rangeOffset = 0;
+    int64_t rangeLength = -1;
+    int64_t previousEnd = 0;
+    Segment init;
+
+    for (const std::string& line : splitLines(text)) {
+        if (startsWith(line, "#EXT-X-TARGETDURATION:")) {
+            targetDuration = std::strtod(line.c_str() + 22, nullptr);
+        } else if (startsWith(line, "#EXT-X-MEDIA-SEQUENCE:")) {
+            sequence = std::strtoll(line.c_str() + 22, nullptr, 10);
+        } else if (startsWith(line, "#EXTINF:")) {
+            duration = std::strtod(line.c_str() + 8, nullptr);
+        } else if (startsWith(line, "#EXT-X-BYTERANGE:")) {
+            parseByteRange(line.substr(17), previousEnd, &rangeOffset, &rangeLength);
+            hasRange = true;
+        } else if (line == "#EXT-X-DISCONTINUITY") {
+            discontinuity = true;
+        } else if (line == "#EXT-X-ENDLIST") {
+            endList = true;
+        } else if (startsWith(line, "#EXT-X-KEY:")) {
+            encrypted = parseAttributes(line.substr(11))["METHOD"] != "NONE";
+        } else if (startsWith(line, "#EXT-X-MAP:")) {
+            std::map<std::string, std::string> attributes = parseAttributes(line.substr(11));
+            init = Segment();
+            init.url = resolveUrl(rendition.playlistUrl, attributes["URI"]);
+            if (!attributes["BYTERANGE"].empty()) {
+                parseByteRange(attributes["BYTERANGE"], 0, &init.offset, &init.length);
+            }
+        } else if (line[0] != '#') {
+            Segment segment;
+            segment.number = sequence + static_cast<int64_t>(segments.size());
+            segment.duration = duration;
+            segment.url = resolveUrl(rendition.playlistUrl, line);
+            segment.discontinuity = discontinuity;
+            if (hasRange) {
+                segment.offset = rangeOffset;
+                segment.length = rangeLength;
+                previousEnd = rangeOffset + rangeLength;
+            } else {
+                previousEnd = 0;
+            }
+            segments.push_back(segment);
+            duration = 0.0;
+            discontinuity = false;
+            hasRange = false;
+        }
+    }
+
+    // 起始时间：首次加载从 0 开始；直播刷新时与已知分段对齐
+    double start = 0.0;
+    if (!segments.empty() && !rendition.segments.empty()) {
+        const int known = findSegment(index, segments.front().number);
+        const Segment& last = rendition.segments.back();
+        if (known >= 0) {
+            start = rendition.segments[known].start;
+        } else if (segments.front().number > last.number) {
+            start = last.start + last.duration
+                    + static_cast<double>(segments.front().number - last.number - 1) * targetDuration;
+        } else {
+            start = rendition.segments.front().start;
+        }
+    }
+    for (Segment& segment : segments) {
+        segment.start = start;
+        start += segment.duration;
+    }
+
+    rendition.segments = std::move(segments);
+    rendition.init = init;
+    rendition.targetDuration = targetDuration;
+    rendition.live = !endList;
+    rendition.encrypted = encrypted;
+    rendition.loaded = true;
+    if (!rendition.live && !rendition.segments.empty()) {
+        m_duration = rendition.segments.back().start + rendition.segments.back().duration;
+    }
+    return true;
+}
+
+bool StreamManifest::parseDash(const std::string& text, QString* errorMessage)
+{
+    std::unique_ptr<XmlElement> mpd = parseXml(text, errorMessage);
+    if (!mpd) {
+        return false;
+    }
+    if (mpd->name != "MPD") {
+        *errorMessage = "Root element is not MPD";
+        return false;
+    }
+    if (mpd->attribute("type", "static") != "static") {
+        *errorMessage = "Dynamic (live) MPD is not supported";
+        return false;
+    }
+    const XmlElement* period = mpd->child("Period");
+    if (!period) {
+        *errorMessage = "MPD has no Period";
+        return false;
+    }
+
+    m_duration = parseIsoDuration(mpd->attribute("mediaPresentationDuration"));
+    const double periodDuration = period->attributes.count("duration")
+                                  ? parseIsoDuration(period->attribute("duration")) : m_duration;
+    const QString periodBase = applyBaseUrl(applyBaseUrl(m_url, mpd.get()), period);
+
+    // 选择视频所在的 AdaptationSet：整个字节流只能交给一个解复用器
+    const std::vector<const XmlElement*> sets = period->childrenNamed("AdaptationSet");
+    const XmlElement* set = nullptr;
+    for (const XmlElement* candidate : sets) {
+        const XmlElement* representation = candidate->child("Representation");
+        const std::string mime = candidate->attribute("mimeType", representation ? representation->attribute("mimeType") : "");
+        if (candidate->attribute("contentType") == "video" || startsWith(mime, "video/")) {
+            set = candidate;
+            break;
+        }
+    }
+    if (!set && !sets.empty()) {
+        set = sets.front();
+    }
+    if (!set) {
+        *errorMessage = "Period has no AdaptationSet";
+        return false;
+    }
+    const QString setBase = applyBaseUrl(periodBase, set);
+
+    for (const XmlElement* representation : set->childrenNamed("Representation")) {
+        Rendition rendition;
+        const std::string id = representation->attribute("id");
+        rendition.id = QString::fromStdString(id);
+        rendition.bandwidth = std::strtoll(representation->attribute("bandwidth").c_str(), nullptr, 10);
+        rendition.width = std::atoi(representation->attribute("width", set->attribute("width")).c_str());
+        rendition.height = std::atoi(representation->attribute("height", set->attribute("height")).c_str());
+        rendition.frameRate = parseFrameRate(representation->attribute("frameRate", set->attribute("frameRate")));
+        rendition.codecs = representation->attribute("codecs", set->attribute("codecs"));
+        const QString base = applyBaseUrl(setBase, representation);
+
+        // Representation 上的 SegmentTemplate 属性覆盖 AdaptationSet 上的
+        const XmlElement* setTemplate = set->child("SegmentTemplate");
+        const XmlElement* ownTemplate = representation->child("SegmentTemplate");
+        const XmlElement* segmentList = representation->child("SegmentList");
+        if (!segmentList) {
+            segmentList = set->child("SegmentList");
+        }
+
+        if (setTemplate || ownTemplate) {
+            std::map<std::string, std::string> attributes;
+            if (setTemplate) {
+                attributes = setTemplate->attributes;
+            }
+            if (ownTemplate) {
+                for (const auto& attribute : ownTemplate->attributes) {
+                    attributes[attribute.first] = attribute.second;
+                }
+            }
+            const XmlElement* timeline = ownTemplate ? ownTemplate->child("SegmentTimeline") : nullptr;
+            if (!timeline && setTemplate) {
+                timeline = setTemplate->child("SegmentTimeline");
+            }
+
+            const double timescale = attributes.count("timescale") ? std::strtod(attributes["timescale"].c_str(), nullptr) : 1.0;
+            const int64_t startNumber = attributes.count("startNumber") ? std::strtoll(attributes["startNumber"].c_str(), nullptr, 10) : 1;
+            const int64_t offset = std::strtoll(attributes["presentationTimeOffset"].c_str(), nullptr, 10);
+            const std::string media = attributes["media"];
+            if (!attributes["initialization"].empty()) {
+                rendition.init.url = resolveUrl(base, expandTemplate(attributes["initialization"], id, rendition.bandwidth, 0, 0));
+            }
+
+            auto addSegment = [&](int64_t number, int64_t time, int64_t length) {
+                Segment segment;
+                segment.number = number;
+                segment.start = static_cast<double>(time - offset) / timescale;
+                segment.duration = static_cast<double>(length) / timescale;
+                segment.url = resolveUrl(base, expandTemplate(media, id, rendition.bandwidth, number, time));
+                rendition.segments.push_back(segment);
+            };
+
+            if (timeline) {
+                int64_t time = 0;
+                int64_t number = startNumber;
+                const int64_t periodEnd = offset + static_cast<int64_t>(periodDuration * timescale);
+                for (const XmlElement* s : timeline->childrenNamed("S")) {
+                    if (s->attributes.count("t")) {
+                        time = std::strtoll(s->attribute("t").c_str(), nullptr, 10);
+                    }
+                    const int64_t length = std::strtoll(s->attribute("d").c_str(), nullptr, 10);
+                    int64_t repeat = std::strtoll(s->attribute("r", "0").c_str(), nullptr, 10);
+                    if (length <= 0) {
+                        continue;
+                    }
+                    if (repeat < 0) {
+                        // r = -1：重复到 Period 结束
+                        repeat = std::max<int64_t>(0, (periodEnd - time + length - 1) / length - 1);
+                    }
+                    for (int64_t i = 0; i <= repeat; ++i) {
+                        addSegment(number++, time, length);
+                        time += length;
+                    }
+                }
+            } else {
+                const int64_t length = std::strtoll(attributes["duration"].c_str(), nullptr, 10);
+                if (length > 0 && periodDuration > 0) {
+                    const int64_t count = static_cast<int64_t>(std::ceil(periodDuration * timescale / length - 1e-6));
+                    for (int64_t i = 0; i < count; ++i) {
+                        addSegment(startNumber + i, offset + i * length, length);
+                    }
+                }
+            }
+        } else if (segmentList) {
+            const double timescale = segmentList->attributes.count("timescale")
+                                     ? std::strtod(segmentList->attribute("timescale").c_str(), nullptr) : 1.0;
+            const double length = std::strtod(segmentList->attribute("duration").c_str(), nullptr) / timescale;
+            if (const XmlElement* initialization = segmentList->child("Initialization")) {
+                rendition.init.url = resolveUrl(base, initialization->attribute("sourceURL"));
+                const std::string range = initialization->attribute("range");
+                if (!range.empty()) {
+                    rendition.init.offset = std::strtoll(range.c_str(), nullptr, 10);
+                    rendition.init.length = std::strtoll(range.c_str() + range.find('-') + 1, nullptr, 10) - rendition.init.offset + 1;
+                }
+            }
+            int64_t number = segmentList->attributes.count("startNumber")
+                             ? std::strtoll(segmentList->attribute("startNumber").c_str(), nullptr, 10) : 1;
+            for (const XmlElement* url : segmentList->childrenNamed("SegmentURL")) {
+                Segment segment;
+                segment.number = number;
+                segment.start = static_cast<double>(rendition.segments.size()) * length;
+                segment.duration = length;
+                segment.url = url->attributes.count("media") ? resolveUrl(base, url->attribute("media")) : base;
+                const std::string range = url->attribute("mediaRange");
+                if (!range.empty()) {
+                    segment.offset = std::strtoll(range.c_str(), nullptr, 10);
+                    segment.length = std::strtoll(range.c_str() + range.find('-') + 1, nullptr, 10) - segment.offset + 1;
+                }
+                rendition.segments.push_back(segment);
+                ++number;
+            }
+        } else {
+            qDebug() << "StreamManifest: Skipping representation without SegmentTemplate or SegmentList:" << rendition.id;
+            continue;
+        }
+
+        if (rendition.segments.empty()) {
+            continue;
+        }
+        rendition.loaded = true;
+        rendition.targetDuration = 0.0;
+        for (const Segment& segment : rendition.segments) {
+            rendition.targetDuration = std::max(rendition.targetDuration, segment.duration);
+        }
+        m_renditions.push_back(rendition);
+    }
+
+    if (m_duration <= 0.0 && !m_renditions.empty()) {
+        const Segment& last = m_renditions.front().segments.back();
+        m_duration = last.start + last.duration;
+    }
+    return true;
+}
+
+StreamManifest::Kind StreamManifest::kind() const { return m_kind; }
+QString StreamManifest::url() const { return m_url; }
+double StreamManifest::duration() const { return m_duration; }
+int StreamManifest::renditionCount() const { return static_cast<int>(m_renditions.size()); }
+const StreamManifest::Rendition& StreamManifest::rendition(int index) const { return m_renditions[index]; }
+
+int StreamManifest::findSegment(int rendition, int64_t number) const
+{
+    const std::vector<Segment>& segments = m_renditions[rendition].segments;
+    if (segments.empty()) {
+        return -1;
+    }
+    // 编号连续，直接按偏移定位
+    const int64_t index = number - segments.front().number;
+    if (index < 0 || index >= static_cast<int64_t>(segments.size()) || segments[index].number != number) {
+        return -1;
+    }
+    return static_cast<int>(index);
+}
+
+int StreamManifest::segmentAt(int rendition, double seconds) const
+{
+    const std::vector<Segment>& segments = m_renditions[rendition].segments;
+    if (segments.empty()) {
+        return -1;
+    }
+    auto it = std::upper_bound(segments.begin(), segments.end(), seconds,
+                               [](double time, const Segment& segment) { return time < segment.start; });
+    return it == segments.begin() ? 0 : static_cast<int>(it - segments.begin()) - 1;
+}
+
+} // namespace core
+} // namespace aurorastream
@@ -0,0 +1,281 @@
+/********************************************************************************
+ * @file   : StreamRecorder.cpp
+ * @brief  : 实现了 aurorastream::core::StreamRecorder 类。
+ *
+ * 输出文件在第一个数据包到达时才打开，avoid_negative_ts 使每个文件的
+ * 时间戳都从 0 开始；时间线不连续时关闭当前文件，下一个数据包
+ * （一定是视频关键帧）打开新文件。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/StreamRecorder.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+#include "aurorastream/utils/Tracer.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QFileInfo>
+
+extern "C" {
+#include <libavutil/error.h>
+#include <libavutil/mathematics.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+QString ffmpegError(const QString& message, int errorCode)
+{
+    char errbuf[AV_ERROR_MAX_STRING_SIZE] = {0};
+    av_strerror(errorCode, errbuf, AV_ERROR_MAX_STRING_SIZE);
+    return QString("FFmpeg error: %1 (%2)").arg(message).arg(errbuf);
+}
+
+} // namespace
+
+StreamRecorder::StreamRecorder(const QString& path, const Options& options)
+    : PacketTap("record", options.limits)
+    , m_path(path)
+    , m_options(options)
+{
+}
+
+StreamRecorder::~StreamRecorder()
+{
+    // 写线程会访问本类的成员，必须在成员析构之前退出
+    stop();
+    wait();
+    for (AVCodecParameters* parameters : m_parameters) {
+        avcodec_parameters_free(&parameters);
+    }
+}
+
+std::unique_ptr<StreamRecorder> StreamRecorder::create(const AVFormatContext* input, const QString& path,
+                                                       const Options& options, QString* errorMessage)
+{
+    auto fail = [errorMessage](const QString& message) {
+        qWarning() << message;
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        return nullptr;
+    };
+
+    if (!input) {
+        return fail("StreamRecorder::create() failed. No input.");
+    }
+    const std::string fileName = path.toStdString();
+    const AVOutputFormat* format = av_guess_format(options.format.empty() ? nullptr : options.format.c_str(),
+                                                   fileName.c_str(), nullptr);
+    if (!format) {
+        return fail(QString("StreamRecorder::create() failed. Unknown output format for: %1").arg(path));
+    }
+
+    std::unique_ptr<StreamRecorder> recorder(new StreamRecorder(path, options));
+    recorder->m_format = format;
+
+    // 只录制容器支持的音视频流，封面图等附加图片不录制
+    for (unsigned i = 0; i < input->nb_streams; ++i) {
+        const AVStream* stream = input->streams[i];
+        const AVMediaType type = stream->codecpar->codec_type;
+        if ((type != AVMEDIA_TYPE_VIDEO && type != AVMEDIA_TYPE_AUDIO)
+            || (stream->disposition & AV_DISPOSITION_ATTACHED_PIC)
+            || avformat_query_codec(format, stream->codecpar->codec_id, FF_COMPLIANCE_NORMAL) == 0) {
+            continue;
+        }
+        AVCodecParameters* parameters = avcodec_parameters_alloc();
+        if (!parameters || avcodec_parameters_copy(parameters, stream->codecpar) < 0) {
+            avcodec_parameters_free(&parameters);
+            return fail("StreamRecorder::create() failed. Could not copy codec parameters.");
+        }
+        // 不同容器的 codec_tag 不通用，交给输出封装器重新选择
+        parameters->codec_tag = 0;
+        recorder->addStream(static_cast<int>(i), stream->time_base, type == AVMEDIA_TYPE_VIDEO);
+        recorder->m_parameters.push_back(parameters);
+    }
+    if (recorder->m_parameters.empty()) {
+        return fail(QString("StreamRecorder::create() failed. No stream can be stored in %1.").arg(format->name));
+    }
+
+    recorder->start();
+    qDebug() << "StreamRecorder: Recording" << recorder->m_parameters.size() << "streams to" << path
+             << "as" << format->name;
+    return recorder;
+}
+
+QString StreamRecorder::path() const
+{
+    return m_path;
+}
+
+StreamRecorder::Statistics StreamRecorder::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    Statistics statistics = m_statistics;
+    statistics.packetsDropped += droppedPackets();
+    return statistics;
+}
+
+/**
+ * @brief 写出一个数据包（写线程调用）
+ */
+void StreamRecorder::consume(AVPacket* packet)
+{
+    static Histogram& writeTime = PerformanceMonitor::instance().histogram("record.write_us");
+    static Counter& writtenBytes = PerformanceMonitor::instance().counter("record.bytes");
+
+    const AVRational timeBase = inputTimeBase(packet->stream_index);
+    const int64_t timestamp = packet->dts != AV_NOPTS_VALUE ? packet->dts : packet->pts;
+    const int64_t time = timestamp != AV_NOPTS_VALUE ? av_rescale_q(timestamp, timeBase, AV_TIME_BASE_Q)
+                                                     : AV_NOPTS_VALUE;
+    const bool boundary = videoStream() < 0
+        || (packet->stream_index == videoStream() && (packet->flags & AV_PKT_FLAG_KEY));
+
+    // 分段只在关键帧处切换，新文件从关键帧开始
+    const bool segmented = m_options.segmentSeconds > 0.0 || m_options.segmentBytes > 0;
+    if (m_output && boundary && segmented) {
+        const bool durationReached = m_options.segmentSeconds > 0.0 && time != AV_NOPTS_VALUE
+            && m_segmentStart != AV_NOPTS_VALUE
+            && time - m_segmentStart >= static_cast<int64_t>(m_options.segmentSeconds * AV_TIME_BASE);
+        const bool sizeReached = m_options.segmentBytes > 0 && m_segmentBytes >= m_options.segmentBytes;
+        if (durationReached || sizeReached) {
+            closeSegment();
+        }
+    }
+    if (!m_output) {
+        // 打开失败时丢弃到下一个关键帧再重试
+        if (!boundary || !openSegment()) {
+            av_packet_free(&packet);
+            std::lock_guard<std::mutex> lock(m_statisticsMutex);
+            ++m_statistics.packetsDropped;
+            return;
+        }
+        m_segmentStart = time;
+    }
+
+    const int size = packet->size;
+    av_packet_rescale_ts(packet, timeBase, m_output->streams[packet->stream_index]->time_base);
+    packet->pos = -1;
+    int ret;
+    {
+        AURORASTREAM_TRACE_SCOPE("record.write", "record");
+        ScopedTimer timer(writeTime);
+        ret = av_interleaved_write_frame(m_output, packet);
+    }
+    av_packet_free(&packet);
+
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    if (ret < 0) {
+        // 单个时间戳异常的数据包不应中断录制
+        ++m_statistics.writeErrors;
+        return;
+    }
+    m_segmentBytes += size;
+    writtenBytes.add(static_cast<uint64_t>(size));
+    ++m_statistics.packetsWritten;
+    m_statistics.bytesWritten += static_cast<uint64_t>(size);
+}
+
+void StreamRecorder::discontinuity()
+{
+    closeSegment();
+}
+
+void StreamRecorder::finish()
+{
+    closeSegment();
+    qDebug() << "StreamRecorder: Finished recording to" << m_path;
+}
+
+bool StreamRecorder::openSegment()
+{
+    const QString path = segmentPath(m_segmentIndex);
+    const std::string fileName = path.toStdString();
+    AVFormatContext* output = nullptr;
+    int ret = avformat_alloc_output_context2(&output, m_format, nullptr, fileName.c_str());
+    if (ret < 0) {
+        qWarning() << ffmpegError(QString("StreamRecorder: Could not create output for %1").arg(path), ret);
+        return false;
+    }
+
+    for (std::size_t i = 0; i < m_parameters.size(); ++i) {
+        AVStream* stream = avformat_new_stream(output, nullptr);
+        if (!stream || avcodec_parameters_copy(stream->codecpar, m_parameters[i]) < 0) {
+            avformat_free_context(output);
+            return false;
+        }
+        stream->time_base = inputTimeBase(static_cast<int>(i));
+    }
+    // 直播流的时间戳通常很大，每个文件都从 0 开始
+    output->avoid_negative_ts = AVFMT_AVOID_NEG_TS_MAKE_ZERO;
+
+    if (!(m_format->flags & AVFMT_NOFILE)) {
+        ret = avio_open(&output->pb, fileName.c_str(), AVIO_FLAG_WRITE);
+        if (ret < 0) {
+            qWarning() << ffmpegError(QString("StreamRecorder: Could not open %1").arg(path), ret);
+            avformat_free_context(output);
+            return false;
+        }
+    }
+
+    // MP4 使用分片写入，录制意外中断时已写入的部分仍可播放
+    AVDictionary* muxerOptions = nullptr;
+    if (std::string(m_format->name).find("mp4") != std::string::npos) {
+        av_dict_set(&muxerOptions, "movflags", "+frag_keyframe+empty_moov+default_base_moof", 0);
+    }
+    ret = avformat_write_header(output, &muxerOptions);
+    av_dict_free(&muxerOptions);
+    if (ret < 0) {
+        qWarning() << ffmpegError(QString("StreamRecorder: Could not write header to %1").arg(path), ret);
+        if (!(m_format->flags & AVFMT_NOFILE)) {
+            avio_closep(&output->pb);
+        }
+        avformat_free_context(output);
+        return false;
+    }
+
+    m_output = output;
+    m_segmentBytes = 0;
+    ++m_segmentIndex;
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    ++m_statistics.segments;
+    return true;
+}
+
+void StreamRecorder::closeSegment()
+{
+    if (!m_output) {
+        return;
+    }
+    av_write_trailer(m_output);
+    if (!(m_format->flags & AVFMT_NOFILE)) {
+        avio_closep(&m_output->pb);
+    }
+    avformat_free_context(m_output);
+    m_output = nullptr;
+    m_segmentStart = AV_NOPTS_VALUE;
+    m_segmentBytes = 0;
+}
+
+/**
+ * @brief 输出文件路径
+ * 分段录制时为 name_000.ext、name_001.ext ...；不分段时第一个文件使用原路径，
+ * 跳转等原因产生的后续文件从 name_001.ext 开始编号
+ */
+QString StreamRecorder::segmentPath(int index) const
+{
+    const bool segmented = m_options.segmentSeconds > 0.0 || m_options.segmentBytes > 0;
+    if (!segmented && index == 0) {
+        return m_path;
+    }
+    const QFileInfo info(m_path);
+    const QString base = info.path() + "/" + info.completeBaseName();
+    const QString suffix = info.suffix().isEmpty() ? QString() : "." + info.suffix();
+    return QString("%1_%2%3").arg(base).arg(index, 3, 10, QChar('0')).arg(suffix);
+}
+
+} // namespace core
+} // namespace aurorastream
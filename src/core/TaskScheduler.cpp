@@ -0,0 +1,299 @@
+/********************************************************************************
+ * @file   : TaskScheduler.cpp
+ * @brief  : 实现了 aurorastream::core::TaskScheduler 和 TaskGroup 类。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/TaskScheduler.h"
+#include "aurorastream/utils/Tracer.h"
+
+#include <QtCore/QDebug>
+
+#include <chrono>
+#include <string>
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+// 当前线程所属的线程池及其工作线程编号
+thread_local TaskScheduler* t_scheduler = nullptr;
+thread_local int t_workerIndex = -1;
+
+constexpr int kPriorityCount = static_cast<int>(TaskScheduler::Priority::Count);
+constexpr auto kIdleRetry = std::chrono::milliseconds(2);
+
+} // namespace
+
+TaskGroup::TaskGroup()
+    : m_state(std::make_shared<State>())
+{
+}
+
+void TaskGroup::wait() const
+{
+    TaskScheduler* scheduler = t_scheduler;
+    if (scheduler) {
+        // 在工作线程上等待：边等边执行其他任务，避免所有工作线程都阻塞
+        while (m_state->pending.load(std::memory_order_acquire) > 0) {
+            if (!scheduler->tryRunOne(t_workerIndex, true)) {
+                std::unique_lock<std::mutex> lock(m_state->mutex);
+                m_state->done.wait_for(lock, kIdleRetry, [this] {
+                    return m_state->pending.load(std::memory_order_acquire) == 0;
+                });
+            }
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    m_state->done.wait(lock, [this] { return m_state->pending.load(std::memory_order_acquire) == 0; });
+}
+
+bool TaskGroup::isBusy() const
+{
+    return m_state->pending.load(std::memory_order_acquire) > 0;
+}
+
+TaskScheduler& TaskScheduler::instance()
+{
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+TaskScheduler::TaskScheduler(int workers)
+{
+#ifdef __linux__
+    // 进程实际可用的 CPU：受 cgroup cpuset、taskset 或容器限制时不一定是 0..N-1
+    std::vector<int> allowedCpus;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &mask)) {
+                allowedCpus.push_back(cpu);
+            }
+        }
+    }
+    const int cores = !allowedCpus.empty()
+        ? static_cast<int>(allowedCpus.size())
+        : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+#else
+    const int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+#endif
+    const int count = workers > 0 ? workers : cores;
+    m_backgroundLimit = std::max(1, count / 2);
+
+    m_workers.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < count; ++i) {
+        m_workers[i]->thread = std::thread(&TaskScheduler::workerLoop, this, i);
+
+#ifdef __linux__
+        const std::string name = "aurora-w" + std::to_string(i);
+        pthread_setname_np(m_workers[i]->thread.native_handle(), name.c_str());
+        if (count <= static_cast<int>(allowedCpus.size())) {
+            // 每个工作线程固定在一个可用核心上，使队列中的数据留在该核心的缓存里
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(allowedCpus[i], &cpus);
+            pthread_setaffinity_np(m_workers[i]->thread.native_handle(), sizeof(cpus), &cpus);
+        }
+#endif
+    }
+
+    qDebug() << "TaskScheduler: Started" << count << "workers.";
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wakeup.notify_all();
+    for (const std::unique_ptr<Worker>& worker : m_workers) {
+        worker->thread.join();
+    }
+}
+
+void TaskScheduler::submit(Priority priority, std::function<void()> task, const TaskGroup* group, int affinity)
+{
+    Task entry;
+    entry.function = std::move(task);
+    entry.priority = priority;
+    if (group) {
+        entry.group = group->m_state;
+        entry.group->pending.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    // 选择工作线程：亲和提示 > 当前工作线程 > 轮询
+    const int count = static_cast<int>(m_workers.size());
+    int index;
+    if (affinity >= 0) {
+        index = affinity % count;
+    } else if (t_scheduler == this) {
+        index = t_workerIndex;
+    } else {
+        index = static_cast<int>(m_nextWorker.fetch_add(1, std::memory_order_relaxed) % count);
+    }
+
+    m_queued.fetch_add(1, std::memory_order_release);
+    {
+        Worker& worker = *m_workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.queues[static_cast<int>(priority)].push_back(std::move(entry));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_wakeupEpoch.fetch_add(1, std::memory_order_release);
+    }
+    m_wakeup.notify_one();
+}
+
+int TaskScheduler::workerCount() const
+{
+    return static_cast<int>(m_workers.size());
+}
+
+bool TaskScheduler::isWorkerThread() const
+{
+    return t_scheduler == this;
+}
+
+TaskScheduler::Statistics TaskScheduler::getStatistics() const
+{
+    Statistics statistics;
+    statistics.workers = static_cast<int>(m_workers.size());
+    statistics.executed = m_executed.load(std::memory_order_relaxed);
+    statistics.stolen = m_stolen.load(std::memory_order_relaxed);
+    statistics.queued = m_queued.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+void TaskScheduler::workerLoop(int index)
+{
+    t_scheduler = this;
+    t_workerIndex = index;
+    utils::Tracer::setThreadName("aurora-w" + std::to_string(index));
+
+    for (;;) {
+        // 先记下唤醒计数再取任务：取任务失败之后才提交的任务或结束的后台任务
+        // 一定会改变计数，不会丢失唤醒
+        const uint64_t epoch = m_wakeupEpoch.load(std::memory_order_acquire);
+        if (tryRunOne(index)) {
+            continue;
+        }
+
+        // 没有可执行的任务（队列为空，或只剩已达上限的后台任务）时一直阻塞，
+        // 直到有新任务提交或有后台任务结束
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        if (m_stopping && m_queued.load(std::memory_order_acquire) == 0) {
+            break;
+        }
+        m_wakeup.wait(lock, [this, epoch] {
+            return (m_stopping && m_queued.load(std::memory_order_acquire) == 0)
+                || m_wakeupEpoch.load(std::memory_order_acquire) != epoch;
+        });
+    }
+
+    t_scheduler = nullptr;
+    t_workerIndex = -1;
+}
+
+bool TaskScheduler::tryRunOne(int index, bool helping)
+{
+    Task task;
+    if (!takeTask(index, helping, task)) {
+        return false;
+    }
+    runTask(task, !helping);
+    return true;
+}
+
+/**
+ * @brief 按优先级从高到低取任务：先取自己的队列尾部，再从其他线程的队列头部窃取
+ * 等待任务组的线程（helping）本身已被占用，执行后台任务不受上限约束，否则可能死锁。
+ * 后台名额只在确实取到任务时占用，因此名额已满时一定有后台任务在执行，
+ * 它结束时会唤醒空闲线程。
+ */
+bool TaskScheduler::takeTask(int index, bool helping, Task& task)
+{
+    const int count = static_cast<int>(m_workers.size());
+    for (int p = 0; p < kPriorityCount; ++p) {
+        const bool background = p == static_cast<int>(Priority::Background) && !helping;
+        if (background && m_backgroundRunning.load(std::memory_order_acquire) >= m_backgroundLimit) {
+            return false;
+        }
+
+        for (int offset = 0; offset < count; ++offset) {
+            Worker& worker = *m_workers[(index + offset) % count];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            std::deque<Task>& queue = worker.queues[p];
+            if (queue.empty()) {
+                continue;
+            }
+            if (background) {
+                int running = m_backgroundRunning.load(std::memory_order_acquire);
+                do {
+                    if (running >= m_backgroundLimit) {
+                        return false;
+                    }
+                } while (!m_backgroundRunning.compare_exchange_weak(running, running + 1, std::memory_order_acq_rel));
+            }
+            if (offset == 0) {
+                task = std::move(queue.back());
+                queue.pop_back();
+            } else {
+                task = std::move(queue.front());
+                queue.pop_front();
+                m_stolen.fetch_add(1, std::memory_order_relaxed);
+            }
+            m_queued.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::runTask(Task& task, bool counted)
+{
+    task.function();
+    task.function = nullptr;   // 捕获的对象在通知等待者之前析构
+    m_executed.fetch_add(1, std::memory_order_relaxed);
+
+    if (counted && task.priority == Priority::Background) {
+        m_backgroundRunning.fetch_sub(1, std::memory_order_acq_rel);
+        // 让出的后台名额交给一个空闲线程；结束时唤醒全部，使它们都能看到队列已空
+        bool stopping;
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_wakeupEpoch.fetch_add(1, std::memory_order_release);
+            stopping = m_stopping;
+        }
+        if (stopping) {
+            m_wakeup.notify_all();
+        } else {
+            m_wakeup.notify_one();
+        }
+    }
+    if (task.group && task.group->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(task.group->mutex);
+        task.group->done.notify_all();
+    }
+}
+
+} // namespace core
+} // namespace aurorastream
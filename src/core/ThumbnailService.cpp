@@ -0,0 +1,700 @@
+/********************************************************************************
+ * @file   : ThumbnailService.cpp
+ * @brief  : 实现了 aurorastream::core::ThumbnailService 和 SpriteSheet 类。
+ *
+ * 精灵图文件格式（本机字节序，只在本机使用）：
+ *   SpriteHeader（64 字节）
+ *   int64 时间戳数组（每个图块一个，毫秒）
+ *   按 64 字节对齐的像素区：rows * tileHeight 行，每行 columns * tileWidth 个 32 位像素
+ *
+ * 一个任务先计算缓存键并尝试映射已有文件；未命中时打开文件确定图块布局，
+ * 把图块按连续区间分段，每段是一个独立的任务（各自打开解复用器和解码器），
+ * 最后完成的一段负责写文件、映射并通知。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/ThumbnailService.h"
+#include "aurorastream/core/ProbeCache.h"
+#include "aurorastream/core/SeekIndex.h"
+#include "aurorastream/core/TaskScheduler.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QDebug>
+#include <QtCore/QFileInfo>
+#include <QtCore/QDateTime>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QCryptographicHash>
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libswscale/swscale.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+struct SpriteHeader {
+    uint32_t magic;
+    uint32_t version;
+    int32_t tileWidth;
+    int32_t tileHeight;
+    int32_t columns;
+    int32_t rows;
+    int32_t count;
+    int32_t reserved0;
+    int64_t interval;
+    int64_t duration;
+    uint32_t stride;
+    uint32_t pixelOffset;
+    uint32_t reserved1[2];
+};
+static_assert(sizeof(SpriteHeader) == 64, "SpriteHeader must stay 64 bytes");
+
+namespace {
+
+constexpr uint32_t kMagic = 0x53545341;    // "ASTS"
+constexpr uint32_t kVersion = 1;
+constexpr int kBytesPerPixel = 4;
+constexpr qint64 kKeyBlockSize = 64 * 1024;
+constexpr int kMaxPacketsPerSeek = 4096;
+
+bool operator==(const ThumbnailService::Options& a, const ThumbnailService::Options& b)
+{
+    return a.interval == b.interval && a.tileWidth == b.tileWidth && a.maxTiles == b.maxTiles && a.columns == b.columns;
+}
+
+/// 限制参数范围，缓存键和内存中的比较都使用规整后的参数
+ThumbnailService::Options normalized(const ThumbnailService::Options& options)
+{
+    ThumbnailService::Options result = options;
+    result.tileWidth = std::max(16, options.tileWidth & ~1);
+    result.maxTiles = std::max(1, options.maxTiles);
+    result.columns = std::max(1, options.columns);
+    result.interval = std::max<int64_t>(1, options.interval);
+    return result;
+}
+
+std::size_t alignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+int64_t steadyMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief 内容缓存键：文件大小、首中尾各 64 KiB 的 SHA-1 和缩略图参数
+ * 只读取 192 KiB，与文件大小无关
+ */
+std::string contentKey(const QString& path, const ThumbnailService::Options& options)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return std::string();
+    }
+    const qint64 size = file.size();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(size));
+    for (const qint64 offset : {qint64(0), std::max<qint64>(0, size / 2 - kKeyBlockSize / 2),
+                                std::max<qint64>(0, size - kKeyBlockSize)}) {
+        if (file.seek(offset)) {
+            hash.addData(file.read(kKeyBlockSize));
+        }
+    }
+    hash.addData(QString("|%1|%2|%3|%4").arg(options.interval).arg(options.tileWidth)
+                     .arg(options.maxTiles).arg(options.columns).toUtf8());
+    return hash.result().toHex().toStdString();
+}
+
+/**
+ * @brief 打开输入并完成探测（优先使用探测缓存），合并离线关键帧索引
+ */
+AVFormatContext* openInput(const std::string& path)
+{
+    AVFormatContext* formatContext = nullptr;
+    if (avformat_open_input(&formatContext, path.c_str(), nullptr, nullptr) < 0) {
+        return nullptr;
+    }
+    if (!ProbeCache::instance().restore(path, formatContext)) {
+        if (avformat_find_stream_info(formatContext, nullptr) < 0) {
+            avformat_close_input(&formatContext);
+            return nullptr;
+        }
+        ProbeCache::instance().store(path, formatContext);
+    }
+    SeekIndex::instance().apply(path, formatContext);
+    return formatContext;
+}
+
+/**
+ * @brief 只解码关键帧的解码器；支持 lowres 的解码器直接输出不小于图块宽度的最小尺寸
+ */
+AVCodecContext* openKeyframeDecoder(const AVStream* stream, int tileWidth)
+{
+    const AVCodec* codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    AVCodecContext* context = codec ? avcodec_alloc_context3(codec) : nullptr;
+    if (!context) {
+        return nullptr;
+    }
+    if (avcodec_parameters_to_context(context, stream->codecpar) < 0) {
+        avcodec_free_context(&context);
+        return nullptr;
+    }
+    // 并行在 GOP 之间进行，单个解码器不再开线程
+    context->thread_count = 1;
+    context->skip_frame = AVDISCARD_NONKEY;
+    context->skip_loop_filter = AVDISCARD_ALL;
+    context->flags2 |= AV_CODEC_FLAG2_FAST;
+
+    int lowres = 0;
+    while (lowres < codec->max_lowres && (stream->codecpar->width >> (lowres + 1)) >= tileWidth) {
+        ++lowres;
+    }
+    context->lowres = lowres;
+
+    if (avcodec_open2(context, codec, nullptr) < 0) {
+        avcodec_free_context(&context);
+        return nullptr;
+    }
+    return context;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// SpriteSheet
+// ---------------------------------------------------------------------------
+
+std::shared_ptr<const SpriteSheet> SpriteSheet::map(const std::string& filePath)
+{
+    auto file = std::make_unique<QFile>(QString::fromStdString(filePath));
+    if (!file->open(QIODevice::ReadOnly) || file->size() < static_cast<qint64>(sizeof(SpriteHeader))) {
+        return nullptr;
+    }
+    const uint8_t* data = file->map(0, file->size());
+    if (!data) {
+        return nullptr;
+    }
+
+    const auto* header = reinterpret_cast<const SpriteHeader*>(data);
+    const uint64_t pixelBytes = static_cast<uint64_t>(header->rows) * header->tileHeight * header->stride;
+    if (header->magic != kMagic || header->version != kVersion || header->count <= 0
+        || header->tileWidth <= 0 || header->tileHeight <= 0 || header->columns <= 0
+        || header->count > static_cast<int64_t>(header->columns) * header->rows
+        || header->stride < static_cast<uint64_t>(header->columns) * header->tileWidth * kBytesPerPixel
+        || header->pixelOffset < sizeof(SpriteHeader) + header->count * sizeof(int64_t)
+        || header->pixelOffset + pixelBytes > static_cast<uint64_t>(file->size())) {
+        return nullptr;
+    }
+
+    std::shared_ptr<SpriteSheet> sheet(new SpriteSheet());
+    sheet->m_data = data;
+    sheet->m_header = header;
+    sheet->m_timestamps = reinterpret_cast<const int64_t*>(data + sizeof(SpriteHeader));
+    sheet->m_file = std::move(file);
+    return sheet;
+}
+
+SpriteSheet::~SpriteSheet()
+{
+    if (m_file && m_data) {
+        m_file->unmap(const_cast<uchar*>(m_data));
+    }
+}
+
+int SpriteSheet::count() const
+{
+    return m_header->count;
+}
+
+int SpriteSheet::tileWidth() const
+{
+    return m_header->tileWidth;
+}
+
+int SpriteSheet::tileHeight() const
+{
+    return m_header->tileHeight;
+}
+
+int SpriteSheet::columns() const
+{
+    return m_header->columns;
+}
+
+int64_t SpriteSheet::interval() const
+{
+    return m_header->interval;
+}
+
+int SpriteSheet::tileAt(int64_t position) const
+{
+    if (m_header->interval <= 0) {
+        return 0;
+    }
+    const int64_t index = (position + m_header->interval / 2) / m_header->interval;
+    return static_cast<int>(std::clamp<int64_t>(index, 0, m_header->count - 1));
+}
+
+const uint8_t* SpriteSheet::tile(int index, int* stride) const
+{
+    if (index < 0 || index >= m_header->count) {
+        return nullptr;
+    }
+    if (stride) {
+        *stride = static_cast<int>(m_header->stride);
+    }
+    const int row = index / m_header->columns;
+    const int column = index % m_header->columns;
+    return m_data + m_header->pixelOffset + static_cast<std::size_t>(row) * m_header->tileHeight * m_header->stride
+         + static_cast<std::size_t>(column) * m_header->tileWidth * kBytesPerPixel;
+}
+
+int64_t SpriteSheet::timestamp(int index) const
+{
+    return index >= 0 && index < m_header->count ? m_timestamps[index] : -1;
+}
+
+// ---------------------------------------------------------------------------
+// ThumbnailService
+// ---------------------------------------------------------------------------
+
+struct ThumbnailService::Job {
+    QString path;
+    std::string localPath;
+    int64_t fileSize = 0;
+    int64_t modifiedTime = 0;
+    Options options;
+    std::atomic<TaskScheduler::Priority> priority {TaskScheduler::Priority::Background};
+    TaskGroup group;
+
+    // 已排队的任务无法改变优先级，提升时按 Interactive 重新提交一份，
+    // 先执行的一份认领工作，另一份直接返回
+    std::atomic<bool> started {false};                  ///< runJob 已被认领
+    std::atomic<bool> chunksReady {false};              ///< 图块分段已确定，可以重新提交
+    int tileCount = 0;
+    int chunkSize = 0;
+    std::unique_ptr<std::atomic<bool>[]> chunkClaimed;  ///< 各分段是否已被认领
+
+    std::string cacheFile;
+    int streamIndex = -1;
+    int64_t streamStart = 0;        ///< 视频流起始时间（流时间基）
+    std::vector<uint8_t> buffer;    ///< 整个精灵图文件的内容
+    SpriteHeader* header = nullptr;
+    std::atomic<int> remainingChunks {0};
+    std::atomic<uint64_t> decoded {0};
+    std::atomic<uint64_t> reused {0};
+};
+
+ThumbnailService& ThumbnailService::instance()
+{
+    static ThumbnailService instance([] {
+        QString base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        if (base.isEmpty()) {
+            base = QDir::tempPath() + "/aurorastream";
+        }
+        return (base + "/thumbnails").toStdString();
+    }());
+    return instance;
+}
+
+ThumbnailService::ThumbnailService(const std::string& directory, QObject* parent)
+    : QObject(parent)
+    , m_directory(directory)
+{
+    if (!QDir().mkpath(QString::fromStdString(m_directory))) {
+        qWarning() << "ThumbnailService: Could not create cache directory:" << QString::fromStdString(m_directory);
+    }
+}
+
+ThumbnailService::~ThumbnailService()
+{
+    // 等待进行中的任务，它们持有 this
+    std::vector<std::shared_ptr<Job>> jobs;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& entry : m_jobs) {
+            jobs.push_back(entry.second);
+        }
+    }
+    for (const auto& job : jobs) {
+        job->group.wait();
+    }
+}
+
+std::string ThumbnailService::directory() const
+{
+    return m_directory;
+}
+
+ThumbnailService::Statistics ThumbnailService::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+std::shared_ptr<const SpriteSheet> ThumbnailService::request(const QString& path, Priority priority,
+                                                             const Options& options)
+{
+    const QFileInfo info(path);
+    if (!info.isFile()) {
+        return nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto found = m_sheets.find(info.absoluteFilePath().toStdString());
+        if (found != m_sheets.end() && found->second.fileSize == info.size()
+            && found->second.modifiedTime == info.lastModified().toMSecsSinceEpoch()
+            && found->second.options == normalized(options)) {
+            return found->second.sheet;
+        }
+    }
+    startJob(info.absoluteFilePath(), priority, options);
+    return nullptr;
+}
+
+std::shared_ptr<const SpriteSheet> ThumbnailService::generate(const QString& path, Priority priority,
+                                                              const Options& options)
+{
+    if (std::shared_ptr<const SpriteSheet> sheet = request(path, priority, options)) {
+        return sheet;
+    }
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto found = m_jobs.find(QFileInfo(path).absoluteFilePath().toStdString());
+        if (found != m_jobs.end()) {
+            job = found->second;
+        }
+    }
+    if (job) {
+        job->group.wait();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto found = m_sheets.find(QFileInfo(path).absoluteFilePath().toStdString());
+    return found != m_sheets.end() && found->second.options == normalized(options) ? found->second.sheet : nullptr;
+}
+
+std::shared_ptr<ThumbnailService::Job> ThumbnailService::startJob(const QString& path, Priority priority,
+                                                                  const Options& options)
+{
+    const QFileInfo info(path);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const std::string key = path.toStdString();
+    const auto running = m_jobs.find(key);
+    if (running != m_jobs.end()) {
+        const std::shared_ptr<Job>& job = running->second;
+        if (priority == Priority::Interactive
+            && job->priority.exchange(TaskScheduler::Priority::Interactive) != TaskScheduler::Priority::Interactive) {
+            // 批量任务正在排队或运行：把还没开始的部分按 Interactive 重新提交
+            if (!job->started.load()) {
+                submitRun(job, TaskScheduler::Priority::Interactive);
+            }
+            if (job->chunksReady.load()) {
+                submitChunks(job, TaskScheduler::Priority::Interactive);
+            }
+        }
+        return job;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->path = path;
+    job->localPath = key;
+    job->fileSize = info.size();
+    job->modifiedTime = info.lastModified().toMSecsSinceEpoch();
+    job->options = normalized(options);
+    job->priority = priority == Priority::Interactive ? TaskScheduler::Priority::Interactive
+                                                      : TaskScheduler::Priority::Background;
+    m_jobs[key] = job;
+
+    submitRun(job, job->priority.load());
+    return job;
+}
+
+void ThumbnailService::submitRun(const std::shared_ptr<Job>& job, TaskScheduler::Priority priority)
+{
+    TaskScheduler::instance().submit(priority, [this, job] {
+        if (!job->started.exchange(true)) {
+            runJob(job);
+        }
+    }, &job->group);
+}
+
+/**
+ * @brief 提交还没有被认领的图块分段
+ * 提升优先级时可能与 runJob 的首次提交重复，重复的一份认领失败后直接返回。
+ */
+void ThumbnailService::submitChunks(const std::shared_ptr<Job>& job, TaskScheduler::Priority priority)
+{
+    for (int chunk = 0, first = 0; first < job->tileCount; ++chunk, first += job->chunkSize) {
+        if (job->chunkClaimed[chunk].load()) {
+            continue;
+        }
+        const int last = std::min(job->tileCount, first + job->chunkSize);
+        TaskScheduler::instance().submit(priority, [this, job, chunk, first, last] {
+            if (!job->chunkClaimed[chunk].exchange(true)) {
+                decodeChunk(job, first, last);
+            }
+        }, &job->group);
+    }
+}
+
+/**
+ * @brief 命中磁盘缓存则直接映射；否则确定图块布局并把图块分段提交解码
+ */
+void ThumbnailService::runJob(const std::shared_ptr<Job>& job)
+{
+    const std::string key = contentKey(job->path, job->options);
+    if (key.empty()) {
+        failJob(job);
+        return;
+    }
+    job->cacheFile = m_directory + "/" + key + ".sprite";
+
+    if (std::shared_ptr<const SpriteSheet> sheet = SpriteSheet::map(job->cacheFile)) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_sheets[job->localPath] = Entry {job->fileSize, job->modifiedTime, job->options, sheet};
+        m_jobs.erase(job->localPath);
+        ++m_statistics.cacheHits;
+    } else {
+        AVFormatContext* formatContext = openInput(job->localPath);
+        const int streamIndex = formatContext
+            ? av_find_best_stream(formatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0) : -1;
+        if (streamIndex < 0
+            || (formatContext->streams[streamIndex]->disposition & AV_DISPOSITION_ATTACHED_PIC)
+            || formatContext->streams[streamIndex]->codecpar->width <= 0) {
+            avformat_close_input(&formatContext);
+            failJob(job);
+            return;
+        }
+
+        const AVStream* stream = formatContext->streams[streamIndex];
+        const AVCodecParameters* par = stream->codecpar;
+        job->streamIndex = streamIndex;
+        job->streamStart = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+
+        int64_t duration = 0;
+        if (formatContext->duration != AV_NOPTS_VALUE) {
+            duration = formatContext->duration / 1000;
+        } else if (stream->duration != AV_NOPTS_VALUE) {
+            duration = av_rescale_q(stream->duration, stream->time_base, AVRational {1, 1000});
+        }
+        avformat_close_input(&formatContext);
+
+        // 图块高度按显示宽高比（考虑像素宽高比）计算，取偶数
+        const Options& options = job->options;
+        const AVRational aspect = par->sample_aspect_ratio.num > 0 ? par->sample_aspect_ratio : AVRational {1, 1};
+        const double displayWidth = par->width * av_q2d(aspect);
+        const int tileHeight = std::max(2, static_cast<int>(options.tileWidth * par->height / displayWidth + 1) & ~1);
+
+        const int64_t interval = std::max<int64_t>({options.interval, (duration + options.maxTiles - 1) / options.maxTiles});
+        const int count = static_cast<int>(std::min<int64_t>(options.maxTiles, duration / interval + 1));
+        const int columns = std::min(options.columns, count);
+        const int rows = (count + columns - 1) / columns;
+        const std::size_t stride = static_cast<std::size_t>(columns) * options.tileWidth * kBytesPerPixel;
+        const std::size_t pixelOffset = alignUp(sizeof(SpriteHeader) + count * sizeof(int64_t), 64);
+
+        job->buffer.assign(pixelOffset + stride * tileHeight * rows, 0);
+        job->header = reinterpret_cast<SpriteHeader*>(job->buffer.data());
+        *job->header = SpriteHeader {kMagic, kVersion, options.tileWidth, tileHeight, columns, rows, count, 0,
+                                     interval, duration, static_cast<uint32_t>(stride),
+                                     static_cast<uint32_t>(pixelOffset), {0, 0}};
+
+        // 每段至少 4 个图块，段数约为工作线程数的两倍
+        const int workers = TaskScheduler::instance().workerCount();
+        const int chunkSize = std::max(4, (count + 2 * workers - 1) / (2 * workers));
+        const int chunks = (count + chunkSize - 1) / chunkSize;
+        job->tileCount = count;
+        job->chunkSize = chunkSize;
+        job->chunkClaimed.reset(new std::atomic<bool>[chunks]);
+        for (int i = 0; i < chunks; ++i) {
+            job->chunkClaimed[i].store(false, std::memory_order_relaxed);
+        }
+        job->remainingChunks.store(chunks);
+        // 先发布分段再读取优先级：与 startJob 中先提升优先级再检查 chunksReady 配对，
+        // 保证提升后的优先级至少被其中一方用上
+        job->chunksReady.store(true);
+        submitChunks(job, job->priority.load());
+        return;
+    }
+
+    emit spriteReady(job->path);
+}
+
+/**
+ * @brief 解码 [first, last) 区间的图块：跳转到目标时间之前的关键帧，只解这一帧并缩放进精灵图
+ */
+void ThumbnailService::decodeChunk(const std::shared_ptr<Job>& job, int first, int last)
+{
+    static Histogram& decodeTime = PerformanceMonitor::instance().histogram("thumbnail.decode_us");
+    static Counter& tilesCounter = PerformanceMonitor::instance().counter("thumbnail.tiles");
+
+    SpriteHeader* header = job->header;
+    int64_t* timestamps = reinterpret_cast<int64_t*>(job->buffer.data() + sizeof(SpriteHeader));
+    uint8_t* pixels = job->buffer.data() + header->pixelOffset;
+    auto tilePointer = [&](int index) {
+        return pixels + static_cast<std::size_t>(index / header->columns) * header->tileHeight * header->stride
+             + static_cast<std::size_t>(index % header->columns) * header->tileWidth * kBytesPerPixel;
+    };
+    for (int i = first; i < last; ++i) {
+        timestamps[i] = -1;
+    }
+
+    AVFormatContext* formatContext = openInput(job->localPath);
+    AVStream* stream = formatContext ? formatContext->streams[job->streamIndex] : nullptr;
+    AVCodecContext* decoder = stream ? openKeyframeDecoder(stream, header->tileWidth) : nullptr;
+    AVPacket* packet = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+    SwsContext* scaler = nullptr;
+    int64_t lastKeyframe = AV_NOPTS_VALUE;
+
+    for (int i = first; decoder && i < last; ++i) {
+        const int64_t target = job->streamStart
+            + av_rescale_q(i * header->interval, AVRational {1, 1000}, stream->time_base);
+        if (av_seek_frame(formatContext, job->streamIndex, target, AVSEEK_FLAG_BACKWARD) < 0) {
+            continue;
+        }
+
+        // 跳转后的第一个视频关键帧
+        bool found = false;
+        for (int n = 0; n < kMaxPacketsPerSeek && av_read_frame(formatContext, packet) >= 0; ++n) {
+            if (packet->stream_index == job->streamIndex && (packet->flags & AV_PKT_FLAG_KEY)) {
+                found = true;
+                break;
+            }
+            av_packet_unref(packet);
+        }
+        if (!found) {
+            continue;
+        }
+
+        const int64_t keyframe = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+        if (keyframe == lastKeyframe && i > first && timestamps[i - 1] >= 0) {
+            // 与上一个图块是同一关键帧（关键帧间隔大于图块间隔），直接复制
+            for (int y = 0; y < header->tileHeight; ++y) {
+                std::memcpy(tilePointer(i) + static_cast<std::size_t>(y) * header->stride,
+                            tilePointer(i - 1) + static_cast<std::size_t>(y) * header->stride,
+                            static_cast<std::size_t>(header->tileWidth) * kBytesPerPixel);
+            }
+            timestamps[i] = timestamps[i - 1];
+            av_packet_unref(packet);
+            job->reused.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        const int64_t start = steadyMicros();
+        // 送入关键帧后立即排空，保证有重排延迟的解码器也输出这一帧
+        int ret = avcodec_send_packet(decoder, packet);
+        av_packet_unref(packet);
+        if (ret >= 0) {
+            avcodec_send_packet(decoder, nullptr);
+            ret = avcodec_receive_frame(decoder, frame);
+        }
+        avcodec_flush_buffers(decoder);
+        if (ret < 0) {
+            continue;
+        }
+
+        scaler = sws_getCachedContext(scaler, frame->width, frame->height, static_cast<AVPixelFormat>(frame->format),
+                                      header->tileWidth, header->tileHeight, AV_PIX_FMT_RGB32,
+                                      SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+        if (scaler) {
+            uint8_t* destination[1] = {tilePointer(i)};
+            const int destinationStride[1] = {static_cast<int>(header->stride)};
+            sws_scale(scaler, frame->data, frame->linesize, 0, frame->height, destination, destinationStride);
+
+            const int64_t pts = frame->best_effort_timestamp != AV_NOPTS_VALUE ? frame->best_effort_timestamp : keyframe;
+            timestamps[i] = std::max<int64_t>(0, av_rescale_q(pts - job->streamStart, stream->time_base, AVRational {1, 1000}));
+            lastKeyframe = keyframe;
+            job->decoded.fetch_add(1, std::memory_order_relaxed);
+            decodeTime.record(steadyMicros() - start);
+        }
+        av_frame_unref(frame);
+    }
+    tilesCounter.add(static_cast<uint64_t>(last - first));
+
+    sws_freeContext(scaler);
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+    avcodec_free_context(&decoder);
+    avformat_close_input(&formatContext);
+
+    if (job->remainingChunks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        finishJob(job);
+    }
+}
+
+/**
+ * @brief 写入缓存文件（临时文件加重命名，保证其他进程不会映射到写了一半的文件）并映射
+ */
+void ThumbnailService::finishJob(const std::shared_ptr<Job>& job)
+{
+    if (job->decoded.load() == 0) {
+        failJob(job);
+        return;
+    }
+
+    const QString target = QString::fromStdString(job->cacheFile);
+    const QString temporary = target + ".tmp";
+    QFile file(temporary);
+    const bool written = file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        && file.write(reinterpret_cast<const char*>(job->buffer.data()), static_cast<qint64>(job->buffer.size()))
+               == static_cast<qint64>(job->buffer.size());
+    file.close();
+    QFile::remove(target);
+    std::shared_ptr<const SpriteSheet> sheet;
+    if (written && QFile::rename(temporary, target)) {
+        sheet = SpriteSheet::map(job->cacheFile);
+    } else {
+        QFile::remove(temporary);
+        qWarning() << "ThumbnailService: Could not write" << target;
+    }
+    if (!sheet) {
+        failJob(job);
+        return;
+    }
+
+    const uint64_t decoded = job->decoded.load();
+    const uint64_t reused = job->reused.load();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_sheets[job->localPath] = Entry {job->fileSize, job->modifiedTime, job->options, sheet};
+        m_jobs.erase(job->localPath);
+        ++m_statistics.sheets;
+        m_statistics.tiles += static_cast<uint64_t>(sheet->count());
+        m_statistics.decodedFrames += decoded;
+        m_statistics.reusedTiles += reused;
+    }
+    std::vector<uint8_t>().swap(job->buffer);
+
+    qDebug() << "ThumbnailService: Generated" << sheet->count() << "tiles for" << job->path << "("
+             << decoded << "keyframes decoded," << reused << "reused)";
+    emit spriteReady(job->path);
+}
+
+void ThumbnailService::failJob(const std::shared_ptr<Job>& job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.erase(job->localPath);
+    }
+    emit spriteFailed(job->path);
+}
+
+} // namespace core
+} // namespace aurorastream
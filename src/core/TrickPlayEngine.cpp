@@ -0,0 +1,159 @@
+/********************************************************************************
+ * @file   : TrickPlayEngine.cpp
+ * @brief  : 实现了 aurorastream::core::TrickPlayEngine 类。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/TrickPlayEngine.h"
+
+#include <QtCore/QDebug>
+
+#include <cmath>
+#include <algorithm>
+
+extern "C" {
+#include <libavutil/error.h>
+#include <libavutil/mathematics.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+TrickPlayEngine::TrickPlayEngine(MediaSource* source, double frameRate)
+    : m_source(source)
+    , m_videoStream(source->videoStream())
+    , m_frameRate(frameRate > 0 ? frameRate : 10.0)
+    , m_savedSkipFrame(source->videoCodecContext()->skip_frame)
+{
+    // 只解码关键帧，音频数据包在解复用层丢弃
+    m_source->videoCodecContext()->skip_frame = AVDISCARD_NONKEY;
+    if (AVStream* audio = m_source->audioStream()) {
+        m_savedAudioDiscard = audio->discard;
+        audio->discard = AVDISCARD_ALL;
+    }
+
+    const int entries = avformat_index_get_entries_count(m_videoStream);
+    for (int i = 0; i < entries; ++i) {
+        const AVIndexEntry* entry = avformat_index_get_entry(m_videoStream, i);
+        if (entry && (entry->flags & AVINDEX_KEYFRAME)) {
+            m_keyframes.push_back(entry->timestamp);
+        }
+    }
+    std::sort(m_keyframes.begin(), m_keyframes.end());
+
+    qDebug() << "TrickPlayEngine: Keyframe-only decoding enabled," << m_keyframes.size() << "indexed keyframes.";
+}
+
+TrickPlayEngine::~TrickPlayEngine()
+{
+    m_source->videoCodecContext()->skip_frame = m_savedSkipFrame;
+    if (AVStream* audio = m_source->audioStream()) {
+        audio->discard = m_savedAudioDiscard;
+    }
+}
+
+void TrickPlayEngine::setRate(double rate)
+{
+    if (rate != 0.0) {
+        m_rate = std::abs(rate);
+    }
+}
+
+double TrickPlayEngine::rate() const
+{
+    return m_rate;
+}
+
+void TrickPlayEngine::reset(qint64 position)
+{
+    m_nextTarget = av_rescale_q(std::max<qint64>(position, 0) * 1000 + m_source->startTime(),
+                                AV_TIME_BASE_Q, m_videoStream->time_base);
+    m_lastPts = AV_NOPTS_VALUE;
+}
+
+int TrickPlayEngine::readFrame(AVFrame* frame)
+{
+    if (m_nextTarget == AV_NOPTS_VALUE) {
+        reset(0);
+    }
+
+    if (!m_keyframes.empty()) {
+        // 选取离目标最近、且晚于上一帧的关键帧
+        auto upper = std::lower_bound(m_keyframes.begin(), m_keyframes.end(), m_nextTarget);
+        auto chosen = upper;
+        if (upper != m_keyframes.begin()) {
+            auto lower = std::prev(upper);
+            const bool lowerUsable = m_lastPts == AV_NOPTS_VALUE || *lower > m_lastPts;
+            if (lowerUsable && (upper == m_keyframes.end() || m_nextTarget - *lower <= *upper - m_nextTarget)) {
+                chosen = lower;
+            }
+        }
+        if (chosen == m_keyframes.end()) {
+            return AVERROR_EOF;
+        }
+
+        int ret = m_source->seekStream(m_videoStream->index, *chosen, AVSEEK_FLAG_BACKWARD);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+
+    int ret = readKeyframe(frame);
+    if (ret < 0) {
+        return ret;
+    }
+
+    // 显示时长按与上一帧之间实际跨过的媒体时长除以速率计算：可用关键帧比步长更远时
+    // 相应延长显示，有效速率保持为 rate，而不是按名义步长把速率抬高
+    const int64_t interval = step();
+    const int64_t advance = m_lastPts != AV_NOPTS_VALUE ? frame->pts - m_lastPts : interval;
+    m_lastPts = frame->pts;
+    m_nextTarget = std::max(frame->pts, m_nextTarget) + interval;
+    frame->duration = std::max<int64_t>(1, std::llround(static_cast<double>(advance) / m_rate));
+    return 0;
+}
+
+qint64 TrickPlayEngine::position() const
+{
+    if (m_lastPts == AV_NOPTS_VALUE) {
+        return 0;
+    }
+    return (av_rescale_q(m_lastPts, m_videoStream->time_base, AV_TIME_BASE_Q) - m_source->startTime()) / 1000;
+}
+
+/**
+ * @brief 每个输出帧对应的媒体时间步长（视频流时间基）
+ */
+int64_t TrickPlayEngine::step() const
+{
+    const double seconds = m_rate / m_frameRate;
+    return std::max<int64_t>(1, av_rescale_q(std::llround(seconds * AV_TIME_BASE), AV_TIME_BASE_Q,
+                                             m_videoStream->time_base));
+}
+
+/**
+ * @brief 读取下一个解码出的关键帧
+ * 没有索引时，早于目标时间的关键帧被丢弃，以保持恒定的时间步长
+ */
+int TrickPlayEngine::readKeyframe(AVFrame* frame)
+{
+    for (;;) {
+        AVMediaType type = AVMEDIA_TYPE_UNKNOWN;
+        int ret = m_source->readFrame(frame, &type);
+        if (ret < 0) {
+            return ret;
+        }
+        if (type != AVMEDIA_TYPE_VIDEO || frame->pts == AV_NOPTS_VALUE
+            || (m_lastPts != AV_NOPTS_VALUE && frame->pts <= m_lastPts)
+            || (m_keyframes.empty() && frame->pts < m_nextTarget)) {
+            av_frame_unref(frame);
+            continue;
+        }
+        return 0;
+    }
+}
+
+} // namespace core
+} // namespace aurorastream
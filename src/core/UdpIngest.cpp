@@ -0,0 +1,726 @@
+/********************************************************************************
+ * @file   : UdpIngest.cpp
+ * @brief  : 实现了 aurorastream::core::UdpIngest 类。
+ *
+ * 环形缓冲区是单生产者单消费者的：接收线程把 recvmmsg 的 iovec 直接指向
+ * 空闲槽位，收完一批后再发布 m_head；解复用线程在 AVIO 读回调中按顺序
+ * 拷出槽位内容，读完一个槽位才推进 m_tail。数据报边界不需要保留，
+ * 一次读回调可以拷出多个数据报。
+ *
+ * 连续计数器和 PCR 的检查都在接收线程中进行，到达时间取自内核时间戳，
+ * 不受解复用线程调度的影响。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/UdpIngest.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+#include "aurorastream/utils/Tracer.h"
+
+#include <QtCore/QDebug>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <ctime>
+#include <poll.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+extern "C" {
+#include <libavutil/mem.h>
+#include <libavutil/error.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+
+constexpr int kAvioBufferSize = 64 * 1024;      ///< 交给 FFmpeg 的 AVIO 缓冲区大小
+constexpr int kTsPacketSize = 188;
+constexpr int kNullPid = 0x1FFF;
+constexpr int kPidCount = 8192;
+constexpr int64_t kReceiveTimeoutUs = 200000;   ///< 接收线程阻塞的最长时间，决定响应停止的延迟
+constexpr int64_t kRateWindowUs = 1000000;      ///< 包速率和码率的统计窗口
+constexpr int64_t kMaxPcrStepUs = 1000000;      ///< 相邻 PCR 的间隔超过该值（或倒退）视为不连续，不计入抖动
+constexpr int64_t kPcrPeriodUs = (int64_t(1) << 33) * 1000000 / 90000;   ///< 33 位 PCR base 的回绕周期
+
+int64_t nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// 与 SO_TIMESTAMPNS 的内核时间戳同一时钟（CLOCK_REALTIME）的当前时间（微秒）
+int64_t realtimeUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief udp:// 地址拆分结果
+ */
+struct UdpAddress {
+    bool rtp = false;           ///< rtp:// 地址
+    std::string host;
+    int port = 0;
+    bool local = false;         ///< 地址前有 '@'，表示本地绑定地址
+    std::string localAddress;   ///< localaddr 参数：加入组播组使用的网卡地址
+    int bufferSize = 0;         ///< buffer_size 参数（字节）
+    int64_t timeoutUs = -1;     ///< timeout 参数（微秒）
+};
+
+bool parseAddress(const std::string& uri, UdpAddress& address)
+{
+    static const std::string kUdpScheme = "udp://";
+    static const std::string kRtpScheme = "rtp://";
+    address.rtp = uri.compare(0, kRtpScheme.size(), kRtpScheme) == 0;
+    if (!address.rtp && uri.compare(0, kUdpScheme.size(), kUdpScheme) != 0) {
+        return false;
+    }
+    std::string authority = uri.substr(kUdpScheme.size());
+    std::string query;
+    const std::size_t mark = authority.find('?');
+    if (mark != std::string::npos) {
+        query = authority.substr(mark + 1);
+        authority.resize(mark);
+    }
+    if (!authority.empty() && authority.back() == '/') {
+        authority.pop_back();
+    }
+    if (!authority.empty() && authority.front() == '@') {
+        address.local = true;
+        authority.erase(0, 1);
+    }
+    const std::size_t colon = authority.rfind(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+    address.host = authority.substr(0, colon);
+    char* end = nullptr;
+    const long port = std::strtol(authority.c_str() + colon + 1, &end, 10);
+    if (end == authority.c_str() + colon + 1 || *end || port < 0 || port > 65535) {
+        return false;
+    }
+    address.port = static_cast<int>(port);
+
+    std::size_t begin = 0;
+    while (begin < query.size()) {
+        std::size_t next = query.find('&', begin);
+        if (next == std::string::npos) {
+            next = query.size();
+        }
+        const std::string item = query.substr(begin, next - begin);
+        const std::size_t equal = item.find('=');
+        if (equal != std::string::npos) {
+            const std::string key = item.substr(0, equal);
+            const std::string value = item.substr(equal + 1);
+            if (key == "localaddr") {
+                address.localAddress = value;
+            } else if (key == "buffer_size") {
+                address.bufferSize = std::atoi(value.c_str());
+            } else if (key == "timeout") {
+                address.timeoutUs = std::atoll(value.c_str());
+            }
+        }
+        begin = next + 1;
+    }
+    return true;
+}
+
+#if defined(__linux__)
+bool resolveIpv4(const std::string& host, in_addr& result)
+{
+    if (host.empty()) {
+        result.s_addr = htonl(INADDR_ANY);
+        return true;
+    }
+    if (inet_pton(AF_INET, host.c_str(), &result) == 1) {
+        return true;
+    }
+    addrinfo hints {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* list = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &list) != 0 || !list) {
+        return false;
+    }
+    result = reinterpret_cast<const sockaddr_in*>(list->ai_addr)->sin_addr;
+    freeaddrinfo(list);
+    return true;
+}
+#endif
+
+} // namespace
+
+UdpIngest::UdpIngest(const Options& options)
+    : m_options(options)
+    , m_continuity(kPidCount, -1)
+{
+    m_options.batchSize = std::max(1, m_options.batchSize);
+    m_options.ringSize = std::max(m_options.batchSize, m_options.ringSize);
+    m_options.maxDatagramSize = std::max(kTsPacketSize, m_options.maxDatagramSize);
+}
+
+UdpIngest::~UdpIngest()
+{
+    m_stopping = true;
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+    }
+    m_dataAvailable.notify_all();
+    if (m_receiver.joinable()) {
+        m_receiver.join();
+    }
+#if defined(__linux__)
+    if (m_socket >= 0) {
+        ::close(m_socket);
+    }
+#endif
+    if (m_avio) {
+        av_freep(&m_avio->buffer);
+        avio_context_free(&m_avio);
+    }
+}
+
+bool UdpIngest::isUdpUrl(const QString& uri)
+{
+    return uri.startsWith("udp://", Qt::CaseInsensitive) || uri.startsWith("rtp://", Qt::CaseInsensitive);
+}
+
+std::unique_ptr<UdpIngest> UdpIngest::create(const QString& uri, const Options& options, QString* errorMessage)
+{
+    AURORASTREAM_TRACE_SCOPE("udp.open", "io");
+
+    auto fail = [errorMessage](const QString& message) {
+        qWarning() << message;
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        return nullptr;
+    };
+
+#if !defined(__linux__)
+    Q_UNUSED(uri);
+    Q_UNUSED(options);
+    return fail("UdpIngest::create() failed. Batched UDP ingest is only supported on Linux.");
+#else
+    std::unique_ptr<UdpIngest> ingest(new UdpIngest(options));
+    QString error;
+    if (!ingest->open(uri.toStdString(), &error)) {
+        return fail("UdpIngest::create() failed. " + error);
+    }
+
+    auto* avioBuffer = static_cast<unsigned char*>(av_malloc(kAvioBufferSize));
+    if (!avioBuffer) {
+        return fail("UdpIngest::create() failed. Could not allocate I/O buffer.");
+    }
+    ingest->m_avio = avio_alloc_context(avioBuffer, kAvioBufferSize, 0, ingest.get(), &UdpIngest::readPacket,
+                                       nullptr, nullptr);
+    if (!ingest->m_avio) {
+        av_free(avioBuffer);
+        return fail("UdpIngest::create() failed. Could not allocate I/O context.");
+    }
+    ingest->m_avio->seekable = 0;
+
+    const std::size_t slotCount = static_cast<std::size_t>(ingest->m_options.ringSize);
+    const std::size_t slotSize = static_cast<std::size_t>(ingest->m_options.maxDatagramSize);
+    ingest->m_ring.resize(slotCount * slotSize);
+    ingest->m_sizes.resize(slotCount, 0);
+    ingest->m_scratch.resize(static_cast<std::size_t>(ingest->m_options.batchSize) * slotSize);
+    ingest->m_lastArrival = nowUs();
+    ingest->m_receiver = std::thread(&UdpIngest::receiveLoop, ingest.get());
+    return ingest;
+#endif
+}
+
+/**
+ * @brief 创建并绑定套接字；组播地址绑定到组地址并加入该组，
+ *        '@' 开头或为空的地址作为本地绑定地址，其他单播地址视为发送端，绑定到任意地址
+ */
+bool UdpIngest::open(const std::string& uri, QString* errorMessage)
+{
+#if !defined(__linux__)
+    Q_UNUSED(uri);
+    *errorMessage = "Not supported on this platform.";
+    return false;
+#else
+    UdpAddress address;
+    if (!parseAddress(uri, address)) {
+        *errorMessage = QString("Invalid UDP address: %1").arg(QString::fromStdString(uri));
+        return false;
+    }
+    if (address.bufferSize > 0) {
+        m_options.receiveBufferSize = address.bufferSize;
+    }
+    if (address.timeoutUs >= 0) {
+        m_options.timeoutSeconds = static_cast<double>(address.timeoutUs) / 1e6;
+    }
+    if (address.rtp) {
+        RtpJitterBuffer::Options jitterOptions = m_options.jitterBuffer;
+        jitterOptions.maxPacketSize = m_options.maxDatagramSize;
+        m_jitterBuffer = std::make_unique<RtpJitterBuffer>(jitterOptions, [this](const uint8_t* data, int size) {
+            deliver(data, size);
+        });
+    }
+
+    in_addr host {};
+    if (!resolveIpv4(address.host, host)) {
+        *errorMessage = QString("Could not resolve %1 (only IPv4 is supported).").arg(QString::fromStdString(address.host));
+        return false;
+    }
+    const bool multicast = IN_MULTICAST(ntohl(host.s_addr));
+
+    m_socket = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (m_socket < 0) {
+        *errorMessage = QString("socket() failed: %1").arg(std::strerror(errno));
+        return false;
+    }
+    const int enable = 1;
+    setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    if (m_options.receiveBufferSize > 0) {
+        // SO_RCVBUFFORCE 需要 CAP_NET_ADMIN，没有权限时退回受 net.core.rmem_max 限制的 SO_RCVBUF
+        const int size = m_options.receiveBufferSize;
+        if (setsockopt(m_socket, SOL_SOCKET, SO_RCVBUFFORCE, &size, sizeof(size)) < 0) {
+            setsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+        }
+    }
+    if (setsockopt(m_socket, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) < 0) {
+        qWarning() << "UdpIngest: SO_TIMESTAMPNS is not available, using user-space arrival times.";
+    }
+    setsockopt(m_socket, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable));
+    const timeval timeout {0, static_cast<suseconds_t>(kReceiveTimeoutUs)};
+    setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    sockaddr_in local {};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(static_cast<uint16_t>(address.port));
+    local.sin_addr.s_addr = (multicast || address.local) ? host.s_addr : htonl(INADDR_ANY);
+    if (::bind(m_socket, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) < 0) {
+        *errorMessage = QString("bind() to port %1 failed: %2").arg(address.port).arg(std::strerror(errno));
+        return false;
+    }
+    socklen_t length = sizeof(local);
+    if (getsockname(m_socket, reinterpret_cast<sockaddr*>(&local), &length) == 0) {
+        m_port = ntohs(local.sin_port);
+    }
+
+    if (multicast) {
+        ip_mreq membership {};
+        membership.imr_multiaddr = host;
+        membership.imr_interface.s_addr = htonl(INADDR_ANY);
+        if (!address.localAddress.empty() && inet_pton(AF_INET, address.localAddress.c_str(), &membership.imr_interface) != 1) {
+            *errorMessage = QString("Invalid localaddr: %1").arg(QString::fromStdString(address.localAddress));
+            return false;
+        }
+        if (setsockopt(m_socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0) {
+            *errorMessage = QString("Could not join multicast group %1: %2")
+                                .arg(QString::fromStdString(address.host), std::strerror(errno));
+            return false;
+        }
+    }
+    return true;
+#endif
+}
+
+AVIOContext* UdpIngest::avioContext() const
+{
+    return m_avio;
+}
+
+int UdpIngest::port() const
+{
+    return m_port;
+}
+
+UdpIngest::Statistics UdpIngest::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_statisticsMutex);
+    Statistics statistics = m_statistics;
+    if (m_jitterBuffer) {
+        statistics.rtp = true;
+        statistics.jitterBuffer = m_jitterBuffer->getStatistics();
+    }
+    return statistics;
+}
+
+int UdpIngest::readPacket(void* opaque, uint8_t* buf, int size)
+{
+    return static_cast<UdpIngest*>(opaque)->read(buf, size);
+}
+
+/**
+ * @brief 解复用线程读取：按顺序拷出环形缓冲区中的数据报，没有数据时等待
+ */
+int UdpIngest::read(uint8_t* buf, int size)
+{
+    const std::size_t slotSize = static_cast<std::size_t>(m_options.maxDatagramSize);
+    const uint64_t slotCount = static_cast<uint64_t>(m_options.ringSize);
+
+    for (;;) {
+        int copied = 0;
+        uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        const uint64_t head = m_head.load(std::memory_order_acquire);
+        while (tail != head && copied < size) {
+            const std::size_t index = static_cast<std::size_t>(tail % slotCount);
+            const std::size_t available = m_sizes[index] - m_readOffset;
+            const std::size_t length = std::min(available, static_cast<std::size_t>(size - copied));
+            std::memcpy(buf + copied, m_ring.data() + index * slotSize + m_readOffset, length);
+            copied += static_cast<int>(length);
+            m_readOffset += length;
+            if (m_readOffset == m_sizes[index]) {
+                m_readOffset = 0;
+                m_tail.store(++tail, std::memory_order_release);
+            }
+        }
+        if (copied > 0) {
+            return copied;
+        }
+
+        if (m_stopping) {
+            return AVERROR_EXIT;
+        }
+        if (m_failed) {
+            return AVERROR(EIO);
+        }
+        if (m_options.timeoutSeconds > 0 &&
+            nowUs() - m_lastArrival.load() > static_cast<int64_t>(m_options.timeoutSeconds * 1e6)) {
+            return AVERROR_EOF;
+        }
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_dataAvailable.wait_for(lock, std::chrono::milliseconds(100), [this, tail] {
+            return m_stopping || m_failed || m_head.load(std::memory_order_acquire) != tail;
+        });
+    }
+}
+
+/**
+ * @brief 接收线程：recvmmsg 批量接收到环形缓冲区的空闲槽位，缓冲区已满时收进临时缓冲并丢弃，
+ *        保证套接字接收队列始终被及时清空。RTP 时收进临时缓冲，经抖动缓冲重排后在放出时间写入环形缓冲区
+ */
+void UdpIngest::receiveLoop()
+{
+#if defined(__linux__)
+    static PerformanceMonitor& monitor = PerformanceMonitor::instance();
+    static Counter& datagramCounter = monitor.counter("udp.datagrams");
+    static Counter& byteCounter = monitor.counter("udp.bytes");
+    static Counter& overflowCounter = monitor.counter("udp.ring_overflows");
+    static Counter& socketDropCounter = monitor.counter("udp.socket_drops");
+    static Gauge& ringFill = monitor.gauge("udp.ring_fill");
+
+    const bool rtp = m_jitterBuffer != nullptr;
+    const std::size_t batch = static_cast<std::size_t>(m_options.batchSize);
+    const std::size_t slotCount = static_cast<std::size_t>(m_options.ringSize);
+    const std::size_t slotSize = static_cast<std::size_t>(m_options.maxDatagramSize);
+    constexpr std::size_t kControlSize = CMSG_SPACE(sizeof(timespec)) + CMSG_SPACE(sizeof(uint32_t));
+    constexpr std::size_t kControlWords = (kControlSize + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::vector<mmsghdr> messages(batch);
+    std::vector<iovec> vectors(batch);
+    std::vector<uint64_t> control(batch * kControlWords);   // uint64_t 保证 cmsghdr 的对齐
+
+    while (!m_stopping) {
+        // RTP 时阻塞到套接字可读或下一个包的放出时间
+        if (rtp) {
+            int64_t wait = kReceiveTimeoutUs;
+            {
+                std::lock_guard<std::mutex> lock(m_statisticsMutex);
+                const int64_t deadline = m_jitterBuffer->nextDeadline();
+                if (deadline >= 0) {
+                    wait = std::clamp<int64_t>(deadline - realtimeUs(), 0, kReceiveTimeoutUs);
+                }
+            }
+            pollfd descriptor {m_socket, POLLIN, 0};
+            const timespec timeout {static_cast<time_t>(wait / 1000000), static_cast<long>(wait % 1000000) * 1000};
+            if (ppoll(&descriptor, 1, &timeout, nullptr) <= 0) {
+                playout();
+                continue;
+            }
+        }
+
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+        const uint64_t used = head - m_tail.load(std::memory_order_acquire);
+        const std::size_t index = static_cast<std::size_t>(head % slotCount);
+        // 一批只使用到环形缓冲区末尾为止的连续槽位，回绕留给下一批
+        std::size_t count = std::min({batch, slotCount - static_cast<std::size_t>(used), slotCount - index});
+        const bool discard = !rtp && count == 0;
+        const bool direct = !rtp && !discard;
+        if (!direct) {
+            count = batch;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            vectors[i].iov_base = direct ? m_ring.data() + (index + i) * slotSize : m_scratch.data() + i * slotSize;
+            vectors[i].iov_len = slotSize;
+            msghdr& header = messages[i].msg_hdr;
+            header = msghdr {};
+            header.msg_iov = &vectors[i];
+            header.msg_iovlen = 1;
+            header.msg_control = control.data() + i * kControlWords;
+            header.msg_controllen = kControlWords * sizeof(uint64_t);
+            messages[i].msg_len = 0;
+        }
+
+        const int received = recvmmsg(m_socket, messages.data(), static_cast<unsigned>(count),
+                                      rtp ? MSG_DONTWAIT : MSG_WAITFORONE, nullptr);
+        if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ECONNREFUSED) {
+                continue;
+            }
+            qWarning() << "UdpIngest: recvmmsg() failed:" << std::strerror(errno);
+            m_failed = true;
+            break;
+        }
+        if (received == 0) {
+            continue;
+        }
+
+        timespec fallback {};
+        clock_gettime(CLOCK_REALTIME, &fallback);
+        uint64_t datagrams = 0;
+        uint64_t bytes = 0;
+        uint32_t kernelDrops = 0;
+        bool haveDrops = false;
+        {
+            std::lock_guard<std::mutex> lock(m_statisticsMutex);
+            for (int i = 0; i < received; ++i) {
+                msghdr& header = messages[i].msg_hdr;
+                timespec arrival = fallback;
+                for (cmsghdr* message = CMSG_FIRSTHDR(&header); message; message = CMSG_NXTHDR(&header, message)) {
+                    if (message->cmsg_level != SOL_SOCKET) {
+                        continue;
+                    }
+                    if (message->cmsg_type == SO_TIMESTAMPNS) {
+                        std::memcpy(&arrival, CMSG_DATA(message), sizeof(arrival));
+                    } else if (message->cmsg_type == SO_RXQ_OVFL) {
+                        std::memcpy(&kernelDrops, CMSG_DATA(message), sizeof(kernelDrops));
+                        haveDrops = true;
+                    }
+                }
+                uint32_t length = messages[i].msg_len;
+                if (header.msg_flags & MSG_TRUNC) {
+                    // 比槽位大的数据报只保留槽位大小，TS 已被截断
+                    ++m_statistics.syncErrors;
+                    length = static_cast<uint32_t>(slotSize);
+                }
+                const int64_t arrivalUs = static_cast<int64_t>(arrival.tv_sec) * 1000000 + arrival.tv_nsec / 1000;
+                const auto* data = static_cast<const uint8_t*>(vectors[i].iov_base);
+                if (rtp) {
+                    if (!m_jitterBuffer->push(data, static_cast<int>(length), arrivalUs)) {
+                        ++m_statistics.syncErrors;
+                    }
+                } else {
+                    inspect(data, static_cast<int>(length), arrivalUs);
+                    if (direct) {
+                        m_sizes[index + i] = length;
+                    }
+                }
+                ++datagrams;
+                bytes += length;
+            }
+            m_statistics.datagrams += datagrams;
+            m_statistics.bytes += bytes;
+            ++m_statistics.batches;
+            if (discard) {
+                m_statistics.ringOverflows += datagrams;
+            }
+            if (haveDrops && kernelDrops != m_kernelDrops) {
+                // SO_RXQ_OVFL 是套接字创建以来的累计值
+                socketDropCounter.add(static_cast<uint32_t>(kernelDrops - m_kernelDrops));
+                m_statistics.socketDrops += static_cast<uint32_t>(kernelDrops - m_kernelDrops);
+                m_kernelDrops = kernelDrops;
+            }
+        }
+
+        datagramCounter.add(datagrams);
+        byteCounter.add(bytes);
+        m_lastArrival = nowUs();
+        if (rtp) {
+            playout();
+            continue;
+        }
+        if (discard) {
+            overflowCounter.add(datagrams);
+            continue;
+        }
+        m_head.store(head + static_cast<uint64_t>(received), std::memory_order_release);
+        ringFill.set(static_cast<int64_t>(used) + received);
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+        }
+        m_dataAvailable.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+    }
+    m_dataAvailable.notify_all();
+#endif
+}
+
+/**
+ * @brief 放出抖动缓冲中已到放出时间的包，有新数据时唤醒解复用线程
+ */
+void UdpIngest::playout()
+{
+    const uint64_t head = m_head.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_statisticsMutex);
+        m_jitterBuffer->drain(realtimeUs());
+    }
+    if (m_head.load(std::memory_order_relaxed) != head) {
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+        }
+        m_dataAvailable.notify_one();
+    }
+}
+
+/**
+ * @brief 抖动缓冲放出的 RTP 负载写入环形缓冲区
+ * @note 在接收线程中持有 m_statisticsMutex 时调用
+ */
+void UdpIngest::deliver(const uint8_t* data, int size)
+{
+    static PerformanceMonitor& monitor = PerformanceMonitor::instance();
+    static Counter& overflowCounter = monitor.counter("udp.ring_overflows");
+    static Gauge& ringFill = monitor.gauge("udp.ring_fill");
+
+    const uint64_t slotCount = static_cast<uint64_t>(m_options.ringSize);
+    const uint64_t head = m_head.load(std::memory_order_relaxed);
+    const uint64_t used = head - m_tail.load(std::memory_order_acquire);
+    if (used >= slotCount) {
+        ++m_statistics.ringOverflows;
+        overflowCounter.add(1);
+        return;
+    }
+    const std::size_t index = static_cast<std::size_t>(head % slotCount);
+    const std::size_t slotSize = static_cast<std::size_t>(m_options.maxDatagramSize);
+    const std::size_t length = std::min(static_cast<std::size_t>(size), slotSize);
+    std::memcpy(m_ring.data() + index * slotSize, data, length);
+    m_sizes[index] = static_cast<uint32_t>(length);
+    // 放出后的到达间隔和 PCR 抖动反映的是抖动缓冲之后的残余抖动
+    inspect(data, static_cast<int>(length), realtimeUs());
+    m_head.store(head + 1, std::memory_order_release);
+    ringFill.set(static_cast<int64_t>(used) + 1);
+}
+
+/**
+ * @brief 检查一个数据报中的 TS 包：同步字节、传输错误、连续计数器，并用 PCR 计算到达抖动
+ * @note 在接收线程中持有 m_statisticsMutex 时调用
+ */
+void UdpIngest::inspect(const uint8_t* data, int size, int64_t arrivalUs)
+{
+    static PerformanceMonitor& monitor = PerformanceMonitor::instance();
+    static Counter& ccErrorCounter = monitor.counter("udp.cc_errors");
+    static Counter& lostCounter = monitor.counter("udp.lost_packets");
+    static Counter& packetCounter = monitor.counter("udp.packets");
+    static Gauge& packetRate = monitor.gauge("udp.packet_rate");
+    static Gauge& bitrate = monitor.gauge("udp.bitrate_kbps");
+    static Gauge& jitter = monitor.gauge("udp.jitter_us");
+    static Histogram& arrivalGap = monitor.histogram("udp.arrival_gap_us");
+
+    if (m_previousArrivalUs > 0) {
+        const int64_t gap = arrivalUs - m_previousArrivalUs;
+        arrivalGap.record(gap);
+        m_statistics.maxGapUs = std::max(m_statistics.maxGapUs, gap);
+    }
+    m_previousArrivalUs = arrivalUs;
+
+    if (m_rateWindowStart == 0) {
+        m_rateWindowStart = arrivalUs;
+    }
+    m_rateWindowPackets += static_cast<uint64_t>(size / kTsPacketSize);
+    m_rateWindowBytes += static_cast<uint64_t>(size);
+    const int64_t window = arrivalUs - m_rateWindowStart;
+    if (window >= kRateWindowUs) {
+        m_statistics.packetRate = static_cast<double>(m_rateWindowPackets) * 1e6 / static_cast<double>(window);
+        m_statistics.bitrate = static_cast<double>(m_rateWindowBytes) * 8e6 / static_cast<double>(window);
+        packetRate.set(static_cast<int64_t>(m_statistics.packetRate));
+        bitrate.set(static_cast<int64_t>(m_statistics.bitrate / 1000.0));
+        m_rateWindowStart = arrivalUs;
+        m_rateWindowPackets = 0;
+        m_rateWindowBytes = 0;
+    }
+
+    m_statistics.packets += static_cast<uint64_t>(size / kTsPacketSize);
+    packetCounter.add(static_cast<uint64_t>(size / kTsPacketSize));
+    if (size % kTsPacketSize != 0) {
+        ++m_statistics.syncErrors;
+    }
+    for (int offset = 0; offset + kTsPacketSize <= size; offset += kTsPacketSize) {
+        const uint8_t* packet = data + offset;
+        if (packet[0] != 0x47) {
+            ++m_statistics.syncErrors;
+            continue;
+        }
+        if (packet[1] & 0x80) {
+            ++m_statistics.transportErrors;
+            continue;
+        }
+        const int pid = ((packet[1] & 0x1F) << 8) | packet[2];
+        if (pid == kNullPid) {
+            continue;
+        }
+        const int adaptation = (packet[3] >> 4) & 0x3;
+        const int counter = packet[3] & 0xF;
+        const bool hasAdaptation = (adaptation & 0x2) && packet[4] > 0;
+        const bool discontinuity = hasAdaptation && (packet[5] & 0x80);
+
+        // 连续计数器只在有负载的包上递增；允许一次重复发送；不连续标志处重新开始
+        if (adaptation & 0x1) {
+            const int previous = m_continuity[pid];
+            if (previous >= 0 && !discontinuity && counter != previous) {
+                const int expected = (previous + 1) & 0xF;
+                if (counter != expected) {
+                    const int lost = (counter - expected) & 0xF;
+                    ++m_statistics.ccErrors;
+                    m_statistics.lostPackets += static_cast<uint64_t>(lost);
+                    ccErrorCounter.add(1);
+                    lostCounter.add(static_cast<uint64_t>(lost));
+                }
+            }
+            m_continuity[pid] = static_cast<int8_t>(counter);
+        }
+
+        // PCR：到达间隔与 PCR 间隔之差按 RFC 3550 的方式平滑（增益 1/16）
+        if (hasAdaptation && packet[4] >= 7 && (packet[5] & 0x10)) {
+            if (m_pcrPid < 0) {
+                m_pcrPid = pid;
+            }
+            if (pid != m_pcrPid) {
+                continue;
+            }
+            const uint64_t base = (static_cast<uint64_t>(packet[6]) << 25) | (static_cast<uint64_t>(packet[7]) << 17) |
+                                  (static_cast<uint64_t>(packet[8]) << 9) | (static_cast<uint64_t>(packet[9]) << 1) |
+                                  (packet[10] >> 7);
+            const uint64_t extension = (static_cast<uint64_t>(packet[10] & 0x1) << 8) | packet[11];
+            const int64_t pcrUs = static_cast<int64_t>((base * 300 + extension) / 27);
+            if (m_lastPcrUs >= 0 && !discontinuity) {
+                int64_t step = pcrUs - m_lastPcrUs;
+                if (step < -kPcrPeriodUs / 2) {
+                    step += kPcrPeriodUs;
+                }
+                if (step > 0 && step <= kMaxPcrStepUs) {
+                    const int64_t difference = (arrivalUs - m_lastPcrArrivalUs) - step;
+                    m_statistics.jitterUs += (static_cast<double>(std::abs(difference)) - m_statistics.jitterUs) / 16.0;
+                    jitter.set(static_cast<int64_t>(m_statistics.jitterUs));
+                }
+            }
+            m_lastPcrUs = pcrUs;
+            m_lastPcrArrivalUs = arrivalUs;
+        }
+    }
+}
+
+} // namespace core
+} // namespace aurorastream
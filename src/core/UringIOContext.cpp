@@ -0,0 +1,396 @@
+/********************************************************************************
+ * @file   : UringIOContext.cpp
+ * @brief  : 实现了 aurorastream::core::UringIOContext 类。
+ *
+ * 文件被划分为固定大小的块，预读窗口 [当前块, 当前块 + queueDepth) 中的每个块
+ * 对应一个槽位（slot = block % queueDepth）。读取时只有当游标所在块尚未完成时
+ * 才会阻塞等待，并把等待时间计入 I/O 等待统计。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/core/UringIOContext.h"
+
+#include <QtCore/QDebug>
+
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef AURORASTREAM_HAVE_IO_URING
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <liburing.h>
+#endif
+
+extern "C" {
+#include <libavutil/mem.h>
+#include <libavutil/error.h>
+}
+
+namespace aurorastream {
+namespace core {
+
+namespace {
+constexpr std::size_t kAlignment = 4096;         // O_DIRECT 要求的偏移/长度/缓冲区对齐
+constexpr int kAvioBufferSize = 256 * 1024;      // 交给 FFmpeg 的 AVIO 缓冲区大小
+}
+
+#ifdef AURORASTREAM_HAVE_IO_URING
+
+class UringIOContext::Impl {
+public:
+    enum class SlotState {
+        Idle,
+        InFlight,
+        Ready
+    };
+
+    struct Slot {
+        void* buffer = nullptr;
+        int64_t block = -1;     // 当前槽位承载的块号
+        int result = 0;         // 读结果：字节数或 -errno
+        SlotState state = SlotState::Idle;
+    };
+
+    ~Impl() {
+        if (m_avio) {
+            av_freep(&m_avio->buffer);
+            avio_context_free(&m_avio);
+        }
+        if (m_ringInitialized) {
+            // 等待所有在途请求完成后才能释放缓冲区
+            drainInFlight();
+            io_uring_queue_exit(&m_ring);
+        }
+        for (Slot& slot : m_slots) {
+            std::free(slot.buffer);
+        }
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+
+    bool open(const std::string& path, const Options& options) {
+        m_blockSize = (options.blockSize + kAlignment - 1) / kAlignment * kAlignment;
+        if (m_blockSize == 0) {
+            m_blockSize = kAlignment;
+        }
+        const int depth = options.queueDepth > 0 ? options.queueDepth : 1;
+
+        int flags = O_RDONLY | O_CLOEXEC;
+        if (options.directIO) {
+            m_fd = ::open(path.c_str(), flags | O_DIRECT);
+            if (m_fd < 0) {
+                // 部分文件系统（tmpfs、某些 FUSE）不支持 O_DIRECT，退回到带页缓存的读取
+                qWarning() << "UringIOContext: O_DIRECT not supported, falling back to buffered reads:"
+                           << std::strerror(errno);
+            }
+        }
+        if (m_fd < 0) {
+            m_fd = ::open(path.c_str(), flags);
+        }
+        if (m_fd < 0) {
+            qWarning() << "UringIOContext: Could not open file:" << std::strerror(errno);
+            return false;
+        }
+
+        struct stat st {};
+        if (::fstat(m_fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+            qWarning() << "UringIOContext: Not a regular file, io_uring read-ahead disabled.";
+            return false;
+        }
+        m_fileSize = st.st_size;
+
+        int ret = io_uring_queue_init(static_cast<unsigned>(depth), &m_ring, 0);
+        if (ret < 0) {
+            qWarning() << "UringIOContext: io_uring_queue_init failed:" << std::strerror(-ret);
+            return false;
+        }
+        m_ringInitialized = true;
+
+        m_slots.resize(static_cast<std::size_t>(depth));
+        for (Slot& slot : m_slots) {
+            if (posix_memalign(&slot.buffer, kAlignment, m_blockSize) != 0) {
+                slot.buffer = nullptr;
+                qWarning() << "UringIOContext: Could not allocate aligned read buffer.";
+                return false;
+            }
+        }
+
+        auto* avioBuffer = static_cast<unsigned char*>(av_malloc(kAvioBufferSize));
+        if (!avioBuffer) {
+            return false;
+        }
+        m_avio = avio_alloc_context(avioBuffer, kAvioBufferSize, 0, this,
+                                   &Impl::readPacket, nullptr, &Impl::seek);
+        if (!m_avio) {
+            av_free(avioBuffer);
+            return false;
+        }
+        m_avio->seekable = AVIO_SEEKABLE_NORMAL;
+
+        // 打开时即预读文件头部的窗口
+        fillWindow(0);
+        return true;
+    }
+
+    AVIOContext* avio() const { return m_avio; }
+
+    Statistics getStatistics() const {
+        Statistics stats {};
+        stats.ioWaitTimeUs = m_ioWaitTimeUs.load(std::memory_order_relaxed);
+        stats.bytesRead = m_bytesRead.load(std::memory_order_relaxed);
+        stats.readsSubmitted = m_readsSubmitted.load(std::memory_order_relaxed);
+        stats.readsWaited = m_readsWaited.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    static int readPacket(void* opaque, uint8_t* buf, int size) {
+        return static_cast<Impl*>(opaque)->read(buf, size);
+    }
+
+    static int64_t seek(void* opaque, int64_t offset, int whence) {
+        return static_cast<Impl*>(opaque)->seekTo(offset, whence);
+    }
+
+    int read(uint8_t* buf, int size) {
+        if (m_position >= m_fileSize) {
+            return AVERROR_EOF;
+        }
+
+        const int64_t block = m_position / static_cast<int64_t>(m_blockSize);
+        fillWindow(block);
+
+        Slot& slot = slotFor(block);
+        if (slot.state == SlotState::InFlight) {
+            m_readsWaited.fetch_add(1, std::memory_order_relaxed);
+            waitFor(slot);
+        }
+        if (slot.result < 0) {
+            return AVERROR(-slot.result);
+        }
+
+        const int64_t offsetInBlock = m_position - block * static_cast<int64_t>(m_blockSize);
+        if (offsetInBlock >= slot.result && !completeShortRead(slot, offsetInBlock)) {
+            return AVERROR_EOF;
+        }
+
+        const int64_t available = slot.result - offsetInBlock;
+        const int count = static_cast<int>(std::min<int64_t>(available, size));
+        std::memcpy(buf, static_cast<const uint8_t*>(slot.buffer) + offsetInBlock, count);
+        m_position += count;
+
+        // 游标跨入下一块时推进窗口，保持 queueDepth 个请求在途
+        if (m_position / static_cast<int64_t>(m_blockSize) != block) {
+            fillWindow(m_position / static_cast<int64_t>(m_blockSize));
+        }
+        return count;
+    }
+
+    int64_t seekTo(int64_t offset, int whence) {
+        int64_t target;
+        switch (whence & ~AVSEEK_FORCE) {
+        case AVSEEK_SIZE:
+            return m_fileSize;
+        case SEEK_SET:
+            target = offset;
+            break;
+        case SEEK_CUR:
+            target = m_position + offset;
+            break;
+        case SEEK_END:
+            target = m_fileSize + offset;
+            break;
+        default:
+            return AVERROR(EINVAL);
+        }
+        if (target < 0) {
+            return AVERROR(EINVAL);
+        }
+        // 窗口在下一次读取时按新位置重新填充，已在途且仍在窗口内的请求会被复用
+        m_position = target;
+        return m_position;
+    }
+
+    Slot& slotFor(int64_t block) {
+        return m_slots[static_cast<std::size_t>(block % static_cast<int64_t>(m_slots.size()))];
+    }
+
+    void fillWindow(int64_t firstBlock) {
+        const int64_t lastBlock = (m_fileSize - 1) / static_cast<int64_t>(m_blockSize);
+        bool submitted = false;
+
+        for (int64_t block = firstBlock;
+             block < firstBlock + static_cast<int64_t>(m_slots.size()) && block <= lastBlock; ++block) {
+            Slot& slot = slotFor(block);
+            if (slot.block == block && slot.state != SlotState::Idle) {
+                continue;
+            }
+            if (slot.state == SlotState::InFlight) {
+                // 槽位仍被窗口外的旧请求占用（通常发生在 seek 之后），必须等其完成才能复用缓冲区
+                waitFor(slot);
+            }
+
+            io_uring_sqe* sqe = io_uring_get_sqe(&m_ring);
+            if (!sqe) {
+                break;
+            }
+            io_uring_prep_read(sqe, m_fd, slot.buffer, static_cast<unsigned>(m_blockSize),
+                               static_cast<__u64>(block) * m_blockSize);
+            io_uring_sqe_set_data(sqe, &slot);
+            slot.block = block;
+            slot.result = 0;
+            slot.state = SlotState::InFlight;
+            m_readsSubmitted.fetch_add(1, std::memory_order_relaxed);
+            submitted = true;
+        }
+
+        if (submitted) {
+            io_uring_submit(&m_ring);
+        }
+    }
+
+    void waitFor(Slot& target) {
+        const auto start = std::chrono::steady_clock::now();
+        while (target.state == SlotState::InFlight) {
+            io_uring_cqe* cqe = nullptr;
+            int ret = io_uring_wait_cqe(&m_ring, &cqe);
+            if (ret == -EINTR) {
+                continue;
+            }
+            if (ret < 0) {
+                target.result = ret;
+                target.state = SlotState::Ready;
+                break;
+            }
+            complete(cqe);
+        }
+        const auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        m_ioWaitTimeUs.fetch_add(waited, std::memory_order_relaxed);
+    }
+
+    void complete(io_uring_cqe* cqe) {
+        auto* slot = static_cast<Slot*>(io_uring_cqe_get_data(cqe));
+        if (slot) {
+            slot->result = cqe->res;
+            slot->state = SlotState::Ready;
+            if (cqe->res > 0) {
+                m_bytesRead.fetch_add(static_cast<uint64_t>(cqe->res), std::memory_order_relaxed);
+            }
+        }
+        io_uring_cqe_seen(&m_ring, cqe);
+    }
+
+    /**
+     * @brief 处理读到文件末尾之前的短读
+     * 内核在非 O_DIRECT 下可能返回少于请求长度的数据，此时同步补齐剩余部分。
+     */
+    bool completeShortRead(Slot& slot, int64_t offsetInBlock) {
+        const int64_t blockStart = slot.block * static_cast<int64_t>(m_blockSize);
+        const int64_t wanted = std::min<int64_t>(m_blockSize, m_fileSize - blockStart);
+        while (slot.result < wanted && slot.result <= offsetInBlock) {
+            ssize_t n = ::pread(m_fd, static_cast<uint8_t*>(slot.buffer) + slot.result,
+                                static_cast<std::size_t>(wanted - slot.result), blockStart + slot.result);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            slot.result += static_cast<int>(n);
+            m_bytesRead.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+        }
+        return offsetInBlock < slot.result;
+    }
+
+    void drainInFlight() {
+        for (Slot& slot : m_slots) {
+            if (slot.state == SlotState::InFlight) {
+                waitFor(slot);
+            }
+        }
+    }
+
+    int m_fd = -1;
+    int64_t m_fileSize = 0;
+    int64_t m_position = 0;
+    std::size_t m_blockSize = 0;
+    io_uring m_ring {};
+    bool m_ringInitialized = false;
+    std::vector<Slot> m_slots;
+    AVIOContext* m_avio = nullptr;
+
+    std::atomic<int64_t> m_ioWaitTimeUs {0};
+    std::atomic<uint64_t> m_bytesRead {0};
+    std::atomic<uint64_t> m_readsSubmitted {0};
+    std::atomic<uint64_t> m_readsWaited {0};
+};
+
+#else // !AURORASTREAM_HAVE_IO_URING
+
+class UringIOContext::Impl {
+public:
+    bool open(const std::string&, const Options&) { return false; }
+    AVIOContext* avio() const { return nullptr; }
+    Statistics getStatistics() const { return Statistics {}; }
+};
+
+#endif // AURORASTREAM_HAVE_IO_URING
+
+UringIOContext::UringIOContext() : m_impl(std::make_unique<Impl>()) {}
+
+UringIOContext::~UringIOContext() = default;
+
+std::unique_ptr<UringIOContext> UringIOContext::create(const std::string& path, const Options& options)
+{
+    if (!isAvailable()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<UringIOContext> context(new UringIOContext());
+    if (!context->m_impl->open(path, options)) {
+        return nullptr;
+    }
+    return context;
+}
+
+bool UringIOContext::isAvailable()
+{
+#ifdef AURORASTREAM_HAVE_IO_URING
+    // 容器的 seccomp 策略或旧内核可能禁用 io_uring，只探测一次
+    static const bool available = [] {
+        io_uring ring {};
+        if (io_uring_queue_init(1, &ring, 0) < 0) {
+            qWarning() << "UringIOContext: io_uring is not available on this kernel, using synchronous I/O.";
+            return false;
+        }
+        io_uring_queue_exit(&ring);
+        return true;
+    }();
+    return available;
+#else
+    return false;
+#endif
+}
+
+AVIOContext* UringIOContext::avioContext() const
+{
+    return m_impl->avio();
+}
+
+UringIOContext::Statistics UringIOContext::getStatistics() const
+{
+    return m_impl->getStatistics();
+}
+
+} // namespace core
+} // namespace aurorastream
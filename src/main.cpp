@@ -10,9 +10,16 @@
 
 #include <QApplication>
 #include <QWidget>
+#include <QDir>
+#include <QDebug>
+#include <QShortcut>
+#include <QKeySequence>
 
 #include "AuroraStream/core/MediaPlayer.h"
 #include "AuroraStream/modules/ui/MainWindow.h"
+#include "aurorastream/core/StartupProfiler.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+#include "aurorastream/utils/Tracer.h"
 
 /**
  * @brief 主程序入口
@@ -21,15 +28,65 @@
  * @return 应用程序执行结果
  */
 int main(int argc, char *argv[]) {
+    using aurorastream::core::StartupProfiler;
+    StartupProfiler& profiler = StartupProfiler::instance();
+    profiler.mark(StartupProfiler::Phase::Main);
+
     QApplication app(argc, argv);
+    profiler.mark(StartupProfiler::Phase::Application);
+
+    // 冷启动预算（毫秒），超出时在日志中警告
+    profiler.setBudget(qEnvironmentVariableIntValue("AURORASTREAM_STARTUP_BUDGET_MS"));
 
     // 初始化媒体播放器
     aurorastream::core::MediaPlayer mediaPlayer;
+    profiler.mark(StartupProfiler::Phase::Player);
 
     // 创建主窗口并设置媒体播放器
     aurorastream::modules::ui::MainWindow mainWindow;
     mainWindow.setMediaPlayer(&mediaPlayer);
     mainWindow.show();
 
-    return app.exec();
+    // 跟踪：设置 AURORASTREAM_TRACE=文件 时启动即开始记录；Ctrl+Shift+T 在运行期开关，
+    // 关闭时导出为 Chrome trace-event JSON，退出时仍在记录的也会导出
+    using aurorastream::utils::Tracer;
+    const QString traceFile = qEnvironmentVariable("AURORASTREAM_TRACE",
+                                                   QDir::temp().filePath("aurorastream-trace.json"));
+    if (qEnvironmentVariableIsSet("AURORASTREAM_TRACE")) {
+        Tracer::instance().start();
+    }
+    auto exportTrace = [traceFile] {
+        Tracer::instance().stop();
+        if (Tracer::instance().exportJson(traceFile.toStdString())) {
+            qInfo() << "Trace written to" << traceFile;
+        } else {
+            qWarning() << "Could not write trace to" << traceFile;
+        }
+    };
+    QShortcut traceShortcut(QKeySequence(QStringLiteral("Ctrl+Shift+T")), &mainWindow);
+    QObject::connect(&traceShortcut, &QShortcut::activated, [exportTrace] {
+        if (Tracer::isEnabled()) {
+            exportTrace();
+        } else {
+            Tracer::instance().clear();
+            Tracer::instance().start();
+            qInfo() << "Tracing started";
+        }
+    });
+
+    // 性能监控：设置 AURORASTREAM_METRICS=文件 时按 AURORASTREAM_METRICS_INTERVAL_MS（默认 1000）
+    // 采样并重写 JSON 快照；只设置间隔时只发出 metricsUpdated，不写文件
+    using aurorastream::core::PerformanceMonitor;
+    const int metricsInterval = qEnvironmentVariableIntValue("AURORASTREAM_METRICS_INTERVAL_MS");
+    if (qEnvironmentVariableIsSet("AURORASTREAM_METRICS") || metricsInterval > 0) {
+        PerformanceMonitor::instance().setSnapshotFile(qEnvironmentVariable("AURORASTREAM_METRICS"));
+        PerformanceMonitor::instance().startMonitoring(metricsInterval > 0 ? metricsInterval : 1000);
+    }
+
+    const int result = app.exec();
+    PerformanceMonitor::instance().stopMonitoring();
+    if (Tracer::isEnabled()) {
+        exportTrace();
+    }
+    return result;
 }
\ No newline at end of file
@@ -0,0 +1,265 @@
+/********************************************************************************
+ * @file   : LoudnessAnalyzer.cpp
+ * @brief  : 实现 AuroraStream 后台响度分析（LoudnessAnalyzer）。
+ *
+ * 解码器输出交错 float 时直接送入 LoudnessMeter，其他样本格式经 swresample
+ * 转为交错 float（采样率和声道布局不变）。声道权重按声道布局确定：
+ * LFE 不计入，侧/后环绕声道为 1.41，其余为 1.0。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/modules/media/audio/LoudnessAnalyzer.h"
+#include "aurorastream/modules/media/audio/LoudnessMeter.h"
+#include "aurorastream/modules/media/decoder/Decoder.h"
+#include "aurorastream/core/MediaLibrary.h"
+#include "aurorastream/core/ProbeCache.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+
+#include <QtCore/QDebug>
+
+#include <cmath>
+#include <chrono>
+#include <vector>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libswresample/swresample.h>
+}
+
+namespace aurorastream {
+namespace modules {
+namespace media {
+namespace audio {
+
+namespace {
+
+/// BS.1770 声道权重，布局未知时返回空（由 LoudnessMeter 按声道数取默认值）
+std::vector<float> channelWeights(const AVChannelLayout& layout)
+{
+    std::vector<float> weights;
+    if (layout.order == AV_CHANNEL_ORDER_UNSPEC) {
+        return weights;
+    }
+    for (int i = 0; i < layout.nb_channels; ++i) {
+        switch (av_channel_layout_channel_from_index(&layout, i)) {
+        case AV_CHAN_LOW_FREQUENCY:
+        case AV_CHAN_LOW_FREQUENCY_2:
+            weights.push_back(0.0f);
+            break;
+        case AV_CHAN_SIDE_LEFT:
+        case AV_CHAN_SIDE_RIGHT:
+        case AV_CHAN_BACK_LEFT:
+        case AV_CHAN_BACK_RIGHT:
+            weights.push_back(1.41f);
+            break;
+        default:
+            weights.push_back(1.0f);
+            break;
+        }
+    }
+    return weights;
+}
+
+} // namespace
+
+LoudnessAnalyzer& LoudnessAnalyzer::instance()
+{
+    static LoudnessAnalyzer instance(core::MediaLibrary::instance());
+    return instance;
+}
+
+LoudnessAnalyzer::LoudnessAnalyzer(core::MediaLibrary& library)
+    : m_library(library)
+{
+}
+
+LoudnessAnalyzer::~LoudnessAnalyzer()
+{
+    m_group.wait();
+}
+
+bool LoudnessAnalyzer::analyze(const std::string& path, Result* result)
+{
+    AVFormatContext* formatContext = nullptr;
+    if (avformat_open_input(&formatContext, path.c_str(), nullptr, nullptr) < 0) {
+        return false;
+    }
+    if (!core::ProbeCache::instance().restore(path, formatContext)) {
+        if (avformat_find_stream_info(formatContext, nullptr) < 0) {
+            avformat_close_input(&formatContext);
+            return false;
+        }
+        core::ProbeCache::instance().store(path, formatContext);
+    }
+    const int streamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    if (streamIndex < 0) {
+        avformat_close_input(&formatContext);
+        return false;
+    }
+    // 只读取音频流的数据包
+    for (unsigned i = 0; i < formatContext->nb_streams; ++i) {
+        if (static_cast<int>(i) != streamIndex) {
+            formatContext->streams[i]->discard = AVDISCARD_ALL;
+        }
+    }
+
+    decoder::Decoder decoder(decoder::Decoder::Type::AUDIO);
+    if (!decoder.init(formatContext->streams[streamIndex]->codecpar)) {
+        avformat_close_input(&formatContext);
+        return false;
+    }
+
+    LoudnessMeter meter;
+    int sampleRate = 0;
+    SwrContext* resampler = nullptr;
+    std::vector<float> converted;
+    AVPacket* packet = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+    bool ok = true;
+
+    auto consume = [&](AVFrame* decoded) {
+        const int channels = decoded->ch_layout.nb_channels;
+        if (channels <= 0 || decoded->nb_samples <= 0) {
+            return;
+        }
+        if (sampleRate == 0) {
+            // 以第一帧的实际参数初始化（HE-AAC 等格式的 codecpar 可能与输出不一致）
+            if (!meter.init(decoded->sample_rate, channels, channelWeights(decoded->ch_layout))
+                && !meter.init(decoded->sample_rate, channels)) {
+                ok = false;
+                return;
+            }
+            sampleRate = decoded->sample_rate;
+        }
+        const auto format = static_cast<AVSampleFormat>(decoded->format);
+        if (format == AV_SAMPLE_FMT_FLT) {
+            meter.process(reinterpret_cast<const float*>(decoded->extended_data[0]), decoded->nb_samples);
+            return;
+        }
+        if (!resampler) {
+            if (swr_alloc_set_opts2(&resampler, &decoded->ch_layout, AV_SAMPLE_FMT_FLT, decoded->sample_rate,
+                                    &decoded->ch_layout, format, decoded->sample_rate, 0, nullptr) < 0
+                || swr_init(resampler) < 0) {
+                swr_free(&resampler);
+                ok = false;
+                return;
+            }
+        }
+        converted.resize(static_cast<std::size_t>(decoded->nb_samples) * channels);
+        uint8_t* output = reinterpret_cast<uint8_t*>(converted.data());
+        const int count = swr_convert(resampler, &output, decoded->nb_samples,
+                                      const_cast<const uint8_t**>(decoded->extended_data), decoded->nb_samples);
+        if (count > 0) {
+            meter.process(converted.data(), count);
+        }
+    };
+
+    while (ok && av_read_frame(formatContext, packet) >= 0) {
+        if (packet->stream_index == streamIndex && decoder.sendPacket(packet)) {
+            while (ok && decoder.receiveFrame(frame)) {
+                consume(frame);
+                av_frame_unref(frame);
+            }
+        }
+        av_packet_unref(packet);
+    }
+    if (ok && decoder.sendPacket(nullptr)) {
+        while (ok && decoder.receiveFrame(frame)) {
+            consume(frame);
+            av_frame_unref(frame);
+        }
+    }
+
+    swr_free(&resampler);
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+    avformat_close_input(&formatContext);
+
+    if (!ok || meter.frames() == 0) {
+        return false;
+    }
+    if (result) {
+        result->loudness = meter.integratedLoudness();
+        result->truePeak = meter.truePeak();
+        result->frames = meter.frames();
+        result->sampleRate = sampleRate;
+    }
+    return true;
+}
+
+void LoudnessAnalyzer::request(const std::string& path)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_pending.insert(path).second) {
+            return;
+        }
+    }
+    core::TaskScheduler::instance().submit(core::TaskScheduler::Priority::Background,
+                                           [this, path] { run(path); }, &m_group);
+}
+
+int LoudnessAnalyzer::analyzeLibrary()
+{
+    const std::vector<std::string> paths = m_library.withoutLoudness(-1);
+    for (const std::string& path : paths) {
+        request(path);
+    }
+    return static_cast<int>(paths.size());
+}
+
+void LoudnessAnalyzer::wait()
+{
+    m_group.wait();
+}
+
+LoudnessAnalyzer::Statistics LoudnessAnalyzer::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+void LoudnessAnalyzer::run(const std::string& path)
+{
+    static core::Histogram& analyzeTime = core::PerformanceMonitor::instance().histogram("loudness.analyze_us");
+    static core::Counter& analyzedCounter = core::PerformanceMonitor::instance().counter("loudness.files");
+
+    const auto started = std::chrono::steady_clock::now();
+    Result result;
+    const bool ok = analyze(path, &result);
+    const auto elapsed = std::chrono::steady_clock::now() - started;
+    analyzeTime.record(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+    // 静音文件没有有效的综合响度，记为绝对门限，避免每次都重新分析
+    if (ok) {
+        analyzedCounter.add();
+        const double loudness = std::isfinite(result.loudness) ? result.loudness : -70.0;
+        const double truePeak = std::isfinite(result.truePeak) ? result.truePeak : -70.0;
+        if (!m_library.setLoudness(path, loudness, truePeak)) {
+            // 不在媒体库中的文件（直接打开播放的）保存到探测缓存
+            core::ProbeCache::instance().storeLoudness(path, loudness, truePeak);
+        }
+    } else {
+        qWarning() << "LoudnessAnalyzer: Could not analyze" << QString::fromStdString(path);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.erase(path);
+    if (ok) {
+        ++m_statistics.analyzed;
+        if (result.sampleRate > 0) {
+            m_statistics.audioSeconds += static_cast<double>(result.frames) / result.sampleRate;
+        }
+    } else {
+        ++m_statistics.failed;
+    }
+    m_statistics.busySeconds += std::chrono::duration<double>(elapsed).count();
+}
+
+} // namespace audio
+} // namespace media
+} // namespace modules
+} // namespace aurorastream
@@ -0,0 +1,323 @@
+/********************************************************************************
+ * @file   : TimeStretcher.cpp
+ * @brief  : 实现 AuroraStream 音频时间伸缩模块（WSOLA）。
+ *
+ * 每次迭代从输入中取出一段长度为 sequence 的片段输出，片段开头的 overlap
+ * 部分与上一段的结尾交叉淡化。下一段在输入中的名义位置前进 rate × (sequence - overlap)，
+ * 再在 search 范围内寻找与上一段结尾最相似（归一化互相关最大）的位置，
+ * 以避免拼接处的相位跳变。搜索先以 4 帧步长粗搜，再在最佳位置附近逐帧细搜，
+ * 使每次迭代的计算量与搜索范围近似无关。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/modules/media/audio/TimeStretcher.h"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace aurorastream {
+namespace modules {
+namespace media {
+namespace audio {
+
+namespace {
+
+constexpr int kCoarseStep = 4;
+
+/// 点积，SIMD 实现
+float dotProduct(const float* a, const float* b, size_t count)
+{
+    size_t i = 0;
+    float sum = 0.0f;
+#if defined(__AVX__)
+    __m256 acc = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    }
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+    sum = _mm_cvtss_f32(half);
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    sum = _mm_cvtss_f32(acc);
+#elif defined(__ARM_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4) {
+        acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+    sum = vgetq_lane_f32(acc, 0) + vgetq_lane_f32(acc, 1) + vgetq_lane_f32(acc, 2) + vgetq_lane_f32(acc, 3);
+#endif
+    for (; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+} // namespace
+
+class TimeStretcher::Impl {
+public:
+    bool init(int sampleRate, int channels, const Options& options) {
+        if (sampleRate <= 0 || channels <= 0) {
+            return false;
+        }
+        channels_ = channels;
+        sequence_ = std::max(16, sampleRate * options.sequenceMs / 1000);
+        overlap_ = std::clamp(sampleRate * options.overlapMs / 1000, 8, sequence_ / 2);
+        search_ = std::max(kCoarseStep, sampleRate * options.searchMs / 1000);
+
+        // 线性交叉淡化
+        fadeIn_.resize(overlap_);
+        for (int i = 0; i < overlap_; ++i) {
+            fadeIn_[i] = (i + 0.5f) / overlap_;
+        }
+        reset();
+        return true;
+    }
+
+    void reset() {
+        input_.clear();
+        inputPos_ = 0;
+        segmentEnd_ = 0;
+        skipFraction_ = 0.0;
+        overlapTail_.clear();
+        primed_ = false;
+    }
+
+    bool isBypassed() const {
+        return rate_ == 1.0 && !primed_ && input_.empty();
+    }
+
+    void process(const float* input, int frames, std::vector<float>& output) {
+        if (channels_ == 0 || frames <= 0) {
+            return;
+        }
+
+        // 1.0 倍速：先输出残留样本，之后直接透传
+        if (rate_ == 1.0) {
+            if (!isBypassed()) {
+                flush(output);
+            }
+            output.insert(output.end(), input, input + static_cast<size_t>(frames) * channels_);
+            return;
+        }
+
+        input_.insert(input_.end(), input, input + static_cast<size_t>(frames) * channels_);
+
+        const size_t required = static_cast<size_t>(search_ + sequence_);
+        while (availableFrames() >= required) {
+            const float* base = input_.data() + inputPos_ * channels_;
+            const int offset = primed_ ? bestOffset(base) : 0;
+            const float* segment = base + static_cast<size_t>(offset) * channels_;
+            const size_t tailStart = static_cast<size_t>(sequence_ - overlap_) * channels_;
+
+            size_t copyStart = 0;
+            if (primed_) {
+                for (int i = 0; i < overlap_; ++i) {
+                    const float in = fadeIn_[i];
+                    const float out = 1.0f - in;
+                    for (int ch = 0; ch < channels_; ++ch) {
+                        const size_t k = static_cast<size_t>(i) * channels_ + ch;
+                        output.push_back(overlapTail_[k] * out + segment[k] * in);
+                    }
+                }
+                copyStart = static_cast<size_t>(overlap_) * channels_;
+            }
+            output.insert(output.end(), segment + copyStart, segment + tailStart);
+            overlapTail_.assign(segment + tailStart, segment + static_cast<size_t>(sequence_) * channels_);
+            segmentEnd_ = inputPos_ + offset + sequence_;
+            primed_ = true;
+
+            const double advance = rate_ * (sequence_ - overlap_) + skipFraction_;
+            const size_t whole = static_cast<size_t>(advance);
+            skipFraction_ = advance - whole;
+            inputPos_ += whole;
+        }
+
+        compact();
+    }
+
+    void flush(std::vector<float>& output) {
+        if (primed_) {
+            output.insert(output.end(), overlapTail_.begin(), overlapTail_.end());
+        }
+        const size_t from = primed_ ? segmentEnd_ : inputPos_;
+        if (from * channels_ < input_.size()) {
+            output.insert(output.end(), input_.begin() + from * channels_, input_.end());
+        }
+        reset();
+    }
+
+    double rate_ {1.0};
+    int channels_ {0};
+    int sequence_ {0};
+    int overlap_ {0};
+    int search_ {0};
+
+private:
+    size_t availableFrames() const {
+        // 高倍速时名义位置可能越过已有的输入
+        const size_t frames = input_.size() / channels_;
+        return frames > inputPos_ ? frames - inputPos_ : 0;
+    }
+
+    /**
+     * @brief 在搜索范围内寻找与上一段结尾最相似的位置
+     * 相似度为归一化互相关，所有声道交错参与计算
+     */
+    int bestOffset(const float* base) const {
+        const size_t length = static_cast<size_t>(overlap_) * channels_;
+        auto score = [&](int offset) {
+            const float* candidate = base + static_cast<size_t>(offset) * channels_;
+            const float energy = dotProduct(candidate, candidate, length);
+            return dotProduct(overlapTail_.data(), candidate, length) / std::sqrt(energy + 1e-9f);
+        };
+
+        int best = 0;
+        float bestScore = -std::numeric_limits<float>::infinity();
+        for (int offset = 0; offset < search_; offset += kCoarseStep) {
+            const float s = score(offset);
+            if (s > bestScore) {
+                bestScore = s;
+                best = offset;
+            }
+        }
+
+        const int coarse = best;
+        for (int offset = std::max(0, coarse - kCoarseStep + 1);
+             offset < std::min(search_, coarse + kCoarseStep); ++offset) {
+            if (offset == coarse) {
+                continue;
+            }
+            const float s = score(offset);
+            if (s > bestScore) {
+                bestScore = s;
+                best = offset;
+            }
+        }
+        return best;
+    }
+
+    /// 丢弃已经不再需要的输入
+    void compact() {
+        const size_t consumed = primed_ ? std::min(inputPos_, segmentEnd_) : inputPos_;
+        if (consumed < static_cast<size_t>(sequence_) * 4) {
+            return;
+        }
+        // 上一段结束位置之前的样本都不会再被访问
+        input_.erase(input_.begin(), input_.begin() + consumed * channels_);
+        inputPos_ -= consumed;
+        segmentEnd_ -= consumed;
+    }
+
+    std::vector<float> input_;          // 待处理的输入（交错）
+    size_t inputPos_ {0};               // 下一段的名义起点（帧）
+    size_t segmentEnd_ {0};             // 上一段在输入中的结束位置（帧）
+    double skipFraction_ {0.0};
+    std::vector<float> overlapTail_;    // 上一段结尾，用于与下一段交叉淡化
+    std::vector<float> fadeIn_;
+    bool primed_ {false};
+};
+
+TimeStretcher::TimeStretcher()
+    : impl_(std::make_unique<Impl>())
+{
+}
+
+TimeStretcher::~TimeStretcher() = default;
+
+bool TimeStretcher::init(int sampleRate, int channels)
+{
+    return impl_->init(sampleRate, channels, Options());
+}
+
+bool TimeStretcher::init(int sampleRate, int channels, const Options& options)
+{
+    return impl_->init(sampleRate, channels, options);
+}
+
+void TimeStretcher::setRate(double rate)
+{
+    impl_->rate_ = std::clamp(rate, 0.25, 4.0);
+}
+
+double TimeStretcher::rate() const
+{
+    return impl_->rate_;
+}
+
+bool TimeStretcher::isBypassed() const
+{
+    return impl_->isBypassed();
+}
+
+void TimeStretcher::process(const float* input, int frames, std::vector<float>& output)
+{
+    impl_->process(input, frames, output);
+}
+
+void TimeStretcher::process(const int16_t* input, int frames, std::vector<int16_t>& output)
+{
+    if (impl_->channels_ == 0 || frames <= 0) {
+        return;
+    }
+
+    const size_t count = static_cast<size_t>(frames) * impl_->channels_;
+    if (isBypassed()) {
+        output.insert(output.end(), input, input + count);
+        return;
+    }
+
+    thread_local std::vector<float> in;
+    thread_local std::vector<float> out;
+    in.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        in[i] = input[i] * (1.0f / 32768.0f);
+    }
+    out.clear();
+    impl_->process(in.data(), frames, out);
+
+    const size_t start = output.size();
+    output.resize(start + out.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+        const float v = std::clamp(out[i] * 32768.0f, -32768.0f, 32767.0f);
+        output[start + i] = static_cast<int16_t>(std::lrint(v));
+    }
+}
+
+void TimeStretcher::flush(std::vector<float>& output)
+{
+    impl_->flush(output);
+}
+
+void TimeStretcher::reset()
+{
+    impl_->reset();
+}
+
+int TimeStretcher::latency() const
+{
+    return impl_->search_ + impl_->sequence_;
+}
+
+} // namespace audio
+} // namespace media
+} // namespace modules
+} // namespace aurorastream
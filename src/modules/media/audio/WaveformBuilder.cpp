@@ -0,0 +1,766 @@
+/********************************************************************************
+ * @file   : WaveformBuilder.cpp
+ * @brief  : 实现 AuroraStream 音频波形概览（Waveform 和 WaveformBuilder）。
+ *
+ * 波形文件格式（本机字节序，只在本机使用）：
+ *   WaveformHeader（64 字节）
+ *   WaveformLevel 数组（每层一个：偏移和区间数）
+ *   各层的 WaveformBin 数组，每层起始按 64 字节对齐
+ *
+ * 生成时把时间轴按区间边界切成若干段，每段是一个独立的任务（各自打开解复用器和
+ * 解码器，跳转到段首后解码到段尾），段内的区间以 float/double 累加，全部完成后
+ * 拼接为第 0 层，再逐级合并、量化并写文件。不可跳转或时长未知的输入只用一段。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/modules/media/audio/WaveformBuilder.h"
+#include "aurorastream/modules/media/decoder/Decoder.h"
+#include "aurorastream/core/ProbeCache.h"
+#include "aurorastream/core/TaskScheduler.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QDebug>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QCryptographicHash>
+
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libswresample/swresample.h>
+}
+
+namespace aurorastream {
+namespace modules {
+namespace media {
+namespace audio {
+
+struct WaveformHeader {
+    uint32_t magic;
+    uint32_t version;
+    int32_t sampleRate;
+    int32_t channels;
+    int32_t binFrames;
+    int32_t levels;
+    int64_t frames;
+    uint32_t reserved[8];
+};
+static_assert(sizeof(WaveformHeader) == 64, "WaveformHeader must stay 64 bytes");
+
+struct WaveformLevel {
+    uint64_t offset;
+    uint64_t count;
+};
+
+namespace {
+
+constexpr uint32_t kMagic = 0x46575341;    // "ASWF"
+constexpr uint32_t kVersion = 1;
+constexpr int kMaxLevels = 48;
+constexpr qint64 kKeyBlockSize = 64 * 1024;
+
+/// 一段样本的最小值、最大值和平方和
+struct Reduction {
+    float min;
+    float max;
+    float sumSquares;
+};
+
+/// 段内累加中的区间
+struct Accumulator {
+    float min = std::numeric_limits<float>::infinity();
+    float max = -std::numeric_limits<float>::infinity();
+    double sumSquares = 0.0;
+    int64_t samples = 0;
+};
+
+/// 合并层级时使用的未量化区间
+struct LevelBin {
+    float min;
+    float max;
+    float meanSquare;
+};
+
+/**
+ * @brief 最小值、最大值和平方和的一次遍历归约，SIMD 实现
+ */
+Reduction reduce(const float* samples, size_t count)
+{
+    size_t i = 0;
+    float minimum = std::numeric_limits<float>::infinity();
+    float maximum = -std::numeric_limits<float>::infinity();
+    float sum = 0.0f;
+#if defined(__AVX__)
+    if (count >= 8) {
+        __m256 vmin = _mm256_set1_ps(minimum);
+        __m256 vmax = _mm256_set1_ps(maximum);
+        __m256 vsum = _mm256_setzero_ps();
+        for (; i + 8 <= count; i += 8) {
+            const __m256 v = _mm256_loadu_ps(samples + i);
+            vmin = _mm256_min_ps(vmin, v);
+            vmax = _mm256_max_ps(vmax, v);
+            vsum = _mm256_add_ps(vsum, _mm256_mul_ps(v, v));
+        }
+        __m128 lo = _mm_min_ps(_mm256_castps256_ps128(vmin), _mm256_extractf128_ps(vmin, 1));
+        lo = _mm_min_ps(lo, _mm_movehl_ps(lo, lo));
+        minimum = _mm_cvtss_f32(_mm_min_ss(lo, _mm_shuffle_ps(lo, lo, 1)));
+        __m128 hi = _mm_max_ps(_mm256_castps256_ps128(vmax), _mm256_extractf128_ps(vmax, 1));
+        hi = _mm_max_ps(hi, _mm_movehl_ps(hi, hi));
+        maximum = _mm_cvtss_f32(_mm_max_ss(hi, _mm_shuffle_ps(hi, hi, 1)));
+        __m128 total = _mm_add_ps(_mm256_castps256_ps128(vsum), _mm256_extractf128_ps(vsum, 1));
+        total = _mm_add_ps(total, _mm_movehl_ps(total, total));
+        sum = _mm_cvtss_f32(_mm_add_ss(total, _mm_shuffle_ps(total, total, 1)));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    if (count >= 4) {
+        __m128 vmin = _mm_set1_ps(minimum);
+        __m128 vmax = _mm_set1_ps(maximum);
+        __m128 vsum = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+            const __m128 v = _mm_loadu_ps(samples + i);
+            vmin = _mm_min_ps(vmin, v);
+            vmax = _mm_max_ps(vmax, v);
+            vsum = _mm_add_ps(vsum, _mm_mul_ps(v, v));
+        }
+        vmin = _mm_min_ps(vmin, _mm_movehl_ps(vmin, vmin));
+        minimum = _mm_cvtss_f32(_mm_min_ss(vmin, _mm_shuffle_ps(vmin, vmin, 1)));
+        vmax = _mm_max_ps(vmax, _mm_movehl_ps(vmax, vmax));
+        maximum = _mm_cvtss_f32(_mm_max_ss(vmax, _mm_shuffle_ps(vmax, vmax, 1)));
+        vsum = _mm_add_ps(vsum, _mm_movehl_ps(vsum, vsum));
+        sum = _mm_cvtss_f32(_mm_add_ss(vsum, _mm_shuffle_ps(vsum, vsum, 1)));
+    }
+#elif defined(__ARM_NEON)
+    if (count >= 4) {
+        float32x4_t vmin = vdupq_n_f32(minimum);
+        float32x4_t vmax = vdupq_n_f32(maximum);
+        float32x4_t vsum = vdupq_n_f32(0.0f);
+        for (; i + 4 <= count; i += 4) {
+            const float32x4_t v = vld1q_f32(samples + i);
+            vmin = vminq_f32(vmin, v);
+            vmax = vmaxq_f32(vmax, v);
+            vsum = vmlaq_f32(vsum, v, v);
+        }
+        float32x2_t lo = vpmin_f32(vget_low_f32(vmin), vget_high_f32(vmin));
+        minimum = vget_lane_f32(vpmin_f32(lo, lo), 0);
+        float32x2_t hi = vpmax_f32(vget_low_f32(vmax), vget_high_f32(vmax));
+        maximum = vget_lane_f32(vpmax_f32(hi, hi), 0);
+        sum = vgetq_lane_f32(vsum, 0) + vgetq_lane_f32(vsum, 1) + vgetq_lane_f32(vsum, 2) + vgetq_lane_f32(vsum, 3);
+    }
+#endif
+    for (; i < count; ++i) {
+        minimum = std::min(minimum, samples[i]);
+        maximum = std::max(maximum, samples[i]);
+        sum += samples[i] * samples[i];
+    }
+    return Reduction {minimum, maximum, sum};
+}
+
+void merge(Accumulator& bin, const Reduction& reduction, size_t samples)
+{
+    bin.min = std::min(bin.min, reduction.min);
+    bin.max = std::max(bin.max, reduction.max);
+    bin.sumSquares += reduction.sumSquares;
+    bin.samples += static_cast<int64_t>(samples);
+}
+
+WaveformOptions normalized(const WaveformOptions& options)
+{
+    WaveformOptions result = options;
+    result.binFrames = std::max(16, options.binFrames);
+    result.segmentSeconds = std::max(10, options.segmentSeconds);
+    return result;
+}
+
+std::size_t alignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+int64_t steadyMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief 内容缓存键：文件大小、首中尾各 64 KiB 的 SHA-1 和区间帧数
+ */
+std::string contentKey(const std::string& path, const WaveformOptions& options)
+{
+    QFile file(QString::fromStdString(path));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return std::string();
+    }
+    const qint64 size = file.size();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(size));
+    for (const qint64 offset : {qint64(0), std::max<qint64>(0, size / 2 - kKeyBlockSize / 2),
+                                std::max<qint64>(0, size - kKeyBlockSize)}) {
+        if (file.seek(offset)) {
+            hash.addData(file.read(kKeyBlockSize));
+        }
+    }
+    hash.addData(QString("|%1").arg(options.binFrames).toUtf8());
+    return hash.result().toHex().toStdString();
+}
+
+/**
+ * @brief 打开输入并定位音频流，其他流在解复用时直接丢弃
+ * @return 没有音频流时返回 nullptr
+ */
+AVFormatContext* openAudioInput(const std::string& path, int* streamIndex)
+{
+    AVFormatContext* formatContext = nullptr;
+    if (avformat_open_input(&formatContext, path.c_str(), nullptr, nullptr) < 0) {
+        return nullptr;
+    }
+    if (!core::ProbeCache::instance().restore(path, formatContext)) {
+        if (avformat_find_stream_info(formatContext, nullptr) < 0) {
+            avformat_close_input(&formatContext);
+            return nullptr;
+        }
+        core::ProbeCache::instance().store(path, formatContext);
+    }
+    *streamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    if (*streamIndex < 0 || formatContext->streams[*streamIndex]->codecpar->sample_rate <= 0) {
+        avformat_close_input(&formatContext);
+        return nullptr;
+    }
+    for (unsigned i = 0; i < formatContext->nb_streams; ++i) {
+        if (static_cast<int>(i) != *streamIndex) {
+            formatContext->streams[i]->discard = AVDISCARD_ALL;
+        }
+    }
+    return formatContext;
+}
+
+/**
+ * @brief 一个时间段的解码结果，bins[0] 对应区间 firstBin
+ */
+struct Segment {
+    int64_t firstBin = 0;
+    int64_t endFrame = std::numeric_limits<int64_t>::max();    ///< 段尾（不含），最后一段解码到文件结束
+    std::vector<Accumulator> bins;
+    int64_t frames = 0;         ///< 实际归约的帧数
+    int64_t endPosition = 0;    ///< 最后一个样本之后的帧位置
+    bool ok = false;
+};
+
+/**
+ * @brief 解码一个时间段并归约为区间
+ * 解码器输出 float 格式时直接在解码缓冲区上归约，其他格式先转换为交错 float
+ */
+void decodeSegment(const std::string& path, int binFrames, Segment& segment)
+{
+    static core::Counter& framesCounter = core::PerformanceMonitor::instance().counter("waveform.frames");
+
+    int streamIndex = -1;
+    AVFormatContext* formatContext = openAudioInput(path, &streamIndex);
+    if (!formatContext) {
+        return;
+    }
+    const AVStream* stream = formatContext->streams[streamIndex];
+    const int sampleRate = stream->codecpar->sample_rate;
+    const AVRational sampleBase {1, sampleRate};
+    const int64_t streamStart = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    const int64_t firstFrame = segment.firstBin * binFrames;
+
+    decoder::Decoder decoder(decoder::Decoder::Type::AUDIO);
+    if (!decoder.init(stream->codecpar)) {
+        avformat_close_input(&formatContext);
+        return;
+    }
+    if (firstFrame > 0) {
+        const int64_t target = streamStart + av_rescale_q(firstFrame, sampleBase, stream->time_base);
+        if (av_seek_frame(formatContext, streamIndex, target, AVSEEK_FLAG_BACKWARD) < 0) {
+            avformat_close_input(&formatContext);
+            return;
+        }
+    }
+
+    AVPacket* packet = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+    SwrContext* resampler = nullptr;
+    std::vector<float> converted;
+    int64_t position = -1;      // 下一个解码样本的帧位置，收到第一帧后确定
+    bool finished = false;
+
+    auto consume = [&](AVFrame* decoded) {
+        const int channels = decoded->ch_layout.nb_channels;
+        if (channels <= 0 || decoded->nb_samples <= 0) {
+            return;
+        }
+        if (position < 0) {
+            // 跳转后第一帧的位置取自时间戳，之后按样本数连续累计
+            const int64_t pts = decoded->best_effort_timestamp;
+            position = firstFrame == 0 || pts == AV_NOPTS_VALUE
+                ? firstFrame : std::max<int64_t>(0, av_rescale_q(pts - streamStart, stream->time_base, sampleBase));
+        }
+        const int64_t frameStart = position;
+        position += decoded->nb_samples;
+        if (frameStart >= segment.endFrame) {
+            finished = true;
+            return;
+        }
+        int64_t begin = std::max<int64_t>(0, firstFrame - frameStart);
+        const int64_t end = std::min<int64_t>(decoded->nb_samples, segment.endFrame - frameStart);
+        if (begin >= end) {
+            return;
+        }
+
+        const float* interleaved = nullptr;
+        const auto format = static_cast<AVSampleFormat>(decoded->format);
+        if (format == AV_SAMPLE_FMT_FLT) {
+            interleaved = reinterpret_cast<const float*>(decoded->extended_data[0]);
+        } else if (format != AV_SAMPLE_FMT_FLTP) {
+            if (!resampler) {
+                if (swr_alloc_set_opts2(&resampler, &decoded->ch_layout, AV_SAMPLE_FMT_FLT, decoded->sample_rate,
+                                        &decoded->ch_layout, format, decoded->sample_rate, 0, nullptr) < 0
+                    || swr_init(resampler) < 0) {
+                    swr_free(&resampler);
+                    finished = true;
+                    return;
+                }
+            }
+            converted.resize(static_cast<std::size_t>(decoded->nb_samples) * channels);
+            uint8_t* output = reinterpret_cast<uint8_t*>(converted.data());
+            if (swr_convert(resampler, &output, decoded->nb_samples,
+                            const_cast<const uint8_t**>(decoded->extended_data), decoded->nb_samples) < 0) {
+                return;
+            }
+            interleaved = converted.data();
+        }
+
+        // 每次归约一个区间内的连续样本
+        while (begin < end) {
+            const int64_t absolute = frameStart + begin;
+            const int64_t bin = absolute / binFrames;
+            const int64_t count = std::min<int64_t>(end - begin, (bin + 1) * binFrames - absolute);
+            const std::size_t index = static_cast<std::size_t>(bin - segment.firstBin);
+            if (index >= segment.bins.size()) {
+                segment.bins.resize(index + 1);
+            }
+            if (interleaved) {
+                merge(segment.bins[index], reduce(interleaved + begin * channels, static_cast<size_t>(count * channels)),
+                      static_cast<size_t>(count * channels));
+            } else {
+                for (int channel = 0; channel < channels; ++channel) {
+                    const float* plane = reinterpret_cast<const float*>(decoded->extended_data[channel]);
+                    merge(segment.bins[index], reduce(plane + begin, static_cast<size_t>(count)), static_cast<size_t>(count));
+                }
+            }
+            segment.frames += count;
+            begin += count;
+        }
+        segment.endPosition = frameStart + end;
+        if (position >= segment.endFrame) {
+            finished = true;
+        }
+    };
+
+    while (!finished && av_read_frame(formatContext, packet) >= 0) {
+        if (packet->stream_index == streamIndex && decoder.sendPacket(packet)) {
+            while (!finished && decoder.receiveFrame(frame)) {
+                consume(frame);
+                av_frame_unref(frame);
+            }
+        }
+        av_packet_unref(packet);
+    }
+    if (!finished && decoder.sendPacket(nullptr)) {
+        while (!finished && decoder.receiveFrame(frame)) {
+            consume(frame);
+            av_frame_unref(frame);
+        }
+    }
+    framesCounter.add(static_cast<uint64_t>(segment.frames));
+    segment.ok = true;
+
+    swr_free(&resampler);
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+    avformat_close_input(&formatContext);
+}
+
+/// 区间的量化，超出 [-1, 1] 的样本截断
+WaveformBin quantize(const LevelBin& bin)
+{
+    WaveformBin result;
+    result.min = static_cast<int8_t>(std::lrint(std::clamp(bin.min, -1.0f, 1.0f) * 127.0f));
+    result.max = static_cast<int8_t>(std::lrint(std::clamp(bin.max, -1.0f, 1.0f) * 127.0f));
+    result.rms = static_cast<uint8_t>(std::lrint(std::min(std::sqrt(bin.meanSquare), 1.0f) * 255.0f));
+    result.reserved = 0;
+    return result;
+}
+
+/**
+ * @brief 由第 0 层逐级两两合并生成所有层级并序列化为文件内容
+ */
+std::vector<uint8_t> serialize(const std::vector<LevelBin>& base, int sampleRate, int channels, int binFrames,
+                               int64_t frames)
+{
+    std::vector<std::vector<LevelBin>> levels;
+    levels.push_back(base);
+    while (levels.back().size() > 1 && static_cast<int>(levels.size()) < kMaxLevels) {
+        const std::vector<LevelBin>& previous = levels.back();
+        std::vector<LevelBin> next((previous.size() + 1) / 2);
+        for (std::size_t i = 0; i < next.size(); ++i) {
+            const LevelBin& a = previous[2 * i];
+            const LevelBin& b = 2 * i + 1 < previous.size() ? previous[2 * i + 1] : a;
+            next[i] = LevelBin {std::min(a.min, b.min), std::max(a.max, b.max), (a.meanSquare + b.meanSquare) * 0.5f};
+        }
+        levels.push_back(std::move(next));
+    }
+
+    std::size_t offset = alignUp(sizeof(WaveformHeader) + levels.size() * sizeof(WaveformLevel), 64);
+    std::vector<WaveformLevel> table;
+    for (const auto& level : levels) {
+        table.push_back(WaveformLevel {offset, level.size()});
+        offset = alignUp(offset + level.size() * sizeof(WaveformBin), 64);
+    }
+
+    std::vector<uint8_t> buffer(offset, 0);
+    WaveformHeader header {};
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.sampleRate = sampleRate;
+    header.channels = channels;
+    header.binFrames = binFrames;
+    header.levels = static_cast<int32_t>(levels.size());
+    header.frames = frames;
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    std::memcpy(buffer.data() + sizeof(header), table.data(), table.size() * sizeof(WaveformLevel));
+    for (std::size_t level = 0; level < levels.size(); ++level) {
+        auto* bins = reinterpret_cast<WaveformBin*>(buffer.data() + table[level].offset);
+        for (std::size_t i = 0; i < levels[level].size(); ++i) {
+            bins[i] = quantize(levels[level][i]);
+        }
+    }
+    return buffer;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Waveform
+// ---------------------------------------------------------------------------
+
+std::shared_ptr<const Waveform> Waveform::map(const std::string& filePath)
+{
+    auto file = std::make_unique<QFile>(QString::fromStdString(filePath));
+    if (!file->open(QIODevice::ReadOnly) || file->size() < static_cast<qint64>(sizeof(WaveformHeader))) {
+        return nullptr;
+    }
+    const uint8_t* data = file->map(0, file->size());
+    if (!data) {
+        return nullptr;
+    }
+
+    const uint64_t size = static_cast<uint64_t>(file->size());
+    const auto* header = reinterpret_cast<const WaveformHeader*>(data);
+    if (header->magic != kMagic || header->version != kVersion || header->sampleRate <= 0
+        || header->binFrames <= 0 || header->levels <= 0 || header->levels > kMaxLevels
+        || sizeof(WaveformHeader) + header->levels * sizeof(WaveformLevel) > size) {
+        return nullptr;
+    }
+    const auto* levels = reinterpret_cast<const WaveformLevel*>(data + sizeof(WaveformHeader));
+    for (int i = 0; i < header->levels; ++i) {
+        if (levels[i].count == 0 || levels[i].offset > size
+            || levels[i].count > (size - levels[i].offset) / sizeof(WaveformBin)) {
+            return nullptr;
+        }
+    }
+
+    std::shared_ptr<Waveform> waveform(new Waveform());
+    waveform->m_data = data;
+    waveform->m_header = header;
+    waveform->m_levels = levels;
+    waveform->m_file = std::move(file);
+    return waveform;
+}
+
+Waveform::~Waveform()
+{
+    if (m_file && m_data) {
+        m_file->unmap(const_cast<uchar*>(m_data));
+    }
+}
+
+int Waveform::sampleRate() const
+{
+    return m_header->sampleRate;
+}
+
+int Waveform::channels() const
+{
+    return m_header->channels;
+}
+
+int64_t Waveform::frames() const
+{
+    return m_header->frames;
+}
+
+int64_t Waveform::duration() const
+{
+    return m_header->frames * 1000 / m_header->sampleRate;
+}
+
+int Waveform::levelCount() const
+{
+    return m_header->levels;
+}
+
+int64_t Waveform::binFrames(int level) const
+{
+    return level >= 0 && level < m_header->levels ? static_cast<int64_t>(m_header->binFrames) << level : 0;
+}
+
+int64_t Waveform::binCount(int level) const
+{
+    return level >= 0 && level < m_header->levels ? static_cast<int64_t>(m_levels[level].count) : 0;
+}
+
+const WaveformBin* Waveform::bins(int level) const
+{
+    if (level < 0 || level >= m_header->levels) {
+        return nullptr;
+    }
+    return reinterpret_cast<const WaveformBin*>(m_data + m_levels[level].offset);
+}
+
+std::vector<WaveformBin> Waveform::peaks(int64_t start, int64_t end, int columns) const
+{
+    std::vector<WaveformBin> result;
+    if (columns <= 0 || end <= start) {
+        return result;
+    }
+    const double firstFrame = static_cast<double>(start) * m_header->sampleRate / 1000.0;
+    const double framesPerColumn = static_cast<double>(end - start) * m_header->sampleRate / 1000.0 / columns;
+
+    int level = 0;
+    while (level + 1 < m_header->levels && binFrames(level + 1) <= framesPerColumn) {
+        ++level;
+    }
+    const WaveformBin* levelBins = bins(level);
+    const int64_t count = binCount(level);
+    const double size = static_cast<double>(binFrames(level));
+
+    result.resize(static_cast<std::size_t>(columns));
+    for (int column = 0; column < columns; ++column) {
+        int64_t first = static_cast<int64_t>((firstFrame + column * framesPerColumn) / size);
+        int64_t last = static_cast<int64_t>(std::ceil((firstFrame + (column + 1) * framesPerColumn) / size));
+        first = std::clamp<int64_t>(first, 0, count);
+        last = std::clamp<int64_t>(std::max(last, first + 1), 0, count);
+
+        WaveformBin& out = result[static_cast<std::size_t>(column)];
+        out = WaveformBin {0, 0, 0, 0};
+        if (first >= last) {
+            continue;
+        }
+        int minimum = 127;
+        int maximum = -127;
+        double squares = 0.0;
+        for (int64_t i = first; i < last; ++i) {
+            minimum = std::min<int>(minimum, levelBins[i].min);
+            maximum = std::max<int>(maximum, levelBins[i].max);
+            squares += static_cast<double>(levelBins[i].rms) * levelBins[i].rms;
+        }
+        out.min = static_cast<int8_t>(minimum);
+        out.max = static_cast<int8_t>(maximum);
+        out.rms = static_cast<uint8_t>(std::lrint(std::sqrt(squares / static_cast<double>(last - first))));
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// WaveformBuilder
+// ---------------------------------------------------------------------------
+
+WaveformBuilder& WaveformBuilder::instance()
+{
+    static WaveformBuilder instance([] {
+        QString base = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        if (base.isEmpty()) {
+            base = QDir::tempPath() + "/aurorastream";
+        }
+        return (base + "/waveforms").toStdString();
+    }());
+    return instance;
+}
+
+WaveformBuilder::WaveformBuilder(const std::string& directory)
+    : m_directory(directory)
+{
+    if (!QDir().mkpath(QString::fromStdString(m_directory))) {
+        qWarning() << "WaveformBuilder: Could not create cache directory:" << QString::fromStdString(m_directory);
+    }
+}
+
+std::string WaveformBuilder::directory() const
+{
+    return m_directory;
+}
+
+WaveformBuilder::Statistics WaveformBuilder::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+std::shared_ptr<const Waveform> WaveformBuilder::load(const std::string& path, const Options& requested)
+{
+    static core::Histogram& buildTime = core::PerformanceMonitor::instance().histogram("waveform.build_us");
+
+    const Options options = normalized(requested);
+    const std::string key = contentKey(path, options);
+    if (key.empty()) {
+        return nullptr;
+    }
+    const std::string cacheFile = m_directory + "/" + key + ".wave";
+    if (std::shared_ptr<const Waveform> waveform = Waveform::map(cacheFile)) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_statistics.cacheHits;
+        return waveform;
+    }
+
+    const int64_t started = steadyMicros();
+    int streamIndex = -1;
+    AVFormatContext* formatContext = openAudioInput(path, &streamIndex);
+    if (!formatContext) {
+        return nullptr;
+    }
+    const AVStream* stream = formatContext->streams[streamIndex];
+    const int sampleRate = stream->codecpar->sample_rate;
+    const int channels = stream->codecpar->ch_layout.nb_channels;
+    int64_t estimatedFrames = 0;
+    if (stream->duration != AV_NOPTS_VALUE && stream->duration > 0) {
+        estimatedFrames = av_rescale_q(stream->duration, stream->time_base, AVRational {1, sampleRate});
+    } else if (formatContext->duration != AV_NOPTS_VALUE && formatContext->duration > 0) {
+        estimatedFrames = av_rescale(formatContext->duration, sampleRate, AV_TIME_BASE);
+    }
+    const bool seekable = formatContext->pb && (formatContext->pb->seekable & AVIO_SEEKABLE_NORMAL);
+    avformat_close_input(&formatContext);
+
+    // 按区间边界分段，每段不短于 segmentSeconds
+    const int64_t segmentFrames = static_cast<int64_t>(options.segmentSeconds) * sampleRate;
+    int segmentCount = 1;
+    if (seekable && estimatedFrames > segmentFrames) {
+        segmentCount = static_cast<int>(std::min<int64_t>(estimatedFrames / segmentFrames,
+                                                          core::TaskScheduler::instance().workerCount()));
+        segmentCount = std::max(1, segmentCount);
+    }
+    const int64_t estimatedBins = (estimatedFrames + options.binFrames - 1) / options.binFrames;
+    std::vector<Segment> segments(static_cast<std::size_t>(segmentCount));
+    for (int i = 0; i < segmentCount; ++i) {
+        segments[i].firstBin = estimatedBins * i / segmentCount;
+        if (i > 0) {
+            segments[i - 1].endFrame = segments[i].firstBin * options.binFrames;
+        }
+    }
+
+    if (segmentCount > 1) {
+        core::TaskGroup group;
+        for (Segment& segment : segments) {
+            core::TaskScheduler::instance().submit(core::TaskScheduler::Priority::Background, [&path, &options, &segment] {
+                decodeSegment(path, options.binFrames, segment);
+            }, &group);
+        }
+        group.wait();
+    }
+    // 单段，或某一段无法跳转时退回顺序解码整个文件
+    const bool parallel = segmentCount > 1
+        && std::all_of(segments.begin(), segments.end(), [](const Segment& segment) { return segment.ok; });
+    if (!parallel) {
+        segments.assign(1, Segment());
+        decodeSegment(path, options.binFrames, segments.front());
+        if (!segments.front().ok) {
+            return nullptr;
+        }
+    }
+
+    // 拼接第 0 层：每段截断到下一段的起点，未解码到的区间（段间空隙）视为静音
+    std::vector<LevelBin> base;
+    int64_t frames = 0;
+    uint64_t decodedFrames = 0;
+    for (std::size_t i = 0; i < segments.size(); ++i) {
+        const Segment& segment = segments[i];
+        std::size_t count = segment.bins.size();
+        if (i + 1 < segments.size()) {
+            count = static_cast<std::size_t>(segments[i + 1].firstBin - segment.firstBin);
+        }
+        base.resize(static_cast<std::size_t>(segment.firstBin), LevelBin {0.0f, 0.0f, 0.0f});
+        for (std::size_t j = 0; j < count; ++j) {
+            if (j < segment.bins.size() && segment.bins[j].samples > 0) {
+                const Accumulator& bin = segment.bins[j];
+                base.push_back(LevelBin {bin.min, bin.max,
+                                         static_cast<float>(bin.sumSquares / static_cast<double>(bin.samples))});
+            } else {
+                base.push_back(LevelBin {0.0f, 0.0f, 0.0f});
+            }
+        }
+        frames = std::max(frames, std::min(segment.endPosition, segment.endFrame));
+        decodedFrames += static_cast<uint64_t>(segment.frames);
+    }
+    if (decodedFrames == 0) {
+        return nullptr;
+    }
+    base.resize(static_cast<std::size_t>((frames + options.binFrames - 1) / options.binFrames));
+
+    // 临时文件加重命名，其他线程或进程不会映射到写了一半的文件
+    static std::atomic<unsigned> sequence {0};
+    const std::vector<uint8_t> buffer = serialize(base, sampleRate, channels, options.binFrames, frames);
+    const QString target = QString::fromStdString(cacheFile);
+    const QString temporary = target + QString(".%1.tmp").arg(sequence.fetch_add(1));
+    QFile file(temporary);
+    const bool written = file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        && file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<qint64>(buffer.size()))
+               == static_cast<qint64>(buffer.size());
+    file.close();
+    QFile::remove(target);
+    std::shared_ptr<const Waveform> waveform;
+    if (written && QFile::rename(temporary, target)) {
+        waveform = Waveform::map(cacheFile);
+    } else {
+        QFile::remove(temporary);
+        qWarning() << "WaveformBuilder: Could not write" << target;
+    }
+    if (!waveform) {
+        return nullptr;
+    }
+
+    const int64_t elapsed = steadyMicros() - started;
+    buildTime.record(elapsed);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_statistics.built;
+        m_statistics.frames += decodedFrames;
+        m_statistics.segments += segments.size();
+    }
+    qDebug() << "WaveformBuilder: Built" << waveform->levelCount() << "levels for" << QString::fromStdString(path)
+             << "(" << segments.size() << "segments," << elapsed / 1000 << "ms)";
+    return waveform;
+}
+
+} // namespace audio
+} // namespace media
+} // namespace modules
+} // namespace aurorastream
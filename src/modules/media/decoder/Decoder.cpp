@@ -10,8 +10,10 @@
  ********************************************************************************/
 
 #include "aurorastream/modules/media/decoder/Decoder.h"
+#include "aurorastream/utils/Logger.h"
+#include "aurorastream/utils/Tracer.h"
+#include "aurorastream/core/PerformanceMonitor.h"
 #include <stdexcept>
-#include <iostream>
 #include <QtCore/QDebug>
 
 extern "C" {
@@ -29,39 +31,40 @@ namespace decoder {
 class Decoder::Impl {
 public:
     Impl(Type type) : type_(type) {
-        std::cout << "Decoder initialized" << std::endl;
+        setMetricsScope(nullptr);
+        AURORASTREAM_LOG_DEBUG("Decoder initialized");
     }
 
     ~Impl() {
-        std::cout << "Decoder destroyed" << std::endl;
+        AURORASTREAM_LOG_DEBUG("Decoder destroyed");
         cleanup();
     }
 
     bool init(AVCodecParameters* params) {
         if (!params) {
-            std::cerr << "Invalid codec parameters" << std::endl;
+            AURORASTREAM_LOG_ERROR("Invalid codec parameters");
             return false;
         }
 
         const AVCodec* codec = avcodec_find_decoder(params->codec_id);
         if (!codec) {
-            std::cerr << "Unsupported codec" << std::endl;
+            AURORASTREAM_LOG_ERROR("Unsupported codec");
             return false;
         }
 
         codecCtx_ = avcodec_alloc_context3(codec);
         if (!codecCtx_) {
-            std::cerr << "Failed to allocate codec context" << std::endl;
+            AURORASTREAM_LOG_ERROR("Failed to allocate codec context");
             return false;
         }
 
         if (avcodec_parameters_to_context(codecCtx_, params) < 0) {
-            std::cerr << "Failed to copy codec parameters" << std::endl;
+            AURORASTREAM_LOG_ERROR("Failed to copy codec parameters");
             return false;
         }
 
         if (avcodec_open2(codecCtx_, codec, nullptr) < 0) {
-            std::cerr << "Failed to open codec" << std::endl;
+            AURORASTREAM_LOG_ERROR("Failed to open codec");
             return false;
         }
 
@@ -70,12 +73,14 @@ public:
 
     bool sendPacket(AVPacket* packet) {
         if (!codecCtx_) return false;
+        AURORASTREAM_TRACE_SCOPE("decode.send", "decode");
+        core::ScopedTimer timer(*sendTime_);
 
         int ret = avcodec_send_packet(codecCtx_, packet);
         if (ret < 0) {
             char errbuf[AV_ERROR_MAX_STRING_SIZE];
             av_strerror(ret, errbuf, sizeof(errbuf));
-            std::cerr << "Error sending packet: " << errbuf << std::endl;
+            AURORASTREAM_LOG_ERROR("Error sending packet: " << errbuf);
             return false;
         }
         return true;
@@ -83,6 +88,8 @@ public:
 
     bool receiveFrame(AVFrame* frame) {
         if (!codecCtx_) return false;
+        AURORASTREAM_TRACE_SCOPE("decode.receive", "decode");
+        core::ScopedTimer timer(*receiveTime_);
 
         int ret = avcodec_receive_frame(codecCtx_, frame);
         if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
@@ -90,7 +97,7 @@ public:
         } else if (ret < 0) {
             char errbuf[AV_ERROR_MAX_STRING_SIZE];
             av_strerror(ret, errbuf, sizeof(errbuf));
-            std::cerr << "Error receiving frame: " << errbuf << std::endl;
+            AURORASTREAM_LOG_ERROR("Error receiving frame: " << errbuf);
             return false;
         }
 
@@ -113,10 +120,24 @@ public:
         return stats_;
     }
 
+    void setMetricsScope(std::shared_ptr<core::MetricsScope> scope) {
+        metricsScope_ = std::move(scope);
+        if (metricsScope_) {
+            sendTime_ = &metricsScope_->histogram("decode.send_us");
+            receiveTime_ = &metricsScope_->histogram("decode.receive_us");
+        } else {
+            sendTime_ = &core::PerformanceMonitor::instance().histogram("decode.send_us");
+            receiveTime_ = &core::PerformanceMonitor::instance().histogram("decode.receive_us");
+        }
+    }
+
 private:
     Type type_;
     AVCodecContext* codecCtx_ = nullptr;
     Statistics stats_;
+    std::shared_ptr<core::MetricsScope> metricsScope_;
+    core::Histogram* sendTime_ = nullptr;
+    core::Histogram* receiveTime_ = nullptr;
 
     void cleanup() {
         if (codecCtx_) {
@@ -139,6 +160,9 @@ Decoder::Statistics Decoder::getStatistics() const { return impl_->getStats(); }
 bool Decoder::enableHardwareAcceleration(const std::string& deviceType) {
     return impl_->enableHardwareAccel(deviceType);
 }
+void Decoder::setMetricsScope(std::shared_ptr<core::MetricsScope> scope) {
+    impl_->setMetricsScope(std::move(scope));
+}
 
 // 媒体控制接口实现
 bool Decoder::open(const QString& uri) {
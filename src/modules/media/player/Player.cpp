@@ -1,4 +1,13 @@
-
+/********************************************************************************
+ * @file   : Player.cpp
+ * @brief  : 实现 AuroraStream 媒体播放器模块。
+ *
+ * 本文件实现了 aurorastream::modules::media::player::Player 类。
+ * 播放控制通过命令队列交给解码任务执行，状态以原子快照的形式对外发布。
+ *
+ * @author : polarours
+ * @date   : 2025/08/25
+ ********************************************************************************/
 
 #include "aurorastream/modules/media/player/Player.h"
 
@@ -6,8 +15,14 @@
 #include "aurorastream/modules/media/decoder/Decoder.h"
 #include "aurorastream/modules/media/renderer/VideoRenderer.h"
 #include "aurorastream/modules/media/renderer/AudioRenderer.h"
+#include "aurorastream/modules/media/audio/LoudnessMeter.h"
+#include "aurorastream/modules/media/audio/LoudnessAnalyzer.h"
+#include "aurorastream/core/MediaLibrary.h"
+#include "aurorastream/core/ProbeCache.h"
+#include "aurorastream/core/PerformanceMonitor.h"
 #include <QtCore/QObject>
 #include <QtCore/QDebug>
+#include <QtCore/QFileInfo>
 #include <QDebug>
 
 #include "SDL2/SDL_audio.h"
@@ -17,12 +32,20 @@ namespace modules {
 namespace media {
 namespace player {
 
+namespace {
+// 每个管线任务最多解码的帧数，之后让出工作线程
+constexpr int kDecodeBatch = 8;
+std::atomic<int> g_playerCount {0};
+}
+
 Player::Player(QObject* parent)
     : QObject(parent),
-    m_state(State::Stopped),
-    m_position(0),
-    m_duration(0)
+    m_metricsScope(core::PerformanceMonitor::instance().createScope("player")),
+    m_affinity(g_playerCount.fetch_add(1)),
+    m_notifyTimer(this)
 {
+    m_notifyTimer.setInterval(1000 / m_notifyRate);
+    connect(&m_notifyTimer, &QTimer::timeout, this, &Player::flushNotifications);
     qDebug() << "Player initialized";
 }
 
@@ -34,16 +57,22 @@ Player::~Player()
 
 bool Player::open(const QString& uri)
 {
-    if (m_state != State::Stopped) {
+    if (state() != State::Stopped) {
         qWarning() << "Player is not in stopped state";
         return false;
     }
 
-    m_state = State::Opening;
-    emit stateChanged(m_state);
+    // 管线尚未运行，由调用线程直接发布状态
+    const double rate = m_working.rate;
+    m_working = Snapshot();
+    m_working.state = State::Opening;
+    m_working.rate = rate;
+    publish();
+    flushNotifications();
 
     // 初始化解码器（视频解码器）
     m_decoder = std::make_unique<decoder::Decoder>(decoder::Decoder::Type::VIDEO);
+    m_decoder->setMetricsScope(m_metricsScope);
 
     // 延迟渲染器初始化
     m_videoRenderer = nullptr;
@@ -66,93 +95,67 @@ bool Player::open(const QString& uri)
                 qWarning() << "Failed to create audio renderer";
                 return false;
             }
+            m_audioRenderer->setPlaybackRate(m_working.rate);
+            applyLoudnessNormalization(uri);
         }
         m_currentUri = uri;
-        m_duration = m_decoder->getDuration();
-        m_state = State::Opened;
-        emit stateChanged(m_state);
+        m_working.duration = m_decoder->getDuration();
+        m_working.state = State::Opened;
+        publish();
+        m_running = true;
+        m_notifyTimer.start();
         emit mediaOpened(uri);
-        emit durationChanged(m_duration);
+        flushNotifications();
         return true;
     }
 
-    m_state = State::Error;
-    emit stateChanged(m_state);
+    m_working.state = State::Error;
+    publish();
+    flushNotifications();
     emit error("Failed to open media");
     return false;
 }
 
 bool Player::play()
 {
-    if (m_state != State::Opened && m_state != State::Paused) {
+    const State current = state();
+    if (current != State::Opened && current != State::Paused && current != State::Playing) {
         qWarning() << "Invalid state for play operation";
         return false;
     }
-
-    m_state = State::Playing;
-    emit stateChanged(m_state);
-
-    // 启动解码线程
-    m_decodeThread = std::thread([this]() {
-        while (m_state == State::Playing) {
-            auto frame = m_decoder->getNextFrame();
-            if (frame) {
-                if (frame->type == decoder::FrameType::VIDEO && m_videoRenderer) {
-                    m_videoRenderer->render(*frame);
-                } else if (frame->type == decoder::FrameType::AUDIO && m_audioRenderer) {
-                    // 对于音频帧，需要转换为AudioFrame
-                    decoder::AudioFrame audioFrame;
-                    audioFrame.type = decoder::FrameType::AUDIO;
-                    audioFrame.data[0] = frame->data[0];
-                    audioFrame.samples = frame->width; // 使用width作为samples
-                    audioFrame.channels = 2;
-                    audioFrame.sampleRate = 44100;
-                    audioFrame.pts = frame->pts;
-                    audioFrame.duration = frame->duration;
-                    m_audioRenderer->queueAudio(audioFrame);
-                }
-                m_position = frame->pts;
-                emit positionChanged(m_position);
-            }
-        }
-    });
-
-    // 启动音频渲染线程
-    if (m_audioRenderer) {
-        m_audioThread = std::thread([this]() {
-            m_audioRenderer->play();
-        });
-    }
+    postCommand({Command::Type::Play});
     return true;
 }
 
 bool Player::pause()
 {
-    if (m_state != State::Playing) {
+    if (state() != State::Playing) {
         qWarning() << "Invalid state for pause operation";
         return false;
     }
-
-    m_state = State::Paused;
-    emit stateChanged(m_state);
+    postCommand({Command::Type::Pause});
     return true;
 }
 
 bool Player::stop()
 {
-    if (m_state == State::Stopped) {
+    if (state() == State::Stopped) {
         return true;
     }
 
-    // 停止解码线程
-    if (m_decodeThread.joinable()) {
-        m_decodeThread.join();
+    // 停止管线，丢弃尚未执行的命令；之后由调用线程接管快照的发布
+    m_running = false;
+    m_pipelineTasks.wait();
+    Command discarded;
+    while (m_pendingCommands.load() > 0) {
+        if (m_commands.pop(discarded)) {
+            --m_pendingCommands;
+        }
     }
 
-    // 停止音频线程
-    if (m_audioThread.joinable()) {
+    // 停止音频输出
+    if (m_audioRenderer) {
         m_audioRenderer->stop();
-        m_audioThread.join();
     }
 
     // 清理渲染器
@@ -163,54 +166,84 @@ bool Player::stop()
         m_audioRenderer->cleanup();
     }
 
-    m_state = State::Stopped;
-    m_position = 0;
+    m_working.state = State::Stopped;
+    m_working.position = 0;
+    publish();
     m_currentUri.clear();
-    emit stateChanged(m_state);
-    emit positionChanged(m_position);
+    flushNotifications();
+    m_notifyTimer.stop();
     emit finished();
     return true;
 }
 
 bool Player::seek(qint64 position)
 {
-    if (m_state != State::Playing && m_state != State::Paused) {
+    const State current = state();
+    if (current != State::Playing && current != State::Paused && current != State::Seeking) {
         qWarning() << "Invalid state for seek operation";
         return false;
     }
+    Command command {Command::Type::Seek};
+    command.position = position;
+    postCommand(command);
+    return true;
+}
 
-    State oldState = m_state;
-    m_state = State::Seeking;
-    emit stateChanged(m_state);
-
-    // TODO: 实现精确跳转
-    if (m_decoder->seek(position)) {
-        m_position = position;
-        m_state = oldState;
-        emit stateChanged(m_state);
-        emit positionChanged(m_position);
+bool Player::setPlaybackRate(double rate)
+{
+    if (rate <= 0.0) {
+        qWarning() << "Invalid playback rate:" << rate;
+        return false;
+    }
+    if (state() == State::Stopped) {
+        // 管线未运行，直接记录，打开后生效
+        m_working.rate = rate;
+        publish();
         return true;
     }
+    Command command {Command::Type::Rate};
+    command.rate = rate;
+    postCommand(command);
+    return true;
+}
 
-    m_state = State::Error;
-    emit stateChanged(m_state);
-    emit error("Seek failed");
-    return false;
+Player::Snapshot Player::snapshot() const
+{
+    Snapshot result;
+    for (;;) {
+        const uint32_t sequence = m_snapshotSequence.load(std::memory_order_acquire);
+        if (sequence & 1) {
+            continue;   // 写者正在发布
+        }
+        result.state = static_cast<State>(m_publishedState.load(std::memory_order_relaxed));
+        result.position = m_publishedPosition.load(std::memory_order_relaxed);
+        result.duration = m_publishedDuration.load(std::memory_order_relaxed);
+        result.rate = m_publishedRate.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_snapshotSequence.load(std::memory_order_relaxed) == sequence) {
+            return result;
+        }
+    }
 }
 
 Player::State Player::state() const
 {
-    return m_state;
+    return static_cast<State>(m_publishedState.load(std::memory_order_acquire));
 }
 
 qint64 Player::position() const
 {
-    return m_position;
+    return m_publishedPosition.load(std::memory_order_acquire);
 }
 
 qint64 Player::duration() const
 {
-    return m_duration;
+    return m_publishedDuration.load(std::memory_order_acquire);
+}
+
+double Player::playbackRate() const
+{
+    return m_publishedRate.load(std::memory_order_acquire);
 }
 
 QString Player::currentUri() const
@@ -218,6 +251,232 @@ QString Player::currentUri() const
     return m_currentUri;
 }
 
+void Player::setNotifyRate(int hz)
+{
+    m_notifyRate = std::max(1, hz);
+    m_notifyTimer.setInterval(1000 / m_notifyRate);
+}
+
+int Player::notifyRate() const
+{
+    return m_notifyRate;
+}
+
+void Player::setLoudnessNormalization(bool enabled)
+{
+    m_loudnessNormalization = enabled;
+}
+
+bool Player::loudnessNormalization() const
+{
+    return m_loudnessNormalization;
+}
+
+void Player::applyLoudnessNormalization(const QString& uri)
+{
+    // 增益在打开时确定，之后与音量合并，播放中不再有额外的逐样本处理
+    float gain = 1.0f;
+    const QFileInfo info(uri);
+    if (m_loudnessNormalization && info.isFile()) {
+        const std::string path = info.absoluteFilePath().toStdString();
+        core::MediaLibrary::MediaFile file;
+        double loudness = 0.0;
+        double truePeak = 0.0;
+        if (core::MediaLibrary::instance().find(path, &file)) {
+            if (file.hasLoudness) {
+                gain = audio::LoudnessMeter::normalizationGain(file.loudness, file.truePeak);
+            } else {
+                audio::LoudnessAnalyzer::instance().request(path);
+            }
+        } else if (core::ProbeCache::instance().loudness(path, &loudness, &truePeak)) {
+            // 不在媒体库中的文件，结果保存在探测缓存
+            gain = audio::LoudnessMeter::normalizationGain(loudness, truePeak);
+        } else {
+            audio::LoudnessAnalyzer::instance().request(path);
+        }
+    }
+    m_audioRenderer->setNormalizationGain(gain);
+}
+
+void Player::postCommand(const Command& command)
+{
+    m_commands.push(command);
+    ++m_pendingCommands;
+    schedulePipeline();
+}
+
+void Player::schedulePipeline()
+{
+    if (!m_running || m_pipelineScheduled.exchange(true)) {
+        return;
+    }
+    core::TaskScheduler::instance().submit(core::TaskScheduler::Priority::PlaybackDecode,
+                                           [this]() { runPipeline(); }, &m_pipelineTasks, m_affinity);
+}
+
+void Player::runPipeline()
+{
+    Command command;
+    while (m_running && m_commands.pop(command)) {
+        --m_pendingCommands;
+        applyCommand(command);
+    }
+
+    if (m_running && m_working.state == State::Playing) {
+        decodeBatch();
+    }
+
+    if (m_running && m_working.state == State::Playing) {
+        core::TaskScheduler::instance().submit(core::TaskScheduler::Priority::PlaybackDecode,
+                                               [this]() { runPipeline(); }, &m_pipelineTasks, m_affinity);
+        return;
+    }
+
+    // 空闲：清除标记后再检查一次，避免与新投递的命令竞争而丢失
+    m_pipelineScheduled = false;
+    if (m_pendingCommands.load() > 0) {
+        schedulePipeline();
+    }
+}
+
+void Player::applyCommand(const Command& command)
+{
+    switch (command.type) {
+    case Command::Type::Play:
+        if (m_working.state != State::Opened && m_working.state != State::Paused) {
+            return;
+        }
+        m_working.state = State::Playing;
+        publish();
+        // 音频由 SDL 的回调线程拉取，这里只需启动设备
+        if (m_audioRenderer) {
+            m_audioRenderer->play();
+        }
+        break;
+
+    case Command::Type::Pause:
+        if (m_working.state != State::Playing) {
+            return;
+        }
+        m_working.state = State::Paused;
+        publish();
+        if (m_audioRenderer) {
+            m_audioRenderer->pause();
+        }
+        break;
+
+    case Command::Type::Seek: {
+        if (m_working.state != State::Playing && m_working.state != State::Paused) {
+            return;
+        }
+        const State previous = m_working.state;
+        m_working.state = State::Seeking;
+        publish();
+
+        // TODO: 实现精确跳转
+        if (m_decoder->seek(command.position)) {
+            m_working.position = command.position;
+            m_working.state = previous;
+            publish();
+        } else {
+            m_working.state = State::Error;
+            publish();
+            reportError("Seek failed");
+        }
+        break;
+    }
+
+    case Command::Type::Rate:
+        m_working.rate = command.rate;
+        publish();
+        if (m_audioRenderer) {
+            m_audioRenderer->setPlaybackRate(command.rate);
+        }
+        break;
+    }
+}
+
+void Player::decodeBatch()
+{
+    for (int i = 0; i < kDecodeBatch && m_running; ++i) {
+        auto frame = m_decoder->getNextFrame();
+        if (frame) {
+            if (frame->type == decoder::FrameType::VIDEO && m_videoRenderer) {
+                m_videoRenderer->render(*frame);
+            } else if (frame->type == decoder::FrameType::AUDIO && m_audioRenderer) {
+                // 对于音频帧，需要转换为AudioFrame
+                decoder::AudioFrame audioFrame;
+                audioFrame.type = decoder::FrameType::AUDIO;
+                audioFrame.data[0] = frame->data[0];
+                audioFrame.samples = frame->width; // 使用width作为samples
+                audioFrame.channels = 2;
+                audioFrame.sampleRate = 44100;
+                audioFrame.pts = frame->pts;
+                audioFrame.duration = frame->duration;
+                m_audioRenderer->queueAudio(audioFrame);
+            }
+            // 只发布快照，UI 通知由定时器合并
+            m_working.position = frame->pts;
+            publish();
+        }
+        // 处理批次中途到达的命令（如暂停、跳转）
+        if (m_pendingCommands.load(std::memory_order_relaxed) > 0) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 发布工作副本（顺序锁：序号为奇数表示正在写入）
+ */
+void Player::publish()
+{
+    m_snapshotSequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_publishedState.store(static_cast<int>(m_working.state), std::memory_order_relaxed);
+    m_publishedPosition.store(m_working.position, std::memory_order_relaxed);
+    m_publishedDuration.store(m_working.duration, std::memory_order_relaxed);
+    m_publishedRate.store(m_working.rate, std::memory_order_relaxed);
+    m_snapshotSequence.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * @brief 把快照的变化通知给 UI（在 UI 线程上执行）
+ */
+void Player::flushNotifications()
+{
+    const Snapshot current = snapshot();
+    if (current.state != m_notified.state) {
+        emit stateChanged(current.state);
+    }
+    if (current.duration != m_notified.duration) {
+        emit durationChanged(current.duration);
+    }
+    if (current.position != m_notified.position) {
+        emit positionChanged(current.position);
+    }
+    if (current.rate != m_notified.rate) {
+        emit playbackRateChanged(current.rate);
+    }
+    m_notified = current;
+
+    QString message;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::swap(message, m_pendingError);
+    }
+    if (!message.isEmpty()) {
+        emit error(message);
+    }
+}
+
+void Player::reportError(const QString& message)
+{
+    qWarning() << "Player:" << message;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pendingError = message;
+}
+
 } // namespace player
 } // namespace media
 } // namespace modules
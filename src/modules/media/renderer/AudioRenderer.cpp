@@ -1,13 +1,76 @@
 #include "aurorastream/modules/media/renderer/AudioRenderer.h"
+#include "aurorastream/modules/media/audio/TimeStretcher.h"
+#include "aurorastream/utils/Tracer.h"
+#include "aurorastream/core/PerformanceMonitor.h"
 #include <SDL2/SDL.h>
 #include <QDebug>
 #include <mutex>
+#include <algorithm>
 
 namespace aurorastream {
 namespace modules {
 namespace media {
 namespace renderer {
 
+void AudioRenderer::setVolume(float volume) {
+    volume = std::clamp(volume, 0.0f, 1.0f);
+    if (volume == m_volume) return;
+    m_volume = volume;
+    updateOutputGain();
+    emit volumeChanged(m_volume);
+}
+
+float AudioRenderer::getVolume() const {
+    return m_volume;
+}
+
+void AudioRenderer::setMute(bool mute) {
+    if (mute == m_mute) return;
+    m_mute = mute;
+    updateOutputGain();
+    emit muteChanged(m_mute);
+}
+
+bool AudioRenderer::isMute() const {
+    return m_mute;
+}
+
+void AudioRenderer::setNormalizationGain(float gain) {
+    m_normalizationGain = gain > 0.0f ? gain : 1.0f;
+    updateOutputGain();
+}
+
+float AudioRenderer::getNormalizationGain() const {
+    return m_normalizationGain;
+}
+
+void AudioRenderer::updateOutputGain() {
+    m_outputGain.store(m_mute ? 0.0f : m_volume * m_normalizationGain, std::memory_order_relaxed);
+}
+
+void AudioRenderer::setPlaybackRate(double rate) {
+    if (rate <= 0.0 || rate == m_playbackRate) return;
+    m_playbackRate = rate;
+    emit playbackRateChanged(m_playbackRate);
+}
+
+double AudioRenderer::getPlaybackRate() const {
+    return m_playbackRate;
+}
+
+namespace {
+
+/// 输出增益级：16 位样本乘以增益并饱和
+void applyGain(int16_t* samples, size_t count, float gain)
+{
+    for (size_t i = 0; i < count; ++i) {
+        const float value = std::clamp(samples[i] * gain, -32768.0f, 32767.0f);
+        samples[i] = static_cast<int16_t>(value);
+    }
+}
+
+} // namespace
+
 class SDLAudioRenderer : public AudioRenderer {
 public:
     SDLAudioRenderer(QObject* parent = nullptr);
@@ -20,6 +83,7 @@ public:
     void queueAudio(const decoder::AudioFrame& frame) override;
     void cleanup() override;
     bool isInitialized() const override;
+    void setPlaybackRate(double rate) override;
 
 private:
     static void audioCallback(void* userdata, Uint8* stream, int len);
@@ -27,23 +91,39 @@ private:
     SDL_AudioDeviceID m_audioDevice = 0;
     std::mutex m_audioMutex;
     std::vector<uint8_t> m_audioBuffer;
+
+    // 变速不变调，位于解码输出和设备缓冲之间
+    std::mutex m_stretchMutex;
+    audio::TimeStretcher m_stretcher;
+    std::vector<int16_t> m_stretchBuffer;
+
+    bool m_subsystemReady = false;
 };
 
 SDLAudioRenderer::SDLAudioRenderer(QObject* parent) :
     AudioRenderer(parent)
 {
-    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
-        qCritical() << "SDL audio init failed:" << SDL_GetError();
-    }
 }
 
 SDLAudioRenderer::~SDLAudioRenderer() {
     cleanup();
+    if (m_subsystemReady) {
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    }
 }
 
 bool SDLAudioRenderer::initialize(int sampleRate, int channels, int format) {
     if (m_initialized) return true;
 
+    // 打开音频设备较慢（需要连接声音服务器），推迟到第一次初始化渲染器时
+    if (!m_subsystemReady) {
+        if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+            qCritical() << "SDL audio init failed:" << SDL_GetError();
+            return false;
+        }
+        m_subsystemReady = true;
+    }
+
     SDL_AudioSpec desired, obtained;
     SDL_zero(desired);
 
@@ -63,6 +143,13 @@ bool SDLAudioRenderer::initialize(int sampleRate, int channels, int format) {
     m_sampleRate = obtained.freq;
     m_channels = obtained.channels;
     m_format = obtained.format;
+
+    {
+        std::lock_guard<std::mutex> lock(m_stretchMutex);
+        m_stretcher.init(m_sampleRate, m_channels);
+        m_stretcher.setRate(m_playbackRate);
+    }
+
     m_initialized = true;
     return true;
 }
@@ -84,6 +171,10 @@ void SDLAudioRenderer::pause() {
 void SDLAudioRenderer::stop() {
     if (!m_initialized) return;
     SDL_PauseAudioDevice(m_audioDevice, 1);
+    {
+        std::lock_guard<std::mutex> lock(m_stretchMutex);
+        m_stretcher.reset();
+    }
     std::lock_guard<std::mutex> lock(m_audioMutex);
     m_audioBuffer.clear();
     m_state = State::Stopped;
@@ -93,12 +184,38 @@ void SDLAudioRenderer::stop() {
 void SDLAudioRenderer::queueAudio(const decoder::AudioFrame& frame) {
     if (!m_initialized) return;
 
+    const int16_t* samples = reinterpret_cast<const int16_t*>(frame.data[0]);
+    std::lock_guard<std::mutex> stretchLock(m_stretchMutex);
+    if (m_stretcher.isBypassed()) {
+        // 原速：直接拷贝，不引入额外延迟
+        std::lock_guard<std::mutex> lock(m_audioMutex);
+        size_t dataSize = frame.samples * m_channels * 2; // 假设16位样本
+        m_audioBuffer.insert(m_audioBuffer.end(),
+                            frame.data[0],
+                            frame.data[0] + dataSize);
+        return;
+    }
+
+    m_stretchBuffer.clear();
+    {
+        AURORASTREAM_TRACE_SCOPE("audio.convert", "audio");
+        m_stretcher.process(samples, frame.samples, m_stretchBuffer);
+    }
+    if (m_stretchBuffer.empty()) return;
+
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(m_stretchBuffer.data());
     std::lock_guard<std::mutex> lock(m_audioMutex);
-    // 修复向量插入语法
-    size_t dataSize = frame.samples * m_channels * 2; // 假设16位样本
     m_audioBuffer.insert(m_audioBuffer.end(),
-                        frame.data[0],
-                        frame.data[0] + dataSize);
+                        bytes,
+                        bytes + m_stretchBuffer.size() * sizeof(int16_t));
+}
+
+void SDLAudioRenderer::setPlaybackRate(double rate) {
+    {
+        std::lock_guard<std::mutex> lock(m_stretchMutex);
+        m_stretcher.setRate(rate);
+    }
+    AudioRenderer::setPlaybackRate(rate);
 }
 
 void SDLAudioRenderer::cleanup() {
@@ -114,17 +231,32 @@ bool SDLAudioRenderer::isInitialized() const {
 }
 
 void SDLAudioRenderer::audioCallback(void* userdata, Uint8* stream, int len) {
+    AURORASTREAM_TRACE_SCOPE("audio.callback", "audio");
+    static core::Histogram& callbackTime = core::PerformanceMonitor::instance().histogram("audio.callback_us");
+    static core::Counter& underruns = core::PerformanceMonitor::instance().counter("audio.underruns");
+    static core::Gauge& buffered = core::PerformanceMonitor::instance().gauge("audio.buffered_bytes");
+    core::ScopedTimer timer(callbackTime);
     SDLAudioRenderer* renderer = static_cast<SDLAudioRenderer*>(userdata);
     std::lock_guard<std::mutex> lock(renderer->m_audioMutex);
 
     size_t copySize = std::min(renderer->m_audioBuffer.size(), static_cast<size_t>(len));
+    if (copySize < static_cast<size_t>(len)) {
+        underruns.add();
+    }
     if (copySize > 0) {
         memcpy(stream, renderer->m_audioBuffer.data(), copySize);
         renderer->m_audioBuffer.erase(renderer->m_audioBuffer.begin(),
                                    renderer->m_audioBuffer.begin() + copySize);
-    } else {
-        memset(stream, 0, len);
+        // 音量和响度归一化已合并为一个增益，单位增益时不处理
+        const float gain = renderer->m_outputGain.load(std::memory_order_relaxed);
+        if (gain != 1.0f) {
+            applyGain(reinterpret_cast<int16_t*>(stream), copySize / sizeof(int16_t), gain);
+        }
+    }
+    if (copySize < static_cast<size_t>(len)) {
+        memset(stream + copySize, 0, len - copySize);
     }
+    buffered.set(static_cast<int64_t>(renderer->m_audioBuffer.size()));
 }
 
 } // namespace renderer
@@ -2,6 +2,10 @@
 #include <SDL2/SDL.h>
 #include <QDebug>
 
+#include "aurorastream/utils/Tracer.h"
+#include "aurorastream/core/PerformanceMonitor.h"
+#include "aurorastream/core/StartupProfiler.h"
+
 namespace aurorastream {
 namespace modules {
 namespace media {
@@ -22,23 +26,33 @@ private:
     SDL_Window* m_sdlWindow = nullptr;
     SDL_Renderer* m_renderer = nullptr;
     SDL_Texture* m_texture = nullptr;
+    bool m_subsystemReady = false;
 };
 
 SDLVideoRenderer::SDLVideoRenderer(QObject* parent) :
     VideoRenderer(parent)
 {
-    if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0) {
-        qCritical() << "SDL video init failed:" << SDL_GetError();
-    }
 }
 
 SDLVideoRenderer::~SDLVideoRenderer() {
     cleanup();
+    if (m_subsystemReady) {
+        SDL_QuitSubSystem(SDL_INIT_VIDEO);
+    }
 }
 
 bool SDLVideoRenderer::initialize(int width, int height, void* windowHandle) {
     if (m_initialized) return true;
 
+    // SDL 视频子系统推迟到第一次初始化渲染器时启动，不占用程序启动时间
+    if (!m_subsystemReady) {
+        if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0) {
+            qCritical() << "SDL video init failed:" << SDL_GetError();
+            return false;
+        }
+        m_subsystemReady = true;
+    }
+
     m_sdlWindow = SDL_CreateWindowFrom(windowHandle);
     if (!m_sdlWindow) {
         qCritical() << "Create SDL window failed:" << SDL_GetError();
@@ -92,13 +106,22 @@ void SDLVideoRenderer::resize(int width, int height) {
 
 void SDLVideoRenderer::render(const decoder::VideoFrame& frame) {
     if (!m_initialized) return;
+    static core::Histogram& renderTime = core::PerformanceMonitor::instance().histogram("render.time_us");
+    static core::Counter& renderFrames = core::PerformanceMonitor::instance().counter("render.frames");
+    core::ScopedTimer timer(renderTime);
+    renderFrames.add();
+    core::StartupProfiler::instance().mark(core::StartupProfiler::Phase::FirstFrame);
+
+    {
+        AURORASTREAM_TRACE_SCOPE("render.upload", "render");
+        // 修夏SDL_UpdateYUVTexture调用
+        SDL_UpdateYUVTexture(m_texture, nullptr,
+                            frame.data[0], frame.linesize[0],
+                            frame.data[1], frame.linesize[1],
+                            frame.data[2], frame.linesize[2]);
+    }
 
-    // 修夏SDL_UpdateYUVTexture调用
-    SDL_UpdateYUVTexture(m_texture, nullptr,
-                        frame.data[0], frame.linesize[0],
-                        frame.data[1], frame.linesize[1],
-                        frame.data[2], frame.linesize[2]);
-
+    AURORASTREAM_TRACE_SCOPE("render.present", "render");
     SDL_RenderClear(m_renderer);
     SDL_RenderCopy(m_renderer, m_texture, nullptr, nullptr);
     SDL_RenderPresent(m_renderer);
@@ -10,10 +10,20 @@
 
 #include "aurorastream/modules/ui/MainWindow.h"
 #include "aurorastream/core/MediaPlayer.h"
+#include "aurorastream/core/StartupProfiler.h"
+#include "aurorastream/core/ThumbnailService.h"
+#include "aurorastream/core/TaskScheduler.h"
+#include "aurorastream/modules/media/audio/WaveformBuilder.h"
 #include <QFileDialog>
 #include <QDragEnterEvent>
 #include <QDropEvent>
 #include <QMimeData>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPointer>
+#include <QCoreApplication>
+#include <QPixmap>
+#include <QImage>
 #include <QDebug>
 
 namespace aurorastream {
@@ -27,10 +37,12 @@ MainWindow::MainWindow(QWidget* parent)
     , m_playButton(nullptr)
     , m_pauseButton(nullptr)
     , m_stopButton(nullptr)
+    , m_recordButton(nullptr)
     , m_seekSlider(nullptr)
     , m_volumeSlider(nullptr)
     , m_timeLabel(nullptr)
     , m_durationLabel(nullptr)
+    , m_seekPreview(nullptr)
     , m_duration(0)
     , m_videoContainer(nullptr)
 {
@@ -60,6 +72,7 @@ void MainWindow::setMediaPlayer(aurorastream::core::MediaPlayer* player)
         connect(m_mediaPlayer, &core::MediaPlayer::durationChanged, this, &MainWindow::onDurationChanged);
         connect(m_mediaPlayer, &core::MediaPlayer::positionChanged, this, &MainWindow::onPositionChanged);
         connect(m_mediaPlayer, &core::MediaPlayer::error, this, &MainWindow::onError);
+        connect(m_mediaPlayer, &core::MediaPlayer::recordingChanged, this, &MainWindow::onRecordingChanged);
     }
 }
 
@@ -89,6 +102,7 @@ void MainWindow::setupUI()
     m_pauseButton = new QPushButton("暂停", controlPanel);
     m_stopButton = new QPushButton("停止", controlPanel);
     m_connectButton = new QPushButton("连接RTMP", controlPanel);
+    m_recordButton = new QPushButton("录制", controlPanel);
     m_rtmpUrlEdit = new QLineEdit(controlPanel);
     m_rtmpUrlEdit->setPlaceholderText("输入RTMP地址");
     m_rtmpUrlEdit->setMinimumWidth(200);
@@ -96,6 +110,8 @@ void MainWindow::setupUI()
     // 创建进度条和音量控制
     m_seekSlider = new QSlider(Qt::Horizontal, controlPanel);
     m_seekSlider->setRange(0, 100);
+    m_seekSlider->setMouseTracking(true);
+    m_seekSlider->installEventFilter(this);
     m_volumeSlider = new QSlider(Qt::Horizontal, controlPanel);
     m_volumeSlider->setRange(0, 100);
     m_volumeSlider->setValue(50);
@@ -111,6 +127,7 @@ void MainWindow::setupUI()
     controlLayout->addWidget(m_stopButton);
     controlLayout->addWidget(m_rtmpUrlEdit);
     controlLayout->addWidget(m_connectButton);
+    controlLayout->addWidget(m_recordButton);
     controlLayout->addWidget(m_timeLabel);
     controlLayout->addWidget(m_seekSlider);
     controlLayout->addWidget(m_durationLabel);
@@ -120,6 +137,11 @@ void MainWindow::setupUI()
     mainLayout->addWidget(controlPanel);
     setCentralWidget(centralWidget);
 
+    // 进度条悬停预览，浮在进度条上方
+    m_seekPreview = new QLabel(this, Qt::ToolTip);
+    m_seekPreview->setStyleSheet("border: 1px solid #808080; background-color: black;");
+    m_seekPreview->hide();
+
     // 初始化按钮状态
     updateButtons();
 }
@@ -133,6 +155,7 @@ void MainWindow::connectSignals()
     connect(m_seekSlider, &QSlider::sliderMoved, this, &MainWindow::onSeekSliderMoved);
     connect(m_volumeSlider, &QSlider::valueChanged, this, &MainWindow::onVolumeChanged);
     connect(m_connectButton, &QPushButton::clicked, this, &MainWindow::onConnectClicked);
+    connect(m_recordButton, &QPushButton::clicked, this, &MainWindow::onRecordClicked);
 }
 
 void MainWindow::onOpenFile()
@@ -196,10 +219,35 @@ void MainWindow::onRtmpOpened(const QString& url)
     }
 }
 
+void MainWindow::onRecordClicked()
+{
+    if (!m_mediaPlayer) {
+        return;
+    }
+    if (m_mediaPlayer->isRecording()) {
+        m_mediaPlayer->stopRecording();
+        return;
+    }
+    // 录制复用播放读到的数据包，不会再建立一次连接
+    QString filePath = QFileDialog::getSaveFileName(this, "录制到文件", "",
+                                                    "MP4 (*.mp4);;Matroska (*.mkv);;MPEG-TS (*.ts)");
+    if (!filePath.isEmpty()) {
+        m_mediaPlayer->startRecording(filePath);
+    }
+}
+
+void MainWindow::onRecordingChanged(bool recording)
+{
+    m_recordButton->setText(recording ? "停止录制" : "录制");
+}
+
 void MainWindow::onMediaOpened(const QString& filePath)
 {
     m_currentFile = filePath;
     updateWindowTitle();
+    // 提前生成悬停预览用的精灵图
+    core::ThumbnailService::instance().request(filePath, core::ThumbnailService::Priority::Interactive);
+    requestWaveform(filePath);
     if (m_mediaPlayer) {
         m_mediaPlayer->setSource(filePath);
     }
@@ -234,6 +282,8 @@ void MainWindow::onPositionChanged(qint64 position)
 void MainWindow::paintEvent(QPaintEvent* event)
 {
     QMainWindow::paintEvent(event);
+    // 第一次绘制即窗口可见的时刻（time-to-window）
+    core::StartupProfiler::instance().mark(core::StartupProfiler::Phase::Window);
     // 视频渲染逻辑可以在这里实现
 }
 
@@ -261,12 +311,99 @@ void MainWindow::dropEvent(QDropEvent* event)
     }
 }
 
+bool MainWindow::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == m_seekSlider) {
+        if (event->type() == QEvent::MouseMove) {
+            showSeekPreview(static_cast<QMouseEvent*>(event)->position().toPoint().x());
+        } else if (event->type() == QEvent::Leave) {
+            m_seekPreview->hide();
+        } else if (event->type() == QEvent::Paint) {
+            // 先画波形，返回 false 后滑槽和滑块再画在上面
+            paintWaveform();
+        }
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+void MainWindow::requestWaveform(const QString& filePath)
+{
+    m_waveform.reset();
+    m_seekSlider->update();
+    // 工作线程只做计算，不读取 self：窗口可能正在界面线程中析构。
+    // 结果投递到应用对象（始终在界面线程），到那里再检查窗口是否还在
+    QPointer<MainWindow> self(this);
+    core::TaskScheduler::instance().submit(core::TaskScheduler::Priority::Background, [self, filePath] {
+        auto waveform = media::audio::WaveformBuilder::instance().load(filePath.toStdString());
+        if (!waveform) {
+            return;
+        }
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [self, filePath, waveform] {
+            if (self && self->m_currentFile == filePath) {
+                self->m_waveform = waveform;
+                self->m_seekSlider->update();
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::paintWaveform()
+{
+    const int width = m_seekSlider->width();
+    const int height = m_seekSlider->height();
+    if (!m_waveform || width <= 0 || height <= 0) {
+        return;
+    }
+    // 每个像素列一个峰值，缩放时 Waveform 自动选用合适的层级
+    const std::vector<media::audio::WaveformBin> peaks = m_waveform->peaks(0, m_waveform->duration(), width);
+    const double scale = (height / 2 - 1) / 127.0;
+    const int middle = height / 2;
+
+    QPainter painter(m_seekSlider);
+    for (int x = 0; x < static_cast<int>(peaks.size()); ++x) {
+        painter.setPen(QColor(96, 128, 160));
+        painter.drawLine(x, middle - static_cast<int>(peaks[x].max * scale), x, middle - static_cast<int>(peaks[x].min * scale));
+        const int rms = static_cast<int>(peaks[x].rms / 2 * scale);
+        painter.setPen(QColor(144, 184, 224));
+        painter.drawLine(x, middle - rms, x, middle + rms);
+    }
+}
+
+void MainWindow::showSeekPreview(int x)
+{
+    if (m_currentFile.isEmpty() || m_duration <= 0 || m_seekSlider->width() <= 0) {
+        return;
+    }
+    const auto sheet = core::ThumbnailService::instance().request(m_currentFile,
+                                                                  core::ThumbnailService::Priority::Interactive);
+    if (!sheet) {
+        m_seekPreview->hide();
+        return;
+    }
+
+    const qint64 position = qBound<qint64>(0, static_cast<qint64>(x) * m_duration / m_seekSlider->width(), m_duration);
+    int stride = 0;
+    const uint8_t* pixels = sheet->tile(sheet->tileAt(position), &stride);
+    if (!pixels) {
+        m_seekPreview->hide();
+        return;
+    }
+    // 直接引用映射的精灵图，QPixmap::fromImage 时才拷贝这一个图块
+    const QImage image(pixels, sheet->tileWidth(), sheet->tileHeight(), stride, QImage::Format_RGB32);
+    m_seekPreview->setPixmap(QPixmap::fromImage(image));
+    m_seekPreview->adjustSize();
+    m_seekPreview->move(m_seekSlider->mapToGlobal(QPoint(x - m_seekPreview->width() / 2,
+                                                         -m_seekPreview->height() - 8)));
+    m_seekPreview->show();
+}
+
 void MainWindow::updateButtons()
 {
     if (!m_mediaPlayer) {
         m_playButton->setEnabled(false);
         m_pauseButton->setEnabled(false);
         m_stopButton->setEnabled(false);
+        m_recordButton->setEnabled(false);
         return;
     }
 
@@ -274,6 +411,7 @@ void MainWindow::updateButtons()
     m_playButton->setEnabled(state != MediaState::PLAYING);
     m_pauseButton->setEnabled(state == MediaState::PLAYING);
     m_stopButton->setEnabled(state != MediaState::STOPPED);
+    m_recordButton->setEnabled(m_mediaPlayer->source() != nullptr);
 }
 
 void MainWindow::updateWindowTitle()
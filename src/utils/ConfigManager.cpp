@@ -1,79 +1,382 @@
 /********************************************************************************
  * @file   : ConfigManager.cpp
- * @brief  : 
+ * @brief  : 实现 AuroraStream 配置管理模块。
  *
- * 
+ * 写入方在 writeMutex_ 下复制当前快照、应用修改，再用 std::atomic_store
+ * 发布新快照并递增版本号；读取方只比较版本号，版本不变时直接使用本线程
+ * 缓存的快照。旧快照在最后一个持有它的线程刷新缓存后释放。
  *
  * @author : polarours
  * @date   : 2025/8/28
  ********************************************************************************/
 
 #include "aurorastream/utils/ConfigManager.h"
+#include "aurorastream/utils/Logger.h"
 
+#include <cerrno>
+#include <chrono>
+#include <limits>
+#include <cstdlib>
 #include <fstream>
 #include <sstream>
 
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#else
+#include <filesystem>
+#endif
+
 namespace aurorastream {
     namespace utils {
 
+        namespace {
+            /// 解析一次所有类型，之后的读取不再解析
+            ConfigSnapshot::Value parseValue(std::string text) {
+                ConfigSnapshot::Value value;
+                value.text = std::move(text);
+                value.boolValue = value.text == "true" || value.text == "1";
+
+                if (!value.text.empty()) {
+                    const char* begin = value.text.c_str();
+                    const char* textEnd = begin + value.text.size();
+                    char* end = nullptr;
+
+                    errno = 0;
+                    const long long integer = std::strtoll(begin, &end, 10);
+                    if (errno == 0 && end == textEnd) {
+                        value.isInt = true;
+                        value.intValue = integer;
+                    }
+
+                    errno = 0;
+                    const double real = std::strtod(begin, &end);
+                    if (errno == 0 && end == textEnd) {
+                        value.isDouble = true;
+                        value.doubleValue = real;
+                    }
+                }
+                return value;
+            }
+
+#ifdef __linux__
+            std::pair<std::string, std::string> splitPath(const std::string& path) {
+                const std::size_t slash = path.find_last_of('/');
+                if (slash == std::string::npos) {
+                    return {".", path};
+                }
+                return {slash == 0 ? "/" : path.substr(0, slash), path.substr(slash + 1)};
+            }
+#endif
+        }
+
+        const ConfigSnapshot::Value* ConfigSnapshot::find(std::string_view key) const {
+            auto it = values_.find(key);
+            return it != values_.end() ? &it->second : nullptr;
+        }
+
+        std::string_view ConfigSnapshot::get(std::string_view key, std::string_view defaultValue) const {
+            const Value* value = find(key);
+            return value ? std::string_view(value->text) : defaultValue;
+        }
+
+        int ConfigSnapshot::getInt(std::string_view key, int defaultValue) const {
+            const Value* value = find(key);
+            if (!value || !value->isInt
+                || value->intValue < std::numeric_limits<int>::min()
+                || value->intValue > std::numeric_limits<int>::max()) {
+                return defaultValue;
+            }
+            return static_cast<int>(value->intValue);
+        }
+
+        int64_t ConfigSnapshot::getInt64(std::string_view key, int64_t defaultValue) const {
+            const Value* value = find(key);
+            return value && value->isInt ? value->intValue : defaultValue;
+        }
+
+        double ConfigSnapshot::getDouble(std::string_view key, double defaultValue) const {
+            const Value* value = find(key);
+            return value && value->isDouble ? value->doubleValue : defaultValue;
+        }
+
+        bool ConfigSnapshot::getBool(std::string_view key, bool defaultValue) const {
+            const Value* value = find(key);
+            return value && !value->text.empty() ? value->boolValue : defaultValue;
+        }
+
         ConfigManager& ConfigManager::instance() {
             static ConfigManager instance;
             return instance;
         }
 
-        void ConfigManager::load(const std::string& configPath) {
-            std::lock_guard<std::mutex> lock(configMutex_);
+        ConfigManager::ConfigManager()
+            : snapshot_(std::make_shared<const ConfigSnapshot>()) {
+        }
+
+        ConfigManager::~ConfigManager() {
+            unwatch();
+        }
+
+        bool ConfigManager::load(const std::string& configPath) {
             std::ifstream file(configPath);
-            std::string line;
+            if (!file.is_open()) {
+                AURORASTREAM_LOG_WARNING("Failed to open config file: " << configPath);
+                return false;
+            }
 
+            ConfigSnapshot::Values updates;
+            std::string line;
             while (std::getline(file, line)) {
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+                if (line.empty() || line[0] == '#') {
+                    continue;
+                }
                 size_t delimiter = line.find('=');
                 if (delimiter != std::string::npos) {
                     std::string key = line.substr(0, delimiter);
-                    std::string value = line.substr(delimiter + 1);
-                    configMap_[key] = value;
+                    updates[key] = parseValue(line.substr(delimiter + 1));
                 }
             }
+            apply(std::move(updates));
+            return true;
         }
 
-        void ConfigManager::save(const std::string& configPath) {
-            std::lock_guard<std::mutex> lock(configMutex_);
+        bool ConfigManager::save(const std::string& configPath) {
+            const std::shared_ptr<const ConfigSnapshot> current = snapshot();
             std::ofstream file(configPath);
 
-            for (const auto& [key, value] : configMap_) {
-                file << key << "=" << value << "\n";
+            for (const auto& [key, value] : current->values()) {
+                file << key << "=" << value.text << "\n";
             }
+            return file.good();
         }
 
-        std::string ConfigManager::get(const std::string& key, const std::string& defaultValue) {
-            std::lock_guard<std::mutex> lock(configMutex_);
-            auto it = configMap_.find(key);
-            return it != configMap_.end() ? it->second : defaultValue;
+        std::shared_ptr<const ConfigSnapshot> ConfigManager::snapshot() const {
+            return std::atomic_load(&snapshot_);
+        }
+
+        /**
+         * @brief 当前线程缓存的快照
+         * 返回的引用在本线程下一次调用之前有效
+         */
+        const ConfigSnapshot& ConfigManager::current() const {
+            thread_local std::shared_ptr<const ConfigSnapshot> cached;
+            if (!cached || cached->version() != version_.load(std::memory_order_acquire)) {
+                cached = std::atomic_load(&snapshot_);
+            }
+            return *cached;
+        }
+
+        std::string ConfigManager::get(std::string_view key, std::string_view defaultValue) const {
+            return std::string(current().get(key, defaultValue));
         }
 
         void ConfigManager::set(const std::string& key, const std::string& value) {
-            std::lock_guard<std::mutex> lock(configMutex_);
-            configMap_[key] = value;
+            ConfigSnapshot::Values updates;
+            updates.emplace(key, parseValue(value));
+            apply(std::move(updates));
         }
 
-        int ConfigManager::getInt(const std::string& key, int defaultValue) {
-            std::string value = get(key);
-            return value.empty() ? defaultValue : std::stoi(value);
+        int ConfigManager::getInt(std::string_view key, int defaultValue) const {
+            return current().getInt(key, defaultValue);
         }
 
         void ConfigManager::setInt(const std::string& key, int value) {
             set(key, std::to_string(value));
         }
 
-        bool ConfigManager::getBool(const std::string& key, bool defaultValue) {
-            std::string value = get(key);
-            if (value.empty()) return defaultValue;
-            return value == "true" || value == "1";
+        double ConfigManager::getDouble(std::string_view key, double defaultValue) const {
+            return current().getDouble(key, defaultValue);
+        }
+
+        void ConfigManager::setDouble(const std::string& key, double value) {
+            std::ostringstream text;
+            text << value;
+            set(key, text.str());
+        }
+
+        bool ConfigManager::getBool(std::string_view key, bool defaultValue) const {
+            return current().getBool(key, defaultValue);
         }
 
         void ConfigManager::setBool(const std::string& key, bool value) {
             set(key, value ? "true" : "false");
         }
 
+        int ConfigManager::subscribe(const std::string& key, ChangeCallback callback) {
+            std::lock_guard<std::mutex> lock(subscribersMutex_);
+            const int id = nextSubscriptionId_++;
+            subscribers_.push_back(Subscription {id, key, std::move(callback)});
+            return id;
+        }
+
+        void ConfigManager::unsubscribe(int subscriptionId) {
+            std::lock_guard<std::mutex> lock(subscribersMutex_);
+            for (auto it = subscribers_.begin(); it != subscribers_.end(); ++it) {
+                if (it->id == subscriptionId) {
+                    subscribers_.erase(it);
+                    return;
+                }
+            }
+        }
+
+        /**
+         * @brief 复制当前快照并应用修改，值有变化时发布新快照并通知订阅者
+         */
+        void ConfigManager::apply(ConfigSnapshot::Values&& updates) {
+            std::vector<std::string> changedKeys;
+            std::shared_ptr<ConfigSnapshot> next;
+            {
+                std::lock_guard<std::mutex> lock(writeMutex_);
+                const std::shared_ptr<const ConfigSnapshot> current = std::atomic_load(&snapshot_);
+                for (auto& [key, value] : updates) {
+                    const ConfigSnapshot::Value* existing = current->find(key);
+                    if (existing && existing->text == value.text) {
+                        continue;
+                    }
+                    if (!next) {
+                        next = std::make_shared<ConfigSnapshot>(*current);
+                    }
+                    next->values_[key] = std::move(value);
+                    changedKeys.push_back(key);
+                }
+                if (!next) {
+                    return;
+                }
+
+                next->version_ = current->version_ + 1;
+                std::atomic_store(&snapshot_, std::shared_ptr<const ConfigSnapshot>(next));
+                version_.store(next->version_, std::memory_order_release);
+            }
+            notify(changedKeys, *next);
+        }
+
+        void ConfigManager::notify(const std::vector<std::string>& changedKeys, const ConfigSnapshot& snapshot) {
+            std::vector<Subscription> subscribers;
+            {
+                std::lock_guard<std::mutex> lock(subscribersMutex_);
+                subscribers = subscribers_;
+            }
+            if (subscribers.empty()) {
+                return;
+            }
+
+            for (const std::string& key : changedKeys) {
+                for (const Subscription& subscription : subscribers) {
+                    if (subscription.key.empty() || subscription.key == key) {
+                        subscription.callback(key, snapshot);
+                    }
+                }
+            }
+        }
+
+        bool ConfigManager::watch(const std::string& configPath) {
+            std::lock_guard<std::mutex> control(watchControlMutex_);
+            if (watcher_.joinable()) {
+                AURORASTREAM_LOG_WARNING("Config file is already being watched");
+                return false;
+            }
+
+#ifdef __linux__
+            const std::string directory = splitPath(configPath).first;
+            watchFd_ = inotify_init1(IN_CLOEXEC);
+            wakeFd_ = eventfd(0, EFD_CLOEXEC);
+            if (watchFd_ < 0 || wakeFd_ < 0
+                || inotify_add_watch(watchFd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+                AURORASTREAM_LOG_ERROR("Failed to watch config directory: " << directory);
+                if (watchFd_ >= 0) close(watchFd_);
+                if (wakeFd_ >= 0) close(wakeFd_);
+                watchFd_ = wakeFd_ = -1;
+                return false;
+            }
+#endif
+
+            {
+                std::lock_guard<std::mutex> lock(watchMutex_);
+                watchStopping_ = false;
+            }
+            watcher_ = std::thread(&ConfigManager::watchLoop, this, configPath);
+            return true;
+        }
+
+        void ConfigManager::unwatch() {
+            std::lock_guard<std::mutex> control(watchControlMutex_);
+            if (!watcher_.joinable()) {
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(watchMutex_);
+                watchStopping_ = true;
+            }
+            watchWakeup_.notify_all();
+#ifdef __linux__
+            const uint64_t one = 1;
+            [[maybe_unused]] const ssize_t written = write(wakeFd_, &one, sizeof(one));
+#endif
+            watcher_.join();
+
+#ifdef __linux__
+            close(watchFd_);
+            close(wakeFd_);
+            watchFd_ = wakeFd_ = -1;
+#endif
+        }
+
+        /**
+         * @brief 监视线程：文件被写入并关闭或被重命名替换后重新加载
+         */
+        void ConfigManager::watchLoop(const std::string& configPath) {
+#ifdef __linux__
+            const std::string fileName = splitPath(configPath).second;
+            pollfd fds[2] = {{watchFd_, POLLIN, 0}, {wakeFd_, POLLIN, 0}};
+            alignas(inotify_event) char buffer[4096];
+
+            for (;;) {
+                if (poll(fds, 2, -1) < 0) {
+                    if (errno == EINTR) continue;
+                    AURORASTREAM_LOG_ERROR("Config watcher poll failed, errno " << errno);
+                    return;
+                }
+                if (fds[1].revents) {
+                    return;
+                }
+
+                const ssize_t length = read(watchFd_, buffer, sizeof(buffer));
+                bool changed = false;
+                for (ssize_t offset = 0; offset < length; ) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                    if (event->len > 0 && fileName == event->name) {
+                        changed = true;
+                    }
+                    offset += sizeof(inotify_event) + event->len;
+                }
+                if (changed) {
+                    AURORASTREAM_LOG_INFO("Reloading config file: " << configPath);
+                    load(configPath);
+                }
+            }
+#else
+            // 没有 inotify 的平台按修改时间轮询
+            std::error_code error;
+            auto lastWrite = std::filesystem::last_write_time(configPath, error);
+            std::unique_lock<std::mutex> lock(watchMutex_);
+            while (!watchWakeup_.wait_for(lock, std::chrono::seconds(1), [this] { return watchStopping_; })) {
+                const auto writeTime = std::filesystem::last_write_time(configPath, error);
+                if (!error && writeTime != lastWrite) {
+                    lastWrite = writeTime;
+                    lock.unlock();
+                    load(configPath);
+                    lock.lock();
+                }
+            }
+#endif
+        }
+
     } // namespace utils
-} // namespace aurorastream
\ No newline at end of file
+} // namespace aurorastream
@@ -1,8 +1,10 @@
 /********************************************************************************
  * @file   : Logger.cpp
- * @brief  : 
+ * @brief  : 实现 AuroraStream 异步日志模块。
  *
- * 
+ * 每个线程的环形缓冲区只有本线程写入、写线程读取，读写位置用原子变量
+ * 同步，记录日志的线程不会加锁或阻塞。写线程每 100 毫秒（或在 flush()、
+ * shutdown() 时）收集一次，按全局序号排序后写入，并且每批只刷新一次文件。
  *
  * @author : polarours
  * @date   : 2025/8/28
@@ -10,23 +12,250 @@
 
 #include "aurorastream/utils/Logger.h"
 
+#include <ctime>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+
 namespace aurorastream {
     namespace utils {
 
+        namespace {
+            // 每个线程的缓冲区容量（条），必须是 2 的幂
+            constexpr std::size_t kRingCapacity = 1024;
+            constexpr auto kWriterInterval = std::chrono::milliseconds(100);
+        }
+
+        /**
+         * @brief 单生产者单消费者环形缓冲区
+         */
+        class Logger::Ring {
+        public:
+            bool push(Record&& record) {
+                const std::size_t head = head_.load(std::memory_order_relaxed);
+                if (head - tail_.load(std::memory_order_acquire) >= kRingCapacity) {
+                    return false;
+                }
+                slots_[head & (kRingCapacity - 1)] = std::move(record);
+                head_.store(head + 1, std::memory_order_release);
+                return true;
+            }
+
+            std::size_t popAll(std::vector<Record>& output) {
+                const std::size_t tail = tail_.load(std::memory_order_relaxed);
+                const std::size_t head = head_.load(std::memory_order_acquire);
+                for (std::size_t i = tail; i != head; ++i) {
+                    output.push_back(std::move(slots_[i & (kRingCapacity - 1)]));
+                }
+                tail_.store(head, std::memory_order_release);
+                return head - tail;
+            }
+
+            std::size_t size() const {
+                return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+            }
+
+            bool isEmpty() const {
+                return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+            }
+
+            std::atomic<bool> alive {true};     // 所属线程是否仍在运行
+
+        private:
+            Record slots_[kRingCapacity];
+            std::atomic<std::size_t> head_ {0};
+            std::atomic<std::size_t> tail_ {0};
+        };
+
         Logger& Logger::instance() {
             static Logger instance;
             return instance;
         }
 
+        Logger::~Logger() {
+            shutdown();
+        }
+
         void Logger::init(const std::string& logFilePath) {
+            shutdown();
+
+            std::lock_guard<std::mutex> lock(logMutex_);
             logFile_.open(logFilePath, std::ios::out | std::ios::app);
+            if (!logFile_.is_open()) {
+                return;
+            }
+            stopping_ = false;
+            running_.store(true, std::memory_order_release);
+            writer_ = std::thread(&Logger::writerLoop, this);
+        }
+
+        void Logger::shutdown() {
+            {
+                std::lock_guard<std::mutex> lock(logMutex_);
+                if (!writer_.joinable()) {
+                    return;
+                }
+                running_.store(false, std::memory_order_release);
+                stopping_ = true;
+            }
+            wakeup_.notify_all();
+            writer_.join();
+            logFile_.close();
         }
 
         void Logger::log(LogLevel level, const std::string& message) {
-            std::lock_guard<std::mutex> lock(logMutex_);
-            if (logFile_.is_open()) {
-                logFile_ << "[" << getLevelString(level) << "] " << message << std::endl;
+            if (!isEnabled(level)) {
+                return;
+            }
+            if (!running_.load(std::memory_order_acquire)) {
+                // 尚未 init()：警告及以上级别直接写到标准错误，避免错误信息丢失
+                if (level >= LogLevel::WARNING) {
+                    std::cerr << "[" << getLevelString(level) << "] " << message << '\n';
+                }
+                return;
+            }
+
+            Record record;
+            record.level = level;
+            record.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            record.sequence = sequence_.fetch_add(1, std::memory_order_relaxed);
+            record.message = message;
+
+            Ring* ring = threadRing();
+            if (!ring->push(std::move(record))) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            } else if (ring->size() == kRingCapacity / 2) {
+                // 缓冲区过半时提前唤醒写线程，减少突发日志的丢弃
+                drainRequested_.store(true, std::memory_order_release);
+                wakeup_.notify_one();
+            }
+        }
+
+        void Logger::setLevel(LogLevel level) {
+            level_.store(static_cast<int>(level), std::memory_order_relaxed);
+        }
+
+        LogLevel Logger::level() const {
+            return static_cast<LogLevel>(level_.load(std::memory_order_relaxed));
+        }
+
+        void Logger::flush() {
+            std::unique_lock<std::mutex> lock(logMutex_);
+            if (!writer_.joinable()) {
+                return;
             }
+            const uint64_t target = ++flushRequests_;
+            wakeup_.notify_all();
+            flushed_.wait(lock, [&] { return flushDone_ >= target || stopping_; });
+        }
+
+        uint64_t Logger::droppedCount() const {
+            return dropped_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief 当前线程的缓冲区，首次调用时创建并注册
+         */
+        Logger::Ring* Logger::threadRing() {
+            // 线程退出时标记缓冲区，写线程取完剩余消息后将其移除
+            struct Holder {
+                std::shared_ptr<Ring> ring;
+                ~Holder() {
+                    if (ring) {
+                        ring->alive.store(false, std::memory_order_release);
+                    }
+                }
+            };
+            thread_local Holder holder;
+
+            if (!holder.ring) {
+                holder.ring = std::make_shared<Ring>();
+                std::lock_guard<std::mutex> lock(logMutex_);
+                rings_.push_back(holder.ring);
+            }
+            return holder.ring.get();
+        }
+
+        void Logger::writerLoop() {
+            std::vector<Record> batch;
+            for (;;) {
+                bool stop;
+                uint64_t flushTarget;
+                {
+                    std::unique_lock<std::mutex> lock(logMutex_);
+                    wakeup_.wait_for(lock, kWriterInterval, [this] {
+                        return stopping_ || flushRequests_ > flushDone_
+                            || drainRequested_.load(std::memory_order_acquire);
+                    });
+                    drainRequested_.store(false, std::memory_order_release);
+                    stop = stopping_;
+                    flushTarget = flushRequests_;
+                }
+
+                drain(batch);
+                writeBatch(batch);
+
+                {
+                    std::lock_guard<std::mutex> lock(logMutex_);
+                    flushDone_ = flushTarget;
+                }
+                flushed_.notify_all();
+
+                if (stop) {
+                    break;
+                }
+            }
+        }
+
+        /**
+         * @brief 收集所有线程缓冲区中的消息，并移除已退出线程的空缓冲区
+         */
+        std::size_t Logger::drain(std::vector<Record>& batch) {
+            std::vector<std::shared_ptr<Ring>> rings;
+            {
+                std::lock_guard<std::mutex> lock(logMutex_);
+                rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [](const std::shared_ptr<Ring>& ring) {
+                    return !ring->alive.load(std::memory_order_acquire) && ring->isEmpty();
+                }), rings_.end());
+                rings = rings_;
+            }
+
+            std::size_t count = 0;
+            for (const std::shared_ptr<Ring>& ring : rings) {
+                count += ring->popAll(batch);
+            }
+            return count;
+        }
+
+        void Logger::writeBatch(std::vector<Record>& batch) {
+            const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+            if (batch.empty() && dropped == droppedReported_) {
+                return;
+            }
+
+            std::sort(batch.begin(), batch.end(), [](const Record& a, const Record& b) {
+                return a.sequence < b.sequence;
+            });
+
+            for (const Record& record : batch) {
+                const std::time_t seconds = static_cast<std::time_t>(record.timestamp / 1000000);
+                std::tm local {};
+                localtime_r(&seconds, &local);
+                logFile_ << std::put_time(&local, "%Y-%m-%d %H:%M:%S") << '.'
+                         << std::setw(3) << std::setfill('0') << (record.timestamp / 1000) % 1000
+                         << " [" << getLevelString(record.level) << "] " << record.message << '\n';
+            }
+            if (dropped != droppedReported_) {
+                logFile_ << "[WARNING] Logger dropped " << (dropped - droppedReported_)
+                         << " messages (buffer full)\n";
+                droppedReported_ = dropped;
+            }
+
+            // 每批只刷新一次
+            logFile_.flush();
+            batch.clear();
         }
 
         std::string Logger::getLevelString(LogLevel level) {
@@ -48,4 +277,4 @@ namespace aurorastream {
         void Logger::critical(const std::string& msg) { log(LogLevel::CRITICAL, msg); }
 
     } // namespace utils
-} // namespace aurorastream
\ No newline at end of file
+} // namespace aurorastream
@@ -0,0 +1,248 @@
+/********************************************************************************
+ * @file   : Tracer.cpp
+ * @brief  : 实现 AuroraStream 跟踪事件记录模块。
+ *
+ * 每个线程的缓冲区只有本线程写入。导出或清空时先关闭记录开关，
+ * 再等待各线程正在进行的写入结束（writing 标志），之后读取是安全的。
+ * 线程退出时缓冲区标记为已结束：导出时仍然包含它的事件，
+ * 导出或清空之后从列表中移除，线程池任务、扫描线程等短命线程不会累积缓冲区。
+ *
+ * @author : polarours
+ * @date   : 2026/10/18
+ ********************************************************************************/
+
+#include "aurorastream/utils/Tracer.h"
+
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <process.h>
+#define AURORASTREAM_GETPID _getpid
+#else
+#include <unistd.h>
+#define AURORASTREAM_GETPID getpid
+#endif
+
+namespace aurorastream {
+namespace utils {
+
+namespace {
+
+// 每个线程保留的事件数，必须是 2 的幂
+constexpr std::size_t kBufferCapacity = 8192;
+
+struct Event {
+    const char* name;
+    const char* category;
+    int64_t start;
+    int64_t duration;
+};
+
+void writeEscaped(std::ofstream& out, const std::string& text)
+{
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) >= 0x20) {
+            out << c;
+        }
+    }
+}
+
+} // namespace
+
+class Tracer::Buffer {
+public:
+    explicit Buffer(int threadId) : threadId(threadId) {}
+
+    void push(const char* name, const char* category, int64_t start, int64_t duration) {
+        if (!events) {
+            events = std::make_unique<Event[]>(kBufferCapacity);
+        }
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        events[head & (kBufferCapacity - 1)] = Event {name, category, start, duration};
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    /// 按时间顺序复制保留的事件（调用前必须确认没有写入）
+    void collect(std::vector<Event>& output) const {
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        const uint64_t first = head > kBufferCapacity ? head - kBufferCapacity : 0;
+        for (uint64_t i = first; i < head; ++i) {
+            output.push_back(events[i & (kBufferCapacity - 1)]);
+        }
+    }
+
+    void reset() {
+        head_.store(0, std::memory_order_release);
+    }
+
+    const int threadId;
+    std::string threadName;                 // 由 Tracer::mutex_ 保护
+    std::atomic<bool> writing {false};
+    std::atomic<bool> finished {false};     // 所属线程已退出
+    std::unique_ptr<Event[]> events;        // 首次记录时分配
+
+private:
+    std::atomic<uint64_t> head_ {0};
+};
+
+std::atomic<bool> Tracer::enabled_ {false};
+
+Tracer& Tracer::instance()
+{
+    static Tracer instance;
+    return instance;
+}
+
+void Tracer::start()
+{
+    enabled_.store(true, std::memory_order_seq_cst);
+}
+
+void Tracer::stop()
+{
+    enabled_.store(false, std::memory_order_seq_cst);
+}
+
+void Tracer::clear()
+{
+    const bool wasEnabled = enabled_.exchange(false, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const std::shared_ptr<Buffer>& buffer : buffers_) {
+            while (buffer->writing.load(std::memory_order_seq_cst)) {
+                std::this_thread::yield();
+            }
+            buffer->reset();
+        }
+        removeFinishedLocked();
+    }
+    enabled_.store(wasEnabled, std::memory_order_seq_cst);
+}
+
+bool Tracer::exportJson(const std::string& filePath)
+{
+    struct Track {
+        int threadId;
+        std::string threadName;
+        std::vector<Event> events;
+    };
+    std::vector<Track> tracks;
+
+    // 暂停记录，等待正在进行的写入结束后复制各线程的事件
+    const bool wasEnabled = enabled_.exchange(false, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const std::shared_ptr<Buffer>& buffer : buffers_) {
+            while (buffer->writing.load(std::memory_order_seq_cst)) {
+                std::this_thread::yield();
+            }
+            Track track {buffer->threadId, buffer->threadName, {}};
+            if (buffer->events) {
+                buffer->collect(track.events);
+            }
+            tracks.push_back(std::move(track));
+        }
+        removeFinishedLocked();
+    }
+    enabled_.store(wasEnabled, std::memory_order_seq_cst);
+
+    std::ofstream out(filePath, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    const int pid = static_cast<int>(AURORASTREAM_GETPID());
+    bool first = true;
+    auto separator = [&]() {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (const Track& track : tracks) {
+        if (!track.threadName.empty()) {
+            separator();
+            out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid << ",\"tid\":" << track.threadId
+                << ",\"args\":{\"name\":\"";
+            writeEscaped(out, track.threadName);
+            out << "\"}}";
+        }
+        for (const Event& event : track.events) {
+            separator();
+            out << "{\"ph\":\"X\",\"name\":\"";
+            writeEscaped(out, event.name);
+            out << "\",\"cat\":\"";
+            writeEscaped(out, event.category);
+            out << "\",\"ts\":" << event.start << ",\"dur\":" << event.duration
+                << ",\"pid\":" << pid << ",\"tid\":" << track.threadId << "}";
+        }
+    }
+    out << "\n]}\n";
+    return out.good();
+}
+
+void Tracer::setThreadName(const std::string& name)
+{
+    Tracer& tracer = instance();
+    Buffer* buffer = tracer.threadBuffer();
+    std::lock_guard<std::mutex> lock(tracer.mutex_);
+    buffer->threadName = name;
+}
+
+int64_t Tracer::now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::record(const char* name, const char* category, int64_t start, int64_t end)
+{
+    Buffer* buffer = threadBuffer();
+    buffer->writing.store(true, std::memory_order_seq_cst);
+    if (enabled_.load(std::memory_order_seq_cst)) {
+        buffer->push(name, category, start, end - start);
+    }
+    buffer->writing.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief 当前线程的缓冲区，首次调用时创建并注册
+ * 线程退出时持有者析构，把缓冲区标记为已结束；缓冲区保留到下一次导出或清空，
+ * 以便导出它记录过的事件
+ */
+Tracer::Buffer* Tracer::threadBuffer()
+{
+    struct Holder {
+        std::shared_ptr<Buffer> buffer;
+        ~Holder() {
+            if (buffer) {
+                buffer->finished.store(true, std::memory_order_release);
+            }
+        }
+    };
+    thread_local Holder holder;
+    if (!holder.buffer) {
+        holder.buffer = std::make_shared<Buffer>(nextThreadId_.fetch_add(1, std::memory_order_relaxed));
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.push_back(holder.buffer);
+    }
+    return holder.buffer.get();
+}
+
+/// 移除所属线程已退出的缓冲区（调用方持有 mutex_）
+void Tracer::removeFinishedLocked()
+{
+    buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+                                  [](const std::shared_ptr<Buffer>& buffer) {
+                                      return buffer->finished.load(std::memory_order_acquire);
+                                  }),
+                   buffers_.end());
+}
+
+} // namespace utils
+} // namespace aurorastream